@@ -0,0 +1,218 @@
+// STL
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Mythos
+#include "Debug.hpp"
+#include "Profile/profiler.hpp"
+#include "Vulkan/mythos_vulkan.hpp"
+
+// renders the scene offscreen under every combination of the frame policy's settings and reports how each one paces
+//
+// usage : Benchmark [-frames N] [-warmup N] [-width W] [-height H] [-trace]
+// the swapchain is a VK_EXT_headless_surface one, nothing is shown and any driver with the extension can run it,
+// lavapipe included : VK_DRIVER_FILES=<path to lvp_icd json> Benchmark
+// settings a device or surface does not support are clamped, configurations that end up identical run once
+// -trace writes each configuration's measured frames as a chrome trace, benchmark_<msaa>_<present>_<images>.json
+// gpu is from a frame's first timestamp to its last, lavapipe renders on the cpu so its timestamps only check the plumbing
+namespace
+{
+	struct run_result
+	{
+		uint32_t samples = 0;
+		VkPresentModeKHR present_mode = VK_PRESENT_MODE_FIFO_KHR;
+		uint32_t images = 0;
+		int frames_in_flight = 0;
+
+		double frame_mean = 0.0, frame_p50 = 0.0, frame_p99 = 0.0;
+		double cpu_mean = 0.0;
+		double gpu_mean = 0.0;
+		double latency_mean = 0.0, latency_p99 = 0.0;
+	};
+
+	auto take_value(std::vector<std::string>& args, const char* flag, uint32_t fallback) -> uint32_t
+	{
+		const auto found = std::ranges::find(args, flag);
+		if (found == args.end() || found + 1 == args.end()) return fallback;
+
+		const auto value = static_cast<uint32_t>(std::stoul(*(found + 1)));
+		args.erase(found, found + 2);
+		return value;
+	}
+
+	auto mean(const std::vector<double>& samples) -> double
+	{
+		auto sum = 0.0;
+		for (const auto sample : samples) sum += sample;
+		return samples.empty() ? 0.0 : sum / static_cast<double>(samples.size());
+	}
+
+	// sorts samples
+	auto percentile(std::vector<double>& samples, double p) -> double
+	{
+		if (samples.empty()) return 0.0;
+
+		std::ranges::sort(samples);
+		const auto index = static_cast<size_t>(p * static_cast<double>(samples.size() - 1) + 0.5);
+		return samples[index];
+	}
+
+	auto run(const Mythos::vulkan::render_settings& settings, uint32_t warmup, uint32_t frames, bool trace,
+	         std::set<std::tuple<uint32_t, VkPresentModeKHR, uint32_t, int>>& seen, run_result& result) -> bool
+	{
+		using namespace Mythos::vulkan;
+
+		auto vulkan = make_unique_vulkan_data(false, settings);
+
+		// a renderer that stopped halfway has no device to wait on, the process ends soon after anyway
+		if (!create_renderer(nullptr, nullptr, *vulkan)) return false;
+
+		result.samples = static_cast<uint32_t>(vulkan->msaa_samples);
+		result.present_mode = vulkan->swapchain_present_mode;
+		result.images = static_cast<uint32_t>(vulkan->images.size());
+		result.frames_in_flight = vulkan->MAX_FRAMES_IN_FLIGHT;
+
+		if (!seen.emplace(result.samples, result.present_mode, result.images, result.frames_in_flight).second)
+		{
+			destroy_vulkan_data(*vulkan);
+			return false;
+		}
+
+		// no job system, the model decodes on the first process_asset_uploads
+		vulkan->model = vulkan->assets.load_mesh(MODEL_PATH);
+		vulkan->model_texture = vulkan->assets.load_texture(TEXTURE_PATH);
+
+		auto frame_ms = std::vector<double>();
+		auto cpu_ms = std::vector<double>();
+		auto gpu_ms = std::vector<double>();
+		auto latency_ms = std::vector<double>();
+
+#if MYTHOS_PROFILE
+		if (trace)
+		{
+			const auto path = "benchmark_" + std::to_string(result.samples) + "_" + present_mode_name(result.present_mode) + "_" +
+				std::to_string(result.images) + ".json";
+			Mythos::profiler::find()->capture(frames, path);
+		}
+#endif
+
+		// a capture starts at the marker ending the warmup and takes one frame per marker after it
+		if (warmup == 0) PROFILE_FRAME();
+
+		for (auto frame = 0u; frame < warmup + frames; frame++)
+		{
+			vulkan->animation_time = static_cast<float>(frame) / 60.0f;
+
+			process_asset_uploads(*vulkan);
+			draw_frame(nullptr, *vulkan);
+
+			if (frame + 1 >= warmup) PROFILE_FRAME();
+
+			if (frame < warmup) continue;
+
+			const auto& timings = vulkan->frame_timings;
+			frame_ms.push_back(timings.frame_ms);
+			cpu_ms.push_back(timings.cpu_ms);
+			gpu_ms.push_back(vulkan->gpu_profile.stats().frame_ms);
+			latency_ms.push_back(timings.latency_ms);
+		}
+
+		result.frame_mean = mean(frame_ms);
+		result.frame_p50 = percentile(frame_ms, 0.5);
+		result.frame_p99 = percentile(frame_ms, 0.99);
+		result.cpu_mean = mean(cpu_ms);
+		result.gpu_mean = mean(gpu_ms);
+		result.latency_mean = mean(latency_ms);
+		result.latency_p99 = percentile(latency_ms, 0.99);
+
+		destroy_vulkan_data(*vulkan);
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	using namespace Mythos;
+
+	// the renderer reports through Debug
+	Debug::SetDefaultBehaviour();
+
+#if MYTHOS_PROFILE
+	// idle unless -trace asks for a capture, created before the renderer's zones first look for it
+	profiler::create();
+#endif
+
+	auto args = std::vector<std::string>(argv + 1, argv + argc);
+
+	const auto frames = std::max(take_value(args, "-frames", 300), 1u);
+	const auto warmup = take_value(args, "-warmup", 60);
+	const auto width = take_value(args, "-width", 1280);
+	const auto height = take_value(args, "-height", 720);
+
+	const auto trace = std::ranges::find(args, "-trace") != args.end();
+	std::erase(args, "-trace");
+
+	if (!args.empty())
+	{
+		std::cout << "usage : Benchmark [-frames N] [-warmup N] [-width W] [-height H] [-trace]\n";
+		return 1;
+	}
+
+	const auto sample_counts = std::vector<uint32_t>{ 1, 4, 8 };
+	const auto present_modes = std::vector<VkPresentModeKHR>{ VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_FIFO_KHR };
+	const auto image_counts = std::vector<uint32_t>{ 2, 3 };
+
+	auto seen = std::set<std::tuple<uint32_t, VkPresentModeKHR, uint32_t, int>>();
+	auto results = std::vector<run_result>();
+
+	for (const auto samples : sample_counts)
+	{
+		for (const auto mode : present_modes)
+		{
+			for (const auto images : image_counts)
+			{
+				auto settings = vulkan::render_settings
+				{
+					.max_samples = samples,
+					.present_modes = { mode },
+					.image_count = images,
+					// a frame in flight per image the presentation engine does not hold
+					.frames_in_flight = static_cast<int>(images) - 1,
+					.headless = true,
+					.extent = { width, height },
+				};
+
+				auto result = run_result();
+				if (run(settings, warmup, frames, trace, seen, result)) results.push_back(result);
+			}
+		}
+	}
+
+	if (results.empty())
+	{
+		std::cout << "[benchmark] no configuration ran, the driver needs VK_EXT_headless_surface\n";
+		return 1;
+	}
+
+	std::cout << "\n[benchmark] " << width << "x" << height << ", " << frames << " frames after " << warmup << " warmup frames, times in ms\n";
+	std::cout << std::left << std::setw(6) << "msaa" << std::setw(14) << "present" << std::setw(8) << "images" <<
+		std::setw(8) << "frames" << std::right << std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10) <<
+		"p99" << std::setw(10) << "cpu" << std::setw(10) << "gpu" << std::setw(10) << "latency" << std::setw(12) << "latency p99" << '\n';
+
+	std::cout << std::fixed << std::setprecision(3);
+
+	for (const auto& result : results)
+	{
+		std::cout << std::left << std::setw(6) << result.samples << std::setw(14) << vulkan::present_mode_name(result.present_mode) <<
+			std::setw(8) << result.images << std::setw(8) << result.frames_in_flight << std::right << std::setw(10) <<
+			result.frame_mean << std::setw(10) << result.frame_p50 << std::setw(10) << result.frame_p99 << std::setw(10) <<
+			result.cpu_mean << std::setw(10) << result.gpu_mean << std::setw(10) << result.latency_mean << std::setw(12) << result.latency_p99 << '\n';
+	}
+
+	return 0;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <vector>
+
+// Mythos
+#include "Job/job_system.hpp"
+#include "Texture/texture_file.hpp"
+
+// --
+namespace Mythos::cooker
+{
+	// --
+
+	// each encoder reads a 4x4 block of rgba8 texels, row major, and writes one compressed block
+	// endpoints come from the principal axis of the block and are refined by a least squares fit to the chosen indices
+
+	auto encode_bc1_block(const uint8_t* texels, uint8_t* block) -> void;                    // 8 bytes, alpha is ignored
+	auto encode_bc3_block(const uint8_t* texels, uint8_t* block) -> void;                    // 16 bytes
+	auto encode_bc4_block(const uint8_t* texels, uint32_t channel, uint8_t* block) -> void;  // 8 bytes, one channel
+	auto encode_bc5_block(const uint8_t* texels, uint8_t* block) -> void;                    // 16 bytes, red and green
+	auto encode_bc7_block(const uint8_t* texels, uint8_t* block) -> void;                    // 16 bytes, modes 5 and 6
+
+	// compresses one level on the job system, blocks hanging over the edge repeat the last row and column
+	auto compress_level(texture_format format, const uint8_t* rgba, uint32_t width, uint32_t height,
+	                    job_system* jobs = nullptr) -> std::vector<uint8_t>;
+}
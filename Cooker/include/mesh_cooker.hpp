@@ -0,0 +1,41 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <string>
+
+// Mythos
+#include "Job/job_system.hpp"
+#include "Mesh/mesh_optimizer.hpp"
+
+// --
+namespace Mythos::cooker
+{
+	// --
+
+	struct mesh_cook_options
+	{
+		job_system* jobs = nullptr;    // null cooks on the calling thread
+		bool verify = false;           // checks the weld against a plain std::unordered_map reference
+	};
+
+	struct mesh_cook_stats
+	{
+		uint32_t source_vertices = 0;  // vertices the importer produced
+		uint32_t vertex_count = 0;     // vertices written after dropping the unreferenced ones
+		uint32_t index_count = 0;
+		uint32_t index_size = 0;       // bytes per index, 2 when every vertex fits in 16 bits
+		uint32_t vertex_stride = 0;    // bytes per vertex in mesh_vertex_layout, over every stream
+		uint32_t clamped_tex_coords = 0;
+		uint64_t file_size = 0;
+
+		double weld_ms = 0.0;
+		double reference_weld_ms = 0.0; // only when verifying
+
+		mesh_optimize_stats optimize;
+	};
+
+	// imports and optimizes an obj and writes it out in the runtime's binary mesh layout, see Mesh/mesh_file.hpp
+	auto cook_mesh(const std::string& source, const std::string& destination, const mesh_cook_options& options,
+	               mesh_cook_stats& stats) -> bool;
+}
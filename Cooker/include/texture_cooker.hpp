@@ -0,0 +1,37 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <string>
+
+// Mythos
+#include "Job/job_system.hpp"
+#include "Texture/texture_file.hpp"
+
+// --
+namespace Mythos::cooker
+{
+	// --
+
+	struct texture_cook_options
+	{
+		job_system* jobs = nullptr;                    // null cooks on the calling thread
+		texture_format format = texture_format::bc7_srgb;
+	};
+
+	struct texture_cook_stats
+	{
+		uint32_t width = 0;
+		uint32_t height = 0;
+		uint32_t level_count = 0;
+		uint64_t source_bytes = 0;     // the whole chain as rgba8
+		uint64_t file_size = 0;
+
+		double mip_ms = 0.0;
+		double compress_ms = 0.0;
+	};
+
+	// decodes an image, filters its full mip chain and writes every level in the runtime's texture layout, see Texture/texture_file.hpp
+	auto cook_texture(const std::string& source, const std::string& destination, const texture_cook_options& options,
+	                  texture_cook_stats& stats) -> bool;
+}
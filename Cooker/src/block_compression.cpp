@@ -0,0 +1,573 @@
+#include "block_compression.hpp"
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+// --
+namespace Mythos::cooker
+{
+	// --
+
+	using block_points = std::array<std::array<float, 4>, 16>;
+
+	// mean and dominant direction of the block in the first channels components, by power iteration on the covariance
+	static auto fit_line(const block_points& points, int channels, std::array<float, 4>& mean, std::array<float, 4>& axis) -> void
+	{
+		mean = {};
+		for (const auto& point : points)
+		{
+			for (auto c = 0; c < channels; c++) mean[c] += point[c] / 16.0f;
+		}
+
+		float covariance[4][4] = {};
+		for (const auto& point : points)
+		{
+			for (auto i = 0; i < channels; i++)
+			{
+				for (auto j = 0; j < channels; j++)
+				{
+					covariance[i][j] += (point[i] - mean[i]) * (point[j] - mean[j]);
+				}
+			}
+		}
+
+		axis = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+		for (auto iteration = 0; iteration < 8; iteration++)
+		{
+			auto next = std::array<float, 4>();
+			auto length = 0.0f;
+
+			for (auto i = 0; i < channels; i++)
+			{
+				for (auto j = 0; j < channels; j++) next[i] += covariance[i][j] * axis[j];
+				length = std::max(length, std::abs(next[i]));
+			}
+
+			// a flat block has no direction, any axis spans it
+			if (length <= 0.0f) return;
+
+			for (auto i = 0; i < channels; i++) axis[i] = next[i] / length;
+		}
+	}
+
+	// the extremes of the block along its axis
+	static auto initial_endpoints(const block_points& points, int channels, std::array<float, 4>& first,
+	                              std::array<float, 4>& second) -> void
+	{
+		auto mean = std::array<float, 4>();
+		auto axis = std::array<float, 4>();
+		fit_line(points, channels, mean, axis);
+
+		auto low = 0.0f;
+		auto high = 0.0f;
+
+		for (const auto& point : points)
+		{
+			auto t = 0.0f;
+			for (auto c = 0; c < channels; c++) t += (point[c] - mean[c]) * axis[c];
+
+			low = std::min(low, t);
+			high = std::max(high, t);
+		}
+
+		auto norm = 0.0f;
+		for (auto c = 0; c < channels; c++) norm += axis[c] * axis[c];
+		if (norm > 0.0f)
+		{
+			low /= norm;
+			high /= norm;
+		}
+
+		for (auto c = 0; c < 4; c++)
+		{
+			first[c] = c < channels ? mean[c] + axis[c] * high : 0.0f;
+			second[c] = c < channels ? mean[c] + axis[c] * low : 0.0f;
+		}
+	}
+
+	// best endpoints for fixed indices, weights are how much of the first endpoint each texel takes
+	static auto least_squares(const block_points& points, const float* weights, int channels, std::array<float, 4>& first,
+	                          std::array<float, 4>& second) -> bool
+	{
+		auto aa = 0.0f, ab = 0.0f, bb = 0.0f;
+		auto ax = std::array<float, 4>();
+		auto bx = std::array<float, 4>();
+
+		for (auto i = 0; i < 16; i++)
+		{
+			const auto a = weights[i];
+			const auto b = 1.0f - a;
+
+			aa += a * a;
+			ab += a * b;
+			bb += b * b;
+
+			for (auto c = 0; c < channels; c++)
+			{
+				ax[c] += a * points[i][c];
+				bx[c] += b * points[i][c];
+			}
+		}
+
+		const auto determinant = aa * bb - ab * ab;
+		if (std::abs(determinant) < 1e-6f) return false;
+
+		for (auto c = 0; c < channels; c++)
+		{
+			first[c] = std::clamp((bb * ax[c] - ab * bx[c]) / determinant, 0.0f, 255.0f);
+			second[c] = std::clamp((aa * bx[c] - ab * ax[c]) / determinant, 0.0f, 255.0f);
+		}
+
+		return true;
+	}
+
+	static auto load_points(const uint8_t* texels) -> block_points
+	{
+		auto points = block_points();
+
+		for (auto i = 0; i < 16; i++)
+		{
+			for (auto c = 0; c < 4; c++) points[i][c] = texels[i * 4 + c];
+		}
+
+		return points;
+	}
+
+	static auto write_bits(uint8_t* block, uint64_t low, uint64_t high) -> void
+	{
+		for (auto i = 0; i < 8; i++)
+		{
+			block[i] = static_cast<uint8_t>(low >> (i * 8));
+			block[i + 8] = static_cast<uint8_t>(high >> (i * 8));
+		}
+	}
+
+	// -- bc1
+
+	static auto to_565(const std::array<float, 4>& color) -> uint16_t
+	{
+		const auto r = static_cast<uint16_t>(std::lround(std::clamp(color[0], 0.0f, 255.0f) * 31.0f / 255.0f));
+		const auto g = static_cast<uint16_t>(std::lround(std::clamp(color[1], 0.0f, 255.0f) * 63.0f / 255.0f));
+		const auto b = static_cast<uint16_t>(std::lround(std::clamp(color[2], 0.0f, 255.0f) * 31.0f / 255.0f));
+		return static_cast<uint16_t>(r << 11 | g << 5 | b);
+	}
+
+	static auto from_565(uint16_t color) -> std::array<int32_t, 3>
+	{
+		const auto r = color >> 11;
+		const auto g = (color >> 5) & 63;
+		const auto b = color & 31;
+		return { r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2 };
+	}
+
+	struct bc1_candidate
+	{
+		uint16_t color0 = 0;
+		uint16_t color1 = 0;
+		uint32_t indices = 0;
+		float error = 0.0f;
+		float weights[16] = {};
+	};
+
+	// always four colour mode, colour0 above colour1, so bc3 reads the same block the same way
+	static auto evaluate_bc1(const block_points& points, const std::array<float, 4>& first, const std::array<float, 4>& second) -> bc1_candidate
+	{
+		auto result = bc1_candidate{ to_565(first), to_565(second) };
+		if (result.color0 < result.color1) std::swap(result.color0, result.color1);
+
+		const auto p0 = from_565(result.color0);
+		const auto p1 = from_565(result.color1);
+
+		std::array<int32_t, 3> palette[4] = { p0, p1 };
+		for (auto c = 0; c < 3; c++)
+		{
+			palette[2][c] = (2 * p0[c] + p1[c]) / 3;
+			palette[3][c] = (p0[c] + 2 * p1[c]) / 3;
+		}
+
+		// equal endpoints decode in three colour mode, where only the first entry is safe to use
+		const auto entries = result.color0 == result.color1 ? 1 : 4;
+		constexpr float weight_of_first[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+		for (auto i = 0; i < 16; i++)
+		{
+			auto best = 0;
+			auto best_error = 1e30f;
+
+			for (auto e = 0; e < entries; e++)
+			{
+				auto error = 0.0f;
+				for (auto c = 0; c < 3; c++)
+				{
+					const auto d = points[i][c] - static_cast<float>(palette[e][c]);
+					error += d * d;
+				}
+
+				if (error < best_error)
+				{
+					best_error = error;
+					best = e;
+				}
+			}
+
+			result.indices |= static_cast<uint32_t>(best) << (i * 2);
+			result.error += best_error;
+			result.weights[i] = weight_of_first[best];
+		}
+
+		return result;
+	}
+
+	auto encode_bc1_block(const uint8_t* texels, uint8_t* block) -> void
+	{
+		const auto points = load_points(texels);
+
+		auto first = std::array<float, 4>();
+		auto second = std::array<float, 4>();
+		initial_endpoints(points, 3, first, second);
+
+		auto best = evaluate_bc1(points, first, second);
+
+		for (auto iteration = 0; iteration < 2 && best.error > 0.0f; iteration++)
+		{
+			if (!least_squares(points, best.weights, 3, first, second)) break;
+
+			const auto refined = evaluate_bc1(points, first, second);
+			if (refined.error >= best.error) break;
+
+			best = refined;
+		}
+
+		block[0] = static_cast<uint8_t>(best.color0);
+		block[1] = static_cast<uint8_t>(best.color0 >> 8);
+		block[2] = static_cast<uint8_t>(best.color1);
+		block[3] = static_cast<uint8_t>(best.color1 >> 8);
+		std::memcpy(block + 4, &best.indices, 4);
+	}
+
+	// -- bc4, bc3 and bc5
+
+	auto encode_bc4_block(const uint8_t* texels, uint32_t channel, uint8_t* block) -> void
+	{
+		auto high = 0;
+		auto low = 255;
+
+		for (auto i = 0; i < 16; i++)
+		{
+			high = std::max<int>(high, texels[i * 4 + channel]);
+			low = std::min<int>(low, texels[i * 4 + channel]);
+		}
+
+		// high above low selects the eight value mode
+		int32_t palette[8] = { high, low };
+		for (auto i = 1; i < 7; i++)
+		{
+			palette[i + 1] = ((7 - i) * high + i * low + 3) / 7;
+		}
+
+		auto bits = uint64_t(high) | uint64_t(low) << 8;
+
+		if (high != low)
+		{
+			for (auto i = 0; i < 16; i++)
+			{
+				const auto value = static_cast<int32_t>(texels[i * 4 + channel]);
+
+				auto best = 0;
+				for (auto e = 1; e < 8; e++)
+				{
+					if (std::abs(palette[e] - value) < std::abs(palette[best] - value)) best = e;
+				}
+
+				bits |= uint64_t(best) << (16 + i * 3);
+			}
+		}
+
+		for (auto i = 0; i < 8; i++)
+		{
+			block[i] = static_cast<uint8_t>(bits >> (i * 8));
+		}
+	}
+
+	auto encode_bc3_block(const uint8_t* texels, uint8_t* block) -> void
+	{
+		encode_bc4_block(texels, 3, block);
+		encode_bc1_block(texels, block + 8);
+	}
+
+	auto encode_bc5_block(const uint8_t* texels, uint8_t* block) -> void
+	{
+		encode_bc4_block(texels, 0, block);
+		encode_bc4_block(texels, 1, block + 8);
+	}
+
+	// -- bc7, mode 6 fits all four channels to one line with 4 bit indices, mode 5 fits colour and alpha
+	// separately with 2 bit indices each, every block is written in whichever of the two is closer
+
+	static constexpr int32_t BC7_WEIGHTS_2[4] = { 0, 21, 43, 64 };
+	static constexpr int32_t BC7_WEIGHTS_4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	struct bc7_precision
+	{
+		int32_t bits = 7;          // per endpoint channel, before the p bit
+		bool p_bits = false;       // one extra low bit per endpoint shared by its channels
+		const int32_t* weights = nullptr;
+		int32_t index_count = 0;
+	};
+
+	static constexpr auto MODE6 = bc7_precision{ 7, true, BC7_WEIGHTS_4, 16 };
+	static constexpr auto MODE5_COLOR = bc7_precision{ 7, false, BC7_WEIGHTS_2, 4 };
+	static constexpr auto MODE5_ALPHA = bc7_precision{ 8, false, BC7_WEIGHTS_2, 4 };
+
+	struct bc7_fit
+	{
+		std::array<int32_t, 4> endpoints[2] = {};
+		int32_t p_bits[2] = {};
+		uint8_t indices[16] = {};
+		float weights[16] = {};
+		float error = 0.0f;
+	};
+
+	static auto expand_bc7(const bc7_fit& fit, const bc7_precision& precision, int32_t endpoint, int32_t channel) -> int32_t
+	{
+		const auto value = fit.endpoints[endpoint][channel];
+
+		if (precision.p_bits) return value << 1 | fit.p_bits[endpoint];
+		if (precision.bits == 8) return value;
+
+		return value << (8 - precision.bits) | value >> (2 * precision.bits - 8);
+	}
+
+	static auto evaluate_bc7(const block_points& points, int channels, const bc7_precision& precision,
+	                         const std::array<float, 4>& first, const std::array<float, 4>& second) -> bc7_fit
+	{
+		auto best = bc7_fit();
+		best.error = 1e30f;
+
+		// the p bit is shared by every channel of an endpoint, so try each pair and keep the closest
+		const auto combinations = precision.p_bits ? 4 : 1;
+		const auto max_value = (1 << precision.bits) - 1;
+
+		for (auto combination = 0; combination < combinations; combination++)
+		{
+			auto fit = bc7_fit();
+			fit.p_bits[0] = combination & 1;
+			fit.p_bits[1] = combination >> 1;
+
+			for (auto c = 0; c < channels; c++)
+			{
+				const auto quantize = [&](float value, int32_t p_bit)
+				{
+					const auto scaled = precision.p_bits ? (value - p_bit) / 2.0f : value * max_value / 255.0f;
+					return std::clamp(static_cast<int32_t>(std::lround(scaled)), 0, max_value);
+				};
+
+				fit.endpoints[0][c] = quantize(first[c], fit.p_bits[0]);
+				fit.endpoints[1][c] = quantize(second[c], fit.p_bits[1]);
+			}
+
+			int32_t palette[16][4] = {};
+			for (auto e = 0; e < precision.index_count; e++)
+			{
+				const auto w = precision.weights[e];
+				for (auto c = 0; c < channels; c++)
+				{
+					palette[e][c] = ((64 - w) * expand_bc7(fit, precision, 0, c) + w * expand_bc7(fit, precision, 1, c) + 32) >> 6;
+				}
+			}
+
+			for (auto i = 0; i < 16 && fit.error < best.error; i++)
+			{
+				auto index = 0;
+				auto index_error = 1e30f;
+
+				for (auto e = 0; e < precision.index_count; e++)
+				{
+					auto error = 0.0f;
+					for (auto c = 0; c < channels; c++)
+					{
+						const auto d = points[i][c] - static_cast<float>(palette[e][c]);
+						error += d * d;
+					}
+
+					if (error < index_error)
+					{
+						index_error = error;
+						index = e;
+					}
+				}
+
+				fit.indices[i] = static_cast<uint8_t>(index);
+				fit.weights[i] = 1.0f - precision.weights[index] / 64.0f;
+				fit.error += index_error;
+			}
+
+			if (fit.error < best.error) best = fit;
+		}
+
+		return best;
+	}
+
+	static auto fit_bc7(const block_points& points, int channels, const bc7_precision& precision) -> bc7_fit
+	{
+		auto first = std::array<float, 4>();
+		auto second = std::array<float, 4>();
+		initial_endpoints(points, channels, first, second);
+
+		auto best = evaluate_bc7(points, channels, precision, first, second);
+
+		for (auto iteration = 0; iteration < 2 && best.error > 0.0f; iteration++)
+		{
+			if (!least_squares(points, best.weights, channels, first, second)) break;
+
+			const auto refined = evaluate_bc7(points, channels, precision, first, second);
+			if (refined.error >= best.error) break;
+
+			best = refined;
+		}
+
+		// the first index is stored without its top bit, swap the endpoints when it is set
+		if (best.indices[0] >= precision.index_count / 2)
+		{
+			std::swap(best.endpoints[0], best.endpoints[1]);
+			std::swap(best.p_bits[0], best.p_bits[1]);
+			for (auto& index : best.indices) index = static_cast<uint8_t>(precision.index_count - 1 - index);
+		}
+
+		return best;
+	}
+
+	auto encode_bc7_block(const uint8_t* texels, uint8_t* block) -> void
+	{
+		const auto points = load_points(texels);
+
+		const auto combined = fit_bc7(points, 4, MODE6);
+		const auto color = combined.error > 0.0f ? fit_bc7(points, 3, MODE5_COLOR) : bc7_fit{};
+
+		auto alpha_points = block_points();
+		for (auto i = 0; i < 16; i++) alpha_points[i][0] = points[i][3];
+		const auto alpha = combined.error > 0.0f ? fit_bc7(alpha_points, 1, MODE5_ALPHA) : bc7_fit{};
+
+		auto low = uint64_t();
+		auto high = uint64_t();
+		auto position = 0;
+
+		const auto put = [&](uint64_t value, int bits)
+		{
+			for (auto i = 0; i < bits; i++, position++)
+			{
+				const auto bit = (value >> i) & 1;
+				if (position < 64) low |= bit << position;
+				else high |= bit << (position - 64);
+			}
+		};
+
+		if (combined.error == 0.0f || combined.error <= color.error + alpha.error)
+		{
+			put(1ull << 6, 7);
+
+			for (auto c = 0; c < 4; c++)
+			{
+				put(static_cast<uint64_t>(combined.endpoints[0][c]), 7);
+				put(static_cast<uint64_t>(combined.endpoints[1][c]), 7);
+			}
+
+			put(static_cast<uint64_t>(combined.p_bits[0]), 1);
+			put(static_cast<uint64_t>(combined.p_bits[1]), 1);
+
+			put(combined.indices[0], 3);
+			for (auto i = 1; i < 16; i++) put(combined.indices[i], 4);
+		}
+		else
+		{
+			// no channel rotation, alpha stays in its own channel
+			put(1ull << 5, 6);
+			put(0, 2);
+
+			for (auto c = 0; c < 3; c++)
+			{
+				put(static_cast<uint64_t>(color.endpoints[0][c]), 7);
+				put(static_cast<uint64_t>(color.endpoints[1][c]), 7);
+			}
+
+			put(static_cast<uint64_t>(alpha.endpoints[0][0]), 8);
+			put(static_cast<uint64_t>(alpha.endpoints[1][0]), 8);
+
+			put(color.indices[0], 1);
+			for (auto i = 1; i < 16; i++) put(color.indices[i], 2);
+
+			put(alpha.indices[0], 1);
+			for (auto i = 1; i < 16; i++) put(alpha.indices[i], 2);
+		}
+
+		write_bits(block, low, high);
+	}
+
+	// --
+
+	auto compress_level(texture_format format, const uint8_t* rgba, uint32_t width, uint32_t height, job_system* jobs) -> std::vector<uint8_t>
+	{
+		const auto blocks_x = (width + 3) / 4;
+		const auto blocks_y = (height + 3) / 4;
+		const auto block_bytes = texture_block_bytes(format);
+
+		auto result = std::vector<uint8_t>(static_cast<size_t>(blocks_x) * blocks_y * block_bytes);
+
+		const auto encode_rows = [&](uint32_t begin, uint32_t end)
+		{
+			uint8_t texels[64];
+
+			for (auto by = begin; by < end; by++)
+			{
+				for (uint32_t bx = 0; bx < blocks_x; bx++)
+				{
+					for (uint32_t i = 0; i < 16; i++)
+					{
+						const auto x = std::min(bx * 4 + i % 4, width - 1);
+						const auto y = std::min(by * 4 + i / 4, height - 1);
+						std::memcpy(texels + i * 4, rgba + (static_cast<size_t>(y) * width + x) * 4, 4);
+					}
+
+					auto* block = result.data() + (static_cast<size_t>(by) * blocks_x + bx) * block_bytes;
+
+					switch (format)
+					{
+					case texture_format::bc1_unorm:
+					case texture_format::bc1_srgb:
+						encode_bc1_block(texels, block);
+						break;
+					case texture_format::bc3_unorm:
+					case texture_format::bc3_srgb:
+						encode_bc3_block(texels, block);
+						break;
+					case texture_format::bc5_unorm:
+						encode_bc5_block(texels, block);
+						break;
+					case texture_format::bc7_unorm:
+					case texture_format::bc7_srgb:
+						encode_bc7_block(texels, block);
+						break;
+					default:
+						break;
+					}
+				}
+			}
+		};
+
+		if (jobs != nullptr)
+		{
+			jobs->parallel_for(blocks_y, 1, encode_rows);
+		}
+		else
+		{
+			encode_rows(0, blocks_y);
+		}
+
+		return result;
+	}
+}
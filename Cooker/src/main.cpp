@@ -0,0 +1,176 @@
+// STL
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Mythos
+#include "Debug.hpp"
+#include "Mesh/mesh_file.hpp"
+#include "Scheduler/thread_pool.hpp"
+#include "Texture/texture_file.hpp"
+#include "mesh_cooker.hpp"
+#include "texture_cooker.hpp"
+
+// offline asset cooker, turns source assets into the binary layouts the runtime maps without parsing
+//
+// usage : Cooker [options] <source> [destination]
+//         Cooker [options] <source> <source> ...
+// .obj sources cook to .mesh, .png .jpg .jpeg .tga and .bmp sources cook to .tex
+// with a single source the destination defaults to the source path with the cooked extension
+// -verify checks every weld against a single threaded reference and fails the cook on any difference
+// -bc1 -bc3 -bc5 -bc7 -rgba pick the texture format, bc7 by default
+// -linear stores colour textures without srgb, bc5 is always linear
+namespace
+{
+	auto is_texture_source(const std::filesystem::path& path) -> bool
+	{
+		auto extension = path.extension().string();
+		std::ranges::transform(extension, extension.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+
+		return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp";
+	}
+
+	auto take_flag(std::vector<std::string>& args, const char* flag) -> bool
+	{
+		const auto found = std::ranges::find(args, flag);
+		if (found == args.end()) return false;
+
+		args.erase(found);
+		return true;
+	}
+
+	auto format_name(Mythos::texture_format format) -> const char*
+	{
+		using Mythos::texture_format;
+
+		switch (format)
+		{
+		case texture_format::rgba8_unorm: return "rgba8";
+		case texture_format::rgba8_srgb: return "rgba8 srgb";
+		case texture_format::bc1_unorm: return "bc1";
+		case texture_format::bc1_srgb: return "bc1 srgb";
+		case texture_format::bc3_unorm: return "bc3";
+		case texture_format::bc3_srgb: return "bc3 srgb";
+		case texture_format::bc5_unorm: return "bc5";
+		case texture_format::bc7_unorm: return "bc7";
+		case texture_format::bc7_srgb: return "bc7 srgb";
+		}
+
+		return "unknown";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	using namespace Mythos;
+
+	// the importer reports through Debug
+	Debug::SetDefaultBehaviour();
+
+	auto args = std::vector<std::string>(argv + 1, argv + argc);
+	auto options = cooker::mesh_cook_options();
+	auto texture_options = cooker::texture_cook_options();
+
+	options.verify = take_flag(args, "-verify");
+
+	const auto linear = take_flag(args, "-linear");
+	if (take_flag(args, "-bc1")) texture_options.format = linear ? texture_format::bc1_unorm : texture_format::bc1_srgb;
+	if (take_flag(args, "-bc3")) texture_options.format = linear ? texture_format::bc3_unorm : texture_format::bc3_srgb;
+	if (take_flag(args, "-bc5")) texture_options.format = texture_format::bc5_unorm;
+	if (take_flag(args, "-bc7")) texture_options.format = linear ? texture_format::bc7_unorm : texture_format::bc7_srgb;
+	if (take_flag(args, "-rgba")) texture_options.format = linear ? texture_format::rgba8_unorm : texture_format::rgba8_srgb;
+
+	if (linear && texture_options.format == texture_format::bc7_srgb)
+	{
+		texture_options.format = texture_format::bc7_unorm;
+	}
+
+	if (args.empty())
+	{
+		std::cout << "usage : Cooker [-verify] [-bc1|-bc3|-bc5|-bc7|-rgba] [-linear] <source> [destination]\n";
+		std::cout << "        Cooker [-verify] [-bc1|-bc3|-bc5|-bc7|-rgba] [-linear] <source> <source> ...\n";
+		return 1;
+	}
+
+	// the same scheduler the engine's job module runs, built in rather than loaded
+	auto pool = Scheduler::thread_pool();
+	options.jobs = &pool;
+	texture_options.jobs = &pool;
+
+	const auto cooked_extension = [](const std::string& source)
+	{
+		return is_texture_source(source) ? TEXTURE_FILE_EXTENSION : MESH_FILE_EXTENSION;
+	};
+
+	// a second argument with the cooked extension of the first names its output
+	auto jobs = std::vector<std::pair<std::string, std::string>>();
+	if (args.size() == 2 && std::filesystem::path(args[1]).extension() == cooked_extension(args[0]))
+	{
+		jobs.emplace_back(args[0], args[1]);
+	}
+	else
+	{
+		for (const auto& source : args)
+		{
+			jobs.emplace_back(source, std::filesystem::path(source).replace_extension(cooked_extension(source)).string());
+		}
+	}
+
+	auto failed = 0;
+
+	for (const auto& [source, destination] : jobs)
+	{
+		if (is_texture_source(source))
+		{
+			auto stats = cooker::texture_cook_stats();
+
+			if (!cooker::cook_texture(source, destination, texture_options, stats))
+			{
+				failed++;
+				continue;
+			}
+
+			std::cout << "[cooker] " << source << " -> " << destination << " : " << stats.width << "x" << stats.height <<
+				" " << format_name(texture_options.format) << ", " << stats.level_count << " levels, " << stats.file_size <<
+				" bytes (" << stats.source_bytes << " as rgba8), mips in " << stats.mip_ms << "ms, compressed in " <<
+				stats.compress_ms << "ms\n";
+			continue;
+		}
+
+		auto stats = cooker::mesh_cook_stats();
+
+		if (!cooker::cook_mesh(source, destination, options, stats))
+		{
+			failed++;
+			continue;
+		}
+
+		std::cout << "[cooker] " << source << " -> " << destination << " : " << stats.vertex_count << " vertices at " << stats.vertex_stride << " bytes (" <<
+			stats.source_vertices << " imported), " << stats.index_count << " indices at " << stats.index_size <<
+			" bytes, " << stats.file_size << " bytes, welded in " << stats.weld_ms << "ms";
+
+		if (options.verify)
+		{
+			std::cout << " (reference " << stats.reference_weld_ms << "ms, identical)";
+		}
+
+		std::cout << '\n';
+
+		const auto print_pass = [](const char* name, const vertex_cache_stats& pass)
+		{
+			std::cout << "[cooker]   " << name << " acmr " << pass.acmr << ", atvr " << pass.atvr << ", overfetch " <<
+				pass.overfetch << '\n';
+		};
+
+		print_pass("source      ", stats.optimize.source);
+		print_pass("vertex cache", stats.optimize.vertex_cache);
+		print_pass("overdraw    ", stats.optimize.overdraw);
+		print_pass("vertex fetch", stats.optimize.vertex_fetch);
+		std::cout << "[cooker]   " << stats.optimize.cluster_count << " overdraw clusters\n";
+	}
+
+	return failed == 0 ? 0 : 1;
+}
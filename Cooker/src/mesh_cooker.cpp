@@ -0,0 +1,204 @@
+#include "mesh_cooker.hpp"
+
+// STL
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+// Mythos
+#include "Mesh/mesh_file.hpp"
+#include "Mesh/mesh_import.hpp"
+#include "Mesh/mesh_optimizer.hpp"
+#include "Shader/vertex_layout.hpp"
+
+// --
+namespace Mythos::cooker
+{
+	// --
+
+	static auto elapsed_ms(std::chrono::steady_clock::time_point start) -> double
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// the obvious single threaded weld, kept deliberately simple so it can be trusted over weld_vertices
+	static auto reference_weld(const std::vector<vertex>& corners, std::vector<vertex>& vertices,
+	                           std::vector<uint32_t>& indices) -> void
+	{
+		auto unique = std::unordered_map<vertex, uint32_t>();
+
+		for (const auto& corner : corners)
+		{
+			const auto [it, inserted] = unique.try_emplace(corner, static_cast<uint32_t>(vertices.size()));
+			if (inserted)
+			{
+				vertices.push_back(corner);
+			}
+
+			indices.push_back(it->second);
+		}
+	}
+
+	static auto verify_weld(const std::string& source, const std::vector<vertex>& corners,
+	                        const std::vector<vertex>& vertices, const std::vector<uint32_t>& indices,
+	                        mesh_cook_stats& stats) -> bool
+	{
+		auto expected_vertices = std::vector<vertex>();
+		auto expected_indices = std::vector<uint32_t>();
+
+		const auto start = std::chrono::steady_clock::now();
+		reference_weld(corners, expected_vertices, expected_indices);
+		stats.reference_weld_ms = elapsed_ms(start);
+
+		if (vertices.size() != expected_vertices.size() || indices.size() != expected_indices.size())
+		{
+			std::cerr << "[cooker] " << source << " weld produced " << vertices.size() << " vertices and " <<
+				indices.size() << " indices, the reference " << expected_vertices.size() << " and " <<
+				expected_indices.size() << '\n';
+			return false;
+		}
+
+		const auto vertex_mismatch = std::ranges::mismatch(vertices, expected_vertices).in1;
+		if (vertex_mismatch != vertices.end())
+		{
+			std::cerr << "[cooker] " << source << " weld differs from the reference at vertex " <<
+				(vertex_mismatch - vertices.begin()) << '\n';
+			return false;
+		}
+
+		const auto index_mismatch = std::ranges::mismatch(indices, expected_indices).in1;
+		if (index_mismatch != indices.end())
+		{
+			std::cerr << "[cooker] " << source << " weld differs from the reference at index " <<
+				(index_mismatch - indices.begin()) << '\n';
+			return false;
+		}
+
+		return true;
+	}
+
+	static auto write_padding(std::ofstream& file, uint64_t offset) -> void
+	{
+		constexpr char zeros[MESH_FILE_ALIGNMENT] = {};
+
+		const auto position = static_cast<uint64_t>(file.tellp());
+		file.write(zeros, static_cast<std::streamsize>(offset - position));
+	}
+
+	auto cook_mesh(const std::string& source, const std::string& destination, const mesh_cook_options& options,
+	               mesh_cook_stats& stats) -> bool
+	{
+		auto corners = std::vector<vertex>();
+		auto vertices = std::vector<vertex>();
+		auto indices = std::vector<uint32_t>();
+
+		if (!import_obj(source, corners, options.jobs))
+		{
+			std::cerr << "[cooker] failed to import " << source << '\n';
+			return false;
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		weld_vertices(corners, vertices, indices, options.jobs);
+		stats.weld_ms = elapsed_ms(start);
+
+		if (options.verify && !verify_weld(source, corners, vertices, indices, stats))
+		{
+			return false;
+		}
+
+		if (indices.empty())
+		{
+			std::cerr << "[cooker] " << source << " has no triangles\n";
+			return false;
+		}
+
+		const auto out_of_range = std::ranges::any_of(indices, [&](uint32_t index) { return index >= vertices.size(); });
+		if (out_of_range)
+		{
+			std::cerr << "[cooker] " << source << " produced an index past the end of its vertices\n";
+			return false;
+		}
+
+		stats.source_vertices = static_cast<uint32_t>(vertices.size());
+		// overfetch measured over the streams that are shipped, not the import vertex
+		optimize_mesh(vertices, indices, &stats.optimize, mesh_vertex_layout::stride);
+
+		const auto bounds = compute_bounds(vertices);
+		const auto encoded = mesh_vertex_layout::encode(vertices, bounds);
+
+		if constexpr (mesh_vertex_layout::tex_coord_encoding::clamped)
+		{
+			const auto outside = [](float value) { return value < 0.0f || value > 1.0f; };
+			stats.clamped_tex_coords = static_cast<uint32_t>(std::ranges::count_if(vertices, [&](const vertex& item)
+			{
+				return outside(item.tex_coord.x) || outside(item.tex_coord.y);
+			}));
+
+			if (stats.clamped_tex_coords > 0)
+			{
+				std::cerr << "[cooker] warning : " << source << " has " << stats.clamped_tex_coords <<
+					" vertices with texture coordinates outside [0, 1], the vertex layout clamps them\n";
+			}
+		}
+
+		auto header = mesh_file_header();
+		header.vertex_layout = mesh_vertex_layout::id;
+		header.vertex_stride = mesh_vertex_layout::stride;
+		header.vertex_count = static_cast<uint32_t>(vertices.size());
+		header.index_count = static_cast<uint32_t>(indices.size());
+		header.index_type = vertices.size() <= UINT16_MAX + 1ull ? mesh_index_type::uint16 : mesh_index_type::uint32;
+
+		const auto vertex_bytes = static_cast<uint64_t>(encoded.size());
+		const auto index_bytes = static_cast<uint64_t>(header.index_count) * mesh_index_size(header.index_type);
+
+		header.vertex_offset = align_mesh_offset(sizeof(mesh_file_header));
+		header.vertex_bytes = vertex_bytes;
+		header.index_offset = align_mesh_offset(header.vertex_offset + vertex_bytes);
+
+		for (auto axis = 0; axis < 3; axis++)
+		{
+			header.bounds_min[axis] = bounds.min[axis];
+			header.bounds_max[axis] = bounds.max[axis];
+		}
+
+		auto file = std::ofstream(destination, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			std::cerr << "[cooker] could not open " << destination << " for writing\n";
+			return false;
+		}
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		write_padding(file, header.vertex_offset);
+		file.write(reinterpret_cast<const char*>(encoded.data()), static_cast<std::streamsize>(vertex_bytes));
+
+		write_padding(file, header.index_offset);
+		if (header.index_type == mesh_index_type::uint16)
+		{
+			auto narrow = std::vector<uint16_t>(indices.begin(), indices.end());
+			file.write(reinterpret_cast<const char*>(narrow.data()), static_cast<std::streamsize>(index_bytes));
+		}
+		else
+		{
+			file.write(reinterpret_cast<const char*>(indices.data()), static_cast<std::streamsize>(index_bytes));
+		}
+
+		if (!file)
+		{
+			std::cerr << "[cooker] failed writing " << destination << '\n';
+			return false;
+		}
+
+		stats.vertex_count = header.vertex_count;
+		stats.index_count = header.index_count;
+		stats.index_size = mesh_index_size(header.index_type);
+		stats.vertex_stride = header.vertex_stride;
+		stats.file_size = header.index_offset + index_bytes;
+		return true;
+	}
+}
@@ -0,0 +1,133 @@
+#include "texture_cooker.hpp"
+
+// STL
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// STB
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+// Mythos
+#include "Texture/texture_mips.hpp"
+#include "block_compression.hpp"
+
+// --
+namespace Mythos::cooker
+{
+	// --
+
+	static auto elapsed_ms(std::chrono::steady_clock::time_point start) -> double
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	static auto is_srgb(texture_format format) -> bool
+	{
+		return format == texture_format::rgba8_srgb || format == texture_format::bc1_srgb ||
+			format == texture_format::bc3_srgb || format == texture_format::bc7_srgb;
+	}
+
+	static auto write_padding(std::ofstream& file, uint64_t offset) -> void
+	{
+		constexpr char zeros[TEXTURE_FILE_ALIGNMENT] = {};
+
+		const auto position = static_cast<uint64_t>(file.tellp());
+		file.write(zeros, static_cast<std::streamsize>(offset - position));
+	}
+
+	auto cook_texture(const std::string& source, const std::string& destination, const texture_cook_options& options,
+	                  texture_cook_stats& stats) -> bool
+	{
+		auto width = 0;
+		auto height = 0;
+		auto channels = 0;
+
+		auto* pixels = stbi_load(source.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+		if (pixels == nullptr)
+		{
+			std::cerr << "[cooker] failed to load " << source << " : " << stbi_failure_reason() << '\n';
+			return false;
+		}
+
+		const auto format = options.format;
+		const auto w = static_cast<uint32_t>(width);
+		const auto h = static_cast<uint32_t>(height);
+
+		// every level filtered in float from the one above, then brought back to rgba8 for the encoders
+		auto start = std::chrono::steady_clock::now();
+		const auto chain = generate_rgba8_mips(pixels, w, h, is_srgb(format), options.jobs);
+		stats.mip_ms = elapsed_ms(start);
+
+		stbi_image_free(pixels);
+
+		start = std::chrono::steady_clock::now();
+		auto levels = std::vector<std::vector<uint8_t>>();
+
+		for (uint32_t i = 0; i < chain.levels.size(); i++)
+		{
+			const auto* level = chain.pixels.data() + chain.levels[i].offset;
+			const auto level_width = texture_level_extent(w, i);
+			const auto level_height = texture_level_extent(h, i);
+
+			if (is_block_compressed(format))
+			{
+				levels.push_back(compress_level(format, level, level_width, level_height, options.jobs));
+			}
+			else
+			{
+				levels.emplace_back(level, level + chain.levels[i].size);
+			}
+
+			stats.source_bytes += chain.levels[i].size;
+		}
+
+		stats.compress_ms = elapsed_ms(start);
+
+		auto header = texture_file_header();
+		header.format = format;
+		header.width = w;
+		header.height = h;
+		header.level_count = static_cast<uint32_t>(levels.size());
+		header.level_index_offset = sizeof(texture_file_header);
+
+		auto index = std::vector<texture_level>();
+		auto offset = align_texture_offset(header.level_index_offset + levels.size() * sizeof(texture_level));
+
+		for (const auto& level : levels)
+		{
+			index.push_back({ offset, level.size() });
+			offset = align_texture_offset(offset + level.size());
+		}
+
+		auto file = std::ofstream(destination, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			std::cerr << "[cooker] could not open " << destination << " for writing\n";
+			return false;
+		}
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(texture_level)));
+
+		for (size_t i = 0; i < levels.size(); i++)
+		{
+			write_padding(file, index[i].offset);
+			file.write(reinterpret_cast<const char*>(levels[i].data()), static_cast<std::streamsize>(levels[i].size()));
+		}
+
+		if (!file)
+		{
+			std::cerr << "[cooker] failed writing " << destination << '\n';
+			return false;
+		}
+
+		stats.width = w;
+		stats.height = h;
+		stats.level_count = header.level_count;
+		stats.file_size = index.back().offset + index.back().size;
+		return true;
+	}
+}
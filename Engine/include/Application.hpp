@@ -5,8 +5,12 @@
 #include <vector>
 
 // Interface
+#include "FrameClock.hpp"
+#include "FrameScheduler.hpp"
+#include "IPC/ipc_channel.hpp"
 #include "LayerStack.hpp"
 #include "Module/Module.hpp"
+#include "Profile/profiler.hpp"
 #include "Utility/Export.hpp"
 
 // --
@@ -22,9 +26,21 @@ namespace Mythos
 		
 		void run();
 		void shutdown();
+
+	protected:
+		// derived applications can adjust these before run() is called
+		clock_settings clock_settings_;
+		profile_capture profile_capture_;
+
 	private:
 		bool is_running_;
 
+		frame_clock clock_;
+		frame_scheduler scheduler_;
+
+		// the log mirrored for tools outside the process, see IPC::mirror_log
+		IPC::ipc_channel log_channel_;
+
 	};
 
 	std::vector<std::unique_ptr<Module, std::default_delete<Module>>> modules_;
@@ -0,0 +1,70 @@
+#pragma once
+
+// STL
+#include <chrono>
+#include <cstdint>
+
+// --
+namespace Mythos
+{
+	// --
+
+	struct clock_settings
+	{
+		// seconds simulated by each update
+		double fixed_step = 1.0 / 60.0;
+
+		// longer frames are clamped so a stall cannot queue up an unbounded number of updates
+		double max_frame_time = 0.25;
+
+		// frames per second the limiter holds the loop to, zero disables the limiter
+		double frame_rate_limit = 144.0;
+
+		// the limiter yields for the last part of the wait to absorb timer wake up jitter
+		double spin_threshold = 0.0005;
+	};
+
+	// drives the fixed timestep loop and paces the frames
+	class frame_clock
+	{
+	public:
+		frame_clock();
+		~frame_clock();
+
+		frame_clock(const frame_clock&) = delete;
+		frame_clock& operator=(const frame_clock&) = delete;
+
+		void configure(const clock_settings& settings);
+
+		// starts a frame and returns how many fixed updates it owes the simulation
+		uint32_t begin_frame();
+
+		// waits out the rest of the frame budget
+		void end_frame();
+
+		// seconds per update
+		float step() const;
+
+		// how far the render time sits between the last two updates, 0 to 1
+		float alpha() const;
+
+	private:
+		using clock = std::chrono::steady_clock;
+
+		void wait_until(clock::time_point deadline) const;
+
+		// the clock is built with the application, before the logger exists, so problems are reported on the first frame
+		void report_settings() const;
+
+		clock_settings settings_;
+
+		clock::time_point frame_begin_;
+		clock::time_point last_frame_;
+		double accumulator_ = 0.0;
+		bool started_ = false;
+		bool clamped_ = false;
+
+		// high resolution waitable timer, null when the OS does not provide one
+		void* timer_ = nullptr;
+	};
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+// STL
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Interface
+#include "Job/job_system.hpp"
+#include "Module/Module.hpp"
+
+// --
+namespace Mythos
+{
+	// --
+
+	struct frame_stats
+	{
+		double update_ms = 0.0;        // wall time of the update phase
+		double render_ms = 0.0;        // wall time of the render phase
+		double serial_ms = 0.0;        // sum of every layer update, what the serial loop would have cost
+		double critical_path_ms = 0.0; // longest dependency chain through the update graph
+	};
+
+	// runs layer updates as a dependency graph built from the module read / write declarations
+	// then renders every layer in priority order once all updates have finished
+	class frame_scheduler
+	{
+	public:
+		// modules must be sorted by priority, jobs may be null to run everything on the calling thread
+		void build(const std::vector<std::unique_ptr<Module>>& modules, job_system* jobs);
+
+		void update(float dt);
+		void render(float alpha);
+
+		const frame_stats& stats() const;
+
+	private:
+		using clock = std::chrono::steady_clock;
+
+		struct node
+		{
+			layer* target = nullptr;
+			bool main_thread = false;
+			std::string name;           // the module's, for profile zones
+
+			std::vector<int> reads;
+			std::vector<int> writes;
+
+			std::vector<uint32_t> predecessors;
+			std::vector<uint32_t> successors;
+			std::atomic<uint32_t> remaining = 0;
+
+			clock::time_point begin;
+			clock::time_point end;
+		};
+
+		static bool conflicts(const node& a, const node& b);
+
+		void submit(uint32_t index);
+		void execute(uint32_t index);
+		void measure(clock::time_point begin, clock::time_point end);
+
+		std::vector<std::unique_ptr<node>> nodes_;
+		std::vector<uint32_t> roots_;
+
+		job_system* jobs_ = nullptr;
+		float dt_ = 0.0f;
+		job_counter counter_;
+
+		std::atomic<uint32_t> completed_ = 0;
+
+		std::mutex main_mutex_;
+		std::vector<uint32_t> main_ready_;
+
+		frame_stats stats_;
+	};
+}
@@ -2,11 +2,13 @@
 
 // STL
 #include <iostream>
+#include <string>
 
 // Utility
 #include "Utility/ModuleUtility.hpp"
 
 #include "Debug.hpp"
+#include "IPC/ipc_log.hpp"
 
 // --
 Mythos::application::application()
@@ -14,6 +16,21 @@ Mythos::application::application()
 	// set the default log behaviour
 	Debug::SetDefaultBehaviour();
 
+	// and mirror it into a channel a log viewer can open with the process' id
+	if (log_channel_.create(IPC::log_channel_name(IPC::current_process_id()), IPC::ipc_mode::spsc, IPC::LOG_CHANNEL_SIZE))
+	{
+		Debug::SetBehaviour([this](const log_entry& entry)
+		{
+			logger::write_default(entry);
+			IPC::mirror_log(log_channel_, entry);
+		});
+	}
+
+#if MYTHOS_PROFILE
+	// before the modules load, their layers record into it from the first frame
+	profiler::create();
+#endif
+
 
 	// try populate the modules
 	if(!Utility::TryLoadModules(modules_))
@@ -35,6 +52,15 @@ Mythos::application::application()
 		return;
 	}
 
+	// let the layers find the interfaces of the other modules
+	for (const auto& layer : layers_)
+	{
+		layer->attach(modules_);
+	}
+
+	// build the update graph, runs serially if no job module was loaded
+	scheduler_.build(modules_, find_interface<job_system>(modules_, JOB));
+
 	// enable run loop 
 	is_running_ = true;
 }
@@ -43,6 +69,9 @@ Mythos::application::~application()
 {
 	Debug::log("Application Destroyed");
 
+	// the writer stops reaching the channel before it closes
+	Debug::SetBehaviour([](const log_entry& entry) { logger::write_default(entry); });
+
 	// destroy layers lowest priority first
 	for(auto i = layers_.size(); !layers_.empty(); --i)
 	{
@@ -52,13 +81,47 @@ Mythos::application::~application()
 
 void Mythos::application::run()
 {
+	auto frame = uint64_t();
+
+	clock_.configure(clock_settings_);
+
+#if MYTHOS_PROFILE
+	PROFILE_THREAD("main");
+
+	if (profile_capture_.frames > 0)
+	{
+		profiler::create()->capture(profile_capture_.frames, profile_capture_.path);
+	}
+#endif
+
 	while (is_running_)
 	{
-		for (auto& layer : layers_)
+		// simulation advances in fixed steps, however long the last frame took
+		const auto steps = clock_.begin_frame();
+		for (uint32_t i = 0; i < steps; i++)
+		{
+			scheduler_.update(clock_.step());
+		}
+
+		// every update finishes before any layer starts submitting its render work
+		scheduler_.render(clock_.alpha());
+
+		// sleep out the rest of the frame budget instead of spinning
+		{
+			PROFILE_ZONE("frame budget");
+			clock_.end_frame();
+		}
+
+		PROFILE_FRAME();
+
+#ifdef  _DEBUG
+		if (++frame % 1000 == 0)
 		{
-			layer->update();
-			layer->render();
+			const auto& stats = scheduler_.stats();
+			Debug::log("Frame {} : update {}ms, critical path {}ms, serial {}ms, render {}ms",
+				frame, stats.update_ms, stats.critical_path_ms, stats.serial_ms, stats.render_ms);
 		}
+#endif
 	}
 }
 
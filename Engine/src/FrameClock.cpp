@@ -0,0 +1,130 @@
+#include "FrameClock.hpp"
+
+// Microsoft
+#include <Windows.h>
+
+// STL
+#include <algorithm>
+#include <thread>
+
+#include "Debug.hpp"
+
+// older SDKs do not declare the flag even though the OS supports it (Windows 10 1803+)
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+// --
+namespace Mythos
+{
+	frame_clock::frame_clock()
+	{
+		timer_ = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	}
+
+	frame_clock::~frame_clock()
+	{
+		if (timer_ != nullptr)
+		{
+			CloseHandle(timer_);
+		}
+	}
+
+	void frame_clock::configure(const clock_settings& settings)
+	{
+		settings_ = settings;
+		settings_.fixed_step = std::max(settings_.fixed_step, 0.0001);
+		settings_.max_frame_time = std::max(settings_.max_frame_time, settings_.fixed_step);
+
+		clamped_ = settings_.fixed_step != settings.fixed_step || settings_.max_frame_time != settings.max_frame_time;
+	}
+
+	uint32_t frame_clock::begin_frame()
+	{
+		frame_begin_ = clock::now();
+
+		if (!started_)
+		{
+			started_ = true;
+			last_frame_ = frame_begin_;
+			report_settings();
+		}
+
+		auto elapsed = std::chrono::duration<double>(frame_begin_ - last_frame_).count();
+		last_frame_ = frame_begin_;
+
+		accumulator_ += std::min(elapsed, settings_.max_frame_time);
+
+		auto steps = uint32_t();
+		while (accumulator_ >= settings_.fixed_step)
+		{
+			accumulator_ -= settings_.fixed_step;
+			steps++;
+		}
+
+		return steps;
+	}
+
+	void frame_clock::end_frame()
+	{
+		if (settings_.frame_rate_limit <= 0.0) return;
+
+		const auto budget = std::chrono::duration<double>(1.0 / settings_.frame_rate_limit);
+		wait_until(frame_begin_ + std::chrono::duration_cast<clock::duration>(budget));
+	}
+
+	float frame_clock::step() const
+	{
+		return static_cast<float>(settings_.fixed_step);
+	}
+
+	float frame_clock::alpha() const
+	{
+		return static_cast<float>(accumulator_ / settings_.fixed_step);
+	}
+
+	void frame_clock::report_settings() const
+	{
+		if (timer_ == nullptr)
+		{
+			Debug::warn("Frame clock : high resolution timer unavailable, falling back to sleep");
+		}
+
+		if (clamped_)
+		{
+			Debug::warn("Frame clock : settings clamped to a fixed step of {}s and a max frame time of {}s",
+				settings_.fixed_step, settings_.max_frame_time);
+		}
+	}
+
+	void frame_clock::wait_until(clock::time_point deadline) const
+	{
+		const auto spin = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(settings_.spin_threshold));
+		const auto remaining = deadline - clock::now() - spin;
+
+		if (remaining > clock::duration::zero())
+		{
+			if (timer_ != nullptr)
+			{
+				// relative due time in 100ns units
+				auto due = LARGE_INTEGER();
+				due.QuadPart = -std::max<LONGLONG>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count() / 100);
+
+				if (SetWaitableTimerEx(timer_, &due, 0, nullptr, nullptr, nullptr, 0))
+				{
+					WaitForSingleObject(timer_, INFINITE);
+				}
+			}
+			else
+			{
+				std::this_thread::sleep_for(remaining);
+			}
+		}
+
+		// the timer wakes slightly early or late, give the remainder back to the scheduler
+		while (clock::now() < deadline)
+		{
+			std::this_thread::yield();
+		}
+	}
+}
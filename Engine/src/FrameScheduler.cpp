@@ -0,0 +1,225 @@
+#include "FrameScheduler.hpp"
+
+// STL
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "Debug.hpp"
+#include "Profile/profiler.hpp"
+
+// --
+namespace Mythos
+{
+	static bool contains(const std::vector<int>& list, int value)
+	{
+		return std::ranges::find(list, value) != list.end();
+	}
+
+	static bool intersects(const std::vector<int>& a, const std::vector<int>& b)
+	{
+		return std::ranges::any_of(a, [&b](int value) { return contains(b, value); });
+	}
+
+	static double to_ms(std::chrono::steady_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	void frame_scheduler::build(const std::vector<std::unique_ptr<Module>>& modules, job_system* jobs)
+	{
+		nodes_.clear();
+		roots_.clear();
+		jobs_ = jobs;
+
+		for (const auto& module : modules)
+		{
+			if (module->layer_ptr == nullptr) continue;
+
+			auto item = std::make_unique<node>();
+			item->target = module->layer_ptr;
+			item->main_thread = module->main_thread;
+			item->name = module->name;
+			item->reads = module->reads;
+			item->writes = module->writes;
+
+			// a layer always owns its own state
+			if (!contains(item->writes, module->priority))
+			{
+				item->writes.push_back(module->priority);
+			}
+
+			nodes_.push_back(std::move(item));
+		}
+
+		// priority order breaks ties, so an edge only ever points from a lower to a higher priority
+		for (uint32_t j = 0; j < nodes_.size(); j++)
+		{
+			for (uint32_t i = 0; i < j; i++)
+			{
+				if (!conflicts(*nodes_[i], *nodes_[j])) continue;
+
+				nodes_[i]->successors.push_back(j);
+				nodes_[j]->predecessors.push_back(i);
+			}
+
+			if (nodes_[j]->predecessors.empty())
+			{
+				roots_.push_back(j);
+			}
+		}
+
+		Debug::log("Frame scheduler built : " + std::to_string(nodes_.size()) + " layers, " +
+			std::to_string(roots_.size()) + " without dependencies");
+	}
+
+	void frame_scheduler::update(float dt)
+	{
+		PROFILE_ZONE("update");
+
+		const auto begin = clock::now();
+		dt_ = dt;
+
+		// no job system, keep the old serial behaviour
+		if (jobs_ == nullptr)
+		{
+			for (uint32_t i = 0; i < nodes_.size(); i++)
+			{
+				execute(i);
+			}
+
+			measure(begin, clock::now());
+			return;
+		}
+
+		completed_ = 0;
+		for (const auto& item : nodes_)
+		{
+			item->remaining = static_cast<uint32_t>(item->predecessors.size());
+		}
+
+		for (const auto root : roots_)
+		{
+			submit(root);
+		}
+
+		// the main thread runs its own layers and helps with the rest while it waits
+		const auto count = static_cast<uint32_t>(nodes_.size());
+		while (completed_.load(std::memory_order_acquire) < count)
+		{
+			auto index = std::optional<uint32_t>();
+			{
+				std::lock_guard lock(main_mutex_);
+				if (!main_ready_.empty())
+				{
+					index = main_ready_.back();
+					main_ready_.pop_back();
+				}
+			}
+
+			if (index)
+			{
+				execute(*index);
+			}
+			else if (!jobs_->run_pending())
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		// every node is done, make sure no job is still unwinding
+		jobs_->wait(counter_);
+
+		measure(begin, clock::now());
+	}
+
+	void frame_scheduler::render(float alpha)
+	{
+		PROFILE_ZONE("render");
+
+		const auto begin = clock::now();
+
+		for (const auto& item : nodes_)
+		{
+			PROFILE_ZONE(item->name.c_str());
+			item->target->render(alpha);
+		}
+
+		stats_.render_ms = to_ms(clock::now() - begin);
+	}
+
+	const frame_stats& frame_scheduler::stats() const
+	{
+		return stats_;
+	}
+
+	bool frame_scheduler::conflicts(const node& a, const node& b)
+	{
+		return intersects(a.writes, b.writes) || intersects(a.writes, b.reads) || intersects(b.writes, a.reads);
+	}
+
+	void frame_scheduler::submit(uint32_t index)
+	{
+		if (nodes_[index]->main_thread)
+		{
+			std::lock_guard lock(main_mutex_);
+			main_ready_.push_back(index);
+			return;
+		}
+
+		jobs_->run([this, index]() { execute(index); }, &counter_);
+	}
+
+	void frame_scheduler::execute(uint32_t index)
+	{
+		auto& item = *nodes_[index];
+
+		item.begin = clock::now();
+		{
+			PROFILE_ZONE(item.name.c_str());
+			item.target->update(dt_);
+		}
+		item.end = clock::now();
+
+		if (jobs_ != nullptr)
+		{
+			for (const auto successor : item.successors)
+			{
+				if (nodes_[successor]->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				{
+					submit(successor);
+				}
+			}
+		}
+
+		completed_.fetch_add(1, std::memory_order_release);
+	}
+
+	void frame_scheduler::measure(clock::time_point begin, clock::time_point end)
+	{
+		// nodes are already in topological order, so one forward pass finds the longest chain
+		auto path = std::vector<double>(nodes_.size(), 0.0);
+
+		stats_.serial_ms = 0.0;
+		stats_.critical_path_ms = 0.0;
+
+		for (uint32_t i = 0; i < nodes_.size(); i++)
+		{
+			const auto duration = to_ms(nodes_[i]->end - nodes_[i]->begin);
+
+			auto longest = 0.0;
+			for (const auto predecessor : nodes_[i]->predecessors)
+			{
+				longest = std::max(longest, path[predecessor]);
+			}
+
+			path[i] = longest + duration;
+
+			stats_.serial_ms += duration;
+			stats_.critical_path_ms = std::max(stats_.critical_path_ms, path[i]);
+		}
+
+		stats_.update_ms = to_ms(end - begin);
+	}
+}
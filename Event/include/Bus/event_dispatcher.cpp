@@ -0,0 +1,82 @@
+#include "Bus/event_dispatcher.hpp"
+
+// STL
+#include <string>
+
+#include "Debug.hpp"
+
+// --
+namespace Mythos::Bus
+{
+	// --
+
+	void event_dispatcher::dispatch()
+	{
+		const auto count = channel_count_.load(std::memory_order_relaxed);
+
+		dispatched_ = 0;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			dispatched_ += channels_[i]->dispatch();
+		}
+	}
+
+	void event_dispatcher::unsubscribe(event_subscription subscription)
+	{
+		if (subscription.id == 0) return;
+
+		const auto count = channel_count_.load(std::memory_order_relaxed);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (channels_[i]->unsubscribe(subscription.id)) return;
+		}
+	}
+
+	event_stats event_dispatcher::stats() const
+	{
+		auto stats = event_stats{ .dispatched = dispatched_ };
+		stats.channels = channel_count_.load(std::memory_order_relaxed);
+
+		for (uint32_t i = 0; i < stats.channels; i++)
+		{
+			stats.subscribers += channels_[i]->subscriber_count();
+			stats.published += channels_[i]->published();
+			stats.dropped += channels_[i]->dropped();
+		}
+
+		return stats;
+	}
+
+	event_channel_base* event_dispatcher::find(std::type_index type) const
+	{
+		// only slots below the count are read, each was written before the count was raised past it
+		const auto count = channel_count_.load(std::memory_order_acquire);
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (channels_[i]->type() == type) return channels_[i].get();
+		}
+
+		return nullptr;
+	}
+
+	event_channel_base* event_dispatcher::add(std::unique_ptr<event_channel_base> channel)
+	{
+		const auto count = channel_count_.load(std::memory_order_relaxed);
+		if (count == MAX_CHANNELS)
+		{
+			Debug::error("Event dispatcher : no room for a channel past " + std::to_string(MAX_CHANNELS));
+			return nullptr;
+		}
+
+		channels_[count] = std::move(channel);
+		channel_count_.store(count + 1, std::memory_order_release);
+
+		return channels_[count].get();
+	}
+
+	uint32_t event_dispatcher::next_subscription()
+	{
+		return next_id_++;
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+// STL
+#include <array>
+#include <atomic>
+#include <memory>
+
+// Interface
+#include "Event/event_bus.hpp"
+
+// --
+namespace Mythos::Bus
+{
+	// --
+
+	// the channels sit in a fixed array published through an atomic count, so a producer looking its channel up
+	// never races the main thread adding another
+	class event_dispatcher final : public event_bus
+	{
+	public:
+		static constexpr uint32_t MAX_CHANNELS = 64;
+
+		event_dispatcher() = default;
+		~event_dispatcher() override = default;
+
+		event_dispatcher(const event_dispatcher&) = delete;
+		event_dispatcher& operator=(const event_dispatcher&) = delete;
+
+		void dispatch() override;
+		void unsubscribe(event_subscription subscription) override;
+		event_stats stats() const override;
+
+	protected:
+		event_channel_base* find(std::type_index type) const override;
+		event_channel_base* add(std::unique_ptr<event_channel_base> channel) override;
+		uint32_t next_subscription() override;
+
+	private:
+		std::array<std::unique_ptr<event_channel_base>, MAX_CHANNELS> channels_;
+		std::atomic<uint32_t> channel_count_ = 0;
+
+		uint32_t next_id_ = 1;
+		uint64_t dispatched_ = 0;
+	};
+}
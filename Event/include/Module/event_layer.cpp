@@ -1,5 +1,8 @@
 #include "event_layer.hpp"
 
+// STL
+#include <string>
+
 #include "Debug.hpp"
 
 // --
@@ -10,6 +13,8 @@ namespace Mythos
 	event_layer::event_layer()
 	{
 		Debug::log_header("Event Layer : Creating the event layer");
+
+		dispatcher_ = std::make_unique<Bus::event_dispatcher>();
 	}
 
 	event_layer::~event_layer()
@@ -17,14 +22,30 @@ namespace Mythos
 		Debug::log_header("Event Layer : Destroying the event layer");
 	}
 
-	void event_layer::update()
+	void event_layer::update(float dt)
 	{
-
+		// updates run in parallel, subscribers would race the layers they belong to
 	}
 
-	void event_layer::render()
+	void event_layer::render(float alpha)
 	{
+		// render runs every layer in priority order on the main thread once the updates are done, this one first,
+		// so the frame's events reach every subscriber before its layer renders and before the next updates
+		dispatcher_->dispatch();
+
+#ifdef  _DEBUG
+		if (++frame_count_ % 1000 == 0)
+		{
+			const auto stats = dispatcher_->stats();
+			Debug::log("Events : {} dispatched this frame, {} published and {} dropped over {} channels to {} subscribers",
+				stats.dispatched, stats.published, stats.dropped, stats.channels, stats.subscribers);
+		}
+#endif
+	}
 
+	event_bus& event_layer::events()
+	{
+		return *dispatcher_;
 	}
 
-}
\ No newline at end of file
+}
@@ -1,8 +1,14 @@
 #pragma once
 
+// STL
+#include <memory>
+
 // Interface
 #include "Module/layer.hpp"
 
+// Bus
+#include "Bus/event_dispatcher.hpp"
+
 // --
 namespace Mythos
 {
@@ -13,10 +19,14 @@ namespace Mythos
 	public:
 		event_layer();
 		~event_layer() override;
-		void update() override;
-		void render() override;
+		void update(float dt) override;
+		void render(float alpha) override;
+
+		event_bus& events();
 
 	private:
+		std::unique_ptr<Bus::event_dispatcher> dispatcher_;
 
+		uint64_t frame_count_ = 0;
 	};
 }
@@ -23,7 +23,7 @@ MODULE_API std::unique_ptr<const Mythos::Module> func(MODULE_HANDLE handle)
 
 		.name = "Default Event Module",
 		.version = "Version 0.0.0.1",
-		.description = "Default event layer",
+		.description = "Lock free event bus exposed as a Mythos::event_bus",
 
 		.dll_path = FILE_PATH,
 		.dll_name = FILE_NAME,
@@ -35,6 +35,11 @@ MODULE_API std::unique_ptr<const Mythos::Module> func(MODULE_HANDLE handle)
 			return std::make_unique<Mythos::event_layer>();
 		},
 
+		.GetInterface = [](Mythos::layer& layer) -> void*
+		{
+			return &static_cast<Mythos::event_layer&>(layer).events();
+		},
+
 	};
 
 	return std::make_unique<const Mythos::Module>(module);
@@ -1,118 +1,99 @@
 #pragma once
 
 // STL
+#include <stdexcept>
 #include <string>
 #include <source_location>
+#include <type_traits>
 
 // Interface
-#include "IPC/shared_func.hpp"
-#include "Utility/Constants.hpp"
+#include "Log/logger.hpp"
 
 // --
 namespace Mythos::Debug
 {
 	// --
 
-	static void SetBehaviour(const std::string& key, std::function<void(const std::string&, const std::source_location&)> callback)
-	{
-#ifdef  _DEBUG
-		auto logger = IPC::shared_func<void(const std::string&, const std::source_location&)>(key);
-		logger.set_function(callback);
-#endif
-	}
+	// messages take a string literal with a {} per argument, the arguments are formatted on the logger's thread
+	// a std::string message is copied as it is, the cheaper literal form is for anything logged every frame
+	// levels below MYTHOS_LOG_LEVEL compile to nothing, though arguments built at the call site are still evaluated
 
-	static void SetDefaultBehaviour()
+	template <typename... Args>
+	static void submit(log_level level, uint8_t flags, const log_format<Args...>& format, const Args&... args)
 	{
-#ifdef  _DEBUG
-		SetBehaviour(DEBUG_LOG_KEY, [](const std::string& msg, const std::source_location& source)
-		{
-			std::cout << "[log] " << msg << '\n';
-		});
-
-		SetBehaviour(DEBUG_WARN_KEY, [](const std::string& msg, const std::source_location& source)
+		if (auto* logger = logger::find())
 		{
-			std::cout << "[warn] " << msg << '\n';
-		});
-
-		SetBehaviour(DEBUG_ERROR_KEY, [](const std::string& msg, const std::source_location& source)
-		{
-			std::cout << "[error] " << msg << '\n';
-		});
+			logger->write(level, flags, format, args...);
+		}
+	}
 
-		SetBehaviour(DEBUG_ASSERT_KEY, [](const std::string& msg, const std::source_location& source)
-		{
-			std::cout << "[assert] " << msg << '\n';
-		});
+	// the writer runs on the logger's thread, one record at a time, and must not log itself
+	static void SetBehaviour(log_writer writer)
+	{
+		logger::create()->set_writer(std::move(writer));
+	}
 
-		SetBehaviour(DEBUG_EXCEPTION_KEY, [](const std::string& msg, const std::source_location& source)
-		{
-			std::cout << "[exception] " << msg << '\n';
-			throw std::runtime_error(msg);
-		});
+	static void SetDefaultBehaviour()
+	{
+		SetBehaviour([](const log_entry& entry) { logger::write_default(entry); });
 
-		std::cout << "[debug] Default log behaviour has been set. \n \n";
-#endif
+		submit(log_level::log, LOG_PLAIN, log_format<>("[debug] Default log behaviour has been set. \n"));
 	}
 
-	static void call(const std::string& key, const std::string& msg, std::source_location source = std::source_location::current())
+	// waits for everything logged so far to be written, before unloading a module whose literals are still queued
+	static void flush()
 	{
-#ifdef  _DEBUG
-		const auto debug = IPC::shared_func<void(const std::string&, const std::source_location&)>(key);
-		debug.invoke(msg, source);
-#endif
+		if (auto* logger = logger::find())
+		{
+			logger->flush();
+		}
 	}
 
-	static void log(const std::string& msg, std::source_location source = std::source_location::current())
+	template <typename... Args>
+	static void log(log_format<std::type_identity_t<Args>...> format, const Args&... args)
 	{
-#ifdef  _DEBUG
-		call(DEBUG_LOG_KEY, msg, source);
-#endif
+		if constexpr (log_enabled(log_level::log)) submit(log_level::log, LOG_DEFAULT, format, args...);
 	}
 
-	static void log_header(const std::string& msg, std::source_location source = std::source_location::current())
+	template <typename... Args>
+	static void log_header(log_format<std::type_identity_t<Args>...> format, const Args&... args)
 	{
-#ifdef  _DEBUG
-		std::cout << '\n';
-		call(DEBUG_LOG_KEY, msg, source);
-		std::cout << '\n';
-#endif
+		if constexpr (log_enabled(log_level::log)) submit(log_level::log, LOG_HEADER, format, args...);
 	}
 
-	static void warn(const std::string& msg, std::source_location source = std::source_location::current())
+	template <typename... Args>
+	static void warn(log_format<std::type_identity_t<Args>...> format, const Args&... args)
 	{
-#ifdef  _DEBUG
-		call(DEBUG_WARN_KEY, msg, source);
-#endif
+		if constexpr (log_enabled(log_level::warn)) submit(log_level::warn, LOG_DEFAULT, format, args...);
 	}
 
-	static void error(const std::string& msg, std::source_location source = std::source_location::current())
+	template <typename... Args>
+	static void error(log_format<std::type_identity_t<Args>...> format, const Args&... args)
 	{
-#ifdef  _DEBUG
-		call(DEBUG_ERROR_KEY, msg, source);
-#endif
+		if constexpr (log_enabled(log_level::error)) submit(log_level::error, LOG_DEFAULT, format, args...);
 	}
 
-	/*static void assert(const std::string& msg, std::source_location source = std::source_location::current())
+	// written out before it throws, the exception carries the same message
+	template <typename... Args>
+	static void exception(log_format<std::type_identity_t<Args>...> format, const Args&... args)
 	{
-#ifdef  _DEBUG
-		call(DEBUG_ASSERT_KEY, msg, source);
-#endif
-	}*/
+		if constexpr (log_enabled(log_level::exception))
+		{
+			submit(log_level::exception, LOG_DEFAULT, format, args...);
+			flush();
+		}
 
-	static void exception(const std::string& msg, std::source_location source = std::source_location::current())
-	{
-#ifdef  _DEBUG
-		call(DEBUG_EXCEPTION_KEY, msg, source);
-#endif
+		throw std::runtime_error(logger::format_now(format, args...));
 	}
 
 	static void new_line(const int count = 1)
 	{
-#ifdef  _DEBUG
-		for(int i = 0; i < count; i++ )
+		if constexpr (log_enabled(log_level::log))
 		{
-			std::cout << '\n';
+			for (int i = 0; i < count; i++)
+			{
+				submit(log_level::log, LOG_PLAIN, log_format<>(""));
+			}
 		}
-#endif		
 	}
 }
@@ -0,0 +1,327 @@
+#pragma once
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+// Interface
+#include "Event/event_ring.hpp"
+
+// --
+namespace Mythos
+{
+	// --
+
+	// who publishes an event type, one thread gets the cheaper single producer ring
+	enum class event_producers : uint8_t
+	{
+		single,
+		multiple,
+	};
+
+	struct event_subscription
+	{
+		uint32_t id = 0;
+	};
+
+	struct event_stats
+	{
+		uint32_t channels = 0;
+		uint32_t subscribers = 0;
+		uint64_t published = 0;     // since the bus was created
+		uint64_t dropped = 0;       // refused by a full ring
+		uint64_t dispatched = 0;    // events delivered by the last dispatch
+	};
+
+	// --
+
+	// one event type's rings and subscribers, the rings are written from any thread and everything else belongs to
+	// the thread that dispatches
+	class event_channel_base
+	{
+	public:
+		explicit event_channel_base(std::type_index type) : type_(type) {}
+		virtual ~event_channel_base() = default;
+
+		event_channel_base(const event_channel_base&) = delete;
+		event_channel_base& operator=(const event_channel_base&) = delete;
+
+		// delivers last frame's deferred events then the immediate ones, returns how many
+		virtual uint32_t dispatch() = 0;
+
+		virtual bool unsubscribe(uint32_t id) = 0;
+		virtual uint32_t subscriber_count() const = 0;
+
+		std::type_index type() const
+		{
+			return type_;
+		}
+
+		uint64_t published() const
+		{
+			return published_.load(std::memory_order_relaxed);
+		}
+
+		uint64_t dropped() const
+		{
+			return dropped_.load(std::memory_order_relaxed);
+		}
+
+	protected:
+		void count(bool pushed)
+		{
+			(pushed ? published_ : dropped_).fetch_add(1, std::memory_order_relaxed);
+		}
+
+	private:
+		const std::type_index type_;
+
+		std::atomic<uint64_t> published_ = 0;
+		std::atomic<uint64_t> dropped_ = 0;
+	};
+
+	// --
+
+	template <typename T>
+	class event_channel final : public event_channel_base
+	{
+	public:
+		using callback = std::function<void(const T&)>;
+
+		event_channel(uint32_t capacity, event_producers producers)
+			: event_channel_base(typeid(T))
+		{
+			for (auto& queue : queues_)
+			{
+				queue = producers == event_producers::single ? ring{ std::make_unique<spsc_ring<T>>(capacity), nullptr } :
+					ring{ nullptr, std::make_unique<mpsc_ring<T>>(capacity) };
+			}
+		}
+
+		// any thread with multiple producers, the one producer thread otherwise
+		bool push(const T& event, bool deferred)
+		{
+			auto& queue = queues_[deferred ? DEFERRED : IMMEDIATE];
+			const auto pushed = queue.single ? queue.single->push(event) : queue.multiple->push(event);
+
+			count(pushed);
+			return pushed;
+		}
+
+		// a subscriber added by a callback hears from the next dispatch on
+		void subscribe(uint32_t id, callback function)
+		{
+			(dispatching_ ? added_ : subscribers_).push_back({ id, std::move(function) });
+		}
+
+		// a callback may remove itself or others, they are only marked until the dispatch ends
+		bool unsubscribe(uint32_t id) override
+		{
+			for (auto* list : { &subscribers_, &added_ })
+			{
+				const auto found = std::find_if(list->begin(), list->end(), [id](const subscriber& entry)
+				{
+					return entry.id == id && !entry.removed;
+				});
+
+				if (found == list->end()) continue;
+
+				if (dispatching_) found->removed = true;
+				else list->erase(found);
+				return true;
+			}
+
+			return false;
+		}
+
+		uint32_t subscriber_count() const override
+		{
+			return static_cast<uint32_t>(subscribers_.size() + added_.size());
+		}
+
+		// dispatching thread, calls the subscribers in place, a trigger from inside a subscriber nests in its delivery
+		uint32_t trigger(const T& event)
+		{
+			count(true);
+
+			const auto nested = dispatching_;
+			dispatching_ = true;
+			deliver(event);
+			dispatching_ = nested;
+
+			if (!nested) settle();
+			return static_cast<uint32_t>(subscribers_.size());
+		}
+
+		uint32_t dispatch() override
+		{
+			// taken before any delivery, events published by subscribers wait for the next dispatch
+			batch_.clear();
+			drain(queues_[IMMEDIATE], batch_);
+
+			dispatching_ = true;
+
+			for (const auto& event : held_)
+			{
+				deliver(event);
+			}
+
+			for (const auto& event : batch_)
+			{
+				deliver(event);
+			}
+
+			dispatching_ = false;
+			settle();
+
+			const auto count = static_cast<uint32_t>(held_.size() + batch_.size());
+
+			// deferred events sit out one dispatch
+			held_.clear();
+			drain(queues_[DEFERRED], held_);
+
+			return count;
+		}
+
+	private:
+		struct ring
+		{
+			std::unique_ptr<spsc_ring<T>> single;
+			std::unique_ptr<mpsc_ring<T>> multiple;
+		};
+
+		struct subscriber
+		{
+			uint32_t id = 0;
+			callback function;
+			bool removed = false;
+		};
+
+		static constexpr size_t IMMEDIATE = 0;
+		static constexpr size_t DEFERRED = 1;
+
+		// at most one ring's worth, a producer that keeps up with the consumer cannot hold the dispatch
+		static void drain(ring& queue, std::vector<T>& events)
+		{
+			const auto capacity = queue.single ? queue.single->capacity() : queue.multiple->capacity();
+			auto event = T();
+
+			for (uint32_t i = 0; i < capacity; i++)
+			{
+				const auto popped = queue.single ? queue.single->pop(event) : queue.multiple->pop(event);
+				if (!popped) break;
+
+				events.push_back(event);
+			}
+		}
+
+		// applies what callbacks changed about the subscribers while events were delivered
+		void settle()
+		{
+			std::erase_if(subscribers_, [](const subscriber& entry) { return entry.removed; });
+			std::erase_if(added_, [](const subscriber& entry) { return entry.removed; });
+			std::move(added_.begin(), added_.end(), std::back_inserter(subscribers_));
+			added_.clear();
+		}
+
+		void deliver(const T& event)
+		{
+			for (const auto& entry : subscribers_)
+			{
+				if (!entry.removed) entry.function(event);
+			}
+		}
+
+		ring queues_[2];
+
+		std::vector<subscriber> subscribers_;
+		std::vector<subscriber> added_;
+		bool dispatching_ = false;
+
+		// kept between dispatches so they stop allocating once the frame's event count settles
+		std::vector<T> batch_;
+		std::vector<T> held_;
+	};
+
+	// --
+
+	// exposed by the event module, see Module::GetInterface
+	// publish never blocks, a full ring drops the event and counts it, so input hooks and job workers can post freely
+	// dispatch runs on the main thread once a frame and calls every subscriber there, subscribers and channels are only
+	// added or removed on that thread
+	// nothing published is delivered before the next dispatch, trigger is the synchronous path for the main thread
+	class event_bus
+	{
+	public:
+		virtual ~event_bus() = default;
+
+		// delivers every channel's events, in the order the channels were added
+		virtual void dispatch() = 0;
+
+		virtual void unsubscribe(event_subscription subscription) = 0;
+
+		virtual event_stats stats() const = 0;
+
+		// main thread, before the type's first publish, capacity is per queue and rounded up to a power of two
+		template <typename T>
+		bool add_channel(uint32_t capacity, event_producers producers = event_producers::multiple)
+		{
+			if (find(typeid(T)) != nullptr) return true;
+			return add(std::make_unique<event_channel<T>>(capacity, producers)) != nullptr;
+		}
+
+		// queued for the next dispatch, not delivered in place, false when the type has no channel or its ring is full
+		template <typename T>
+		bool publish(const T& event)
+		{
+			auto* channel = static_cast<event_channel<T>*>(find(typeid(T)));
+			return channel != nullptr && channel->push(event, false);
+		}
+
+		// delivered by the dispatch after the next, for events that should see the rest of the frame's state settle
+		template <typename T>
+		bool defer(const T& event)
+		{
+			auto* channel = static_cast<event_channel<T>*>(find(typeid(T)));
+			return channel != nullptr && channel->push(event, true);
+		}
+
+		// main thread, calls the type's subscribers before returning, ahead of anything queued for it
+		// false when the type has no channel
+		template <typename T>
+		bool trigger(const T& event)
+		{
+			auto* channel = static_cast<event_channel<T>*>(find(typeid(T)));
+			if (channel == nullptr) return false;
+
+			channel->trigger(event);
+			return true;
+		}
+
+		// main thread, an id of 0 when the type has no channel
+		template <typename T>
+		event_subscription subscribe(std::function<void(const T&)> function)
+		{
+			auto* channel = static_cast<event_channel<T>*>(find(typeid(T)));
+			if (channel == nullptr) return {};
+
+			const auto id = next_subscription();
+			channel->subscribe(id, std::move(function));
+			return { id };
+		}
+
+	protected:
+		// lock free, safe from any thread while the main thread adds channels
+		virtual event_channel_base* find(std::type_index type) const = 0;
+
+		virtual event_channel_base* add(std::unique_ptr<event_channel_base> channel) = 0;
+		virtual uint32_t next_subscription() = 0;
+	};
+}
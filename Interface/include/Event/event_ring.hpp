@@ -0,0 +1,107 @@
+#pragma once
+
+// STL
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+// Interface
+#include "Utility/Rings.hpp"
+
+// --
+namespace Mythos
+{
+	// --
+
+	// bounded ring for one producer thread and one consumer thread, push and pop are a load and a store each
+	// a full ring refuses the event instead of waiting for room, a producer never blocks
+	template <typename T>
+	class spsc_ring
+	{
+	public:
+		static_assert(std::is_trivially_copyable_v<T>, "events are copied between threads by value, keep them plain data");
+
+		// rounded up to a power of two
+		explicit spsc_ring(uint32_t capacity)
+			: capacity_(std::bit_ceil(capacity < 2 ? 2u : capacity)), slots_(std::make_unique<T[]>(capacity_)) {}
+
+		spsc_ring(const spsc_ring&) = delete;
+		spsc_ring& operator=(const spsc_ring&) = delete;
+
+		// producer thread
+		bool push(const T& item)
+		{
+			const auto tail = tail_.load(std::memory_order_relaxed);
+			if (tail - head_.load(std::memory_order_acquire) == capacity_) return false;
+
+			slots_[tail & (capacity_ - 1)] = item;
+			tail_.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		// consumer thread
+		bool pop(T& item)
+		{
+			const auto head = head_.load(std::memory_order_relaxed);
+			if (head == tail_.load(std::memory_order_acquire)) return false;
+
+			item = slots_[head & (capacity_ - 1)];
+			head_.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		uint32_t capacity() const
+		{
+			return capacity_;
+		}
+
+	private:
+		const uint32_t capacity_;
+		std::unique_ptr<T[]> slots_;
+
+		alignas(Utility::CACHE_LINE) std::atomic<uint32_t> head_ = 0;
+		alignas(Utility::CACHE_LINE) std::atomic<uint32_t> tail_ = 0;
+	};
+
+	// --
+
+	// bounded ring for any number of producer threads and one consumer thread, a slot ring whose slots hold one T
+	// a full ring refuses the event, the consumer stops at the first slot still being written rather than waiting
+	template <typename T>
+	class mpsc_ring
+	{
+	public:
+		static_assert(std::is_trivially_copyable_v<T>, "events are copied between threads by value, keep them plain data");
+
+		// rounded up to a power of two
+		explicit mpsc_ring(uint32_t capacity) : slots_(capacity, sizeof(T)) {}
+
+		mpsc_ring(const mpsc_ring&) = delete;
+		mpsc_ring& operator=(const mpsc_ring&) = delete;
+
+		// any thread
+		bool push(const T& item)
+		{
+			return slots_.push(sizeof(T), [&item](std::byte* bytes) { std::memcpy(bytes, &item, sizeof(T)); });
+		}
+
+		// consumer thread
+		bool pop(T& item)
+		{
+			return slots_.pop([&item](std::span<const std::byte> bytes) { std::memcpy(&item, bytes.data(), sizeof(T)); });
+		}
+
+		uint32_t capacity() const
+		{
+			return slots_.capacity();
+		}
+
+	private:
+		Utility::slot_ring slots_;
+	};
+}
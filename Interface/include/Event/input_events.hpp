@@ -0,0 +1,44 @@
+#pragma once
+
+// STL
+#include <cstdint>
+
+// --
+namespace Mythos
+{
+	// --
+
+	// published by the platform's input hooks, one producer thread each
+
+	struct key_event
+	{
+		uint32_t code = 0;      // virtual key code
+		bool pressed = false;
+	};
+
+	enum class mouse_action : uint8_t
+	{
+		move,
+		button_down,
+		button_up,
+		wheel,
+	};
+
+	enum class mouse_button : uint8_t
+	{
+		none,
+		left,
+		right,
+		middle,
+	};
+
+	struct mouse_event
+	{
+		mouse_action action = mouse_action::move;
+		mouse_button button = mouse_button::none;
+		int32_t x = 0;          // in the foreground window's client area
+		int32_t y = 0;
+		int32_t wheel = 0;      // in multiples of WHEEL_DELTA, positive away from the user
+		bool horizontal = false;
+	};
+}
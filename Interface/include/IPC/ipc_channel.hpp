@@ -0,0 +1,261 @@
+#pragma once
+
+// STL
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+// Interface
+#include "Debug.hpp"
+#include "IPC/shared_memory.hpp"
+#include "Utility/Rings.hpp"
+
+// --
+namespace Mythos::IPC
+{
+	// --
+
+	// the rings live in memory mapped by several processes, their atomics must not hide a lock in one process' heap
+	static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+		"shared memory rings need address free atomics");
+
+	constexpr uint32_t IPC_MAGIC = 0x4D495043;     // MIPC
+	constexpr uint32_t IPC_VERSION = 2;
+
+	// spsc carries messages of any length between one writer and one reader, both work in place in the shared memory
+	// mpsc carries messages up to a fixed size from any number of writers to one reader, copied in and read in place
+	enum class ipc_mode : uint32_t
+	{
+		spsc = 1,
+		mpsc = 2,
+	};
+
+	// a message as it sits in the ring, the payload is only valid inside the receive callback
+	struct ipc_message
+	{
+		uint32_t type = 0;
+		std::span<const std::byte> payload;
+
+		// false when the payload is not exactly a T
+		template <typename T>
+		bool read(T& value) const
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "messages cross process boundaries as bytes, keep them plain data");
+			if (payload.size() != sizeof(T)) return false;
+
+			std::memcpy(&value, payload.data(), sizeof(T));
+			return true;
+		}
+	};
+
+	// at the start of the shared memory, fixed width fields so 32 and 64 bit processes agree on the layout
+	struct ipc_ring_header
+	{
+		std::atomic<uint32_t> magic = 0;    // written last by the creator, an opener waits for it
+		uint32_t version = IPC_VERSION;
+		ipc_mode mode = ipc_mode::spsc;
+		uint32_t capacity = 0;              // bytes for spsc, slots for mpsc, a power of two either way
+		uint32_t slot_size = 0;             // mpsc only, bytes per slot including the message prefix
+
+		Utility::ring_positions positions;
+	};
+
+	// leads every message in either ring, the payload follows it and stays eight byte aligned
+	struct ipc_prefix
+	{
+		uint32_t type = 0;
+		uint32_t reserved = 0;
+	};
+
+	// --
+
+	// a message type a channel can carry by value, the id is what the other process switches on
+	template <typename T>
+	concept ipc_type = std::is_trivially_copyable_v<T> && requires { { T::IPC_TYPE } -> std::convertible_to<uint32_t>; };
+
+	// one ring in named shared memory, the engine creates it and a tool such as a log viewer or profiler opens it
+	// the rings are Utility's byte and slot rings laid over the mapping, a process that dies holding an mpsc slot stalls
+	// the ring at that slot, recreate the channel to recover
+	// nothing here blocks, a full ring refuses the message and an empty one returns false, so the engine never waits
+	// on a reader that has fallen behind or gone away
+	class ipc_channel
+	{
+	public:
+		// capacity is bytes for spsc and messages for mpsc, rounded up to a power of two
+		// max_message is the largest payload an mpsc slot holds, spsc messages can be up to half the capacity
+		bool create(const std::string& name, ipc_mode mode, uint32_t capacity, uint32_t max_message = 256)
+		{
+			capacity = std::bit_ceil(capacity < 2 ? 2u : capacity);
+			const auto slot_size = static_cast<uint32_t>(sizeof(ipc_prefix)) + ((max_message + 7) & ~7u);
+
+			if (!memory_.create(name, storage_size(mode, capacity, slot_size))) return false;
+
+			header_ = new (memory_.data()) ipc_ring_header();
+			header_->mode = mode;
+			header_->capacity = capacity;
+			header_->slot_size = mode == ipc_mode::mpsc ? slot_size : 0;
+
+			bind();
+			if (mode == ipc_mode::mpsc) mpsc_.initialise();
+
+			header_->magic.store(IPC_MAGIC, std::memory_order_release);
+
+			Debug::log("IPC : created channel {}, {} with capacity {}", name, mode == ipc_mode::spsc ? "spsc" : "mpsc", capacity);
+			return true;
+		}
+
+		// false when no process has created it or its layout is not one this build understands
+		bool open(const std::string& name, std::chrono::milliseconds wait = std::chrono::milliseconds(100))
+		{
+			if (!memory_.open(name)) return false;
+
+			header_ = reinterpret_cast<ipc_ring_header*>(memory_.data());
+
+			// the creator may still be laying it out
+			const auto deadline = std::chrono::steady_clock::now() + wait;
+			while (header_->magic.load(std::memory_order_acquire) != IPC_MAGIC)
+			{
+				if (std::chrono::steady_clock::now() > deadline)
+				{
+					Debug::error("IPC : channel {} was never initialised", name);
+					close();
+					return false;
+				}
+				std::this_thread::yield();
+			}
+
+			const auto known_mode = header_->mode == ipc_mode::spsc || header_->mode == ipc_mode::mpsc;
+
+			if (header_->version != IPC_VERSION || !known_mode || !std::has_single_bit(header_->capacity) ||
+				storage_size(header_->mode, header_->capacity, header_->slot_size) > memory_.size())
+			{
+				Debug::error("IPC : channel {} has an unknown layout, version {}", name, header_->version);
+				close();
+				return false;
+			}
+
+			bind();
+			return true;
+		}
+
+		void close()
+		{
+			memory_.close();
+			header_ = nullptr;
+			spsc_ = {};
+			mpsc_ = {};
+		}
+
+		bool is_open() const
+		{
+			return header_ != nullptr;
+		}
+
+		// spsc, the writer fills the payload in place then commits, nullptr when full
+		std::byte* reserve(uint32_t type, uint32_t length)
+		{
+			if (header_ == nullptr || header_->mode != ipc_mode::spsc || length > UINT32_MAX - sizeof(ipc_prefix)) return nullptr;
+
+			auto* bytes = spsc_.reserve(static_cast<uint32_t>(sizeof(ipc_prefix)) + length);
+			if (bytes == nullptr) return nullptr;
+
+			const auto prefix = ipc_prefix{ .type = type };
+			std::memcpy(bytes, &prefix, sizeof(ipc_prefix));
+			return bytes + sizeof(ipc_prefix);
+		}
+
+		void commit()
+		{
+			spsc_.commit();
+		}
+
+		bool send(uint32_t type, std::span<const std::byte> payload)
+		{
+			if (header_ == nullptr || payload.size() > UINT32_MAX - sizeof(ipc_prefix)) return false;
+
+			if (header_->mode == ipc_mode::mpsc)
+			{
+				const auto length = static_cast<uint32_t>(sizeof(ipc_prefix) + payload.size());
+				return mpsc_.push(length, [type, payload](std::byte* bytes)
+				{
+					const auto prefix = ipc_prefix{ .type = type };
+					std::memcpy(bytes, &prefix, sizeof(ipc_prefix));
+					std::memcpy(bytes + sizeof(ipc_prefix), payload.data(), payload.size());
+				});
+			}
+
+			auto* bytes = reserve(type, static_cast<uint32_t>(payload.size()));
+			if (bytes == nullptr) return false;
+
+			std::memcpy(bytes, payload.data(), payload.size());
+			spsc_.commit();
+			return true;
+		}
+
+		template <ipc_type T>
+		bool send(const T& message)
+		{
+			return send(T::IPC_TYPE, std::as_bytes(std::span(&message, 1)));
+		}
+
+		// the one reader, hands the oldest message to handle(const ipc_message&) where it sits, false when there is none
+		template <typename F>
+		bool receive(F&& handle)
+		{
+			if (header_ == nullptr) return false;
+			if (header_->mode == ipc_mode::mpsc) return mpsc_.pop([&handle](std::span<const std::byte> bytes) { handle(message_of(bytes)); });
+
+			const auto bytes = spsc_.front();
+			if (bytes.empty()) return false;
+
+			handle(message_of(bytes));
+			spsc_.pop();
+			return true;
+		}
+
+		// up to max messages, returns how many
+		template <typename F>
+		uint32_t receive_all(F&& handle, uint32_t max = UINT32_MAX)
+		{
+			auto count = 0u;
+			while (count < max && receive(handle)) count++;
+			return count;
+		}
+
+	private:
+		static size_t storage_size(ipc_mode mode, uint32_t capacity, uint32_t slot_size)
+		{
+			const auto ring = mode == ipc_mode::spsc ? size_t(capacity) : Utility::slot_ring::storage_size(capacity, slot_size);
+			return sizeof(ipc_ring_header) + ring;
+		}
+
+		// every record holds at least its prefix, the writers put it there
+		static ipc_message message_of(std::span<const std::byte> bytes)
+		{
+			auto prefix = ipc_prefix();
+			std::memcpy(&prefix, bytes.data(), sizeof(ipc_prefix));
+			return { prefix.type, bytes.subspan(sizeof(ipc_prefix)) };
+		}
+
+		void bind()
+		{
+			auto* bytes = memory_.data() + sizeof(ipc_ring_header);
+
+			if (header_->mode == ipc_mode::spsc) spsc_ = Utility::byte_ring(bytes, header_->capacity, &header_->positions);
+			else mpsc_ = Utility::slot_ring(bytes, header_->capacity, header_->slot_size, &header_->positions);
+		}
+
+		shared_memory memory_;
+		ipc_ring_header* header_ = nullptr;
+		Utility::byte_ring spsc_;
+		Utility::slot_ring mpsc_;
+	};
+}
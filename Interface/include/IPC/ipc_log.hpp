@@ -0,0 +1,69 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// Interface
+#include "IPC/ipc_channel.hpp"
+#include "Log/logger.hpp"
+#include "Utility/Constants.hpp"
+
+// --
+namespace Mythos::IPC
+{
+	// --
+
+	constexpr uint32_t LOG_CHANNEL_SIZE = 256 * 1024;
+
+	// a log record as the engine mirrors it into its log channel, the message's bytes follow
+	struct ipc_log_record
+	{
+		static constexpr uint32_t IPC_TYPE = 1;
+
+		int64_t time = 0;       // nanoseconds since the logger was created
+		uint32_t length = 0;    // of the message
+		log_level level = log_level::log;
+		uint8_t flags = LOG_DEFAULT;
+	};
+
+	inline uint32_t current_process_id()
+	{
+#ifdef _WIN64
+		return static_cast<uint32_t>(GetCurrentProcessId());
+#else
+		return static_cast<uint32_t>(getpid());
+#endif
+	}
+
+	// the spsc channel a process mirrors its log into, a tool opens it with the process' id
+	inline std::string log_channel_name(uint32_t process_id)
+	{
+		return LOG_CHANNEL_KEY + std::to_string(process_id);
+	}
+
+	// from the logger's writer, the sink thread being the channel's one writer, false when the ring is full
+	// a channel nobody reads fills up and drops the rest, the console still has everything
+	inline bool mirror_log(ipc_channel& channel, const log_entry& entry)
+	{
+		const auto length = static_cast<uint32_t>(entry.message.size());
+
+		auto* bytes = channel.reserve(ipc_log_record::IPC_TYPE, static_cast<uint32_t>(sizeof(ipc_log_record)) + length);
+		if (bytes == nullptr) return false;
+
+		const auto record = ipc_log_record
+		{
+			.time = entry.time.count(),
+			.length = length,
+			.level = entry.level,
+			.flags = entry.flags,
+		};
+
+		std::memcpy(bytes, &record, sizeof(ipc_log_record));
+		std::memcpy(bytes + sizeof(ipc_log_record), entry.message.data(), length);
+
+		channel.commit();
+		return true;
+	}
+}
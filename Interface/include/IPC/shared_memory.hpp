@@ -0,0 +1,203 @@
+#pragma once
+
+// Microsoft
+#ifdef _WIN64
+#define WIN64_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// STL
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <utility>
+
+// Interface
+#include "Debug.hpp"
+
+// --
+namespace Mythos::IPC
+{
+	// --
+
+	// a named block of memory other processes can map, the creator owns the name and removes it when closed
+	// on windows the block lives while any process has it open, on posix an opener keeps its mapping after the
+	// creator unlinks the name but nobody new can find it
+	class shared_memory
+	{
+	public:
+		shared_memory() = default;
+
+		~shared_memory()
+		{
+			close();
+		}
+
+		shared_memory(shared_memory&& other) noexcept
+		{
+			*this = std::move(other);
+		}
+
+		shared_memory& operator=(shared_memory&& other) noexcept
+		{
+			if (this != &other)
+			{
+				close();
+				name_ = std::move(other.name_);
+				data_ = std::exchange(other.data_, nullptr);
+				size_ = std::exchange(other.size_, 0);
+				owner_ = std::exchange(other.owner_, false);
+#ifdef _WIN64
+				handle_ = std::exchange(other.handle_, nullptr);
+#endif
+			}
+			return *this;
+		}
+
+		shared_memory(const shared_memory&) = delete;
+		shared_memory& operator=(const shared_memory&) = delete;
+
+		// zero filled, a name left behind by a process that crashed is replaced
+		bool create(const std::string& name, size_t size)
+		{
+			close();
+			name_ = name;
+
+#ifdef _WIN64
+			const auto high = static_cast<DWORD>(static_cast<uint64_t>(size) >> 32);
+			const auto low = static_cast<DWORD>(size & 0xFFFFFFFF);
+
+			handle_ = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, high, low, name_.c_str());
+			if (handle_ == nullptr)
+			{
+				Debug::error("IPC : failed to create shared memory {}, error {}", name_, GetLastError());
+				return false;
+			}
+
+			if (GetLastError() == ERROR_ALREADY_EXISTS)
+			{
+				Debug::error("IPC : shared memory {} is already in use", name_);
+				close();
+				return false;
+			}
+
+			data_ = static_cast<std::byte*>(MapViewOfFile(handle_, FILE_MAP_ALL_ACCESS, 0, 0, size));
+#else
+			shm_unlink(name_.c_str());
+
+			const auto descriptor = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+			if (descriptor < 0)
+			{
+				Debug::error("IPC : failed to create shared memory {}, errno {}", name_, errno);
+				return false;
+			}
+
+			if (ftruncate(descriptor, static_cast<off_t>(size)) == 0)
+			{
+				auto* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+				data_ = mapped == MAP_FAILED ? nullptr : static_cast<std::byte*>(mapped);
+			}
+
+			::close(descriptor);
+#endif
+
+			owner_ = true;
+
+			if (data_ == nullptr)
+			{
+				Debug::error("IPC : failed to map shared memory {}", name_);
+				close();
+				return false;
+			}
+
+			size_ = size;
+			return true;
+		}
+
+		// the whole block another process created
+		bool open(const std::string& name)
+		{
+			close();
+			name_ = name;
+
+#ifdef _WIN64
+			handle_ = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name_.c_str());
+			if (handle_ == nullptr) return false;
+
+			data_ = static_cast<std::byte*>(MapViewOfFile(handle_, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+
+			// whole pages, the creator's layout records the size it asked for
+			auto info = MEMORY_BASIC_INFORMATION();
+			if (data_ != nullptr && VirtualQuery(data_, &info, sizeof(info)) != 0) size_ = info.RegionSize;
+#else
+			const auto descriptor = shm_open(name_.c_str(), O_RDWR, 0600);
+			if (descriptor < 0) return false;
+
+			struct stat info = {};
+			if (fstat(descriptor, &info) == 0 && info.st_size > 0)
+			{
+				size_ = static_cast<size_t>(info.st_size);
+				auto* mapped = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+				data_ = mapped == MAP_FAILED ? nullptr : static_cast<std::byte*>(mapped);
+			}
+
+			::close(descriptor);
+#endif
+
+			if (data_ == nullptr)
+			{
+				Debug::error("IPC : failed to map shared memory {}", name_);
+				close();
+				return false;
+			}
+
+			return true;
+		}
+
+		void close()
+		{
+#ifdef _WIN64
+			if (data_ != nullptr) UnmapViewOfFile(data_);
+			if (handle_ != nullptr) CloseHandle(handle_);
+			handle_ = nullptr;
+#else
+			if (data_ != nullptr) munmap(data_, size_);
+			if (owner_) shm_unlink(name_.c_str());
+#endif
+
+			data_ = nullptr;
+			size_ = 0;
+			owner_ = false;
+		}
+
+		std::byte* data() const
+		{
+			return data_;
+		}
+
+		size_t size() const
+		{
+			return size_;
+		}
+
+		bool owner() const
+		{
+			return owner_;
+		}
+
+	private:
+		std::string name_;
+		std::byte* data_ = nullptr;
+		size_t size_ = 0;
+		bool owner_ = false;
+
+#ifdef _WIN64
+		HANDLE handle_ = nullptr;
+#endif
+	};
+}
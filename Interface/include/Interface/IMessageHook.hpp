@@ -3,9 +3,6 @@
 // Interface
 #include "IMakeUnique.hpp"
 
-// STL
-#include <functional>
-
 enum class HookType
 {
 	Window,
@@ -19,8 +16,8 @@ class IMessageHook : public IMakeUnique<T>
 public:
 	virtual ~IMessageHook() = default;
 
-	virtual std::function<void()>& InstallKeyboardHook() = 0;
-	virtual std::function<void()>& InstallMouseHook() = 0;
-	virtual std::function<void()>& InstallSystemHook() = 0;
+	// input reaches the engine as events on the bus, false when the hook could not be installed
+	virtual bool InstallKeyboardHook() = 0;
+	virtual bool InstallMouseHook() = 0;
 
 };
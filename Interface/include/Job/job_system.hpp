@@ -0,0 +1,101 @@
+#pragma once
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// --
+namespace Mythos
+{
+	// --
+
+	// counts the jobs still outstanding, waiting on it acts as a fence
+	class job_counter
+	{
+	public:
+		job_counter() = default;
+		job_counter(const job_counter&) = delete;
+		job_counter& operator=(const job_counter&) = delete;
+
+		void add(int count)
+		{
+			count_.fetch_add(count, std::memory_order_relaxed);
+		}
+
+		void done()
+		{
+			count_.fetch_sub(1, std::memory_order_acq_rel);
+		}
+
+		bool is_done() const
+		{
+			return count_.load(std::memory_order_acquire) == 0;
+		}
+
+	private:
+		std::atomic<int> count_ = 0;
+	};
+
+	// --
+
+	struct job
+	{
+		std::function<void()> function;
+		job_counter* counter = nullptr;
+	};
+
+	// --
+
+	// exposed by the job module, see Module::GetInterface
+	class job_system
+	{
+	public:
+		virtual ~job_system() = default;
+
+		// queues the jobs, the counter is raised by the job count and lowered as each one completes
+		virtual void run(job* jobs, size_t count, job_counter* counter) = 0;
+
+		// runs queued jobs on the calling thread until the counter reaches zero
+		virtual void wait(const job_counter& counter) = 0;
+
+		// runs at most one queued job on the calling thread, false if there was nothing to run
+		virtual bool run_pending() = 0;
+
+		// number of threads executing jobs, including the waiting thread
+		virtual uint32_t worker_count() const = 0;
+
+		void run(std::function<void()> function, job_counter* counter = nullptr)
+		{
+			auto single = job{ .function = std::move(function) };
+			run(&single, 1, counter);
+		}
+
+		// splits [0, count) into batches of at least batch_size and blocks until all have run
+		// function is called as function(begin, end)
+		template <typename F>
+		void parallel_for(uint32_t count, uint32_t batch_size, F&& function)
+		{
+			if (count == 0) return;
+
+			// aim for a few batches per worker so stealing can balance uneven work
+			const auto target = std::max(1u, worker_count() * 4);
+			const auto batch = std::max({ 1u, batch_size, (count + target - 1) / target });
+
+			auto jobs = std::vector<job>();
+			jobs.reserve((count + batch - 1) / batch);
+
+			for (auto begin = 0u; begin < count; begin += batch)
+			{
+				const auto end = std::min(count, begin + batch);
+				jobs.push_back(job{ .function = [&function, begin, end]() { function(begin, end); } });
+			}
+
+			auto counter = job_counter();
+			run(jobs.data(), jobs.size(), &counter);
+			wait(counter);
+		}
+	};
+}
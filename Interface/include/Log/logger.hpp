@@ -0,0 +1,648 @@
+#pragma once
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Interface
+#include "Utility/Constants.hpp"
+#include "Utility/ProcessInstance.hpp"
+#include "Utility/Rings.hpp"
+
+// the lowest level compiled in, a project defining MYTHOS_LOG_LEVEL=2 strips its logs and warnings
+#ifndef MYTHOS_LOG_LEVEL
+#define MYTHOS_LOG_LEVEL 0
+#endif
+
+// --
+namespace Mythos
+{
+	// --
+
+	enum class log_level : uint8_t
+	{
+		log,
+		warn,
+		error,
+		exception,
+	};
+
+	constexpr bool log_enabled(log_level level)
+	{
+		return static_cast<int>(level) >= MYTHOS_LOG_LEVEL;
+	}
+
+	constexpr auto log_level_name(log_level level) -> const char*
+	{
+		switch (level)
+		{
+		case log_level::log: return "log";
+		case log_level::warn: return "warn";
+		case log_level::error: return "error";
+		case log_level::exception: return "exception";
+		}
+
+		return "log";
+	}
+
+	// how a record is laid out by the writer
+	enum log_flags : uint8_t
+	{
+		LOG_DEFAULT = 0,
+		LOG_HEADER = 1 << 0,    // a blank line either side
+		LOG_PLAIN = 1 << 1,     // no level prefix
+	};
+
+	// one formatted record, handed to the writer on the sink thread
+	struct log_entry
+	{
+		log_level level = log_level::log;
+		uint8_t flags = LOG_DEFAULT;
+		std::chrono::nanoseconds time = {};     // since the logger was created
+		std::string_view message;
+		std::source_location source;
+	};
+
+	using log_writer = std::function<void(const log_entry&)>;
+
+	// --
+
+	// arguments are copied into the record as a type tag and the value, strings by their bytes
+	enum class log_arg : uint8_t
+	{
+		boolean,
+		character,
+		signed_integer,
+		unsigned_integer,
+		floating,
+		string,
+		pointer,
+	};
+
+	template <typename T>
+	constexpr log_arg log_arg_of()
+	{
+		using U = std::remove_cvref_t<T>;
+
+		if constexpr (std::is_same_v<U, bool>) return log_arg::boolean;
+		else if constexpr (std::is_same_v<U, char>) return log_arg::character;
+		else if constexpr (std::is_enum_v<U>) return log_arg_of<std::underlying_type_t<U>>();
+		else if constexpr (std::is_integral_v<U>) return std::is_signed_v<U> ? log_arg::signed_integer : log_arg::unsigned_integer;
+		else if constexpr (std::is_floating_point_v<U>) return log_arg::floating;
+		else if constexpr (std::is_convertible_v<const U&, std::string_view>) return log_arg::string;
+		else if constexpr (std::is_pointer_v<U>) return log_arg::pointer;
+		else static_assert(std::is_pointer_v<U>, "log arguments are numbers, strings and pointers, convert anything else first");
+	}
+
+	// a null char pointer logs as null rather than reaching strlen
+	template <typename T>
+	std::string_view log_string(const T& value)
+	{
+		if constexpr (std::is_pointer_v<std::remove_cvref_t<T>>)
+		{
+			if (value == nullptr) return "null";
+		}
+
+		return std::string_view(value);
+	}
+
+	template <typename T>
+	size_t log_arg_size(const T& value)
+	{
+		constexpr auto type = log_arg_of<T>();
+
+		if constexpr (type == log_arg::boolean || type == log_arg::character) return 2;
+		else if constexpr (type == log_arg::string) return 1 + sizeof(uint32_t) + log_string(value).size();
+		else return 1 + 8;
+	}
+
+	template <typename T>
+	void log_arg_write(std::byte*& bytes, const T& value)
+	{
+		constexpr auto type = log_arg_of<T>();
+		*bytes++ = static_cast<std::byte>(type);
+
+		const auto put = [&bytes](const void* data, size_t size)
+		{
+			std::memcpy(bytes, data, size);
+			bytes += size;
+		};
+
+		if constexpr (type == log_arg::boolean || type == log_arg::character)
+		{
+			*bytes++ = static_cast<std::byte>(value);
+		}
+		else if constexpr (type == log_arg::signed_integer)
+		{
+			const auto number = static_cast<int64_t>(value);
+			put(&number, 8);
+		}
+		else if constexpr (type == log_arg::unsigned_integer)
+		{
+			const auto number = static_cast<uint64_t>(value);
+			put(&number, 8);
+		}
+		else if constexpr (type == log_arg::floating)
+		{
+			const auto number = static_cast<double>(value);
+			put(&number, 8);
+		}
+		else if constexpr (type == log_arg::string)
+		{
+			const auto text = log_string(value);
+			const auto length = static_cast<uint32_t>(text.size());
+			put(&length, sizeof(uint32_t));
+			put(text.data(), length);
+		}
+		else
+		{
+			const auto address = reinterpret_cast<uintptr_t>(value);
+			const auto number = static_cast<uint64_t>(address);
+			put(&number, 8);
+		}
+	}
+
+	// --
+
+	constexpr size_t log_placeholders(std::string_view format)
+	{
+		auto count = size_t(0);
+
+		for (auto position = format.find("{}"); position != std::string_view::npos; position = format.find("{}", position + 2))
+		{
+			count++;
+		}
+
+		return count;
+	}
+
+	// reached only while checking a format at compile time, naming the mistake in the error
+	inline void log_format_placeholders_do_not_match_the_arguments() {}
+
+	// a string literal with a {} for each argument, checked at compile time and formatted on the sink thread,
+	// or a message built at runtime which is copied in whole and takes no arguments
+	template <typename... Args>
+	struct log_format
+	{
+		consteval log_format(const char* format, std::source_location source = std::source_location::current())
+			: text(format), source(source), literal(true)
+		{
+			if (log_placeholders(text) != sizeof...(Args)) log_format_placeholders_do_not_match_the_arguments();
+		}
+
+		log_format(const std::string& message, std::source_location source = std::source_location::current())
+			requires (sizeof...(Args) == 0)
+			: text(message), source(source), literal(false) {}
+
+		std::string_view text;
+		std::source_location source;
+		bool literal = false;
+	};
+
+	// --
+
+	// the process' logger, one sink thread draining a ring per logging thread
+	// writing a record is a clock read and a copy into the calling thread's ring, formatting and output happen on the
+	// sink thread later, a full ring drops the record and counts it rather than wait on the sink
+	// the format literals stay in the module that logged them, a module flushes before it is unloaded
+	class logger
+	{
+	public:
+		static constexpr uint32_t BUFFER_SIZE = 64 * 1024;
+
+		explicit logger(log_writer writer)
+			: writer_(std::move(writer)), start_(std::chrono::steady_clock::now()), sink_([this] { run(); }) {}
+
+		~logger()
+		{
+			Utility::process_instance<logger>::withdraw();
+
+			{
+				const auto lock = std::lock_guard(mutex_);
+				stopping_ = true;
+			}
+			wake_.notify_all();
+			sink_.join();
+		}
+
+		logger(const logger&) = delete;
+		logger& operator=(const logger&) = delete;
+
+		// the one logger of the process, created by the first module to ask, it lives until the process exits
+		static logger* create()
+		{
+			if (auto* existing = find()) return existing;
+
+			static auto instance = logger([](const log_entry& entry) { write_default(entry); });
+			Utility::process_instance<logger>::publish(LOGGER_KEY, &instance);
+			return &instance;
+		}
+
+		// the process' logger or nullptr before one is created
+		static logger* find()
+		{
+			return Utility::process_instance<logger>::find(LOGGER_KEY);
+		}
+
+		// any thread
+		template <typename... Args>
+		bool write(log_level level, uint8_t flags, const log_format<Args...>& format, const Args&... args)
+		{
+			auto* buffer = thread_buffer();
+			if (buffer == nullptr) return drop();
+
+			const auto copied = format.literal ? size_t(0) : format.text.size();
+			const auto size = sizeof(record) + copied + (log_arg_size(args) + ... + size_t(0));
+			if (size > buffer->capacity() / 2) return drop();
+
+			auto* bytes = buffer->reserve(static_cast<uint32_t>(size));
+			if (bytes == nullptr) return drop();
+
+			const auto header = record
+			{
+				.time = std::chrono::steady_clock::now().time_since_epoch().count(),
+				.source = format.source,
+				.format = format.literal ? format.text.data() : nullptr,
+				.length = static_cast<uint32_t>(format.text.size()),
+				.level = level,
+				.flags = flags,
+			};
+
+			std::memcpy(bytes, &header, sizeof(record));
+			bytes += sizeof(record);
+
+			if (copied > 0)
+			{
+				std::memcpy(bytes, format.text.data(), copied);
+				bytes += copied;
+			}
+
+			(log_arg_write(bytes, args), ...);
+
+			buffer->commit();
+			return true;
+		}
+
+		// waits until everything any thread wrote before the call is written out
+		void flush()
+		{
+			auto lock = std::unique_lock(mutex_);
+			const auto ticket = ++flush_requested_;
+
+			wake_.notify_all();
+			flushed_.wait(lock, [this, ticket] { return flush_done_ >= ticket || stopping_; });
+		}
+
+		// the writer is called on the sink thread, one record at a time
+		void set_writer(log_writer writer)
+		{
+			const auto lock = std::lock_guard(writer_mutex_);
+			writer_ = std::move(writer);
+		}
+
+		uint64_t dropped() const
+		{
+			return dropped_.load(std::memory_order_relaxed);
+		}
+
+		// the message a record would be written with, for callers that need it straight away
+		template <typename... Args>
+		static std::string format_now(const log_format<Args...>& format, const Args&... args)
+		{
+			auto bytes = std::vector<std::byte>((log_arg_size(args) + ... + size_t(0)));
+			auto* cursor = bytes.data();
+			(log_arg_write(cursor, args), ...);
+
+			auto message = std::string();
+			if (format.literal) format_into(message, format.text, bytes.data(), bytes.data() + bytes.size());
+			else message = format.text;
+			return message;
+		}
+
+		static void write_default(const log_entry& entry)
+		{
+			if (entry.flags & LOG_HEADER) std::cout << '\n';
+			if (!(entry.flags & LOG_PLAIN)) std::cout << '[' << log_level_name(entry.level) << "] ";
+			std::cout << entry.message << '\n';
+			if (entry.flags & LOG_HEADER) std::cout << '\n';
+		}
+
+	private:
+		// leads every record, followed by the copied message if any then the arguments
+		struct record
+		{
+			int64_t time = 0;
+			std::source_location source;
+			const char* format = nullptr;   // the literal, nullptr when the message was copied in
+			uint32_t length = 0;
+			log_level level = log_level::log;
+			uint8_t flags = LOG_DEFAULT;
+		};
+
+		struct thread_ring
+		{
+			std::unique_ptr<Utility::byte_ring> buffer;
+			bool retired = false;
+		};
+
+		// gives the ring back when its thread exits, the sink frees it once drained
+		struct thread_slot
+		{
+			logger* owner = nullptr;
+			Utility::byte_ring* buffer = nullptr;
+
+			~thread_slot()
+			{
+				if (owner != nullptr) owner->retire(buffer);
+			}
+		};
+
+		// sorted by time before writing, records from different threads drained in one pass come out in order
+		struct pending
+		{
+			int64_t time = 0;
+			uint64_t sequence = 0;
+			log_level level = log_level::log;
+			uint8_t flags = LOG_DEFAULT;
+			std::source_location source;
+			std::string message;
+		};
+
+		bool drop()
+		{
+			dropped_.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		// the calling thread's ring, the mutex is taken once per thread and module
+		Utility::byte_ring* thread_buffer()
+		{
+			thread_local auto slot = thread_slot();
+			if (slot.owner == this) return slot.buffer;
+
+			const auto lock = std::lock_guard(mutex_);
+			if (stopping_) return nullptr;
+
+			rings_.push_back({ std::make_unique<Utility::byte_ring>(BUFFER_SIZE), false });
+			slot.owner = this;
+			slot.buffer = rings_.back().buffer.get();
+			return slot.buffer;
+		}
+
+		void retire(Utility::byte_ring* buffer)
+		{
+			const auto lock = std::lock_guard(mutex_);
+
+			for (auto& ring : rings_)
+			{
+				if (ring.buffer.get() == buffer) ring.retired = true;
+			}
+		}
+
+		static void format_into(std::string& message, std::string_view format, const std::byte* args, const std::byte* end)
+		{
+			auto position = size_t(0);
+
+			for (auto found = format.find("{}"); found != std::string_view::npos; found = format.find("{}", position))
+			{
+				message.append(format.substr(position, found - position));
+				position = found + 2;
+
+				if (args < end) args = append_arg(message, args);
+				else message.append("{}");
+			}
+
+			message.append(format.substr(position));
+		}
+
+		static const std::byte* append_arg(std::string& message, const std::byte* bytes)
+		{
+			const auto type = static_cast<log_arg>(*bytes++);
+
+			const auto take = [&bytes](auto& value)
+			{
+				std::memcpy(&value, bytes, sizeof(value));
+				bytes += sizeof(value);
+			};
+
+			switch (type)
+			{
+			case log_arg::boolean:
+				message.append(*bytes++ != std::byte(0) ? "true" : "false");
+				break;
+			case log_arg::character:
+				message.push_back(static_cast<char>(*bytes++));
+				break;
+			case log_arg::signed_integer:
+			{
+				auto number = int64_t(0);
+				take(number);
+				message.append(std::to_string(number));
+				break;
+			}
+			case log_arg::unsigned_integer:
+			{
+				auto number = uint64_t(0);
+				take(number);
+				message.append(std::to_string(number));
+				break;
+			}
+			case log_arg::floating:
+			{
+				// the same digits std::to_string gave the messages this replaced
+				auto number = 0.0;
+				take(number);
+				message.append(std::to_string(number));
+				break;
+			}
+			case log_arg::string:
+			{
+				auto length = uint32_t(0);
+				take(length);
+				message.append(reinterpret_cast<const char*>(bytes), length);
+				bytes += length;
+				break;
+			}
+			case log_arg::pointer:
+			{
+				auto number = uint64_t(0);
+				take(number);
+
+				char digits[16] = {};
+				const auto result = std::to_chars(std::begin(digits), std::end(digits), number, 16);
+				message.append("0x").append(digits, result.ptr);
+				break;
+			}
+			}
+
+			return bytes;
+		}
+
+		void run()
+		{
+			for (;;)
+			{
+				auto ticket = uint64_t(0);
+				auto stopping = false;
+
+				{
+					const auto lock = std::lock_guard(mutex_);
+					ticket = flush_requested_;
+					stopping = stopping_;
+				}
+
+				// records written before the flush request or the stop are in the rings by now
+				const auto drained = drain();
+
+				{
+					const auto lock = std::lock_guard(mutex_);
+					flush_done_ = ticket;
+				}
+				flushed_.notify_all();
+
+				if (stopping) return;
+				if (drained > 0) continue;
+
+				// nothing to write, writers never signal so the sink looks again shortly or when asked to
+				auto lock = std::unique_lock(mutex_);
+				wake_.wait_for(lock, std::chrono::milliseconds(1), [this, ticket] { return flush_requested_ != ticket || stopping_; });
+			}
+		}
+
+		size_t drain()
+		{
+			{
+				const auto lock = std::lock_guard(mutex_);
+				snapshot_.clear();
+
+				for (const auto& ring : rings_)
+				{
+					snapshot_.push_back({ ring.buffer.get(), ring.retired });
+				}
+			}
+
+			for (const auto& [buffer, retired] : snapshot_)
+			{
+				// at most one ring's worth, a thread that keeps logging cannot hold the others back
+				for (auto read = size_t(0); read < buffer->capacity(); )
+				{
+					const auto bytes = buffer->front();
+					if (bytes.empty()) break;
+
+					decode(bytes);
+					read += bytes.size();
+					buffer->pop();
+				}
+			}
+
+			const auto count = pending_count_;
+			pending_count_ = 0;
+
+			std::sort(pending_.begin(), pending_.begin() + count, [](const pending& a, const pending& b)
+			{
+				return a.time != b.time ? a.time < b.time : a.sequence < b.sequence;
+			});
+
+			const auto dropped = dropped_.load(std::memory_order_relaxed);
+
+			{
+				const auto lock = std::lock_guard(writer_mutex_);
+
+				for (auto i = size_t(0); i < count; i++)
+				{
+					const auto& entry = pending_[i];
+					const auto time = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(entry.time)) - start_;
+					writer_({ entry.level, entry.flags, std::chrono::duration_cast<std::chrono::nanoseconds>(time), entry.message, entry.source });
+				}
+
+				if (dropped != reported_dropped_)
+				{
+					const auto message = "Logger : " + std::to_string(dropped - reported_dropped_) + " records dropped, a thread's ring was full";
+					const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+					writer_({ log_level::warn, LOG_DEFAULT, time, message, std::source_location::current() });
+					reported_dropped_ = dropped;
+				}
+			}
+
+			// a retired ring was seen before this pass and is empty now, its thread has exited
+			{
+				const auto lock = std::lock_guard(mutex_);
+				std::erase_if(rings_, [this](const thread_ring& ring)
+				{
+					return ring.retired && std::ranges::find(snapshot_, std::pair(ring.buffer.get(), true)) != snapshot_.end();
+				});
+			}
+
+			return count;
+		}
+
+		void decode(std::span<const std::byte> bytes)
+		{
+			auto header = record();
+			std::memcpy(&header, bytes.data(), sizeof(record));
+
+			// kept between passes so the sink stops allocating once the log rate settles
+			if (pending_count_ == pending_.size()) pending_.emplace_back();
+			auto& entry = pending_[pending_count_++];
+
+			entry.time = header.time;
+			entry.sequence = sequence_++;
+			entry.level = header.level;
+			entry.flags = header.flags;
+			entry.source = header.source;
+			entry.message.clear();
+
+			const auto* args = bytes.data() + sizeof(record);
+			const auto* end = bytes.data() + bytes.size();
+
+			if (header.format != nullptr)
+			{
+				format_into(entry.message, std::string_view(header.format, header.length), args, end);
+			}
+			else
+			{
+				entry.message.assign(reinterpret_cast<const char*>(args), header.length);
+			}
+		}
+
+		log_writer writer_;
+		std::mutex writer_mutex_;
+
+		const std::chrono::steady_clock::time_point start_;
+		std::atomic<uint64_t> dropped_ = 0;
+
+		// rings, flush tickets and the stop flag
+		std::mutex mutex_;
+		std::condition_variable wake_;
+		std::condition_variable flushed_;
+		std::vector<thread_ring> rings_;
+		uint64_t flush_requested_ = 0;
+		uint64_t flush_done_ = 0;
+		bool stopping_ = false;
+
+		// sink thread only
+		std::vector<std::pair<Utility::byte_ring*, bool>> snapshot_;
+		std::vector<pending> pending_;
+		size_t pending_count_ = 0;
+		uint64_t sequence_ = 0;
+		uint64_t reported_dropped_ = 0;
+
+		// last, the sink starts once everything it reads is constructed
+		std::thread sink_;
+	};
+}
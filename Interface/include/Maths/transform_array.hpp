@@ -0,0 +1,50 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <vector>
+
+// GLM
+#include <glm/vec3.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// --
+namespace Mythos
+{
+	// --
+
+	// translation, rotation and scale of many objects as parallel arrays rather than a matrix per object,
+	// a pass over one component streams only that component and matrices are composed in one sweep where needed
+	struct transform_array
+	{
+		std::vector<glm::vec3> positions;
+		std::vector<glm::quat> rotations;
+		std::vector<glm::vec3> scales;
+
+		size_t size() const { return positions.size(); }
+
+		void clear()
+		{
+			positions.clear();
+			rotations.clear();
+			scales.clear();
+		}
+
+		void reserve(size_t count)
+		{
+			positions.reserve(count);
+			rotations.reserve(count);
+			scales.reserve(count);
+		}
+
+		// returns the index of the new transform
+		uint32_t push(const glm::vec3& position, const glm::quat& rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+		              const glm::vec3& scale = glm::vec3(1.0f))
+		{
+			positions.push_back(position);
+			rotations.push_back(rotation);
+			scales.push_back(scale);
+			return static_cast<uint32_t>(positions.size() - 1);
+		}
+	};
+}
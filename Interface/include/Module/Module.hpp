@@ -4,6 +4,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 // Utility
 #include "../Utility/Handles.hpp"
@@ -31,7 +32,32 @@ namespace Mythos
 		std::string dll_date;
 		std::string dll_time;
 
+		// modules whose state this layer touches during update, by priority
+		// a layer always writes its own priority, layers that do not conflict update in parallel
+		std::vector<int> reads;
+		std::vector<int> writes;
+
+		// update has to stay on the thread that owns the window and its message queue
+		bool main_thread = false;
+
 		std::function<std::unique_ptr<layer>()> MakeUniqueLayer;
+		mutable layer* layer_ptr = nullptr;
+
+		// optional, returns the interface other layers can use from the layer this module created
+		std::function<void*(layer&)> GetInterface;
+		mutable void* interface_ptr = nullptr;
 	};
 
+	// finds the interface exposed by the module loaded at the given priority
+	template <typename T>
+	T* find_interface(const std::vector<std::unique_ptr<Module>>& modules, int priority)
+	{
+		for (const auto& module : modules)
+		{
+			if (module->priority != priority) continue;
+			return static_cast<T*>(module->interface_ptr);
+		}
+		return nullptr;
+	}
+
 }
\ No newline at end of file
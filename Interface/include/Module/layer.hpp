@@ -1,15 +1,26 @@
 #pragma once
 
+// STL
+#include <memory>
+#include <vector>
+
 // --
 namespace Mythos
 {
+	class Module;
 
 	class layer
 	{
 	public:
 		virtual ~layer() = default;
 
-		virtual void update() = 0;
-		virtual void render() = 0;
+		// called once every layer has been created, use find_interface to reach other modules
+		virtual void attach(const std::vector<std::unique_ptr<Module>>& modules) {}
+
+		// called zero or more times a frame, dt is always the engine's fixed step in seconds
+		virtual void update(float dt) = 0;
+
+		// called once a frame, alpha is how far the frame sits between the last two updates
+		virtual void render(float alpha) = 0;
 	};
 }
@@ -0,0 +1,491 @@
+#pragma once
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Interface
+#include "Debug.hpp"
+#include "Event/event_ring.hpp"
+#include "Utility/Constants.hpp"
+#include "Utility/ProcessInstance.hpp"
+
+// instrumentation is compiled out of shipping builds, a project can also set MYTHOS_PROFILE to 0 or 1 itself
+#ifndef MYTHOS_PROFILE
+#ifdef MYTHOS_SHIPPING
+#define MYTHOS_PROFILE 0
+#else
+#define MYTHOS_PROFILE 1
+#endif
+#endif
+
+// --
+namespace Mythos
+{
+	// --
+
+	enum class profile_kind : uint8_t
+	{
+		zone,
+		counter,
+		frame,
+	};
+
+	// as recorded, names are string literals or strings that live at least until the next frame marker
+	struct profile_event
+	{
+		const char* name = nullptr;
+		int64_t begin = 0;      // steady clock nanoseconds
+		int64_t end = 0;        // zones only
+		double value = 0.0;     // counters only
+		profile_kind kind = profile_kind::zone;
+	};
+
+	// frames to capture from the start of a run, none by default
+	struct profile_capture
+	{
+		uint32_t frames = 0;
+		std::string path = "mythos_trace.json";
+	};
+
+	// a thread's lane in the trace, the gpu gets one of its own
+	struct profile_track
+	{
+		uint32_t id = 0;
+		std::string name;
+	};
+
+	// --
+
+	// the process' profiler, idle until a capture is requested
+	// while idle a zone costs two atomic loads, while capturing it is two clock reads and a push into the calling
+	// thread's ring, the main thread drains every ring at each frame marker and names are copied at that point
+	// a full ring drops events rather than wait, the trace reports how many
+	class profiler
+	{
+	public:
+		static constexpr uint32_t RING_SIZE = 16 * 1024;
+
+		profiler() = default;
+
+		~profiler()
+		{
+			Utility::process_instance<profiler>::withdraw();
+		}
+
+		profiler(const profiler&) = delete;
+		profiler& operator=(const profiler&) = delete;
+
+		// the one profiler of the process, created by the first module to ask, it lives until the process exits
+		// applications create it before anything records, modules that asked earlier keep seeing none
+		static profiler* create()
+		{
+			if (auto* existing = Utility::process_instance<profiler>::find(PROFILER_KEY)) return existing;
+
+			static auto instance = profiler();
+			Utility::process_instance<profiler>::publish(PROFILER_KEY, &instance);
+			return &instance;
+		}
+
+		// looked up once per module, an idle or missing profiler costs no more than the atomic loads
+		static profiler* find()
+		{
+			return Utility::process_instance<profiler>::find_cached(PROFILER_KEY);
+		}
+
+		// the profiler while it captures, nullptr otherwise
+		static profiler* active()
+		{
+			auto* found = find();
+			return found != nullptr && found->capturing_.load(std::memory_order_relaxed) ? found : nullptr;
+		}
+
+		static int64_t now()
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		// records the next frames then writes a chrome trace (chrome://tracing, ui.perfetto.dev) to path
+		void capture(uint32_t frames, const std::string& path)
+		{
+			const auto lock = std::lock_guard(mutex_);
+			requested_frames_ = frames;
+			path_ = path;
+		}
+
+		// any thread, a zone is recorded once it ends
+		void zone(const char* name, int64_t begin, int64_t end)
+		{
+			push({ name, begin, end, 0.0, profile_kind::zone });
+		}
+
+		void counter(const char* name, double value)
+		{
+			push({ name, now(), 0, value, profile_kind::counter });
+		}
+
+		// the calling thread's lane name, before its first event
+		void name_thread(const std::string& name)
+		{
+			auto* lane = thread_ring();
+
+			const auto lock = std::lock_guard(mutex_);
+			lane->name = name;
+		}
+
+		// main thread, once a frame, starts and ends captures and collects what every thread recorded
+		void frame()
+		{
+			const auto time = now();
+
+			if (capturing_.load(std::memory_order_relaxed))
+			{
+				const auto* lane = thread_ring();
+
+				collect();
+				captured_.push_back({ intern(FRAME_NAME), time, 0, 0.0, profile_kind::frame, lane->track });
+
+				if (++frames_ >= capture_frames_)
+				{
+					capturing_.store(false, std::memory_order_relaxed);
+					write();
+				}
+				return;
+			}
+
+			const auto lock = std::lock_guard(mutex_);
+			if (requested_frames_ == 0) return;
+
+			capture_frames_ = std::exchange(requested_frames_, 0);
+			capture_path_ = path_;
+			frames_ = 0;
+			start_ = time;
+			dropped_.store(0, std::memory_order_relaxed);
+
+			// events recorded since the last capture belong to nobody
+			discard();
+
+			capturing_.store(true, std::memory_order_relaxed);
+			Debug::log("Profiler : capturing {} frames to {}", capture_frames_, capture_path_);
+		}
+
+		// events timed elsewhere, for a lane that is not a thread such as the gpu, main thread between frame markers
+		void add_track_events(const std::string& track, const std::vector<profile_event>& events)
+		{
+			if (!capturing_.load(std::memory_order_relaxed)) return;
+
+			const auto lane = track_id(track);
+
+			for (const auto& event : events)
+			{
+				// read back late and timed before the capture started
+				if (event.begin < start_) continue;
+
+				captured_.push_back({ intern(event.name), event.begin, event.end, event.value, event.kind, lane });
+			}
+		}
+
+		bool capturing() const
+		{
+			return capturing_.load(std::memory_order_relaxed);
+		}
+
+	private:
+		static constexpr const char* FRAME_NAME = "frame";
+
+		struct ring
+		{
+			explicit ring(uint32_t id) : events(RING_SIZE), track(id) {}
+
+			spsc_ring<profile_event> events;
+			uint32_t track = 0;
+			std::string name;
+			bool retired = false;
+		};
+
+		// gives the ring back when its thread exits
+		struct thread_slot
+		{
+			profiler* owner = nullptr;
+			ring* lane = nullptr;
+
+			~thread_slot()
+			{
+				if (owner != nullptr) owner->retire(lane);
+			}
+		};
+
+		struct captured_event
+		{
+			uint32_t name_index = 0;
+			int64_t begin = 0;
+			int64_t end = 0;
+			double value = 0.0;
+			profile_kind kind = profile_kind::zone;
+			uint32_t track = 0;
+		};
+
+		void push(const profile_event& event)
+		{
+			auto* ring = thread_ring();
+			if (ring == nullptr || !ring->events.push(event)) dropped_.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// the mutex is taken once per thread and module
+		ring* thread_ring()
+		{
+			thread_local auto slot = thread_slot();
+			if (slot.owner == this) return slot.lane;
+
+			const auto lock = std::lock_guard(mutex_);
+
+			rings_.push_back(std::make_unique<ring>(next_track_++));
+			slot.owner = this;
+			slot.lane = rings_.back().get();
+			return slot.lane;
+		}
+
+		void retire(ring* retired)
+		{
+			const auto lock = std::lock_guard(mutex_);
+
+			for (auto& entry : rings_)
+			{
+				if (entry.get() == retired) entry->retired = true;
+			}
+		}
+
+		// a pointer seen this frame skips the string lookup, the pointers are forgotten at each frame marker
+		uint32_t intern(const char* name)
+		{
+			const auto seen = names_.find(name);
+			if (seen != names_.end()) return seen->second;
+
+			auto text = std::string(name != nullptr ? name : "unnamed");
+			auto found = indices_.find(text);
+
+			if (found == indices_.end())
+			{
+				found = indices_.emplace(text, static_cast<uint32_t>(strings_.size())).first;
+				strings_.push_back(std::move(text));
+			}
+
+			names_.emplace(name, found->second);
+			return found->second;
+		}
+
+		uint32_t track_id(const std::string& name)
+		{
+			const auto lock = std::lock_guard(mutex_);
+
+			for (const auto& track : tracks_)
+			{
+				if (track.name == name) return track.id;
+			}
+
+			tracks_.push_back({ next_track_++, name });
+			return tracks_.back().id;
+		}
+
+		void collect()
+		{
+			const auto lock = std::lock_guard(mutex_);
+			auto event = profile_event();
+
+			for (const auto& entry : rings_)
+			{
+				// at most one ring's worth, a thread that keeps recording cannot hold the frame
+				for (uint32_t i = 0; i < entry->events.capacity() && entry->events.pop(event); i++)
+				{
+					captured_.push_back({ intern(event.name), event.begin, event.end, event.value, event.kind, entry->track });
+				}
+
+				if (!entry->name.empty() && std::ranges::none_of(tracks_, [&entry](const profile_track& track) { return track.id == entry->track; }))
+				{
+					tracks_.push_back({ entry->track, entry->name });
+				}
+			}
+
+			// a retired ring's thread is gone and its ring is empty now
+			std::erase_if(rings_, [](const std::unique_ptr<ring>& entry) { return entry->retired; });
+
+			// the strings behind the pointers may not outlive the frame
+			names_.clear();
+		}
+
+		void discard()
+		{
+			auto event = profile_event();
+
+			for (const auto& entry : rings_)
+			{
+				while (entry->events.pop(event)) {}
+			}
+
+			captured_.clear();
+			strings_.clear();
+			indices_.clear();
+			names_.clear();
+		}
+
+		static void write_escaped(std::ofstream& file, const std::string& text)
+		{
+			for (const auto c : text)
+			{
+				if (c == '"' || c == '\\') file << '\\' << c;
+				else if (static_cast<unsigned char>(c) < 0x20) file << ' ';
+				else file << c;
+			}
+		}
+
+		// microseconds from the start of the capture, as the format expects
+		double micro(int64_t time) const
+		{
+			return static_cast<double>(time - start_) / 1000.0;
+		}
+
+		void write()
+		{
+			auto file = std::ofstream(capture_path_, std::ios::trunc);
+			if (!file)
+			{
+				Debug::error("Profiler : failed to open {}", capture_path_);
+				captured_.clear();
+				return;
+			}
+
+			file << std::fixed;
+			file.precision(3);
+			file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+			auto first = true;
+			const auto separator = [&file, &first]
+			{
+				if (!first) file << ",\n";
+				first = false;
+			};
+
+			for (const auto& track : tracks_)
+			{
+				separator();
+				file << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << track.id << R"(,"args":{"name":")";
+				write_escaped(file, track.name);
+				file << "\"}}";
+			}
+
+			for (const auto& event : captured_)
+			{
+				separator();
+				file << "{\"name\":\"";
+				write_escaped(file, strings_[event.name_index]);
+				file << "\",\"pid\":1,\"tid\":" << event.track << ",\"ts\":" << micro(event.begin);
+
+				switch (event.kind)
+				{
+				case profile_kind::zone:
+					file << ",\"ph\":\"X\",\"dur\":" << static_cast<double>(event.end - event.begin) / 1000.0 << '}';
+					break;
+				case profile_kind::counter:
+					file << ",\"ph\":\"C\",\"args\":{\"value\":" << event.value << "}}";
+					break;
+				case profile_kind::frame:
+					file << ",\"ph\":\"i\",\"s\":\"g\"}";
+					break;
+				}
+			}
+
+			file << "\n]}\n";
+
+			Debug::log("Profiler : wrote {} events over {} frames to {}, {} dropped", captured_.size(), frames_, capture_path_,
+				dropped_.load(std::memory_order_relaxed));
+
+			captured_.clear();
+			strings_.clear();
+			indices_.clear();
+			names_.clear();
+		}
+
+		std::atomic<bool> capturing_ = false;
+		std::atomic<uint64_t> dropped_ = 0;
+
+		// rings, tracks and the capture request
+		std::mutex mutex_;
+		std::vector<std::unique_ptr<ring>> rings_;
+		std::vector<profile_track> tracks_;
+		uint32_t next_track_ = 1;
+		uint32_t requested_frames_ = 0;
+		std::string path_;
+
+		// main thread only
+		uint32_t capture_frames_ = 0;
+		uint32_t frames_ = 0;
+		std::string capture_path_;
+		int64_t start_ = 0;
+		std::vector<captured_event> captured_;
+		std::vector<std::string> strings_;
+		std::unordered_map<std::string, uint32_t> indices_;
+		std::unordered_map<const char*, uint32_t> names_;
+	};
+
+	// --
+
+	// times the scope it is declared in, costs nothing past the null check while no capture runs
+	class profile_zone
+	{
+	public:
+		explicit profile_zone(const char* name)
+			: profiler_(profiler::active()), name_(name), begin_(profiler_ != nullptr ? profiler::now() : 0) {}
+
+		~profile_zone()
+		{
+			if (profiler_ != nullptr) profiler_->zone(name_, begin_, profiler::now());
+		}
+
+		profile_zone(const profile_zone&) = delete;
+		profile_zone& operator=(const profile_zone&) = delete;
+
+	private:
+		profiler* profiler_ = nullptr;
+		const char* name_ = nullptr;
+		int64_t begin_ = 0;
+	};
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if MYTHOS_PROFILE
+
+// a zone from here to the end of the scope
+#define PROFILE_ZONE(name) const auto PROFILE_CONCAT(profile_zone_, __COUNTER__) = Mythos::profile_zone(name)
+
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+
+#define PROFILE_COUNTER(name, value) \
+	do { if (auto* profile_active = Mythos::profiler::active()) profile_active->counter(name, static_cast<double>(value)); } while (false)
+
+// once a frame on the main thread
+#define PROFILE_FRAME() \
+	do { if (auto* profile_found = Mythos::profiler::find()) profile_found->frame(); } while (false)
+
+#define PROFILE_THREAD(name) \
+	do { if (auto* profile_found = Mythos::profiler::find()) profile_found->name_thread(name); } while (false)
+
+#else
+
+#define PROFILE_ZONE(name)
+#define PROFILE_FUNCTION()
+#define PROFILE_COUNTER(name, value)
+#define PROFILE_FRAME()
+#define PROFILE_THREAD(name)
+
+#endif
@@ -3,12 +3,10 @@
 // --
 namespace Mythos
 {
-	// shared memory keys
-	const std::string DEBUG_LOG_KEY = "DEBUG_LOG_KEY";
-	const std::string DEBUG_WARN_KEY = "DEBUG_WARN_KEY";
-	const std::string DEBUG_ERROR_KEY = "DEBUG_ERROR_KEY";
-	const std::string DEBUG_ASSERT_KEY = "DEBUG_ASSERT_KEY";
-	const std::string DEBUG_EXCEPTION_KEY = "DEBUG_EXCEPTION_KEY";
+	// shared memory keys, the process id is appended
+	const std::string LOGGER_KEY = "MYTHOS_LOGGER_";
+	const std::string PROFILER_KEY = "MYTHOS_PROFILER_";
+	const std::string LOG_CHANNEL_KEY = "MYTHOS_LOG_";
 
 
 	// priority ranges for modules and layers
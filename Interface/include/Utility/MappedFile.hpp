@@ -0,0 +1,136 @@
+#pragma once
+
+// Microsoft
+#include <Windows.h>
+
+// STL
+#include <cstddef>
+#include <string>
+#include <utility>
+
+// --
+namespace Mythos::Utility
+{
+	// --
+
+	// read only view of a whole file, the OS pages it in on first touch instead of copying it through a read buffer
+	class mapped_file
+	{
+	public:
+		mapped_file() = default;
+		~mapped_file();
+
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+
+		mapped_file(mapped_file&& other) noexcept;
+		mapped_file& operator=(mapped_file&& other) noexcept;
+
+		bool open(const std::string& path);
+		void close();
+
+		// faults every page in on the calling thread, so a later copy out of the view does not stall on disk
+		void prefetch() const;
+
+		const void* data() const { return view_; }
+		size_t size() const { return size_; }
+		bool is_open() const { return view_ != nullptr; }
+
+	private:
+		HANDLE file_ = INVALID_HANDLE_VALUE;
+		HANDLE mapping_ = nullptr;
+		const void* view_ = nullptr;
+		size_t size_ = 0;
+	};
+
+	inline mapped_file::~mapped_file()
+	{
+		close();
+	}
+
+	inline mapped_file::mapped_file(mapped_file&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	inline mapped_file& mapped_file::operator=(mapped_file&& other) noexcept
+	{
+		if (this == &other) return *this;
+
+		close();
+
+		file_ = std::exchange(other.file_, INVALID_HANDLE_VALUE);
+		mapping_ = std::exchange(other.mapping_, nullptr);
+		view_ = std::exchange(other.view_, nullptr);
+		size_ = std::exchange(other.size_, 0);
+		return *this;
+	}
+
+	inline bool mapped_file::open(const std::string& path)
+	{
+		close();
+
+		file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		                    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+		if (file_ == INVALID_HANDLE_VALUE) return false;
+
+		auto size = LARGE_INTEGER();
+		if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0)
+		{
+			close();
+			return false;
+		}
+
+		mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping_ == nullptr)
+		{
+			close();
+			return false;
+		}
+
+		view_ = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+		if (view_ == nullptr)
+		{
+			close();
+			return false;
+		}
+
+		size_ = static_cast<size_t>(size.QuadPart);
+		return true;
+	}
+
+	inline void mapped_file::close()
+	{
+		if (view_ != nullptr)
+		{
+			UnmapViewOfFile(view_);
+			view_ = nullptr;
+		}
+
+		if (mapping_ != nullptr)
+		{
+			CloseHandle(mapping_);
+			mapping_ = nullptr;
+		}
+
+		if (file_ != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(file_);
+			file_ = INVALID_HANDLE_VALUE;
+		}
+
+		size_ = 0;
+	}
+
+	inline void mapped_file::prefetch() const
+	{
+		constexpr size_t page_size = 4096;
+
+		const auto* bytes = static_cast<const volatile std::byte*>(view_);
+		for (size_t offset = 0; offset < size_; offset += page_size)
+		{
+			static_cast<void>(bytes[offset]);
+		}
+	}
+}
@@ -68,6 +68,9 @@ namespace Mythos::Utility
 
 	void UnloadModule(const std::unique_ptr<Module>& module)
 	{
+		// queued records point at format strings inside the module
+		Debug::flush();
+
 		auto result = FreeLibrary(module->handle);
 
 		if (result = false)
@@ -135,6 +138,14 @@ namespace Mythos::Utility
 				continue;
 			}
 
+			module->layer_ptr = layer.get();
+
+			// expose the layer's interface through the module descriptor
+			if (module->GetInterface)
+			{
+				module->interface_ptr = module->GetInterface(*layer);
+			}
+
 			layers.push_back(std::move(layer));
 		}
 
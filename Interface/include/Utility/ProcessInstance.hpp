@@ -0,0 +1,114 @@
+#pragma once
+
+// Microsoft
+#ifdef _WIN64
+#define WIN64_LEAN_AND_MEAN
+#include <Windows.h>
+#endif
+
+// STL
+#include <atomic>
+#include <cstring>
+#include <string>
+
+// --
+namespace Mythos::Utility
+{
+	// --
+
+	// one object of T per process that every module can reach
+	// each dll has its own statics, so the pointer is published through a named mapping private to the process and
+	// each module looks it up once then caches it, on posix shared objects already share the static
+	template <typename T>
+	class process_instance
+	{
+	public:
+		// the instance or nullptr before one is published, the lookup repeats until one is
+		static T* find(const std::string& key)
+		{
+			if (auto* found = found_.load(std::memory_order_acquire)) return found;
+
+			auto* found = lookup(key);
+			found_.store(found, std::memory_order_release);
+			return found;
+		}
+
+		// as find but a miss is kept too, the lookup happens once per module
+		// for hot paths whose instance is published at startup, before any module asks for it
+		static T* find_cached(const std::string& key)
+		{
+			if (auto* found = found_.load(std::memory_order_acquire)) return found;
+			if (searched_.load(std::memory_order_acquire)) return nullptr;
+
+			auto* found = lookup(key);
+			found_.store(found, std::memory_order_release);
+			searched_.store(true, std::memory_order_release);
+			return found;
+		}
+
+		// instance must outlive every module that may find it, withdraw before it is destroyed
+		static void publish(const std::string& key, T* instance)
+		{
+#ifdef _WIN64
+			mapping_ = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(T*), name(key).c_str());
+			if (mapping_ == nullptr) return;
+
+			auto* view = MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(T*));
+			if (view == nullptr) return;
+
+			std::memcpy(view, &instance, sizeof(T*));
+			UnmapViewOfFile(view);
+#endif
+
+			found_.store(instance, std::memory_order_release);
+		}
+
+		static void withdraw()
+		{
+			found_.store(nullptr, std::memory_order_release);
+
+#ifdef _WIN64
+			if (mapping_ != nullptr)
+			{
+				CloseHandle(mapping_);
+				mapping_ = nullptr;
+			}
+#endif
+		}
+
+	private:
+		static T* lookup(const std::string& key)
+		{
+			auto* found = static_cast<T*>(nullptr);
+
+#ifdef _WIN64
+			auto* mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name(key).c_str());
+			if (mapping == nullptr) return nullptr;
+
+			if (auto* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, sizeof(T*)))
+			{
+				std::memcpy(&found, view, sizeof(T*));
+				UnmapViewOfFile(view);
+			}
+
+			CloseHandle(mapping);
+#endif
+
+			return found;
+		}
+
+#ifdef _WIN64
+		static std::string name(const std::string& key)
+		{
+			return key + std::to_string(GetCurrentProcessId());
+		}
+
+		// held by the module that published
+		inline static HANDLE mapping_ = nullptr;
+#endif
+
+		// per module on windows
+		inline static std::atomic<T*> found_ = nullptr;
+		inline static std::atomic<bool> searched_ = false;
+	};
+}
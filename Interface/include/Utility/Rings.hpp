@@ -0,0 +1,312 @@
+#pragma once
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+
+// --
+namespace Mythos::Utility
+{
+	// --
+
+	// head and tail apart, a producer writing one does not evict the consumer reading the other
+	constexpr size_t CACHE_LINE = 64;
+
+	// byte or slot counts that only grow, the offset in the ring is the count modulo the capacity
+	// kept beside the storage so a ring can sit in memory another process maps, see IPC::ipc_channel
+	struct ring_positions
+	{
+		alignas(CACHE_LINE) std::atomic<uint64_t> head = 0;
+		alignas(CACHE_LINE) std::atomic<uint64_t> tail = 0;
+	};
+
+	// --
+
+	// bounded byte ring for one producer thread and one consumer, records are variable length and never split by the wrap
+	// a record that does not fit before the end pads the rest of the lap, a full ring refuses it instead of waiting
+	// the producer writes in place between reserve and commit, the consumer reads in place between front and pop
+	class byte_ring
+	{
+	public:
+		// every record is framed as its size and its length, the frame keeps the next one aligned
+		struct frame
+		{
+			uint32_t size = 0;      // the whole frame, a multiple of the frame header so headers stay aligned
+			uint32_t length = 0;    // the record's bytes, or SKIP
+		};
+
+		static constexpr uint32_t SKIP = UINT32_MAX;
+
+		byte_ring() = default;
+
+		// owns its storage, rounded up to a power of two
+		explicit byte_ring(uint32_t capacity)
+			: owned_bytes_(std::make_unique<std::byte[]>(std::bit_ceil(std::max(capacity, 256u)))),
+			  owned_positions_(std::make_unique<ring_positions>())
+		{
+			bind(owned_bytes_.get(), std::bit_ceil(std::max(capacity, 256u)), owned_positions_.get());
+		}
+
+		// over storage someone else owns, capacity is a power of two
+		byte_ring(std::byte* bytes, uint32_t capacity, ring_positions* positions)
+		{
+			bind(bytes, capacity, positions);
+		}
+
+		byte_ring(byte_ring&&) noexcept = default;
+		byte_ring& operator=(byte_ring&&) noexcept = default;
+
+		// producer, length bytes to write the record into or nullptr when full, published by commit
+		std::byte* reserve(uint32_t length)
+		{
+			const auto size = frame_size(length);
+			if (size > capacity_ / 2) return nullptr;
+
+			auto tail = positions_->tail.load(std::memory_order_relaxed);
+			const auto free = capacity_ - static_cast<uint32_t>(tail - positions_->head.load(std::memory_order_acquire));
+			const auto to_end = capacity_ - static_cast<uint32_t>(tail & (capacity_ - 1));
+
+			if (to_end < size)
+			{
+				if (free < to_end + size) return nullptr;
+
+				// the consumer skips to the start of the next lap
+				write_frame(tail, { to_end, SKIP });
+				tail += to_end;
+				positions_->tail.store(tail, std::memory_order_release);
+			}
+			else if (free < size)
+			{
+				return nullptr;
+			}
+
+			write_frame(tail, { size, length });
+			return &bytes_[(tail & (capacity_ - 1)) + sizeof(frame)];
+		}
+
+		// producer, publishes the record last reserved
+		void commit()
+		{
+			const auto tail = positions_->tail.load(std::memory_order_relaxed);
+			positions_->tail.store(tail + read_frame(tail).size, std::memory_order_release);
+		}
+
+		// consumer, the oldest record or an empty span, it stays valid until pop
+		std::span<const std::byte> front()
+		{
+			for (;;)
+			{
+				const auto head = positions_->head.load(std::memory_order_relaxed);
+				if (head == positions_->tail.load(std::memory_order_acquire)) return {};
+
+				const auto found = read_frame(head);
+
+				if (found.length == SKIP)
+				{
+					positions_->head.store(head + found.size, std::memory_order_release);
+					continue;
+				}
+
+				return { &bytes_[(head & (capacity_ - 1)) + sizeof(frame)], found.length };
+			}
+		}
+
+		// consumer, frees the record front returned
+		void pop()
+		{
+			const auto head = positions_->head.load(std::memory_order_relaxed);
+			positions_->head.store(head + read_frame(head).size, std::memory_order_release);
+		}
+
+		uint32_t capacity() const
+		{
+			return capacity_;
+		}
+
+	private:
+		void bind(std::byte* bytes, uint32_t capacity, ring_positions* positions)
+		{
+			bytes_ = bytes;
+			capacity_ = capacity;
+			positions_ = positions;
+		}
+
+		static uint32_t frame_size(uint32_t length)
+		{
+			const auto size = static_cast<uint64_t>(sizeof(frame)) + length;
+			return static_cast<uint32_t>(std::min<uint64_t>((size + sizeof(frame) - 1) & ~(sizeof(frame) - 1), UINT32_MAX));
+		}
+
+		void write_frame(uint64_t position, frame value)
+		{
+			std::memcpy(&bytes_[position & (capacity_ - 1)], &value, sizeof(frame));
+		}
+
+		frame read_frame(uint64_t position) const
+		{
+			auto value = frame();
+			std::memcpy(&value, &bytes_[position & (capacity_ - 1)], sizeof(frame));
+			return value;
+		}
+
+		std::unique_ptr<std::byte[]> owned_bytes_;
+		std::unique_ptr<ring_positions> owned_positions_;
+
+		std::byte* bytes_ = nullptr;
+		uint32_t capacity_ = 0;
+		ring_positions* positions_ = nullptr;
+	};
+
+	// --
+
+	// bounded ring of fixed size slots for any number of producer threads and one consumer
+	// producers claim a slot with a compare exchange on the tail and publish it through the slot's sequence number,
+	// the consumer stops at the first slot still being written rather than waiting for it
+	class slot_ring
+	{
+	public:
+		// leads every slot, the payload follows
+		struct slot
+		{
+			std::atomic<uint64_t> sequence = 0;
+			uint32_t length = 0;
+			uint32_t reserved = 0;
+		};
+
+		static size_t stride(uint32_t slot_size)
+		{
+			return (sizeof(slot) + slot_size + alignof(slot) - 1) & ~(alignof(slot) - 1);
+		}
+
+		static size_t storage_size(uint32_t capacity, uint32_t slot_size)
+		{
+			return capacity * stride(slot_size);
+		}
+
+		slot_ring() = default;
+
+		// owns its storage, capacity is rounded up to a power of two
+		slot_ring(uint32_t capacity, uint32_t slot_size)
+			: owned_positions_(std::make_unique<ring_positions>())
+		{
+			capacity = std::bit_ceil(std::max(capacity, 2u));
+			owned_bytes_ = std::make_unique<std::byte[]>(storage_size(capacity, slot_size));
+
+			bind(owned_bytes_.get(), capacity, slot_size, owned_positions_.get());
+			initialise();
+		}
+
+		// over storage someone else owns, capacity is a power of two, initialised once by whoever lays it out
+		slot_ring(std::byte* bytes, uint32_t capacity, uint32_t slot_size, ring_positions* positions)
+		{
+			bind(bytes, capacity, slot_size, positions);
+		}
+
+		slot_ring(slot_ring&&) noexcept = default;
+		slot_ring& operator=(slot_ring&&) noexcept = default;
+
+		void initialise()
+		{
+			for (uint64_t i = 0; i < capacity_; i++)
+			{
+				new (&bytes_[i * stride_]) slot();
+				cell(i).sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		// any thread, write(std::byte*) fills length bytes of the claimed slot, false when full or larger than a slot
+		template <typename F>
+		bool push(uint32_t length, F&& write)
+		{
+			if (length > slot_size_) return false;
+
+			auto tail = positions_->tail.load(std::memory_order_relaxed);
+
+			for (;;)
+			{
+				auto& claimed = cell(tail);
+				const auto sequence = claimed.sequence.load(std::memory_order_acquire);
+				const auto distance = static_cast<int64_t>(sequence - tail);
+
+				if (distance == 0)
+				{
+					// the slot is free for this lap, claim it unless another producer got there first
+					if (positions_->tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+					{
+						claimed.length = length;
+						write(payload_of(claimed));
+						claimed.sequence.store(tail + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (distance < 0)
+				{
+					// the consumer has not freed the slot from the last lap, the ring is full
+					return false;
+				}
+				else
+				{
+					tail = positions_->tail.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		// consumer, hands the oldest payload to handle(std::span<const std::byte>) where it sits, false when empty
+		template <typename F>
+		bool pop(F&& handle)
+		{
+			const auto head = positions_->head.load(std::memory_order_relaxed);
+
+			auto& claimed = cell(head);
+			if (claimed.sequence.load(std::memory_order_acquire) != head + 1) return false;
+
+			handle(std::span<const std::byte>(payload_of(claimed), claimed.length));
+
+			// free for the producers' next lap
+			claimed.sequence.store(head + capacity_, std::memory_order_release);
+			positions_->head.store(head + 1, std::memory_order_relaxed);
+			return true;
+		}
+
+		uint32_t capacity() const
+		{
+			return capacity_;
+		}
+
+	private:
+		void bind(std::byte* bytes, uint32_t capacity, uint32_t slot_size, ring_positions* positions)
+		{
+			bytes_ = bytes;
+			capacity_ = capacity;
+			slot_size_ = slot_size;
+			stride_ = stride(slot_size);
+			positions_ = positions;
+		}
+
+		slot& cell(uint64_t position) const
+		{
+			return *std::launder(reinterpret_cast<slot*>(&bytes_[(position & (capacity_ - 1)) * stride_]));
+		}
+
+		static std::byte* payload_of(slot& claimed)
+		{
+			return reinterpret_cast<std::byte*>(&claimed) + sizeof(slot);
+		}
+
+		std::unique_ptr<std::byte[]> owned_bytes_;
+		std::unique_ptr<ring_positions> owned_positions_;
+
+		std::byte* bytes_ = nullptr;
+		uint32_t capacity_ = 0;
+		uint32_t slot_size_ = 0;
+		size_t stride_ = 0;
+		ring_positions* positions_ = nullptr;
+	};
+}
@@ -0,0 +1,37 @@
+#include "job_layer.hpp"
+
+#include "Debug.hpp"
+
+// --
+namespace Mythos
+{
+	//--
+
+	job_layer::job_layer()
+	{
+		Debug::log_header("Job Layer : Creating the job layer");
+
+		thread_pool_ = std::make_unique<Scheduler::thread_pool>();
+	}
+
+	job_layer::~job_layer()
+	{
+		Debug::log_header("Job Layer : Destroying the job layer");
+	}
+
+	void job_layer::update(float dt)
+	{
+
+	}
+
+	void job_layer::render(float alpha)
+	{
+
+	}
+
+	job_system& job_layer::jobs()
+	{
+		return *thread_pool_;
+	}
+
+}
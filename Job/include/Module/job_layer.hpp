@@ -0,0 +1,31 @@
+#pragma once
+
+// STL
+#include <memory>
+
+// Interface
+#include "Module/layer.hpp"
+
+// Scheduler
+#include "Scheduler/thread_pool.hpp"
+
+// --
+namespace Mythos
+{
+	// --
+
+	class job_layer : public layer
+	{
+	public:
+		job_layer();
+		~job_layer() override;
+
+		void update(float dt) override;
+		void render(float alpha) override;
+
+		job_system& jobs();
+
+	private:
+		std::unique_ptr<Scheduler::thread_pool> thread_pool_;
+	};
+}
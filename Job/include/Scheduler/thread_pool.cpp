@@ -0,0 +1,152 @@
+#include "Scheduler/thread_pool.hpp"
+
+// STL
+#include <string>
+
+#include "Debug.hpp"
+#include "Profile/profiler.hpp"
+
+// --
+namespace Mythos::Scheduler
+{
+	// index of the calling thread's queue, 0 for threads the pool does not own
+	static thread_local uint32_t tls_queue_index = 0;
+
+	thread_pool::thread_pool(uint32_t thread_count)
+	{
+		if (thread_count == 0)
+		{
+			const auto hardware = std::thread::hardware_concurrency();
+			thread_count = hardware > 1 ? hardware - 1 : 1;
+		}
+
+		for (uint32_t i = 0; i < thread_count + 1; i++)
+		{
+			queues_.push_back(std::make_unique<work_stealing_queue>());
+		}
+
+		for (uint32_t i = 1; i < thread_count + 1; i++)
+		{
+			threads_.emplace_back(&thread_pool::worker_main, this, i);
+		}
+
+		Debug::log(" >> Job system started with " + std::to_string(thread_count) + " worker threads");
+	}
+
+	thread_pool::~thread_pool()
+	{
+		// let the workers drain what is left before they exit
+		{
+			std::lock_guard lock(sleep_mutex_);
+			running_ = false;
+		}
+		sleep_cv_.notify_all();
+
+		for (auto& thread : threads_)
+		{
+			thread.join();
+		}
+
+		// anything queued from outside the pool after the workers stopped
+		while (try_execute(0)) {}
+
+		Debug::log(" >> Job system stopped");
+	}
+
+	void thread_pool::run(job* jobs, size_t count, job_counter* counter)
+	{
+		if (count == 0) return;
+
+		if (counter != nullptr)
+		{
+			counter->add(static_cast<int>(count));
+		}
+
+		// counted before they are visible, a worker that pops one first must not take pending_ below zero
+		pending_.fetch_add(static_cast<uint32_t>(count), std::memory_order_release);
+
+		// workers feed their own queue, everyone else the shared one the workers steal from
+		auto& queue = *queues_[tls_queue_index];
+
+		for (size_t i = 0; i < count; i++)
+		{
+			jobs[i].counter = counter;
+			queue.push(std::move(jobs[i]));
+		}
+
+		// take the lock so a worker between its check and its wait cannot miss the wake up
+		{
+			std::lock_guard lock(sleep_mutex_);
+		}
+		count == 1 ? sleep_cv_.notify_one() : sleep_cv_.notify_all();
+	}
+
+	void thread_pool::wait(const job_counter& counter)
+	{
+		// help out rather than block, the caller may be the only thread free to run the jobs
+		while (!counter.is_done())
+		{
+			if (!try_execute(tls_queue_index))
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	bool thread_pool::run_pending()
+	{
+		return try_execute(tls_queue_index);
+	}
+
+	uint32_t thread_pool::worker_count() const
+	{
+		return static_cast<uint32_t>(queues_.size());
+	}
+
+	void thread_pool::worker_main(uint32_t index)
+	{
+		tls_queue_index = index;
+		PROFILE_THREAD("worker " + std::to_string(index));
+
+		while (true)
+		{
+			if (try_execute(index)) continue;
+
+			std::unique_lock lock(sleep_mutex_);
+			sleep_cv_.wait(lock, [this]()
+			{
+				return pending_.load(std::memory_order_acquire) > 0 || !running_;
+			});
+
+			if (!running_ && pending_.load(std::memory_order_acquire) == 0) return;
+		}
+	}
+
+	bool thread_pool::try_execute(uint32_t index)
+	{
+		auto item = queues_[index]->pop();
+
+		// walk the other queues starting next to our own to avoid every thief hitting the same victim
+		const auto size = static_cast<uint32_t>(queues_.size());
+		for (uint32_t i = 1; !item && i < size; i++)
+		{
+			item = queues_[(index + i) % size]->steal();
+		}
+
+		if (!item) return false;
+
+		pending_.fetch_sub(1, std::memory_order_acq_rel);
+		execute(*item);
+		return true;
+	}
+
+	void thread_pool::execute(job& item)
+	{
+		item.function();
+
+		if (item.counter != nullptr)
+		{
+			item.counter->done();
+		}
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+// STL
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Interface
+#include "Job/job_system.hpp"
+
+// Scheduler
+#include "Scheduler/work_stealing_queue.hpp"
+
+// --
+namespace Mythos::Scheduler
+{
+	// --
+
+	class thread_pool final : public job_system
+	{
+	public:
+		// thread_count of zero uses one worker per hardware thread, minus the main thread
+		explicit thread_pool(uint32_t thread_count = 0);
+		~thread_pool() override;
+
+		using job_system::run;
+
+		void run(job* jobs, size_t count, job_counter* counter) override;
+		void wait(const job_counter& counter) override;
+		bool run_pending() override;
+		uint32_t worker_count() const override;
+
+	private:
+		void worker_main(uint32_t index);
+
+		// pops from this thread's queue or steals from another, returns false if nothing was found
+		bool try_execute(uint32_t index);
+
+		static void execute(job& item);
+
+		// queue 0 is shared by every thread that is not a worker
+		std::vector<std::unique_ptr<work_stealing_queue>> queues_;
+		std::vector<std::thread> threads_;
+
+		std::atomic<bool> running_ = true;
+		std::atomic<uint32_t> pending_ = 0;
+
+		std::mutex sleep_mutex_;
+		std::condition_variable sleep_cv_;
+	};
+}
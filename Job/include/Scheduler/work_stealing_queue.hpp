@@ -0,0 +1,51 @@
+#pragma once
+
+// STL
+#include <deque>
+#include <mutex>
+#include <optional>
+
+// Interface
+#include "Job/job_system.hpp"
+
+// --
+namespace Mythos::Scheduler
+{
+	// --
+
+	// owner pushes and pops at the back (LIFO, cache warm)
+	// thieves take from the front (FIFO, oldest and usually largest work first)
+	class work_stealing_queue
+	{
+	public:
+		void push(job&& item)
+		{
+			std::lock_guard lock(mutex_);
+			jobs_.push_back(std::move(item));
+		}
+
+		std::optional<job> pop()
+		{
+			std::lock_guard lock(mutex_);
+			if (jobs_.empty()) return std::nullopt;
+
+			auto item = std::move(jobs_.back());
+			jobs_.pop_back();
+			return item;
+		}
+
+		std::optional<job> steal()
+		{
+			std::lock_guard lock(mutex_);
+			if (jobs_.empty()) return std::nullopt;
+
+			auto item = std::move(jobs_.front());
+			jobs_.pop_front();
+			return item;
+		}
+
+	private:
+		std::mutex mutex_;
+		std::deque<job> jobs_;
+	};
+}
@@ -1,5 +1,10 @@
 #include "Module/platform_layer.hpp"
 
+// Interface
+#include "Event/input_events.hpp"
+#include "Module/Module.hpp"
+#include "Utility/Constants.hpp"
+
 #include "WindowsOS/Window.hpp"
 
 #include "Debug.hpp"
@@ -13,22 +18,47 @@ Mythos::platform_layer::platform_layer()
 	msg_loop_ = std::make_unique<MessageLoop>();
 	msg_hook_ = std::make_unique<MessageHook>();
 
-	msg_hook_->InstallKeyboardHook() = []() { std::cout << "[" << __FILE__ << "] Button Press\n"; };
-	/*msg_hook_->InstallMouseHook() = []() { };
-	msg_hook_->InstallSystemHook() = []() { };*/
+	// both publish once attach has found the event module
+	if (!msg_hook_->InstallKeyboardHook())
+	{
+		Debug::error("Platform Layer : failed to install the keyboard hook");
+	}
 
+	if (!msg_hook_->InstallMouseHook())
+	{
+		Debug::error("Platform Layer : failed to install the mouse hook");
+	}
 }
 
 Mythos::platform_layer::~platform_layer()
 {
 	Debug::log_header("Platform Layer : Destroying the platform layer");
+
+	// the hooks outlive the layer until the message hook is destroyed
+	msg_hook_->SetEventBus(nullptr);
+}
+
+void Mythos::platform_layer::attach(const std::vector<std::unique_ptr<Module>>& modules)
+{
+	auto* events = find_interface<event_bus>(modules, EVENT);
+	if (events == nullptr)
+	{
+		Debug::warn("Platform Layer : no event module, input is not published");
+		return;
+	}
+
+	// the low level hooks run on the thread that installed them, the main thread pumping messages
+	events->add_channel<key_event>(256, event_producers::single);
+	events->add_channel<mouse_event>(1024, event_producers::single);
+
+	msg_hook_->SetEventBus(events);
 }
 
-void Mythos::platform_layer::update()
+void Mythos::platform_layer::update(float dt)
 {
 	msg_loop_->Update();
 }
 
-void Mythos::platform_layer::render()
+void Mythos::platform_layer::render(float alpha)
 {
 }
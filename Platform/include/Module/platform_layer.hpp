@@ -23,8 +23,10 @@ namespace Mythos
 		platform_layer();
 		~platform_layer() override;
 
-		void update() override;
-		void render() override;
+		void attach(const std::vector<std::unique_ptr<Module>>& modules) override;
+
+		void update(float dt) override;
+		void render(float alpha) override;
 		
 	private:
 		std::unique_ptr<Window> window_;
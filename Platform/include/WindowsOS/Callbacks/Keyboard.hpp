@@ -3,60 +3,31 @@
 // Microsoft
 #include <Windows.h>
 
-// STL
-#include <iostream>
-
-struct KeyboardEvent 
-{
-	ULONG code;
-
-}; // temporary move to interface lib
-
+// Interface
+#include "Event/event_bus.hpp"
+#include "Event/input_events.hpp"
 
 namespace Mythos::Platform::Keyboard
 {
-
-	// function pointer
-	typedef void (*KeyboardEventCallback)(const KeyboardEvent&);
-
-	// event calback 
-	KeyboardEventCallback Callback;
-
-	void SetCallback(const KeyboardEventCallback& callback)
-	{
-		Callback = callback;
-	}
-
-	// invoker 
-	void OnEvent(const KeyboardEvent& event)
-	{
-		if (!Callback) return;
-		Callback(event);
-	}
+	// set by the platform layer once the event module is attached, keys are dropped until then
+	event_bus* Events = nullptr;
 
 	HHOOK Hook; 
 
 	LRESULT CALLBACK Proc(int nCode, WPARAM wParam, LPARAM lParam)
 	{
-		if (nCode == HC_ACTION)
+		if (nCode == HC_ACTION && Events != nullptr)
 		{
-			auto* lData = (KBDLLHOOKSTRUCT*)lParam;
+			const auto* data = reinterpret_cast<KBDLLHOOKSTRUCT*>(lParam);
 
-			auto data = KeyboardEvent
+			// the hook has to return quickly or windows removes it, publishing only writes to a ring
+			if (wParam == WM_KEYDOWN || wParam == WM_SYSKEYDOWN)
 			{
-				.code = lData->vkCode
-			};
-
-			if (wParam == WM_KEYDOWN)
-			{
-				OnEvent(data);
-
-				std::cout << "Key down event: " << data.code << std::endl;
+				Events->publish(key_event{ .code = static_cast<uint32_t>(data->vkCode), .pressed = true });
 			}
-			else if (wParam == WM_KEYUP)
+			else if (wParam == WM_KEYUP || wParam == WM_SYSKEYUP)
 			{
-				auto* pKeyboard = (KBDLLHOOKSTRUCT*)lParam;
-				std::cout << "Key up event: " << pKeyboard->vkCode << std::endl;
+				Events->publish(key_event{ .code = static_cast<uint32_t>(data->vkCode), .pressed = false });
 			}
 		}
 
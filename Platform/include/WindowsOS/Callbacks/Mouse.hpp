@@ -3,64 +3,71 @@
 // Microsoft
 #include <Windows.h>
 
-// STL
-#include <iostream>
+// Interface
+#include "Event/event_bus.hpp"
+#include "Event/input_events.hpp"
 
 namespace Mythos::Platform::Mouse
 {
+	// set by the platform layer once the event module is attached, input is dropped until then
+	event_bus* Events = nullptr;
+
 	HHOOK Hook;
 
 	LRESULT CALLBACK Proc(int nCode, WPARAM wParam, LPARAM lParam)
 	{
-		if (nCode != HC_ACTION)
+		if (nCode != HC_ACTION || Events == nullptr)
 		{
 			return CallNextHookEx(NULL, nCode, wParam, lParam);
 		}
 
-		POINT p;
-		GetCursorPos(&p);
+		const auto* data = reinterpret_cast<MSLLHOOKSTRUCT*>(lParam);
+
+		POINT p = data->pt;
 		ScreenToClient(GetForegroundWindow(), &p);
 
+		auto event = mouse_event{ .x = static_cast<int32_t>(p.x), .y = static_cast<int32_t>(p.y) };
+
 		switch (wParam)
 		{
 		case WM_MOUSEMOVE:
-			std::cout << "Move" << p.x << "," << p.y << std::endl;
+			event.action = mouse_action::move;
 			break;
 
 		case WM_LBUTTONDOWN:
-			std::cout << "Left Down" << std::endl;
-			break;
-
-		case WM_LBUTTONUP:
-			std::cout << "Left Down" << std::endl;
-			break;
-
 		case WM_RBUTTONDOWN:
-			std::cout << "Right Down" << std::endl;
+		case WM_MBUTTONDOWN:
+			event.action = mouse_action::button_down;
 			break;
 
+		case WM_LBUTTONUP:
 		case WM_RBUTTONUP:
-			std::cout << "Right Down" << std::endl;
+		case WM_MBUTTONUP:
+			event.action = mouse_action::button_up;
 			break;
 
 		case WM_MOUSEWHEEL:
-			std::cout << "MouseWheel Verticle" << std::endl;
-			break;
-
 		case WM_MOUSEHWHEEL:
-			std::cout << "MouseWheel Horizontal" << std::endl;
+			event.action = mouse_action::wheel;
+			event.wheel = GET_WHEEL_DELTA_WPARAM(data->mouseData) / WHEEL_DELTA;
+			event.horizontal = wParam == WM_MOUSEHWHEEL;
 			break;
 
-		case WM_VSCROLL:
-			std::cout << "Scroll Verticle" << std::endl;
-			break;
+		default:
+			return CallNextHookEx(nullptr, nCode, wParam, lParam);
+		}
 
-		case WM_HSCROLL:
-			std::cout << "Scroll Horizontal" << std::endl;
-			break;
+		switch (wParam)
+		{
+		case WM_LBUTTONDOWN: case WM_LBUTTONUP: event.button = mouse_button::left; break;
+		case WM_RBUTTONDOWN: case WM_RBUTTONUP: event.button = mouse_button::right; break;
+		case WM_MBUTTONDOWN: case WM_MBUTTONUP: event.button = mouse_button::middle; break;
+		default: break;
 		}
 
+		Events->publish(event);
+
 		return CallNextHookEx(nullptr, nCode, wParam, lParam);
 	}
 
-}
\ No newline at end of file
+}
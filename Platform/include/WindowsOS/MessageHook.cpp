@@ -30,23 +30,30 @@ namespace Mythos::Platform
 		}
 	}
 
-	std::function<void()>& MessageHook::InstallKeyboardHook()
+	bool MessageHook::InstallKeyboardHook()
 	{
 		auto hook = SetWindowsHookEx(WH_KEYBOARD_LL, Keyboard::Proc, nullptr, 0);
+		if (hook == nullptr) return false;
+
+		Keyboard::Hook = hook;
 		hook_list_.push_back(hook);
-		return OnKeyboardProc;
+		return true;
 	}
 
-	std::function<void()>& Platform::MessageHook::InstallMouseHook()
+	bool MessageHook::InstallMouseHook()
 	{
 		auto hook = SetWindowsHookEx(WH_MOUSE_LL, Mouse::Proc, GetModuleHandle(NULL), 0);
+		if (hook == nullptr) return false;
+
+		Mouse::Hook = hook;
 		hook_list_.push_back(hook);
-		return OnKeyboardProc;
+		return true;
 	}
 
-	std::function<void()>& Platform::MessageHook::InstallSystemHook()
+	void MessageHook::SetEventBus(event_bus* events)
 	{
-		return OnWindowProc;
+		Keyboard::Events = events;
+		Mouse::Events = events;
 	}
 
 }
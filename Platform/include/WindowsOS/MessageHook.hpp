@@ -1,7 +1,10 @@
 #pragma once
 
 // STL
-#include <functional>
+#include <vector>
+
+// Interface
+#include "Event/event_bus.hpp"
 
 // --
 namespace Mythos::Platform
@@ -13,17 +16,16 @@ namespace Mythos::Platform
 		MessageHook();
 		~MessageHook();
 
-		std::function<void()>& InstallKeyboardHook();
-		std::function<void()>& InstallMouseHook();
-		std::function<void()>& InstallSystemHook();
+		// input only reaches the engine as key_event and mouse_event on the bus, false when windows refuses the hook
+		bool InstallKeyboardHook();
+		bool InstallMouseHook();
+
+		// where the keyboard and mouse hooks publish, null drops their input
+		void SetEventBus(event_bus* events);
 
 	private:
 		std::vector<void*> hook_list_;
 
-		std::function<void()> OnKeyboardProc = nullptr;
-		std::function<void()> OnMouseProc = nullptr;
-		std::function<void()> OnWindowProc = nullptr;
-
 	};
 
 }
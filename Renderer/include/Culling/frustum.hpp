@@ -0,0 +1,52 @@
+#pragma once
+
+// STL
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// GLM
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+// --
+namespace Mythos
+{
+	// --
+
+	// six inward facing planes as (normal, distance), a point p is inside when dot(normal, p) + distance >= 0 for all
+	struct frustum
+	{
+		std::array<glm::vec4, 6> planes = {};
+	};
+
+	// the planes of the clip volume of view_proj, normalized so a plane's distance to a point is in world units
+	// near is z >= 0 as vulkan clips it, whatever depth range the projection was built for
+	auto extract_frustum(const glm::mat4& view_proj) -> frustum;
+
+	// bounding spheres as parallel arrays, the layout the simd test loads four at a time
+	struct sphere_array
+	{
+		std::vector<float> x;
+		std::vector<float> y;
+		std::vector<float> z;
+		std::vector<float> radius;
+
+		size_t size() const { return x.size(); }
+
+		void resize(size_t count)
+		{
+			x.resize(count);
+			y.resize(count);
+			z.resize(count);
+			radius.resize(count);
+		}
+	};
+
+	// sets visible[i] to 1 for every sphere of [begin, end) that touches the frustum and to 0 for the others,
+	// four spheres per step with sse, returns how many are visible
+	auto cull_spheres(const frustum& view, const sphere_array& spheres, uint32_t begin, uint32_t end, uint8_t* visible) -> uint32_t;
+
+	// one sphere at a time, the reference cull_spheres has to agree with
+	auto cull_spheres_scalar(const frustum& view, const sphere_array& spheres, uint32_t begin, uint32_t end, uint8_t* visible) -> uint32_t;
+}
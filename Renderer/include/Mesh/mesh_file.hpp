@@ -0,0 +1,127 @@
+#pragma once
+
+// STL
+#include <cstddef>
+#include <cstdint>
+
+// --
+namespace Mythos
+{
+	// --
+
+	// cooked mesh layout written by the Cooker and mapped straight into memory by the renderer
+	// [header][vertices, aligned][indices, aligned], every integer is little endian
+	// the vertex block is every stream of the vertex layout back to back, see Shader/vertex_layout.hpp
+	constexpr uint32_t MESH_FILE_MAGIC = 0x48534D4D; // "MMSH"
+	constexpr uint32_t MESH_FILE_VERSION = 2;
+	constexpr uint64_t MESH_FILE_ALIGNMENT = 16;
+
+	constexpr const char* MESH_FILE_EXTENSION = ".mesh";
+
+	enum class mesh_index_type : uint32_t
+	{
+		uint16 = 0,
+		uint32 = 1,
+	};
+
+	struct mesh_file_header
+	{
+		uint32_t magic = MESH_FILE_MAGIC;
+		uint32_t version = MESH_FILE_VERSION;
+
+		uint32_t vertex_layout = 0;  // vertex_layout::id
+		uint32_t vertex_stride = 0;
+		uint32_t vertex_count = 0;
+
+		mesh_index_type index_type = mesh_index_type::uint32;
+		uint32_t index_count = 0;
+		uint32_t reserved = 0;
+
+		// byte offsets from the start of the file
+		uint64_t vertex_offset = 0;
+		uint64_t vertex_bytes = 0;   // including the padding between streams
+		uint64_t index_offset = 0;
+
+		// positions quantized against the bounds are decoded with them
+		float bounds_min[3] = {};
+		float bounds_max[3] = {};
+	};
+
+	static_assert(sizeof(mesh_file_header) == 80, "mesh_file_header is read straight from disk, keep its layout fixed");
+
+	// pointers into a mapped mesh file, valid for as long as the mapping is
+	struct mesh_file_view
+	{
+		const mesh_file_header* header = nullptr;
+
+		const void* vertices = nullptr;
+		uint64_t vertex_bytes = 0;
+
+		const void* indices = nullptr;
+		uint64_t index_bytes = 0;
+	};
+
+	inline auto mesh_index_size(mesh_index_type type) -> uint32_t
+	{
+		return type == mesh_index_type::uint16 ? 2 : 4;
+	}
+
+	inline auto align_mesh_offset(uint64_t offset) -> uint64_t
+	{
+		return (offset + MESH_FILE_ALIGNMENT - 1) & ~(MESH_FILE_ALIGNMENT - 1);
+	}
+
+	// whether every index names one of the vertex_count vertices, indices start on a MESH_FILE_ALIGNMENT boundary
+	template <typename Index>
+	auto mesh_indices_in_range(const void* indices, uint32_t index_count, uint32_t vertex_count) -> bool
+	{
+		const auto* first = static_cast<const Index*>(indices);
+
+		// a running maximum rather than an early exit, the loop vectorizes
+		auto highest = Index(0);
+		for (uint32_t i = 0; i < index_count; i++)
+		{
+			highest = first[i] > highest ? first[i] : highest;
+		}
+
+		return index_count == 0 || highest < vertex_count;
+	}
+
+	// checks the header against the file size and the vertex layout the caller expects, and every index against the
+	// vertex count so a corrupt or mismatched file cannot make the gpu fetch past the vertex buffer, no data is copied
+	inline auto read_mesh_file(const void* data, size_t size, uint32_t vertex_layout, uint32_t vertex_stride,
+	                           mesh_file_view& view) -> bool
+	{
+		if (data == nullptr || size < sizeof(mesh_file_header)) return false;
+
+		const auto* header = static_cast<const mesh_file_header*>(data);
+
+		if (header->magic != MESH_FILE_MAGIC || header->version != MESH_FILE_VERSION) return false;
+		if (header->vertex_layout != vertex_layout || header->vertex_stride != vertex_stride) return false;
+		if (header->index_type != mesh_index_type::uint16 && header->index_type != mesh_index_type::uint32) return false;
+
+		const auto vertex_bytes = header->vertex_bytes;
+		const auto index_bytes = static_cast<uint64_t>(header->index_count) * mesh_index_size(header->index_type);
+
+		if (vertex_bytes < static_cast<uint64_t>(header->vertex_count) * header->vertex_stride) return false;
+		if (header->vertex_offset % MESH_FILE_ALIGNMENT != 0 || header->index_offset % MESH_FILE_ALIGNMENT != 0) return false;
+		if (header->vertex_offset < sizeof(mesh_file_header) || header->vertex_offset + vertex_bytes > size) return false;
+		if (header->index_offset < header->vertex_offset + vertex_bytes || header->index_offset + index_bytes > size) return false;
+
+		const auto* bytes = static_cast<const std::byte*>(data);
+		const auto* indices = bytes + header->index_offset;
+
+		const auto in_range = header->index_type == mesh_index_type::uint16 ?
+			mesh_indices_in_range<uint16_t>(indices, header->index_count, header->vertex_count) :
+			mesh_indices_in_range<uint32_t>(indices, header->index_count, header->vertex_count);
+
+		if (!in_range) return false;
+
+		view.header = header;
+		view.vertices = bytes + header->vertex_offset;
+		view.vertex_bytes = vertex_bytes;
+		view.indices = indices;
+		view.index_bytes = index_bytes;
+		return true;
+	}
+}
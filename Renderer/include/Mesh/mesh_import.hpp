@@ -0,0 +1,29 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Mythos
+#include "Job/job_system.hpp"
+#include "Shader/vertex.hpp"
+
+// --
+namespace Mythos
+{
+	// --
+
+	// parses an obj into one vertex per triangle corner, nothing is shared yet
+	auto import_obj(const std::string& path, std::vector<vertex>& corners, job_system* jobs = nullptr) -> bool;
+
+	// merges identical corners, vertices come out in the order the corners first reference them
+	// the output is the same with or without a job system, only the time it takes changes
+	auto weld_vertices(const std::vector<vertex>& corners, std::vector<vertex>& vertices, std::vector<uint32_t>& indices,
+	                   job_system* jobs = nullptr) -> void;
+
+	// import_obj followed by weld_vertices, shared by the renderer's loading jobs and the Cooker
+	// with a job system the shapes are processed in parallel, null runs everything on the calling thread
+	auto load_model(const std::string& path, std::vector<vertex>& vertices, std::vector<uint32_t>& indices,
+	                job_system* jobs = nullptr) -> bool;
+}
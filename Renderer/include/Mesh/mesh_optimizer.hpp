@@ -0,0 +1,59 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <vector>
+
+// Mythos
+#include "Shader/vertex.hpp"
+
+// --
+namespace Mythos
+{
+	// --
+
+	// entries in the simulated post transform cache, a fifo like most hardware since the unified shader era
+	constexpr uint32_t VERTEX_CACHE_SIZE = 16;
+
+	// a cluster may cost this much more than its hard boundaries allow before it is split for overdraw sorting
+	constexpr float OVERDRAW_THRESHOLD = 1.05f;
+
+	struct vertex_cache_stats
+	{
+		float acmr = 0.0f;      // vertex shader invocations per triangle, 0.5 is the ideal for a regular grid
+		float atvr = 0.0f;      // vertex shader invocations per vertex, 1.0 is the ideal
+		float overfetch = 0.0f; // bytes pulled through a 64 byte line cache per vertex buffer byte, 1.0 is the ideal
+	};
+
+	// measured after each pass, source is the order the importer produced
+	struct mesh_optimize_stats
+	{
+		vertex_cache_stats source;
+		vertex_cache_stats vertex_cache;
+		vertex_cache_stats overdraw;
+		vertex_cache_stats vertex_fetch;
+		uint32_t cluster_count = 0;
+	};
+
+	auto analyze_vertex_cache(const std::vector<uint32_t>& indices, uint32_t vertex_count, uint32_t vertex_stride,
+	                          uint32_t cache_size = VERTEX_CACHE_SIZE) -> vertex_cache_stats;
+
+	// tipsify, reorders triangles so consecutive ones reuse the vertices still in the cache
+	// clusters receives the first triangle of every run that ended in a dead end
+	auto optimize_vertex_cache(std::vector<uint32_t>& indices, uint32_t vertex_count, std::vector<uint32_t>& clusters,
+	                           uint32_t cache_size = VERTEX_CACHE_SIZE) -> void;
+
+	// splits the clusters further while they stay within threshold of their cache efficiency, then draws the
+	// ones facing away from the mesh centre first so they occlude the rest from most view directions
+	auto optimize_overdraw(std::vector<uint32_t>& indices, const std::vector<vertex>& vertices,
+	                       std::vector<uint32_t>& clusters, float threshold = OVERDRAW_THRESHOLD,
+	                       uint32_t cache_size = VERTEX_CACHE_SIZE) -> void;
+
+	// renumbers vertices in the order the index buffer first uses them and drops any that are never referenced
+	auto optimize_vertex_fetch(std::vector<vertex>& vertices, std::vector<uint32_t>& indices) -> void;
+
+	// all three passes in order, stats is optional
+	// vertex_stride is the bytes per vertex of the layout the mesh is drawn with, the stats measure overfetch with it
+	auto optimize_mesh(std::vector<vertex>& vertices, std::vector<uint32_t>& indices,
+	                   mesh_optimize_stats* stats = nullptr, uint32_t vertex_stride = sizeof(vertex)) -> void;
+}
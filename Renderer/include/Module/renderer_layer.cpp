@@ -1,13 +1,21 @@
 #include "Module/renderer_layer.hpp"
 
 // Mythos
+#include "Event/input_events.hpp"
+#include "Job/job_system.hpp"
+#include "Module/Module.hpp"
+#include "Utility/Constants.hpp"
 #include "Vulkan/mythos_vulkan.hpp"
 
+// STL
+#include <string>
+
 // temp
 #include <Windows.h>
 
 #include "Debug.hpp"
 #include "Maths/vectors.hpp"
+#include "Profile/profiler.hpp"
 
 // --
 namespace Mythos
@@ -18,101 +26,112 @@ namespace Mythos
 	{
 		Debug::log_header("Renderer Layer : Creating the renderer layer");
 
-		vulkan_data_ = Mythos::vulkan::make_unique_vulkan_data(true);
+		const auto settings = vulkan::render_settings::from_policy(vulkan::FRAME_POLICY);
+		Debug::log("Renderer Layer : " + std::string(vulkan::policy_name(vulkan::FRAME_POLICY)) + " frame policy");
 
-		auto success = false;
+		vulkan_data_ = Mythos::vulkan::make_unique_vulkan_data(true, settings);
 
 		// TODO: get windows handles by event
 		auto* hwnd = GetForegroundWindow();
 		auto* hmodule = GetModuleHandle(nullptr);
 
-		success = vulkan::create_instance(*vulkan_data_);
-		if (!success) return;
-
-		success = vulkan::create_surface(hmodule, hwnd, *vulkan_data_);
-		if (!success) return;
-
-		success = vulkan::select_physical_device(*vulkan_data_);
-		if (!success) return;
-
-		success = vulkan::create_logical_device(*vulkan_data_);
-		if (!success) return;
-
-		success = vulkan::create_swapchain(hwnd, *vulkan_data_);
-		if (!success) return;
-
-		success = vulkan::create_image_views(*vulkan_data_);
-		if (!success) return;
-
-		success = vulkan::create_render_pass(*vulkan_data_);
-		if (!success) return;
-
-		success = vulkan::create_descriptor_set_layout(*vulkan_data_);
-		if (!success) return;
-
-		success = vulkan::create_graphics_pipeline(*vulkan_data_);
-		if (!success) return;
-
-		success = vulkan::create_command_pool(*vulkan_data_);
-		if (!success) return;
-
-		success = vulkan::create_color_resources(*vulkan_data_);
-		if (!success) return;
-
-		success = vulkan::create_depth_resources(*vulkan_data_);
-		if (!success) return;
-
-		success = vulkan::create_frame_buffers(*vulkan_data_);
-		if (!success) return;
-
-		success = vulkan::create_texture_image(*vulkan_data_);
-		if (!success) return;
-
-		success = vulkan::create_texture_image_view(*vulkan_data_);
-		if (!success) return;
-
-		success = vulkan::create_texture_sampler(*vulkan_data_);
-		if (!success) return;
+		vulkan::create_renderer(hmodule, hwnd, *vulkan_data_);
+	}
 
-		success = vulkan::load_model(*vulkan_data_); // TODO
-		if (!success) return;                        // TODO
+	Mythos::renderer_layer::~renderer_layer()
+	{
+		// the event layer is destroyed after this one
+		if (events_ != nullptr)
+		{
+			events_->unsubscribe(cull_toggle_);
+		}
 
-		success = vulkan::create_vertex_buffer(*vulkan_data_);
-		if (!success) return;
+		vulkan::destroy_vulkan_data(*vulkan_data_);
+	}
 
-		success = vulkan::create_index_buffer(*vulkan_data_);
-		if (!success) return;
+	void Mythos::renderer_layer::attach(const std::vector<std::unique_ptr<Module>>& modules)
+	{
+		// decode on the job module when it is loaded, the first frames draw without the model meanwhile
+		auto* jobs = find_interface<job_system>(modules, JOB);
+		vulkan_data_->jobs = jobs;
 
-		success = vulkan::create_uniform_buffers(*vulkan_data_);
-		if (!success) return;
+		auto& assets = vulkan_data_->assets;
+		assets.set_job_system(jobs);
 
-		success = vulkan::create_descriptor_pool(*vulkan_data_);
-		if (!success) return;
+		vulkan_data_->model = assets.load_mesh(vulkan::MODEL_PATH);
+		vulkan_data_->model_texture = assets.load_texture(vulkan::TEXTURE_PATH);
 
-		success = vulkan::create_descriptor_set(*vulkan_data_);
-		if (!success) return;
+		// F2 switches culling between the compute pass and the cpu, delivered on the main thread before render
+		// the platform layer attaches first and adds the key channel
+		events_ = find_interface<event_bus>(modules, EVENT);
+		if (events_ == nullptr) return;
 
-		success = vulkan::create_command_buffers(*vulkan_data_);
-		if (!success) return;
+		cull_toggle_ = events_->subscribe<key_event>([this](const key_event& event)
+		{
+			if (event.code != VK_F2 || !event.pressed) return;
 
-		success = vulkan::create_sync_objects(*vulkan_data_);
-		if (!success) return;
+			auto& batcher = vulkan_data_->batcher;
+			batcher.set_cull_mode(batcher.culling() == vulkan::cull_mode::gpu ? vulkan::cull_mode::cpu : vulkan::cull_mode::gpu);
+			Debug::log(std::string("Renderer : culling on the ") + (batcher.culling() == vulkan::cull_mode::gpu ? "gpu" : "cpu"));
+		});
 	}
 
-	Mythos::renderer_layer::~renderer_layer()
+	void Mythos::renderer_layer::update(float dt)
 	{
-		vulkan::destroy_vulkan_data(*vulkan_data_);
+		previous_time_ = current_time_;
+		current_time_ += dt;
 	}
 
-	void Mythos::renderer_layer::update()
+	void Mythos::renderer_layer::render(float alpha)
 	{
-	}
+		// blend the last two simulation states so motion stays smooth between fixed updates
+		vulkan_data_->animation_time = previous_time_ + (current_time_ - previous_time_) * alpha;
+
+		vulkan::process_asset_uploads(*vulkan_data_);
 
-	void Mythos::renderer_layer::render()
-	{
 		// todo : if window can be used then;
 		vulkan::draw_frame(GetForegroundWindow(), *vulkan_data_);
 
-		vkDeviceWaitIdle(vulkan_data_->device);
+		PROFILE_COUNTER("draws", vulkan_data_->recorder.stats().draws);
+		PROFILE_COUNTER("visible instances", vulkan_data_->batcher.stats().visible);
+		PROFILE_COUNTER("frame latency ms", vulkan_data_->frame_timings.latency_ms);
+		PROFILE_COUNTER("gpu ms", vulkan_data_->gpu_profile.stats().frame_ms);
+
+#ifdef  _DEBUG
+		if (++frame_count_ % 1000 == 0)
+		{
+			const auto& timings = vulkan_data_->frame_timings;
+			Debug::log("Renderer : {} frames in flight, cpu {}ms, fence wait {}ms, acquire {}ms, frame {}ms, overlap {}, latency {}ms",
+				vulkan_data_->MAX_FRAMES_IN_FLIGHT, timings.cpu_ms, timings.fence_wait_ms, timings.acquire_ms, timings.frame_ms,
+				timings.overlap, timings.latency_ms);
+
+			const auto& gpu = vulkan_data_->gpu_profile.stats();
+			Debug::log("Renderer : gpu {}ms over {} regions, {} dropped", gpu.frame_ms, gpu.regions, gpu.dropped);
+
+			const auto& recording = vulkan_data_->recorder.stats();
+			Debug::log("Renderer : recorded {} draws into {} secondary command buffers in {}ms",
+				recording.draws, recording.secondaries, recording.record_ms);
+
+			const auto& batching = vulkan_data_->batcher.stats();
+			Debug::log("Renderer : {} instances in {} batches, {}",
+				batching.instances, batching.batches, vulkan_data_->batcher.indirect() ? "indirect" : "direct");
+
+			const auto culled_on = vulkan_data_->batcher.culling() == vulkan::cull_mode::gpu ? "gpu" : "cpu";
+			Debug::log("Renderer : {} visible, {} culled on the {}", batching.visible, batching.culled, culled_on);
+
+			if (vulkan_data_->bindless)
+			{
+				Debug::log("Renderer : {} textures in the table, {} descriptor pools", vulkan_data_->textures.texture_count(), vulkan_data_->descriptors.pool_count());
+			}
+			else
+			{
+				Debug::log("Renderer : single texture, {} descriptor pools", vulkan_data_->descriptors.pool_count());
+			}
+
+			const auto& graph = vulkan_data_->graph.stats();
+			Debug::log("Renderer : {} passes, {} image barriers, {} transients in {} allocations",
+				graph.passes - graph.culled, graph.barriers, graph.transients, graph.memory_slots);
+		}
+#endif
 	}
 }
@@ -2,8 +2,10 @@
 
 // STL
 #include <memory>
+#include <vector>
 
 // Mythos
+#include "Event/event_bus.hpp"
 #include "Module/layer.hpp"
 #include "Vulkan/vulkan_data.hpp"
 
@@ -18,12 +20,24 @@ namespace Mythos
 		renderer_layer();
 		~renderer_layer() override;
 
-		void update() override;
-		void render() override;
+		void attach(const std::vector<std::unique_ptr<Module>>& modules) override;
+
+		void update(float dt) override;
+		void render(float alpha) override;
 
 	private:
 		std::unique_ptr<vulkan::vulkan_data> vulkan_data_ {};
 
+		// simulation time at the last two fixed updates
+		float previous_time_ = 0.0f;
+		float current_time_ = 0.0f;
+
+		uint64_t frame_count_ = 0;
+
+		// the event module's bus, null without one, and the key subscription switching the cull mode
+		event_bus* events_ = nullptr;
+		event_subscription cull_toggle_ = {};
+
 	};
 
 }
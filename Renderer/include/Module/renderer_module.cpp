@@ -32,6 +32,8 @@ MODULE_API std::unique_ptr<const Mythos::Module> func(MODULE_HANDLE handle)
 		.dll_date = FILE_DATE,
 		.dll_time = FILE_TIME,
 
+		.reads = { Mythos::PLATFORM },
+
 		.MakeUniqueLayer = []() -> std::unique_ptr<Mythos::layer>
 		{
 			return std::make_unique<Mythos::renderer_layer>();
@@ -0,0 +1,45 @@
+#pragma once
+
+// STL
+#include <cstdint>
+
+// GLM
+#include <glm/mat3x4.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+// one element of the instance storage buffer, laid out as the Instance struct of shader.vert and build_draws.comp
+struct gpu_instance
+{
+    glm::mat3x4 model; // top three rows of the world matrix, a position is transformed as vec4(position, 1) * model
+    uint32_t batch;
+    uint32_t texture;  // slot of the instance's texture in the descriptor table, see Vulkan/descriptor_table.hpp
+    uint32_t padding[2];
+};
+
+static_assert(sizeof(gpu_instance) == 64, "gpu_instance must match the std430 layout of the shaders");
+
+// the bounds of a batch's mesh in the space the instance rows take positions in, quantized or not
+struct gpu_batch
+{
+    glm::vec4 sphere;        // centre and radius, the radius in mesh units
+    glm::vec4 inverse_scale; // undoes the dequantization folded into the rows when measuring the instance's scale
+};
+
+static_assert(sizeof(gpu_batch) == 32, "gpu_batch must match the std430 layout of build_draws.comp");
+
+// per frame parameters of the culling in build_draws.comp, std140
+struct cull_uniforms
+{
+    glm::vec4 planes[6];             // the frame's frustum, see Culling/frustum.hpp
+    glm::mat4 previous_view_proj;    // the view the depth pyramid was built from
+    glm::vec2 pyramid_size;          // texels of the pyramid's first level
+    uint32_t pyramid_levels;
+    uint32_t flags;                  // CULL_FRUSTUM and CULL_OCCLUSION
+};
+
+constexpr uint32_t CULL_FRUSTUM = 1;
+constexpr uint32_t CULL_OCCLUSION = 2;
+
+static_assert(sizeof(cull_uniforms) == 176, "cull_uniforms must match the std140 layout of build_draws.comp");
@@ -2,10 +2,11 @@
 
 #include <glm/mat4x4.hpp>
 
+// per view data, the product is taken once on the cpu rather than per vertex
+// per object transforms are in the instance buffer, see Shader/instance_data.hpp
 struct uniform_buffer_object
 {
-    alignas(16) glm::mat4 model;
     alignas(16) glm::mat4 view;
     alignas(16) glm::mat4 proj;
+    alignas(16) glm::mat4 view_proj;
 };
-
@@ -1,9 +1,9 @@
 #pragma once
 
 // Mythos
-#include <array>
-#include <vector>
-#include <vulkan/vulkan_core.h>
+#include <bit>
+#include <cstdint>
+#include <iterator>
 
 //#include "Maths/vectors.hpp"
 #include "glm/vec2.hpp"
@@ -11,55 +11,49 @@
 
 namespace Mythos
 {
+	// full precision vertex as it comes out of the importer, the gpu sees one of the layouts in Shader/vertex_layout.hpp
 	struct vertex
 	{
 		glm::vec3 pos;
-		glm::vec3 color;
+		glm::vec3 normal;
 		glm::vec2 tex_coord;
 
 		bool operator==(const vertex& other) const
 		{
-			return pos == other.pos && color == other.color && tex_coord == other.tex_coord;
+			return pos == other.pos && normal == other.normal && tex_coord == other.tex_coord;
 		}
+	};
 
-		static auto get_binding_description() -> VkVertexInputBindingDescription
+	// hashes the raw bits of every component, -0 is folded into 0 so vertices that compare equal hash equal
+	// one multiply and shift per pair of floats, then a full avalanche so the low bits are usable as a table index
+	inline auto hash_vertex(const vertex& value) -> uint64_t
+	{
+		const float components[] =
 		{
-			constexpr auto binding_description = VkVertexInputBindingDescription
-			{
-				.binding = 0,
-				.stride = sizeof(vertex),
-				.inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
-			};
-
-			return binding_description;
+			value.pos.x, value.pos.y, value.pos.z,
+			value.normal.x, value.normal.y, value.normal.z,
+			value.tex_coord.x, value.tex_coord.y,
 		};
 
-		static auto get_attribute_descriptions() -> std::array<VkVertexInputAttributeDescription, 3>
+		const auto bits = [](float component) -> uint64_t
 		{
-			std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
-
-			attributeDescriptions[0].binding = 0;
-			attributeDescriptions[0].location = 0;
-			attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-			attributeDescriptions[0].offset = offsetof(vertex, pos);
-
-			attributeDescriptions[1].binding = 0;
-			attributeDescriptions[1].location = 1;
-			attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
-			attributeDescriptions[1].offset = offsetof(vertex, color);
+			return component == 0.0f ? 0u : std::bit_cast<uint32_t>(component);
+		};
 
-			attributeDescriptions[2].binding = 0;
-			attributeDescriptions[2].location = 2;
-			attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
-			attributeDescriptions[2].offset = offsetof(vertex, tex_coord);
+		auto hash = 0x9E3779B97F4A7C15ull;
 
-			return attributeDescriptions;
+		for (auto i = 0u; i < std::size(components); i += 2)
+		{
+			hash = (hash ^ (bits(components[i]) | bits(components[i + 1]) << 32)) * 0xBF58476D1CE4E5B9ull;
+			hash ^= hash >> 31;
 		}
-	};
-}
 
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/hash.hpp>
+		hash ^= hash >> 33;
+		hash *= 0xFF51AFD7ED558CCDull;
+		hash ^= hash >> 33;
+		return hash;
+	}
+}
 
 namespace std
 {
@@ -67,9 +61,7 @@ namespace std
 	{
 		size_t operator()(Mythos::vertex const& vertex) const
 		{
-			return ((hash<glm::vec3>()(vertex.pos) ^
-				    (hash<glm::vec3>()(vertex.color) << 1)) >> 1) ^
-				    (hash<glm::vec2>()(vertex.tex_coord) << 1);
+			return static_cast<size_t>(Mythos::hash_vertex(vertex));
 		}
 	};
 }
@@ -0,0 +1,390 @@
+#pragma once
+
+// Vulkan
+#include <Vulkan/vulkan_core.h>
+
+// STL
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// GLM
+#include "glm/common.hpp"
+
+// Mythos
+#include "Shader/vertex.hpp"
+
+// --
+namespace Mythos
+{
+	// --
+
+	struct vertex_bounds
+	{
+		glm::vec3 min = glm::vec3(0.0f);
+		glm::vec3 max = glm::vec3(0.0f);
+
+		auto centre() const -> glm::vec3
+		{
+			return (min + max) * 0.5f;
+		}
+
+		// flat axes get an extent of one so they still divide cleanly
+		auto half_extent() const -> glm::vec3
+		{
+			const auto extent = (max - min) * 0.5f;
+			return { extent.x > 0.0f ? extent.x : 1.0f, extent.y > 0.0f ? extent.y : 1.0f, extent.z > 0.0f ? extent.z : 1.0f };
+		}
+	};
+
+	inline auto compute_bounds(const std::vector<vertex>& vertices) -> vertex_bounds
+	{
+		if (vertices.empty()) return {};
+
+		auto bounds = vertex_bounds{ vertices[0].pos, vertices[0].pos };
+
+		for (const auto& item : vertices)
+		{
+			bounds.min = glm::min(bounds.min, item.pos);
+			bounds.max = glm::max(bounds.max, item.pos);
+		}
+
+		return bounds;
+	}
+
+	// --
+
+	// ieee binary16, rounded to nearest even
+	inline auto float_to_half(float value) -> uint16_t
+	{
+		const auto bits = std::bit_cast<uint32_t>(value);
+		const auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+		const auto exponent = static_cast<int32_t>((bits >> 23) & 0xFFu) - 127 + 15;
+		auto mantissa = bits & 0x7FFFFFu;
+
+		if (((bits >> 23) & 0xFFu) == 0xFFu) return sign | 0x7C00u | (mantissa != 0 ? 0x200u : 0u);
+		if (exponent >= 31) return sign | 0x7C00u;
+
+		// too small for a normal half, shift the implicit bit into a subnormal
+		if (exponent <= 0)
+		{
+			if (exponent < -10) return sign;
+
+			mantissa |= 0x800000u;
+			const auto shift = static_cast<uint32_t>(14 - exponent);
+			const auto halfway = 1u << (shift - 1);
+			const auto remainder = mantissa & ((1u << shift) - 1);
+
+			auto half = mantissa >> shift;
+			if (remainder > halfway || (remainder == halfway && (half & 1u) != 0)) half++;
+
+			return static_cast<uint16_t>(sign | half);
+		}
+
+		// a carry out of the mantissa rounds up into the exponent, which is the right answer
+		auto half = static_cast<uint32_t>(exponent) << 10 | mantissa >> 13;
+		const auto remainder = mantissa & 0x1FFFu;
+		if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u) != 0)) half++;
+
+		return static_cast<uint16_t>(sign | half);
+	}
+
+	inline auto float_to_snorm16(float value) -> int16_t
+	{
+		return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+	}
+
+	inline auto float_to_unorm16(float value) -> uint16_t
+	{
+		return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+	}
+
+	// folds the unit sphere onto the [-1, 1] square, the shader undoes it in decode_octahedral
+	inline auto encode_octahedral(glm::vec3 normal) -> glm::vec2
+	{
+		const auto length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+		if (length <= 0.0f) return glm::vec2(0.0f);
+
+		normal /= length;
+		if (normal.z >= 0.0f) return { normal.x, normal.y };
+
+		const auto sign = [](float value) { return value >= 0.0f ? 1.0f : -1.0f; };
+		return { (1.0f - std::abs(normal.y)) * sign(normal.x), (1.0f - std::abs(normal.x)) * sign(normal.y) };
+	}
+
+	// -- attribute encodings
+	// each names its storage, the format the input assembler reads it with and how to get there from a vertex
+	// the ids are written into cooked files so a mesh is never read back with a layout it was not cooked for
+
+	struct position_float3
+	{
+		using type = glm::vec3;
+		static constexpr VkFormat format = VK_FORMAT_R32G32B32_SFLOAT;
+		static constexpr uint32_t id = 1;
+		static constexpr bool quantized = false;
+
+		static auto encode(const glm::vec3& position, const vertex_bounds&) -> type { return position; }
+	};
+
+	// the fourth half is padding, three component 16 bit formats are rarely supported for vertex input
+	struct position_half4
+	{
+		using type = std::array<uint16_t, 4>;
+		static constexpr VkFormat format = VK_FORMAT_R16G16B16A16_SFLOAT;
+		static constexpr uint32_t id = 2;
+		static constexpr bool quantized = false;
+
+		static auto encode(const glm::vec3& position, const vertex_bounds&) -> type
+		{
+			return { float_to_half(position.x), float_to_half(position.y), float_to_half(position.z), float_to_half(1.0f) };
+		}
+	};
+
+	// relative to the mesh bounds, the model matrix scales and offsets it back, see vertex_layout::position_scale
+	struct position_snorm16
+	{
+		using type = std::array<int16_t, 4>;
+		static constexpr VkFormat format = VK_FORMAT_R16G16B16A16_SNORM;
+		static constexpr uint32_t id = 3;
+		static constexpr bool quantized = true;
+
+		static auto encode(const glm::vec3& position, const vertex_bounds& bounds) -> type
+		{
+			const auto local = (position - bounds.centre()) / bounds.half_extent();
+			return { float_to_snorm16(local.x), float_to_snorm16(local.y), float_to_snorm16(local.z), 32767 };
+		}
+	};
+
+	struct normal_float3
+	{
+		using type = glm::vec3;
+		static constexpr VkFormat format = VK_FORMAT_R32G32B32_SFLOAT;
+		static constexpr uint32_t id = 1;
+		static constexpr bool octahedral = false;
+
+		static auto encode(const glm::vec3& normal) -> type { return normal; }
+	};
+
+	struct normal_oct16
+	{
+		using type = std::array<int16_t, 2>;
+		static constexpr VkFormat format = VK_FORMAT_R16G16_SNORM;
+		static constexpr uint32_t id = 2;
+		static constexpr bool octahedral = true;
+
+		static auto encode(const glm::vec3& normal) -> type
+		{
+			const auto folded = encode_octahedral(normal);
+			return { float_to_snorm16(folded.x), float_to_snorm16(folded.y) };
+		}
+	};
+
+	struct tex_coord_float2
+	{
+		using type = glm::vec2;
+		static constexpr VkFormat format = VK_FORMAT_R32G32_SFLOAT;
+		static constexpr uint32_t id = 1;
+		static constexpr bool clamped = false;
+
+		static auto encode(const glm::vec2& tex_coord) -> type { return tex_coord; }
+	};
+
+	// repeating coordinates outside [0, 1] are clamped, the Cooker warns when a mesh has any
+	struct tex_coord_unorm16
+	{
+		using type = std::array<uint16_t, 2>;
+		static constexpr VkFormat format = VK_FORMAT_R16G16_UNORM;
+		static constexpr uint32_t id = 2;
+		static constexpr bool clamped = true;
+
+		static auto encode(const glm::vec2& tex_coord) -> type
+		{
+			return { float_to_unorm16(tex_coord.x), float_to_unorm16(tex_coord.y) };
+		}
+	};
+
+	// --
+
+	enum class vertex_streams : uint32_t
+	{
+		interleaved = 0,
+		split = 1,  // positions alone in binding 0 so depth only passes fetch nothing else
+	};
+
+	// shader locations, shared by every layout
+	constexpr uint32_t POSITION_LOCATION = 0;
+	constexpr uint32_t NORMAL_LOCATION = 1;
+	constexpr uint32_t TEX_COORD_LOCATION = 2;
+
+	// specialization constant the vertex shader decodes octahedral normals behind
+	constexpr uint32_t OCTAHEDRAL_NORMALS_CONSTANT = 0;
+
+	template <typename Position, typename Normal, typename TexCoord, vertex_streams Streams>
+	struct vertex_layout
+	{
+		using position_encoding = Position;
+		using normal_encoding = Normal;
+		using tex_coord_encoding = TexCoord;
+
+		struct position_vertex
+		{
+			typename Position::type position;
+		};
+
+		struct attribute_vertex
+		{
+			typename Normal::type normal;
+			typename TexCoord::type tex_coord;
+		};
+
+		struct interleaved_vertex
+		{
+			typename Position::type position;
+			typename Normal::type normal;
+			typename TexCoord::type tex_coord;
+		};
+
+		static constexpr bool split = Streams == vertex_streams::split;
+		static constexpr uint32_t stream_count = split ? 2 : 1;
+		static constexpr uint32_t id = Position::id | Normal::id << 8 | TexCoord::id << 16 | static_cast<uint32_t>(Streams) << 24;
+
+		// bytes per vertex summed over every stream
+		static constexpr uint32_t stride = split ? sizeof(position_vertex) + sizeof(attribute_vertex) : sizeof(interleaved_vertex);
+
+		// streams are stored one after another in a single buffer, each starting on a 16 byte boundary
+		static auto stream_offsets(uint32_t vertex_count) -> std::array<VkDeviceSize, 2>
+		{
+			if constexpr (split)
+			{
+				const auto positions = static_cast<VkDeviceSize>(vertex_count) * sizeof(position_vertex);
+				return { 0, (positions + 15) & ~VkDeviceSize(15) };
+			}
+			else
+			{
+				return { 0, 0 };
+			}
+		}
+
+		static auto buffer_size(uint32_t vertex_count) -> VkDeviceSize
+		{
+			if constexpr (split)
+			{
+				return stream_offsets(vertex_count)[1] + static_cast<VkDeviceSize>(vertex_count) * sizeof(attribute_vertex);
+			}
+			else
+			{
+				return static_cast<VkDeviceSize>(vertex_count) * sizeof(interleaved_vertex);
+			}
+		}
+
+		// undoes the position quantization, applied to the model matrix rather than in the shader
+		static auto position_offset(const vertex_bounds& bounds) -> glm::vec3
+		{
+			return Position::quantized ? bounds.centre() : glm::vec3(0.0f);
+		}
+
+		static auto position_scale(const vertex_bounds& bounds) -> glm::vec3
+		{
+			return Position::quantized ? bounds.half_extent() : glm::vec3(1.0f);
+		}
+
+		// position_only leaves out binding 1 for depth passes, the same as the full layout when interleaved
+		static auto get_binding_descriptions(bool position_only = false) -> std::vector<VkVertexInputBindingDescription>
+		{
+			if constexpr (split)
+			{
+				auto bindings = std::vector<VkVertexInputBindingDescription>
+				{
+					{ .binding = 0, .stride = sizeof(position_vertex), .inputRate = VK_VERTEX_INPUT_RATE_VERTEX },
+					{ .binding = 1, .stride = sizeof(attribute_vertex), .inputRate = VK_VERTEX_INPUT_RATE_VERTEX },
+				};
+
+				if (position_only) bindings.pop_back();
+				return bindings;
+			}
+			else
+			{
+				return { { .binding = 0, .stride = sizeof(interleaved_vertex), .inputRate = VK_VERTEX_INPUT_RATE_VERTEX } };
+			}
+		}
+
+		static auto get_attribute_descriptions(bool position_only = false) -> std::vector<VkVertexInputAttributeDescription>
+		{
+			auto attributes = std::vector<VkVertexInputAttributeDescription>();
+
+			if constexpr (split)
+			{
+				attributes.push_back({ POSITION_LOCATION, 0, Position::format, offsetof(position_vertex, position) });
+				if (position_only) return attributes;
+
+				attributes.push_back({ NORMAL_LOCATION, 1, Normal::format, offsetof(attribute_vertex, normal) });
+				attributes.push_back({ TEX_COORD_LOCATION, 1, TexCoord::format, offsetof(attribute_vertex, tex_coord) });
+			}
+			else
+			{
+				attributes.push_back({ POSITION_LOCATION, 0, Position::format, offsetof(interleaved_vertex, position) });
+				if (position_only) return attributes;
+
+				attributes.push_back({ NORMAL_LOCATION, 0, Normal::format, offsetof(interleaved_vertex, normal) });
+				attributes.push_back({ TEX_COORD_LOCATION, 0, TexCoord::format, offsetof(interleaved_vertex, tex_coord) });
+			}
+
+			return attributes;
+		}
+
+		// packs every stream into one buffer of buffer_size bytes, ready to upload or write to a cooked file
+		static auto encode(const std::vector<vertex>& vertices, const vertex_bounds& bounds) -> std::vector<uint8_t>
+		{
+			const auto count = static_cast<uint32_t>(vertices.size());
+			const auto offsets = stream_offsets(count);
+
+			auto buffer = std::vector<uint8_t>(buffer_size(count));
+
+			for (uint32_t i = 0; i < count; i++)
+			{
+				const auto& source = vertices[i];
+
+				if constexpr (split)
+				{
+					const auto position = position_vertex{ Position::encode(source.pos, bounds) };
+					const auto attribute = attribute_vertex{ Normal::encode(source.normal), TexCoord::encode(source.tex_coord) };
+
+					std::memcpy(buffer.data() + offsets[0] + i * sizeof(position), &position, sizeof(position));
+					std::memcpy(buffer.data() + offsets[1] + i * sizeof(attribute), &attribute, sizeof(attribute));
+				}
+				else
+				{
+					const auto packed = interleaved_vertex
+					{
+						Position::encode(source.pos, bounds), Normal::encode(source.normal), TexCoord::encode(source.tex_coord)
+					};
+
+					std::memcpy(buffer.data() + i * sizeof(packed), &packed, sizeof(packed));
+				}
+			}
+
+			return buffer;
+		}
+	};
+
+	// 32 bytes, the import vertex as is
+	using standard_vertex_layout = vertex_layout<position_float3, normal_float3, tex_coord_float2, vertex_streams::interleaved>;
+
+	// 16 bytes, no dequantization needed for positions
+	using half_vertex_layout = vertex_layout<position_half4, normal_oct16, tex_coord_unorm16, vertex_streams::interleaved>;
+
+	// 16 bytes, 8 of them in the position stream
+	using compact_vertex_layout = vertex_layout<position_snorm16, normal_oct16, tex_coord_unorm16, vertex_streams::split>;
+
+	static_assert(standard_vertex_layout::stride == sizeof(vertex));
+	static_assert(half_vertex_layout::stride == 16);
+	static_assert(compact_vertex_layout::stride == 16);
+
+	// what the Cooker writes and the renderer draws, cooked meshes have to be cooked again after changing it
+	using mesh_vertex_layout = compact_vertex_layout;
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// --
+namespace Mythos
+{
+	// --
+
+	// cooked texture layout written by the Cooker and uploaded straight out of its mapping by the renderer
+	// [header][level index][level 0, aligned][level 1, aligned]..., every integer is little endian
+	// modelled on ktx2, every mip is stored ready to copy and the level index says where each one is
+	constexpr uint32_t TEXTURE_FILE_MAGIC = 0x58544D4D; // "MMTX"
+	constexpr uint32_t TEXTURE_FILE_VERSION = 1;
+	constexpr uint64_t TEXTURE_FILE_ALIGNMENT = 16;
+	constexpr uint32_t TEXTURE_MAX_LEVELS = 16;
+
+	constexpr const char* TEXTURE_FILE_EXTENSION = ".tex";
+
+	enum class texture_format : uint32_t
+	{
+		rgba8_unorm = 0,
+		rgba8_srgb = 1,
+		bc1_unorm = 2,  // rgb, 4 bits per texel
+		bc1_srgb = 3,
+		bc3_unorm = 4,  // rgba, 8 bits per texel
+		bc3_srgb = 5,
+		bc5_unorm = 6,  // two channels, for normal maps
+		bc7_unorm = 7,  // rgba, 8 bits per texel and much closer to the source than bc1 or bc3
+		bc7_srgb = 8,
+	};
+
+	struct texture_file_header
+	{
+		uint32_t magic = TEXTURE_FILE_MAGIC;
+		uint32_t version = TEXTURE_FILE_VERSION;
+
+		texture_format format = texture_format::rgba8_srgb;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		uint32_t level_count = 0;
+
+		// byte offset of the level index from the start of the file
+		uint64_t level_index_offset = 0;
+	};
+
+	static_assert(sizeof(texture_file_header) == 32, "texture_file_header is read straight from disk, keep its layout fixed");
+
+	// one per mip, largest first, offsets are from the start of the file
+	struct texture_level
+	{
+		uint64_t offset = 0;
+		uint64_t size = 0;
+	};
+
+	static_assert(sizeof(texture_level) == 16, "texture_level is read straight from disk, keep its layout fixed");
+
+	// pointers into a mapped texture file, valid for as long as the mapping is
+	struct texture_file_view
+	{
+		const texture_file_header* header = nullptr;
+		const texture_level* levels = nullptr;
+
+		// from the first level to the end of the last, levels are relative to the file so subtract data_offset
+		const void* data = nullptr;
+		uint64_t data_offset = 0;
+		uint64_t data_bytes = 0;
+	};
+
+	inline auto is_block_compressed(texture_format format) -> bool
+	{
+		return format != texture_format::rgba8_unorm && format != texture_format::rgba8_srgb;
+	}
+
+	// bytes per 4x4 block, or per texel for uncompressed formats
+	inline auto texture_block_bytes(texture_format format) -> uint32_t
+	{
+		switch (format)
+		{
+		case texture_format::bc1_unorm:
+		case texture_format::bc1_srgb:
+			return 8;
+		case texture_format::bc3_unorm:
+		case texture_format::bc3_srgb:
+		case texture_format::bc5_unorm:
+		case texture_format::bc7_unorm:
+		case texture_format::bc7_srgb:
+			return 16;
+		default:
+			return 4;
+		}
+	}
+
+	inline auto texture_level_bytes(texture_format format, uint32_t width, uint32_t height) -> uint64_t
+	{
+		if (!is_block_compressed(format))
+		{
+			return static_cast<uint64_t>(width) * height * texture_block_bytes(format);
+		}
+
+		return static_cast<uint64_t>((width + 3) / 4) * ((height + 3) / 4) * texture_block_bytes(format);
+	}
+
+	// a full chain down to 1x1
+	inline auto texture_level_count(uint32_t width, uint32_t height) -> uint32_t
+	{
+		auto count = 1u;
+		for (auto size = std::max(width, height); size > 1; size /= 2) count++;
+		return count;
+	}
+
+	inline auto texture_level_extent(uint32_t extent, uint32_t level) -> uint32_t
+	{
+		return std::max(1u, extent >> level);
+	}
+
+	inline auto align_texture_offset(uint64_t offset) -> uint64_t
+	{
+		return (offset + TEXTURE_FILE_ALIGNMENT - 1) & ~(TEXTURE_FILE_ALIGNMENT - 1);
+	}
+
+	// checks the header and every level against the file size, no data is copied
+	inline auto read_texture_file(const void* data, size_t size, texture_file_view& view) -> bool
+	{
+		if (data == nullptr || size < sizeof(texture_file_header)) return false;
+
+		const auto* header = static_cast<const texture_file_header*>(data);
+
+		if (header->magic != TEXTURE_FILE_MAGIC || header->version != TEXTURE_FILE_VERSION) return false;
+		if (header->format > texture_format::bc7_srgb) return false;
+		if (header->width == 0 || header->height == 0) return false;
+		if (header->level_count == 0 || header->level_count > std::min(TEXTURE_MAX_LEVELS, texture_level_count(header->width, header->height))) return false;
+
+		const auto index_bytes = static_cast<uint64_t>(header->level_count) * sizeof(texture_level);
+		if (header->level_index_offset < sizeof(texture_file_header) || header->level_index_offset % alignof(texture_level) != 0) return false;
+		if (header->level_index_offset + index_bytes > size) return false;
+
+		const auto* bytes = static_cast<const std::byte*>(data);
+		const auto* levels = reinterpret_cast<const texture_level*>(bytes + header->level_index_offset);
+
+		auto end = header->level_index_offset + index_bytes;
+
+		for (uint32_t i = 0; i < header->level_count; i++)
+		{
+			const auto expected = texture_level_bytes(header->format, texture_level_extent(header->width, i),
+			                                          texture_level_extent(header->height, i));
+
+			// levels follow each other in order so the whole chain stages as one copy
+			if (levels[i].size != expected || levels[i].offset % TEXTURE_FILE_ALIGNMENT != 0) return false;
+			if (levels[i].offset < end || levels[i].offset + levels[i].size > size) return false;
+
+			end = levels[i].offset + levels[i].size;
+		}
+
+		view.header = header;
+		view.levels = levels;
+		view.data_offset = levels[0].offset;
+		view.data = bytes + view.data_offset;
+		view.data_bytes = end - view.data_offset;
+		return true;
+	}
+}
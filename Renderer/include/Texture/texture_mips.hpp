@@ -0,0 +1,46 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <vector>
+
+// Mythos
+#include "Job/job_system.hpp"
+#include "Texture/texture_file.hpp"
+
+// --
+namespace Mythos
+{
+	// --
+
+	// one float rgba image, linear and with premultiplied alpha while it is being filtered
+	struct float_image
+	{
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<float> texels; // rgba
+	};
+
+	// rgba8 levels packed one after another, largest first, level offsets are from the start of pixels
+	struct rgba8_mip_chain
+	{
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<texture_level> levels;
+		std::vector<uint8_t> pixels;
+	};
+
+	// srgb sources are filtered in linear space and converted back, alpha is premultiplied while filtering
+	// so transparent texels do not bleed their colour into the smaller levels
+	auto to_float_image(const uint8_t* rgba, uint32_t width, uint32_t height, bool srgb) -> float_image;
+	auto to_rgba8(const float_image& image, bool srgb, uint8_t* rgba) -> void;
+
+	// halves the image with a separable lanczos 2 filter, clamped at the edges, odd sizes round down
+	auto downsample(const float_image& source, job_system* jobs = nullptr) -> float_image;
+
+	// every level down to 1x1, each filtered from the full precision level above it
+	auto generate_mips(const uint8_t* rgba, uint32_t width, uint32_t height, bool srgb, job_system* jobs = nullptr) -> std::vector<float_image>;
+
+	// the same chain converted back to rgba8 and packed for upload, used when there is no cooked file
+	auto generate_rgba8_mips(const uint8_t* rgba, uint32_t width, uint32_t height, bool srgb, job_system* jobs = nullptr) -> rgba8_mip_chain;
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+// Vulkan
+#include <Vulkan/vulkan_core.h>
+
+// STL
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Mythos
+#include "Job/job_system.hpp"
+#include "Mesh/mesh_file.hpp"
+#include "Shader/vertex_layout.hpp"
+#include "Texture/texture_file.hpp"
+#include "Utility/MappedFile.hpp"
+#include "Vulkan/memory_allocator.hpp"
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	enum class asset_state : uint8_t
+	{
+		loading,
+		ready,
+		failed,
+	};
+
+	struct mesh_handle
+	{
+		uint32_t index = UINT32_MAX;
+	};
+
+	struct texture_handle
+	{
+		uint32_t index = UINT32_MAX;
+	};
+
+	struct mesh_resource
+	{
+		std::string path;
+		asset_state state = asset_state::loading;
+
+		// every stream of mesh_vertex_layout in one buffer, bound once per stream at its offset
+		VkBuffer vertex_buffer = VK_NULL_HANDLE;
+		gpu_allocation vertex_allocation = {};
+		std::array<VkDeviceSize, 2> stream_offsets = {};
+
+		// applied ahead of the model matrix to undo quantized positions
+		glm::vec3 position_offset = glm::vec3(0.0f);
+		glm::vec3 position_scale = glm::vec3(1.0f);
+
+		// a sphere around the decoded positions, what culling tests an instance with
+		glm::vec3 bounds_centre = glm::vec3(0.0f);
+		float bounds_radius = 0.0f;
+
+		VkBuffer index_buffer = VK_NULL_HANDLE;
+		gpu_allocation index_allocation = {};
+		VkIndexType index_type = VK_INDEX_TYPE_UINT32;
+		uint32_t index_count = 0;
+	};
+
+	struct texture_resource
+	{
+		std::string path;
+		asset_state state = asset_state::loading;
+
+		VkImage image = VK_NULL_HANDLE;
+		VkImageView view = VK_NULL_HANDLE;
+		gpu_allocation allocation = {};
+		uint32_t mip_levels = 1;
+
+		// its slot in the renderer's texture table once ready
+		uint32_t descriptor = 0;
+	};
+
+	// results handed from the loading jobs to the render thread
+	struct decoded_mesh
+	{
+		uint32_t index = 0;
+		bool success = false;
+
+		uint32_t vertex_count = 0;
+		vertex_bounds bounds;
+
+		// parsed from the source obj and encoded into mesh_vertex_layout when there is no up to date cooked file
+		std::vector<uint8_t> vertex_data;
+		std::vector<uint32_t> indices;
+
+		// otherwise the cooked file, mapped and copied straight into the staging ring
+		Utility::mapped_file file;
+		mesh_file_view view;
+	};
+
+	struct decoded_texture
+	{
+		uint32_t index = 0;
+		bool success = false;
+
+		texture_format format = texture_format::rgba8_srgb;
+		uint32_t width = 0;
+		uint32_t height = 0;
+
+		// the source image and its mips filtered on the worker when there is no usable cooked file
+		// level offsets are from the start of pixels
+		std::vector<texture_level> levels;
+		std::vector<uint8_t> pixels;
+
+		// otherwise the cooked file, mapped and every level copied straight into the staging ring
+		Utility::mapped_file file;
+		texture_file_view view;
+	};
+
+	// reads and decodes assets on the job system and hands out handles straight away
+	// the render thread drains the decoded assets and creates their gpu resources, see process_asset_uploads
+	class asset_manager
+	{
+	public:
+		asset_manager() = default;
+		~asset_manager();
+
+		asset_manager(const asset_manager&) = delete;
+		asset_manager& operator=(const asset_manager&) = delete;
+
+		// null loads on the calling thread
+		void set_job_system(job_system* jobs);
+
+		// set once the device is created and before the first load, without it cooked bc textures fall back to their source
+		void set_block_compression(bool supported);
+
+		// prefer a cooked .mesh or .tex next to the source file, see the Cooker project
+		mesh_handle load_mesh(const std::string& path);
+		texture_handle load_texture(const std::string& path);
+
+		std::vector<decoded_mesh> take_decoded_meshes();
+		std::vector<decoded_texture> take_decoded_textures();
+
+		mesh_resource* mesh(mesh_handle handle);
+		texture_resource* texture(texture_handle handle);
+
+		std::vector<mesh_resource>& meshes();
+		std::vector<texture_resource>& textures();
+
+		// blocks until every queued load has been decoded
+		void wait_idle();
+
+	private:
+		void run(std::function<void()> function);
+
+		job_system* jobs_ = nullptr;
+		job_counter counter_;
+
+		bool block_compression_ = false;
+
+		// only touched by the render thread
+		std::vector<mesh_resource> meshes_;
+		std::vector<texture_resource> textures_;
+
+		std::mutex mutex_;
+		std::vector<decoded_mesh> decoded_meshes_;
+		std::vector<decoded_texture> decoded_textures_;
+	};
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+// Vulkan
+#include <Vulkan/vulkan_core.h>
+
+// STL
+#include <cstdint>
+#include <vector>
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	// a contiguous run of the draw list, recorded into one secondary command buffer
+	struct draw_range
+	{
+		uint32_t begin = 0;
+		uint32_t end = 0;
+	};
+
+	// splits count draws into at most max_ranges contiguous runs whose sizes differ by at most one draw,
+	// executing the runs in order keeps the draw list order, so sorting done upstream survives
+	// every run holds at least min_draws, a handful of draws records faster inline than through a job
+	auto partition_draws(uint32_t count, uint32_t max_ranges, uint32_t min_draws) -> std::vector<draw_range>;
+
+	struct recorder_stats
+	{
+		uint32_t draws = 0;         // recorded last frame
+		uint32_t secondaries = 0;   // 0 when the frame was recorded inline into its primary
+		double record_ms = 0.0;     // from the first command to the last, including waiting on the jobs
+	};
+
+	// one command pool per frame in flight and recording slot, a slot is only ever recorded by one job at a time
+	// so its pool needs no lock, and all of a frame's pools are reset together once the frame's fence has signalled
+	// the primary has a pool of its own, it is recorded on the render thread while the jobs fill the slots
+	class command_recorder
+	{
+	public:
+		static constexpr uint32_t MAX_SLOTS = 16;
+		static constexpr uint32_t MIN_DRAWS_PER_SLOT = 256;
+
+		command_recorder() = default;
+		~command_recorder() = default;
+
+		command_recorder(const command_recorder&) = delete;
+		command_recorder& operator=(const command_recorder&) = delete;
+
+		bool create(VkDevice device, uint32_t queue_family, uint32_t frame_count, uint32_t slot_count);
+		void destroy();
+
+		// resets every pool of the frame, the command buffers allocated from them are kept for reuse
+		void begin_frame(uint32_t frame);
+
+		VkCommandBuffer primary(uint32_t frame) const;
+
+		// a secondary from the slot's pool, begun to continue the render pass described by inheritance
+		// only the job that owns the slot may call this while the frame is being recorded
+		VkCommandBuffer begin_secondary(uint32_t frame, uint32_t slot, const VkCommandBufferInheritanceInfo& inheritance);
+
+		uint32_t slot_count() const;
+
+		recorder_stats& stats();
+
+	private:
+		struct slot_pool
+		{
+			VkCommandPool pool = VK_NULL_HANDLE;
+			std::vector<VkCommandBuffer> secondaries;
+			uint32_t used = 0;
+		};
+
+		struct frame_pools
+		{
+			VkCommandPool primary_pool = VK_NULL_HANDLE;
+			VkCommandBuffer primary = VK_NULL_HANDLE;
+			std::vector<slot_pool> slots;
+		};
+
+		VkDevice device_ = VK_NULL_HANDLE;
+		std::vector<frame_pools> frames_;
+		uint32_t slot_count_ = 0;
+
+		recorder_stats stats_;
+	};
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+// Vulkan
+#include <Vulkan/vulkan_core.h>
+
+// STL
+#include <array>
+#include <cstdint>
+
+// GLM
+#include <glm/mat4x4.hpp>
+
+// Mythos
+#include "Vulkan/memory_allocator.hpp"
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	// the farthest depth of every region of the depth buffer at halving resolutions, built after the frame's render pass
+	// and read by the next frame's occlusion culling, see build_draws.comp
+	// the queue runs frames in submission order, so one pyramid serves every frame in flight
+	class depth_pyramid
+	{
+	public:
+		static constexpr uint32_t GROUP_SIZE = 8; // local_size of depth_pyramid.comp
+		static constexpr uint32_t MAX_LEVELS = 16;
+
+		depth_pyramid() = default;
+		~depth_pyramid() = default;
+
+		depth_pyramid(const depth_pyramid&) = delete;
+		depth_pyramid& operator=(const depth_pyramid&) = delete;
+
+		// false when the reduction shaders are missing, the caller culls without occlusion then
+		bool create(VkDevice device, memory_allocator& allocator);
+		void destroy();
+
+		// sizes the pyramid for a new depth buffer, called after the swapchain is recreated with the device idle
+		// the buffer must have been created with sampled usage
+		// false when the pyramid was never created or destroyed after create failed
+		bool resize(VkImageView depth_view, uint32_t width, uint32_t height, VkSampleCountFlagBits samples);
+
+		// reduces the depth buffer written by the render pass that just ended into every level
+		// the render graph has the depth in its read only layout and the pyramid in the general layout it stays in
+		// view_proj is the view the depth was rendered with, handed to the next frame's culling
+		void record(VkCommandBuffer commands, const glm::mat4& view_proj);
+
+		// whether a pyramid was recorded since the last resize, the first frame after one has nothing to test against
+		bool valid() const;
+
+		VkImage image() const;
+		VkImageView view() const;
+		VkSampler sampler() const;
+		VkExtent2D extent() const;
+		uint32_t level_count() const;
+		const glm::mat4& view_proj() const;
+
+	private:
+		bool create_pipeline(const char* path, VkPipeline& pipeline);
+		void release();
+
+		VkDevice device_ = VK_NULL_HANDLE;
+		memory_allocator* allocator_ = nullptr;
+
+		VkDescriptorSetLayout set_layout_ = VK_NULL_HANDLE;
+		VkDescriptorPool descriptor_pool_ = VK_NULL_HANDLE;
+		VkPipelineLayout pipeline_layout_ = VK_NULL_HANDLE;
+		VkPipeline reduce_pipeline_ = VK_NULL_HANDLE;           // a level from the one above it
+		VkPipeline multisampled_pipeline_ = VK_NULL_HANDLE;     // the first level from a multisampled depth buffer
+		VkSampler sampler_ = VK_NULL_HANDLE;
+
+		VkExtent2D depth_extent_ = {};
+		VkSampleCountFlagBits depth_samples_ = VK_SAMPLE_COUNT_1_BIT;
+
+		VkImage image_ = VK_NULL_HANDLE;
+		gpu_allocation allocation_ = {};
+		VkImageView view_ = VK_NULL_HANDLE;
+		VkExtent2D extent_ = {};
+		uint32_t level_count_ = 0;
+
+		std::array<VkImageView, MAX_LEVELS> level_views_ = {};
+		std::array<VkDescriptorSet, MAX_LEVELS> level_sets_ = {};
+
+		bool valid_ = false;
+		glm::mat4 view_proj_ = glm::mat4(1.0f);
+	};
+}
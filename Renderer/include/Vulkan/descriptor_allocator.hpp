@@ -0,0 +1,53 @@
+#pragma once
+
+// Vulkan
+#include <Vulkan/vulkan_core.h>
+
+// STL
+#include <cstdint>
+#include <vector>
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	// descriptor sets that live for one frame, allocated linearly from the frame's pools and all freed at once by
+	// resetting the pools when the frame's fence has signalled, a set is never freed or rewritten on its own
+	// a frame that needs more sets than its pools hold gets another pool, kept for the frames after it
+	class descriptor_allocator
+	{
+	public:
+		static constexpr uint32_t SETS_PER_POOL = 64;
+
+		descriptor_allocator() = default;
+		~descriptor_allocator() = default;
+
+		descriptor_allocator(const descriptor_allocator&) = delete;
+		descriptor_allocator& operator=(const descriptor_allocator&) = delete;
+
+		bool create(VkDevice device, uint32_t frame_count);
+		void destroy();
+
+		// resets every pool of the frame, the sets allocated from them are gone, later allocations come from its pools
+		void begin_frame(uint32_t frame);
+
+		// VK_NULL_HANDLE when the device is out of memory
+		VkDescriptorSet allocate(VkDescriptorSetLayout layout);
+
+		uint32_t pool_count() const;
+
+	private:
+		struct frame_pools
+		{
+			std::vector<VkDescriptorPool> pools;
+			uint32_t current = 0;
+		};
+
+		VkDescriptorPool create_pool();
+
+		VkDevice device_ = VK_NULL_HANDLE;
+		std::vector<frame_pools> frames_;
+		uint32_t frame_ = 0;
+	};
+}
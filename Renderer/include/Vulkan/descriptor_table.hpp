@@ -0,0 +1,97 @@
+#pragma once
+
+// Vulkan
+#include <Vulkan/vulkan_core.h>
+
+// STL
+#include <cstdint>
+#include <vector>
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	// slots of one array of the table, released slots wait out the frames that may still read them before reuse
+	class slot_list
+	{
+	public:
+		void reset(uint32_t capacity);
+
+		// UINT32_MAX when every slot is taken
+		uint32_t allocate();
+		void release(uint32_t slot, uint64_t frame);
+
+		// hands back the slots released at least frame_count frames before frame
+		void recycle(uint64_t frame, uint32_t frame_count);
+
+		uint32_t used() const;
+
+	private:
+		struct retired_slot
+		{
+			uint32_t slot = 0;
+			uint64_t frame = 0;
+		};
+
+		uint32_t capacity_ = 0;
+		uint32_t next_ = 0;                 // slots below it were handed out at least once
+		std::vector<uint32_t> free_;
+		std::vector<retired_slot> retired_; // in release order, so the oldest are at the front
+	};
+
+	// one descriptor set holding every texture and storage buffer of the renderer, shaders index it with a slot
+	// carried by the instance, so materials never allocate or bind sets of their own
+	// the set is bound every frame and updated while frames are in flight, only ever at slots none of them reads
+	class descriptor_table
+	{
+	public:
+		static constexpr uint32_t TEXTURE_BINDING = 0;
+		static constexpr uint32_t BUFFER_BINDING = 1;
+		static constexpr uint32_t MAX_TEXTURES = 4096;
+		static constexpr uint32_t MAX_BUFFERS = 1024;
+		static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+
+		// whether the device can index and update the table as it is used, enable receives the vulkan 1.2
+		// features to chain into the device's create info
+		static bool supported(VkPhysicalDevice physical_device, VkPhysicalDeviceVulkan12Features& enable);
+
+		descriptor_table() = default;
+		~descriptor_table() = default;
+
+		descriptor_table(const descriptor_table&) = delete;
+		descriptor_table& operator=(const descriptor_table&) = delete;
+
+		// the device must have been created with the features supported returned
+		bool create(VkDevice device, VkPhysicalDevice physical_device, uint32_t frame_count);
+		void destroy();
+
+		// called once per frame after its fence, slots released frame_count frames ago become free again
+		void begin_frame();
+
+		uint32_t add_texture(VkImageView view, VkSampler sampler);
+		uint32_t add_buffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range);
+
+		// the slot keeps its descriptor until reused, frames still in flight read what they were recorded with
+		void remove_texture(uint32_t slot);
+		void remove_buffer(uint32_t slot);
+
+		VkDescriptorSetLayout layout() const;
+		VkDescriptorSet set() const;
+
+		uint32_t texture_count() const;
+		uint32_t buffer_count() const;
+
+	private:
+		VkDevice device_ = VK_NULL_HANDLE;
+		uint32_t frame_count_ = 0;
+		uint64_t frame_ = 0;
+
+		VkDescriptorSetLayout layout_ = VK_NULL_HANDLE;
+		VkDescriptorPool pool_ = VK_NULL_HANDLE;
+		VkDescriptorSet set_ = VK_NULL_HANDLE;
+
+		slot_list textures_;
+		slot_list buffers_;
+	};
+}
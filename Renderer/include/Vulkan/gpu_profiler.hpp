@@ -0,0 +1,103 @@
+#pragma once
+
+// Vulkan
+#include <Vulkan/vulkan_core.h>
+
+// STL
+#include <cstdint>
+#include <vector>
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	struct gpu_profiler_stats
+	{
+		double frame_ms = 0.0;      // first timestamp to last of the latest frame read back
+		uint32_t regions = 0;       // in that frame
+		uint32_t dropped = 0;       // regions past the pool's size or whose results were not there, since creation
+	};
+
+	// timestamps around named regions of a frame's commands, one query pool per frame in flight
+	// a frame's timestamps are read back when its slot comes round again, the slot's fence has signalled by then so
+	// reading never waits on the gpu, and converted to steady clock time to sit on a gpu track of the cpu profiler
+	// calibrated timestamps read the device's clock and the host's, the one steady_clock counts in, in a single call
+	// and follow their drift when the device has them, otherwise the offset is measured once at creation by waiting
+	// on a single timestamp
+	class gpu_profiler
+	{
+	public:
+		static constexpr uint32_t MAX_REGIONS = 64;
+		static constexpr uint32_t RECALIBRATE_FRAMES = 120;
+		static constexpr uint32_t CALIBRATION_TRIES = 4;
+		static constexpr uint32_t NO_REGION = UINT32_MAX;
+
+		gpu_profiler() = default;
+		~gpu_profiler() = default;
+
+		gpu_profiler(const gpu_profiler&) = delete;
+		gpu_profiler& operator=(const gpu_profiler&) = delete;
+
+		// whether the device can read its clock and the host's together, VK_EXT_calibrated_timestamps must then be enabled
+		static bool calibration_supported(VkInstance instance, VkPhysicalDevice physical_device);
+
+		// a queue family without timestamps leaves the profiler disabled, which is not an error
+		bool create(VkPhysicalDevice physical_device, VkDevice device, VkQueue queue, uint32_t queue_family, uint32_t frame_count,
+		            bool calibrated);
+		void destroy();
+
+		// once the frame's fence has signalled, reads back what the slot recorded last time then resets its queries
+		// recorded outside any render pass, ahead of the frame's regions
+		void begin_frame(VkCommandBuffer commands, uint32_t frame);
+
+		// regions nest, names must live until the frame is read back, NO_REGION when the pool is full
+		// outside a render pass whose contents are secondary command buffers
+		uint32_t begin(VkCommandBuffer commands, const char* name);
+		void end(VkCommandBuffer commands, uint32_t region);
+
+		bool enabled() const;
+		const gpu_profiler_stats& stats() const;
+
+	private:
+		struct region
+		{
+			const char* name = nullptr;
+			uint32_t query = 0;     // begin, the end follows it
+			bool ended = false;
+		};
+
+		struct frame_queries
+		{
+			VkQueryPool pool = VK_NULL_HANDLE;
+			std::vector<region> regions;
+			bool pending = false;   // recorded and not read back yet
+		};
+
+		bool calibrate();
+		bool calibrate_by_submit(VkQueue queue, uint32_t queue_family);
+		void read_back(frame_queries& frame);
+
+		// device ticks to steady clock nanoseconds
+		int64_t host_time(uint64_t ticks) const;
+
+		VkDevice device_ = VK_NULL_HANDLE;
+		std::vector<frame_queries> frames_;
+		frame_queries* recording_ = nullptr;
+
+		double period_ = 1.0;       // nanoseconds per tick
+		uint64_t mask_ = 0;         // the bits the queue family's timestamps are valid in
+
+		// a device tick and the steady clock nanoseconds it was read at, to within the deviation
+		uint64_t calibration_ticks_ = 0;
+		int64_t calibration_host_ = 0;
+		uint64_t calibration_deviation_ = 0;
+
+		PFN_vkGetCalibratedTimestampsEXT get_calibrated_timestamps_ = nullptr;
+		uint32_t frames_since_calibration_ = 0;
+
+		std::vector<uint64_t> results_;
+
+		gpu_profiler_stats stats_;
+	};
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+// Vulkan
+#include <Vulkan/vulkan_core.h>
+
+// STL
+#include <cstdint>
+#include <vector>
+
+// GLM
+#include <glm/mat4x4.hpp>
+
+// Mythos
+#include "Culling/frustum.hpp"
+#include "Job/job_system.hpp"
+#include "Maths/transform_array.hpp"
+#include "Shader/instance_data.hpp"
+#include "Vulkan/asset_manager.hpp"
+#include "Vulkan/depth_pyramid.hpp"
+#include "Vulkan/memory_allocator.hpp"
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	// the placements of meshes in the scene, the mesh and texture slot of every instance alongside its transform
+	struct instance_list
+	{
+		std::vector<mesh_handle> meshes;
+		std::vector<uint32_t> textures;     // slots in the descriptor table
+		transform_array transforms;
+
+		size_t size() const { return meshes.size(); }
+
+		void clear()
+		{
+			meshes.clear();
+			textures.clear();
+			transforms.clear();
+		}
+
+		void reserve(size_t count)
+		{
+			meshes.reserve(count);
+			textures.reserve(count);
+			transforms.reserve(count);
+		}
+
+		void push(mesh_handle mesh, uint32_t texture, const glm::vec3& position, const glm::quat& rotation,
+		          const glm::vec3& scale = glm::vec3(1.0f))
+		{
+			meshes.push_back(mesh);
+			textures.push_back(texture);
+			transforms.push(position, rotation, scale);
+		}
+	};
+
+	// one batch of the frame, drawn with the indirect command at index batch
+	// or directly from the batch's instances when the indirect path is off
+	struct draw_item
+	{
+		mesh_handle mesh = {};
+		uint32_t batch = 0;
+		uint32_t first_instance = 0;
+		uint32_t instance_count = 0;
+	};
+
+	struct batcher_stats
+	{
+		uint32_t instances = 0;     // written last frame
+		uint32_t batches = 0;       // one per mesh, each a single draw call
+		uint32_t visible = 0;       // drawn, counted back from the commands frames in flight late when culling on the gpu
+		uint32_t culled = 0;
+	};
+
+	// where instances outside the view are dropped
+	enum class cull_mode
+	{
+		cpu,    // bounding spheres against the frustum before the instances are written, the fallback without compute
+		gpu,    // the compute pass, against the frustum and the previous frame's depth pyramid
+	};
+
+	// groups the frame's instances into one batch per mesh and draws each batch with a single indirect command,
+	// a compute pass culls every instance, counts the survivors into their batch's command and writes their index
+	// into the batch's run of the visible list, the vertex shader reads its transform through that list
+	// every buffer is per frame in flight, build and record are only called once the frame's fence has signalled
+	class instance_batcher
+	{
+	public:
+		static constexpr uint32_t GROUP_SIZE = 64;      // local_size_x of build_draws.comp
+		static constexpr uint32_t MIN_INSTANCES = 1024;
+		static constexpr uint32_t MIN_COMMANDS = 64;
+		static constexpr uint32_t INSTANCES_PER_JOB = 4096;
+
+		instance_batcher() = default;
+		~instance_batcher() = default;
+
+		instance_batcher(const instance_batcher&) = delete;
+		instance_batcher& operator=(const instance_batcher&) = delete;
+
+		// without indirect, or without build_draws.spv, the compute pass is skipped and batches are drawn directly
+		bool create(VkDevice device, memory_allocator& allocator, uint32_t frame_count, bool indirect);
+		void destroy();
+
+		// points the compute pass at the pyramid occlusion is tested against, again after every resize of it
+		// called with the device idle, without a pyramid only the frustum is culled
+		void bind_depth_pyramid(const depth_pyramid* pyramid);
+
+		// gpu falls back to cpu without the compute pass
+		void set_cull_mode(cull_mode mode);
+		cull_mode culling() const;
+
+		// writes the instances and one command per batch into the frame's buffers and the calls drawing them into draws,
+		// the world matrices are composed straight into the mapped buffer, on the job system when there are many
+		// view_proj is the frame's view, instances outside it are culled
+		// returns true when the frame's buffers had to grow, descriptor sets pointing at them must be rewritten
+		bool build(uint32_t frame, const glm::mat4& view_proj, const instance_list& instances, asset_manager& assets,
+		           job_system* jobs, std::vector<draw_item>& draws);
+
+		// the compute pass filling the frame's commands, recorded ahead of the render pass
+		void record(VkCommandBuffer commands, uint32_t frame);
+
+		bool indirect() const;
+
+		VkBuffer instance_buffer(uint32_t frame) const;
+		VkBuffer visible_buffer(uint32_t frame) const;
+		VkBuffer command_buffer(uint32_t frame) const;
+
+		const batcher_stats& stats() const;
+
+	private:
+		struct frame_buffers
+		{
+			VkBuffer instances = VK_NULL_HANDLE;
+			gpu_allocation instance_allocation = {};
+
+			// instance indices grouped by batch, filled by the compute pass or identity when drawing directly
+			VkBuffer visible = VK_NULL_HANDLE;
+			gpu_allocation visible_allocation = {};
+
+			VkBuffer commands = VK_NULL_HANDLE;
+			gpu_allocation command_allocation = {};
+
+			// the mesh bounds of every batch, one per command
+			VkBuffer batches = VK_NULL_HANDLE;
+			gpu_allocation batch_allocation = {};
+
+			// lives as long as the batcher, it never grows
+			VkBuffer cull = VK_NULL_HANDLE;
+			gpu_allocation cull_allocation = {};
+
+			uint32_t instance_capacity = 0;
+			uint32_t command_capacity = 0;
+			uint32_t instance_count = 0;
+			uint32_t batch_count = 0;
+			bool occlusion = false;
+
+			VkDescriptorSet set = VK_NULL_HANDLE;
+		};
+
+		bool create_pipelines();
+		bool create_pipeline(const char* path, VkPipeline& pipeline);
+		bool create_descriptor_pool(uint32_t frame_count);
+
+		// the spheres of every instance in world space against the frustum, into visible_
+		void cull_instances(const frustum& view, const instance_list& instances, const std::vector<mesh_resource>& meshes,
+		                    job_system* jobs);
+
+		// the instances the compute pass drew when the frame's buffers were last used
+		void count_visible(const frame_buffers& frame);
+
+		// the bounds of every batch and the frame's cull uniforms
+		void write_cull_data(frame_buffers& frame, const frustum& view, const std::vector<draw_item>& draws,
+		                     const std::vector<mesh_resource>& meshes);
+
+		// grows the frame's buffers to fit, grown is set when they were replaced
+		bool reserve(frame_buffers& frame, uint32_t instance_count, uint32_t command_count, bool& grown);
+		void release(frame_buffers& frame);
+		void write_descriptor_set(frame_buffers& frame);
+
+		bool create_buffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+		                   VkBuffer& buffer, gpu_allocation& allocation);
+
+		VkDevice device_ = VK_NULL_HANDLE;
+		memory_allocator* allocator_ = nullptr;
+
+		bool indirect_ = false;
+		cull_mode cull_mode_ = cull_mode::cpu;
+		const depth_pyramid* pyramid_ = nullptr;
+
+		VkDescriptorSetLayout set_layout_ = VK_NULL_HANDLE;
+		VkDescriptorPool descriptor_pool_ = VK_NULL_HANDLE;
+		VkPipelineLayout pipeline_layout_ = VK_NULL_HANDLE;
+		VkPipeline pipeline_ = VK_NULL_HANDLE;              // frustum only, never reads the pyramid
+		VkPipeline occlusion_pipeline_ = VK_NULL_HANDLE;    // frustum and depth pyramid
+
+		std::vector<frame_buffers> frames_;
+
+		// scratch reused across frames, the batch of every mesh, the next instance slot of every batch
+		// and where every instance of the list lands in the instance buffer
+		std::vector<uint32_t> batch_of_mesh_;
+		std::vector<uint32_t> cursors_;
+		std::vector<uint32_t> slots_;
+
+		// scratch of the cpu culling, the world sphere and visibility of every instance of the list
+		sphere_array spheres_;
+		std::vector<uint8_t> visible_;
+
+		batcher_stats stats_;
+	};
+}
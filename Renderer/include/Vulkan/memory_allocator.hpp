@@ -0,0 +1,151 @@
+#pragma once
+
+// Vulkan
+#include <Vulkan/vulkan_core.h>
+
+// STL
+#include <array>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	// buffers and linear images never share a block with optimal images, so bufferImageGranularity
+	// can not place a linear and an optimal resource on the same page
+	enum class resource_kind : uint32_t
+	{
+		linear = 0,
+		optimal = 1,
+	};
+
+	struct memory_block;
+
+	struct gpu_allocation
+	{
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		VkDeviceSize offset = 0;
+		VkDeviceSize size = 0;
+
+		// persistent host pointer to offset, null unless the memory is host visible
+		void* mapped = nullptr;
+
+		uint32_t memory_type = 0;
+
+		// owning block, null for dedicated allocations
+		memory_block* block = nullptr;
+	};
+
+	struct allocator_stats
+	{
+		uint32_t device_allocations = 0;    // live vkAllocateMemory calls, blocks plus dedicated
+		uint32_t block_count = 0;
+		uint32_t dedicated_count = 0;
+		uint32_t sub_allocation_count = 0;
+
+		VkDeviceSize reserved_bytes = 0;    // device memory owned by the allocator
+		VkDeviceSize used_bytes = 0;        // bytes requested by live allocations
+		VkDeviceSize padding_bytes = 0;     // lost to power of two rounding inside blocks
+
+		uint32_t peak_device_allocations = 0;
+	};
+
+	// power of two buddy sub allocator over the offsets of one block
+	// every block sits at a multiple of its own size, so rounding a request up to its alignment is enough
+	class buddy_allocator
+	{
+	public:
+		buddy_allocator(VkDeviceSize size, VkDeviceSize min_size);
+
+		// false when no free block is large enough
+		bool allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset);
+
+		// returns the size of the block that was released
+		VkDeviceSize free(VkDeviceSize offset);
+
+		VkDeviceSize size() const;
+		VkDeviceSize free_bytes() const;
+		bool empty() const;
+
+	private:
+		VkDeviceSize size_ = 0;
+		VkDeviceSize free_bytes_ = 0;
+
+		// free block offsets per level, level 0 is the whole range
+		std::vector<std::set<VkDeviceSize>> free_;
+		std::unordered_map<VkDeviceSize, uint32_t> allocated_;
+	};
+
+	struct memory_block
+	{
+		memory_block(VkDeviceSize size, VkDeviceSize min_size) : buddy(size, min_size) {}
+
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		void* mapped = nullptr;
+
+		uint32_t memory_type = 0;
+		resource_kind kind = resource_kind::linear;
+
+		buddy_allocator buddy;
+	};
+
+	// hands out sub ranges of large per memory type blocks instead of one vkAllocateMemory per resource
+	class memory_allocator
+	{
+	public:
+		static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64ull * 1024 * 1024;
+		static constexpr VkDeviceSize MIN_ALLOCATION_SIZE = 256;
+
+		memory_allocator() = default;
+		~memory_allocator();
+
+		memory_allocator(const memory_allocator&) = delete;
+		memory_allocator& operator=(const memory_allocator&) = delete;
+
+		bool create(VkPhysicalDevice physical_device, VkDevice device, VkDeviceSize block_size = DEFAULT_BLOCK_SIZE);
+		void destroy();
+
+		// requests larger than half a block get their own device allocation
+		bool allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, resource_kind kind,
+		              gpu_allocation& allocation);
+
+		void free(gpu_allocation& allocation);
+
+		// makes what the device wrote visible to host reads of the mapping, nothing to do for host coherent memory
+		void invalidate(const gpu_allocation& allocation) const;
+
+		allocator_stats stats() const;
+		void log_stats() const;
+
+	private:
+		bool allocate_from_type(uint32_t type, const VkMemoryRequirements& requirements, resource_kind kind,
+		                        gpu_allocation& allocation);
+
+		bool allocate_dedicated(uint32_t type, const VkMemoryRequirements& requirements, gpu_allocation& allocation);
+
+		memory_block* create_block(uint32_t type, resource_kind kind);
+		void destroy_block(memory_block& block);
+
+		bool allocate_device_memory(uint32_t type, VkDeviceSize size, VkDeviceMemory& memory, void*& mapped);
+
+		VkDeviceSize block_size_for(uint32_t type) const;
+		bool is_host_visible(uint32_t type) const;
+
+		VkDevice device_ = VK_NULL_HANDLE;
+		VkPhysicalDeviceMemoryProperties memory_properties_ = {};
+		VkDeviceSize block_size_ = DEFAULT_BLOCK_SIZE;
+		uint32_t max_allocations_ = 0;
+		VkDeviceSize non_coherent_atom_size_ = 1;
+
+		// blocks per memory type and resource kind
+		std::array<std::array<std::vector<std::unique_ptr<memory_block>>, 2>, VK_MAX_MEMORY_TYPES> pools_;
+
+		mutable std::mutex mutex_;
+		allocator_stats stats_;
+	};
+}
@@ -17,14 +17,25 @@ namespace Mythos::vulkan
 	const uint32_t WIDTH = 800;
 	const uint32_t HEIGHT = 600;
 
+	// msaa, present mode, swapchain images and frames in flight, the Benchmark project measures each of them
+	const frame_policy FRAME_POLICY = frame_policy::balanced;
+
 	const std::string MODEL_PATH = "../Renderer/textures/viking_room.obj";
 	const std::string TEXTURE_PATH = "../Renderer/textures/viking_room.png";
 
-	auto load_model(vulkan_data& vulkan) -> bool;
+	// the driver's compiled pipelines, reused by the next start on the same device and driver
+	const std::string PIPELINE_CACHE_PATH = "../Renderer/shaders/pipeline_cache.bin";
+
+	// models per side of the instance grid, 317 puts 100k instances through a single indirect draw
+	const uint32_t MODEL_GRID = 1;
+	const float MODEL_SPACING = 2.0f;
 
 	// --
 	
-	auto make_unique_vulkan_data(bool set_validation = false) -> std::unique_ptr<vulkan_data>;
+	auto make_unique_vulkan_data(bool set_validation = false, const render_settings& settings = render_settings::from_policy(FRAME_POLICY)) -> std::unique_ptr<vulkan_data>;
+
+	// every create step below in order, stops at the first that fails, hwnd is ignored by a headless renderer
+	auto create_renderer(void* hmodule, void* hwnd, vulkan_data& vulkan) -> bool;
 
 	auto create_instance(vulkan_data& vulkan) -> bool;
 
@@ -34,44 +45,49 @@ namespace Mythos::vulkan
 
 	auto create_logical_device(vulkan_data& vulkan) -> bool;
 
+	auto create_memory_allocator(vulkan_data& vulkan) -> bool;
+
+	auto create_staging_uploader(vulkan_data& vulkan) -> bool;
+
 	auto create_swapchain(void* hwnd, vulkan_data& vulkan) -> bool;
 
 	auto create_image_views(vulkan_data& vulkan) -> bool;
 
-	auto create_render_pass(vulkan_data& vulkan) -> bool;
+	// declares the frame's passes and compiles them, the forward pass's render pass is the one pipelines are made for
+	auto create_render_graph(vulkan_data& vulkan) -> bool;
+
+	auto create_pipeline_cache(vulkan_data& vulkan) -> bool;
 
 	auto create_descriptor_set_layout(vulkan_data& vulkan) -> bool;
 
 	auto create_graphics_pipeline(vulkan_data& vulkan) -> bool;
 
-	auto create_frame_buffers(vulkan_data& vulkan) -> bool;
+	auto create_command_recorder(vulkan_data& vulkan) -> bool;
 
-	auto create_command_pool(vulkan_data& vulkan) -> bool;
+	// a device without timestamps on the graphics queue runs without it
+	auto create_gpu_profiler(vulkan_data& vulkan) -> bool;
 
-	auto create_color_resources(vulkan_data& vulkan) -> bool;
+	// the graph's transients at the swapchain's extent, and the depth pyramid that follows the depth buffer
+	auto create_frame_resources(vulkan_data& vulkan) -> bool;
 
-	auto create_depth_resources(vulkan_data& vulkan) -> bool;
-
-	auto create_texture_image(vulkan_data& vulkan) -> bool;
-
-	auto create_texture_image_view(vulkan_data& vulkan) -> bool;
+	auto create_placeholder_texture(vulkan_data& vulkan) -> bool;
 
 	auto create_texture_sampler(vulkan_data& vulkan) -> bool;
 
-	auto create_vertex_buffer(vulkan_data& vulkan) -> bool;
-
-	auto create_index_buffer(vulkan_data& vulkan) -> bool;
-
 	auto create_uniform_buffers(vulkan_data& vulkan) -> bool;
 
-	auto create_descriptor_pool(vulkan_data& vulkan) -> bool;
+	auto create_instance_batcher(vulkan_data& vulkan) -> bool;
 
-	auto create_descriptor_set(vulkan_data& vulkan) -> bool;
+	auto create_descriptor_allocator(vulkan_data& vulkan) -> bool;
 
-	auto create_command_buffers(vulkan_data& vulkan) -> bool;
+	// puts the placeholder in the texture table's first slot, nothing to do without the table
+	auto create_texture_table(vulkan_data& vulkan) -> bool;
 
 	auto create_sync_objects(vulkan_data& vulkan) -> bool;
 
+	// creates the gpu resources of every asset the loading jobs finished since the last call
+	auto process_asset_uploads(vulkan_data& vulkan) -> void;
+
 	auto draw_frame(void* hwnd, vulkan_data& vulkan) -> void;
 
 	auto recreate_swapchain(void* hwnd, vulkan_data& vulkan) -> void;
@@ -0,0 +1,112 @@
+#pragma once
+
+// Vulkan
+#include <Vulkan/vulkan_core.h>
+
+// STL
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Mythos
+#include "Job/job_system.hpp"
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	// everything a graphics pipeline is built from, two materials with equal states share one pipeline
+	// viewport and scissor are dynamic and not part of it
+	struct pipeline_state
+	{
+		std::string vertex_shader;      // spir-v paths, the modules are loaded once per path
+		std::string fragment_shader;
+		std::vector<uint32_t> vertex_constants;     // specialization constants of the vertex shader, id is the index
+
+		std::vector<VkVertexInputBindingDescription> bindings;
+		std::vector<VkVertexInputAttributeDescription> attributes;
+
+		VkPipelineLayout layout = VK_NULL_HANDLE;
+		VkRenderPass render_pass = VK_NULL_HANDLE;
+		uint32_t subpass = 0;
+
+		VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+		float min_sample_shading = 0.0f;    // sample shading is off at 0
+		VkCullModeFlags cull_mode = VK_CULL_MODE_BACK_BIT;
+
+		bool blend = false;             // alpha blended over the target, opaque otherwise
+		bool depth_test = true;
+		bool depth_write = true;
+		VkCompareOp depth_compare = VK_COMPARE_OP_LESS;
+	};
+
+	bool operator==(const pipeline_state& a, const pipeline_state& b);
+
+	auto hash_pipeline_state(const pipeline_state& state) -> uint64_t;
+
+	struct pipeline_cache_stats
+	{
+		uint32_t pipelines = 0;     // built and owned by the cache
+		uint32_t hits = 0;          // requests answered with an existing pipeline
+		double build_ms = 0.0;      // spent in vkCreateGraphicsPipelines, summed over every thread
+	};
+
+	// a VkPipelineCache kept on disk between runs and the graphics pipelines built through it, keyed by their state
+	// the driver's cache makes a second start skip shader compilation, the state map makes a pipeline asked for
+	// twice a lookup, pipelines can be requested from any thread
+	class pipeline_cache
+	{
+	public:
+		pipeline_cache() = default;
+		~pipeline_cache() = default;
+
+		pipeline_cache(const pipeline_cache&) = delete;
+		pipeline_cache& operator=(const pipeline_cache&) = delete;
+
+		// starts from the file at path when it was written by the same driver on the same device, empty otherwise
+		bool create(VkDevice device, VkPhysicalDevice physical_device, const std::string& path);
+
+		// saves the driver's cache and destroys every pipeline it built
+		void destroy();
+
+		// writes the driver's cache to disk, through a temporary file so a crash never leaves half a cache
+		bool save() const;
+
+		// the pipeline of state, built on the calling thread the first time it is asked for
+		// VK_NULL_HANDLE when a shader is missing or the driver rejects the state
+		VkPipeline get(const pipeline_state& state);
+
+		// builds every state that is not cached yet, spread over the job system when there is one
+		void prewarm(const std::vector<pipeline_state>& states, job_system* jobs);
+
+		VkPipelineCache handle() const;
+
+		pipeline_cache_stats stats() const;
+
+	private:
+		struct state_hasher
+		{
+			size_t operator()(const pipeline_state& state) const { return static_cast<size_t>(hash_pipeline_state(state)); }
+		};
+
+		// whether the file's header matches this device, a cache of another driver is at best ignored by it
+		bool validate(const std::vector<char>& data) const;
+
+		VkShaderModule shader_module(const std::string& path);
+		VkPipeline build(const pipeline_state& state);
+
+		VkDevice device_ = VK_NULL_HANDLE;
+		VkPhysicalDeviceProperties properties_ = {};
+		VkPipelineCache cache_ = VK_NULL_HANDLE;
+		std::string path_;
+
+		// built outside the lock, two threads racing for one state keep the first pipeline and destroy the other
+		mutable std::mutex mutex_;
+		std::unordered_map<pipeline_state, VkPipeline, state_hasher> pipelines_;
+		std::unordered_map<std::string, VkShaderModule> modules_;
+		pipeline_cache_stats stats_;
+	};
+}
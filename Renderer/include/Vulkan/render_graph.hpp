@@ -0,0 +1,224 @@
+#pragma once
+
+// Vulkan
+#include <Vulkan/vulkan_core.h>
+
+// STL
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Mythos
+#include "Vulkan/memory_allocator.hpp"
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	class gpu_profiler;
+
+	// the layout an image is in and the stages and accesses that last touched it, or that are about to
+	struct image_state
+	{
+		VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+		VkPipelineStageFlags stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		VkAccessFlags access = 0;
+	};
+
+	// how the renderer uses an image in layout, for barriers in and out of it without listing every pair of layouts
+	auto layout_state(VkImageLayout layout) -> image_state;
+
+	struct graph_image
+	{
+		uint32_t index = UINT32_MAX;
+	};
+
+	struct graph_pass
+	{
+		uint32_t index = UINT32_MAX;
+	};
+
+	enum class pass_type : uint8_t
+	{
+		graphics,   // one render pass over its attachments, shader reads happen in the fragment stage
+		compute,
+	};
+
+	// how a pass touches an image, each usage decides the layout, stages and access the graph synchronises on
+	enum class image_usage : uint8_t
+	{
+		color_attachment,
+		depth_attachment,
+		resolve_attachment,
+		sampled,            // read through a sampler in the read only layout
+		depth_sampled,      // a depth buffer read through a sampler after the pass that wrote it
+		general_read,       // read by a shader in the general layout, an image that never leaves it
+		storage,            // read and written by a shader in the general layout
+	};
+
+	// a transient image is created by the graph at its extent, an imported one is handed in every frame
+	struct image_desc
+	{
+		VkFormat format = VK_FORMAT_UNDEFINED;
+		VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+		VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+	};
+
+	struct image_use
+	{
+		graph_image image = {};
+		image_usage usage = image_usage::sampled;
+		bool clear = false;
+		VkClearValue clear_value = {};
+	};
+
+	// what a graphics pass renders into, the pass begins its render pass through it and the graph ends it
+	struct pass_target
+	{
+		VkRenderPass render_pass = VK_NULL_HANDLE;
+		VkFramebuffer framebuffer = VK_NULL_HANDLE;
+		VkExtent2D extent = {};
+		const std::vector<VkClearValue>* clear_values = nullptr;
+
+		void begin(VkCommandBuffer commands, VkSubpassContents contents) const;
+	};
+
+	struct graph_stats
+	{
+		uint32_t passes = 0;            // declared
+		uint32_t culled = 0;            // nothing alive reads what they write
+		uint32_t barriers = 0;          // image barriers recorded last frame
+		uint32_t transients = 0;
+		uint32_t memory_slots = 0;      // allocations the transients share, fewer than transients when some alias
+		VkDeviceSize transient_bytes = 0;
+	};
+
+	// the frame as passes that declare the images they read and write, in the order they run
+	// compile culls the passes nothing reads from and makes a render pass for each graphics pass whose attachments
+	// are kept in the layout the graph puts them in, so every transition is a barrier the graph derives
+	// transient images whose passes never overlap share memory, each first use discards the contents of the last
+	// the queue runs frames in order and transients are shared by every frame in flight, a first use waits on
+	// every stage its memory is used in
+	class render_graph
+	{
+	public:
+		using execute_fn = std::function<void(VkCommandBuffer, const pass_target&)>;
+
+		render_graph() = default;
+		~render_graph() = default;
+
+		render_graph(const render_graph&) = delete;
+		render_graph& operator=(const render_graph&) = delete;
+
+		void create(VkDevice device, memory_allocator& allocator);
+		void destroy();
+
+		// declaration, before compile
+		graph_image add_image(const std::string& name, const image_desc& desc);
+
+		// persistent imports keep their layout from one frame to the next, the others are undefined at the frame's start
+		graph_image import_image(const std::string& name, const image_desc& desc, bool persistent);
+
+		// ends the frame in the present layout, keeps the passes writing it alive
+		void present(graph_image image);
+
+		graph_pass add_pass(const std::string& name, pass_type type, std::vector<image_use> uses, execute_fn execute);
+
+		// kept even when nothing reads its images, for a pass whose results are buffers the graph does not track
+		void keep(graph_pass pass);
+
+		bool compile();
+
+		// creates the transient images at extent and places them in memory, called again after the swapchain is recreated
+		// with the device idle
+		bool realize(VkExtent2D extent);
+
+		// before execute, every frame for images that change, after a resize for the others
+		void bind(graph_image image, VkImage handle, VkImageView view);
+
+		// each pass is timed as a region of profiler under its name when one is given, the barriers ahead of it are not
+		void execute(VkCommandBuffer commands, gpu_profiler* profiler = nullptr);
+
+		VkRenderPass render_pass(graph_pass pass) const;
+		VkImage image(graph_image image) const;
+		VkImageView view(graph_image image) const;
+		bool alive(graph_pass pass) const;
+		const graph_stats& stats() const;
+
+	private:
+		struct image_entry
+		{
+			std::string name;
+			image_desc desc;
+			bool transient = true;
+			bool persistent = false;
+			bool presented = false;
+
+			VkImageUsageFlags usage = 0;
+			uint32_t first_pass = UINT32_MAX;
+			uint32_t last_pass = 0;
+			uint32_t slot = UINT32_MAX;
+
+			VkImage image = VK_NULL_HANDLE;
+			VkImageView view = VK_NULL_HANDLE;
+			image_state state = {};
+		};
+
+		struct pass_entry
+		{
+			std::string name;
+			pass_type type = pass_type::compute;
+			std::vector<image_use> uses;
+			execute_fn execute;
+			bool keep = false;
+			bool alive = false;
+
+			VkRenderPass render_pass = VK_NULL_HANDLE;
+			std::vector<graph_image> attachments;   // in render pass order, colors, depth, resolves
+			std::vector<VkClearValue> clear_values;
+		};
+
+		// memory shared by transients with disjoint lifetimes
+		struct memory_slot
+		{
+			VkMemoryRequirements requirements = {};
+			gpu_allocation allocation = {};
+			uint32_t last_pass = 0;
+			VkPipelineStageFlags stages = 0;    // of every use of every image placed in it
+			VkAccessFlags access = 0;
+		};
+
+		struct framebuffer_entry
+		{
+			uint32_t pass = 0;
+			std::vector<VkImageView> views;
+			VkFramebuffer framebuffer = VK_NULL_HANDLE;
+		};
+
+		bool create_render_pass(pass_entry& pass);
+		VkFramebuffer framebuffer(uint32_t pass);
+		void release_transients();
+
+		image_state use_state(const image_use& use, pass_type type) const;
+		bool read_later(uint32_t image, uint32_t pass) const;
+		bool written_before(uint32_t image, uint32_t pass) const;
+
+		VkDevice device_ = VK_NULL_HANDLE;
+		memory_allocator* allocator_ = nullptr;
+
+		std::vector<image_entry> images_;
+		std::vector<pass_entry> passes_;
+		std::vector<memory_slot> slots_;
+		std::vector<framebuffer_entry> framebuffers_;
+
+		// the layouts persistent imports were left in, by handle, forgotten on realize
+		std::unordered_map<VkImage, image_state> persistent_states_;
+
+		VkExtent2D extent_ = {};
+		bool compiled_ = false;
+		graph_stats stats_ = {};
+	};
+}
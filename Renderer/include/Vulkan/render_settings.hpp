@@ -0,0 +1,54 @@
+#pragma once
+
+// Vulkan
+#include <Vulkan/vulkan_core.h>
+
+// STL
+#include <cstdint>
+#include <vector>
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	// where the renderer sits between image quality and the time from input to the image on screen
+	enum class frame_policy : uint8_t
+	{
+		low_latency,    // no multisampling, present as soon as a frame is done, one frame in flight
+		balanced,       // 4x msaa, mailbox when the surface has it, two frames in flight
+		quality,        // 8x msaa, vsync through fifo, two frames in flight
+	};
+
+	// what the renderer asks for, every value is clamped to what the device and surface support
+	// samples and frames in flight are fixed at creation, the swapchain settings apply whenever it is recreated
+	struct render_settings
+	{
+		uint32_t max_samples = 4;
+		std::vector<VkPresentModeKHR> present_modes = { VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_FIFO_KHR }; // by preference
+		uint32_t image_count = 3;
+		int frames_in_flight = 2;
+		bool srgb = true;
+
+		// renders to a VK_EXT_headless_surface swapchain nothing is shown on, at extent, for benchmarks
+		bool headless = false;
+		VkExtent2D extent = { 1280, 720 };
+
+		static render_settings from_policy(frame_policy policy);
+	};
+
+	auto policy_name(frame_policy policy) -> const char*;
+	auto present_mode_name(VkPresentModeKHR mode) -> const char*;
+
+	// the highest count in supported that is not above max_samples
+	auto choose_sample_count(VkSampleCountFlags supported, uint32_t max_samples) -> VkSampleCountFlagBits;
+
+	// the first preferred mode the surface has, fifo otherwise, the one mode every surface must support
+	auto choose_present_mode(const std::vector<VkPresentModeKHR>& available, const std::vector<VkPresentModeKHR>& preferred) -> VkPresentModeKHR;
+
+	// requested within the surface's limits, a max of 0 has no upper limit
+	auto choose_image_count(const VkSurfaceCapabilitiesKHR& capabilities, uint32_t requested) -> uint32_t;
+
+	// an 8 bit srgb format in the srgb colour space when asked for and available, the surface's first format otherwise
+	auto choose_surface_format(const std::vector<VkSurfaceFormatKHR>& available, bool srgb) -> VkSurfaceFormatKHR;
+}
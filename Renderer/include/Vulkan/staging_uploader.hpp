@@ -0,0 +1,136 @@
+#pragma once
+
+// Vulkan
+#include <Vulkan/vulkan_core.h>
+
+// STL
+#include <array>
+#include <deque>
+#include <vector>
+
+// Mythos
+#include "Vulkan/memory_allocator.hpp"
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	// where staged data landed and the command buffer the copy out of it has to be recorded into
+	struct staging_region
+	{
+		VkCommandBuffer commands = VK_NULL_HANDLE;
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VkDeviceSize offset = 0;
+	};
+
+	struct staging_stats
+	{
+		uint64_t bytes_staged = 0;
+		uint64_t uploads = 0;
+		uint64_t batches_submitted = 0;
+		uint64_t ring_stalls = 0;       // times the cpu had to wait for the gpu to free ring space
+		uint64_t oversized_uploads = 0; // uploads larger than the ring, given a buffer of their own
+	};
+
+	// one persistently mapped ring buffer that every upload is copied into, the copies are batched
+	// into a single command buffer per submit and the ring space is reclaimed as each batch's fence signals
+	// not thread safe, stage and submit from the thread that owns the graphics queue
+	class staging_uploader
+	{
+	public:
+		static constexpr VkDeviceSize DEFAULT_RING_SIZE = 32ull * 1024 * 1024;
+		static constexpr uint32_t BATCH_COUNT = 4;
+
+		staging_uploader() = default;
+		~staging_uploader() = default;
+
+		staging_uploader(const staging_uploader&) = delete;
+		staging_uploader& operator=(const staging_uploader&) = delete;
+
+		bool create(VkDevice device, VkQueue queue, uint32_t queue_family, memory_allocator& allocator,
+		            VkDeviceSize ring_size = DEFAULT_RING_SIZE);
+		void destroy();
+
+		// copies data into the ring, the caller records the transfer out of it into region.commands
+		bool stage(const void* data, VkDeviceSize size, VkDeviceSize alignment, staging_region& region);
+
+		// submits everything staged so far, returns the value the batch completes at
+		// or 0 if nothing was staged or the submit failed, a failed batch's uploads are dropped
+		uint64_t submit();
+
+		// completion values increase with every submit and batches retire in order
+		bool is_complete(uint64_t value);
+		void wait(uint64_t value);
+		void wait_idle();
+
+		const staging_stats& stats() const;
+
+	private:
+		struct batch
+		{
+			VkCommandBuffer commands = VK_NULL_HANDLE;
+			VkFence fence = VK_NULL_HANDLE;
+
+			// ring space held until the fence signals, including alignment and wrap padding
+			VkDeviceSize ring_bytes = 0;
+			VkDeviceSize ring_end = 0;
+
+			uint64_t value = 0;
+			bool recording = false;
+
+			// uploads too large for the ring staged while recording, handed to oversized_ on submit
+			std::vector<std::pair<VkBuffer, gpu_allocation>> oversized;
+
+			// anything to submit, a batch may hold oversized uploads and no ring space at all
+			bool has_work() const
+			{
+				return ring_bytes > 0 || !oversized.empty();
+			}
+		};
+
+		// a buffer of its own for an upload larger than the ring, freed once the batch it was submitted in completes
+		struct oversized_upload
+		{
+			uint64_t value = 0;
+			VkBuffer buffer = VK_NULL_HANDLE;
+			gpu_allocation allocation = {};
+		};
+
+		bool begin_batch();
+		bool reserve(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset);
+		bool stage_oversized(const void* data, VkDeviceSize size, staging_region& region);
+
+		// retires every finished batch, or blocks on the oldest one when wait is set
+		void retire(bool wait);
+		void release(batch& item);
+		void release_oversized();
+		void abandon(batch& item);
+
+		bool create_buffer(VkDeviceSize size, VkBuffer& buffer, gpu_allocation& allocation);
+
+		VkDevice device_ = VK_NULL_HANDLE;
+		VkQueue queue_ = VK_NULL_HANDLE;
+		VkCommandPool command_pool_ = VK_NULL_HANDLE;
+		memory_allocator* allocator_ = nullptr;
+
+		VkBuffer ring_ = VK_NULL_HANDLE;
+		gpu_allocation ring_allocation_ = {};
+		VkDeviceSize ring_size_ = 0;
+
+		// free space runs from head to tail, wrapping at the end of the ring
+		VkDeviceSize head_ = 0;
+		VkDeviceSize tail_ = 0;
+		VkDeviceSize in_use_ = 0;
+
+		std::array<batch, BATCH_COUNT> batches_ = {};
+		std::deque<uint32_t> pending_;
+		std::deque<oversized_upload> oversized_;
+		uint32_t current_ = 0;
+
+		uint64_t next_value_ = 1;
+		uint64_t completed_value_ = 0;
+
+		staging_stats stats_;
+	};
+}
@@ -27,11 +27,27 @@ typedef _SECURITY_ATTRIBUTES SECURITY_ATTRIBUTES;
 #include <vulkan/vulkan_win32.h>
 
 // STL
+#include <array>
+#include <chrono>
 #include <functional>
 #include <optional>
 
 // Mythos
+#include "Shader/uniform_buffer_object.hpp"
 #include "Shader/vertex.hpp"
+#include "Job/job_system.hpp"
+#include "Vulkan/asset_manager.hpp"
+#include "Vulkan/command_recorder.hpp"
+#include "Vulkan/depth_pyramid.hpp"
+#include "Vulkan/gpu_profiler.hpp"
+#include "Vulkan/descriptor_allocator.hpp"
+#include "Vulkan/descriptor_table.hpp"
+#include "Vulkan/instance_batcher.hpp"
+#include "Vulkan/memory_allocator.hpp"
+#include "Vulkan/pipeline_cache.hpp"
+#include "Vulkan/render_graph.hpp"
+#include "Vulkan/render_settings.hpp"
+#include "Vulkan/staging_uploader.hpp"
 
 // -- 
 namespace Mythos::vulkan
@@ -40,15 +56,18 @@ namespace Mythos::vulkan
 
 	struct vulkan_data
 	{
-		vulkan_data(bool enable_validation = true);
+		vulkan_data(bool enable_validation = true, const render_settings& requested = {});
 
 		~vulkan_data() = default;
 
 		// validation
 		const bool validation_enabled;
 
-		// constants
-		const int MAX_FRAMES_IN_FLIGHT = 2;
+		// what was asked for, msaa_samples and the swapchain hold what the device and surface gave
+		const render_settings settings;
+
+		// constants, fixed for the lifetime of the renderer as every per frame resource is sized by it
+		const int MAX_FRAMES_IN_FLIGHT;
 
 		// application
 		VkApplicationInfo application_info = {};
@@ -60,15 +79,26 @@ namespace Mythos::vulkan
 		VkSwapchainKHR swapchain = VK_NULL_HANDLE;
 		VkPhysicalDevice physical_device = VK_NULL_HANDLE;
 
+		memory_allocator allocator;
+		staging_uploader uploader;
+
 		VkQueue present_queue = VK_NULL_HANDLE;
 		VkQueue graphics_queue = VK_NULL_HANDLE;
 
-		VkCommandPool command_pool = VK_NULL_HANDLE;
+		// owned by the pipeline cache, which builds every graphics pipeline
+		pipeline_cache pipelines;
 		VkPipeline graphics_pipeline = VK_NULL_HANDLE;
 
-		std::vector<VkCommandBuffer> command_buffers = {};
+		// per frame primaries and the per slot pools draws are recorded into on the job system
+		command_recorder recorder;
+		job_system* jobs = nullptr;
+
+		// timestamps around the frame and each of the graph's passes, read back a slot later
+		gpu_profiler gpu_profile;
+		bool calibrated_timestamps = false;
 
 		std::vector<VkFence> in_flight_fences = {};
+		std::vector<VkFence> images_in_flight = {}; // fence of the frame last submitted to each swapchain image
 		std::vector<VkSemaphore> image_available_semaphores = {};
 		std::vector<VkSemaphore> render_finished_semaphores = {};
 
@@ -77,6 +107,7 @@ namespace Mythos::vulkan
 		VkInstanceCreateInfo instance_create_info = {};
 		VkSwapchainCreateInfoKHR swapchain_create_info{};
 		VkWin32SurfaceCreateInfoKHR surface_create_info = {};
+		VkHeadlessSurfaceCreateInfoEXT headless_surface_create_info = {};
 
 		VkFenceCreateInfo fence_create_info = {};
 		VkSemaphoreCreateInfo semaphore_create_info = {};
@@ -98,6 +129,7 @@ namespace Mythos::vulkan
 		std::vector<const char*> device_extensions = {};
 		std::vector<VkPhysicalDevice> available_devices = {};
 		VkPhysicalDeviceFeatures physical_device_features = {};
+		VkPhysicalDeviceVulkan12Features physical_device_features_12 = {}; // descriptor indexing, when bindless
 
 		// queues family indices
 		std::optional<uint32_t> graphics_queue_family_indices{};
@@ -120,50 +152,81 @@ namespace Mythos::vulkan
 		int current_frame = 0;
 		bool frame_buffer_resized = false;
 
-		std::vector<vertex> vertices = {};
-		std::vector<uint32_t> indices = {};
+		// cpu side view of how well the frames in flight overlap with the gpu
+		struct frame_timings
+		{
+			double cpu_ms = 0.0;        // recording and submitting, waits excluded
+			double fence_wait_ms = 0.0; // blocked on the gpu finishing an earlier frame
+			double acquire_ms = 0.0;    // blocked on the presentation engine
+			double frame_ms = 0.0;      // interval since the previous frame started
+			double overlap = 0.0;       // share of the frame the cpu was not blocked on the gpu, 1 when fully pipelined
+			double latency_ms = 0.0;    // from the start of the slot's last frame to its fence, an upper bound as the fence may
+			                            // have signalled before the wait, presentation excluded
+		}
+		frame_timings;
+
+		std::chrono::steady_clock::time_point last_frame_begin{};
+		std::vector<std::chrono::steady_clock::time_point> slot_frame_begins = {};
+
+		// interpolated simulation time in seconds, set by the layer before each frame
+		float animation_time = 0.0f;
 
-		VkBuffer vertex_buffer = {};
-		VkDeviceMemory vertex_buffer_memory = {};
+		asset_manager assets;
+		mesh_handle model = {};
+		texture_handle model_texture = {};
+		texture_resource placeholder_texture = {};
 
-		VkBuffer index_buffer = {};
-		VkDeviceMemory index_buffer_memory = {};
+		// the scene's instances, batched per mesh into the draw list every frame
+		instance_list instances = {};
+		instance_batcher batcher;
+		std::vector<draw_item> draw_list = {};
+
+		// the last frame's depth, what the batcher tests occlusion against
+		depth_pyramid pyramid;
+
+		// per view data, rebuilt only when the swapchain extent changes and copied into the frame's buffer
+		uniform_buffer_object view_uniforms = {};
+		VkExtent2D view_extent = {};
 
 		std::vector<VkBuffer> uniform_buffers = {};
 		std::vector<void*> uniform_buffers_mapped = {};
-		std::vector<VkDeviceMemory> uniform_buffers_memory = {};
+		std::vector<gpu_allocation> uniform_buffers_allocation = {};
+
+		// the frame's own buffers in set 0, allocated and written every frame from pools reset with its fence
+		descriptor_allocator descriptors;
+
+		// every texture in set 1, indexed by the instances, without descriptor indexing set 1 holds the model's texture alone
+		descriptor_table textures;
+		bool bindless = false;
+		VkDescriptorSetLayout texture_set_layout = {};
 
-		VkDescriptorPool descriptor_pool = {};
-		std::vector<VkDescriptorSet> descriptor_sets = {};
+		std::vector<std::array<VkDescriptorSet, 2>> frame_descriptor_sets = {};
 
 		std::vector<VkImage> images = {};
 		std::vector<VkImageView> image_views = {};
-		std::vector<VkFramebuffer> frame_buffers = {};
 
-		// probably wont store image data here in the future? 
-		uint32_t mip_levels = {};
-		VkImage texture_image = {};
 		VkSampler texture_sampler = {};
-		VkImageView texture_image_view = {};
-		VkDeviceMemory texture_image_memory = {};
 
-		VkImage color_image = {};
-		VkImageView color_image_view = {};
-		VkDeviceMemory color_image_memory = {};
 		VkSampleCountFlagBits msaa_samples = { VK_SAMPLE_COUNT_1_BIT };
 
-		VkImage depth_image = {};
-		VkImageView depth_image_view = {};
-		VkDeviceMemory depth_image_memory = {};
+		// the frame's passes and images, the multisampled color and the depth are transients it creates and places
+		render_graph graph;
+		graph_image backbuffer = {};
+		graph_image color_target = {};
+		graph_image depth_target = {};
+		graph_image pyramid_target = {};
+		graph_pass forward_pass = {};
 
 		//graphics pipeline
-		VkRenderPass render_pass = {};
+		VkRenderPass render_pass = {};      // the forward pass's, owned by the graph
 		VkPipelineLayout pipeline_layout = {};
 		VkDescriptorSetLayout descriptor_set_layout = {};
 
 	};
 
-	inline vulkan_data::vulkan_data(bool enable_validation): validation_enabled(enable_validation)
+	inline vulkan_data::vulkan_data(bool enable_validation, const render_settings& requested)
+		: validation_enabled(enable_validation), settings(requested),
+		  MAX_FRAMES_IN_FLIGHT(requested.frames_in_flight < 1 ? 1 : requested.frames_in_flight)
 	{
 		application_info = VkApplicationInfo
 		{
@@ -172,7 +235,7 @@ namespace Mythos::vulkan
 			.applicationVersion = VK_MAKE_VERSION(1, 0, 0),
 			.pEngineName = "No Engine",
 			.engineVersion = VK_MAKE_VERSION(1, 0, 0),
-			.apiVersion = VK_API_VERSION_1_0
+			.apiVersion = VK_API_VERSION_1_2
 		};
 
 		validation_layers = std::vector<const char*>
@@ -183,7 +246,7 @@ namespace Mythos::vulkan
 		required_extensions = std::vector<const char*>
 		{
 			"VK_KHR_surface",
-			"VK_KHR_win32_surface",
+			settings.headless ? VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME : "VK_KHR_win32_surface",
 		};
 
 		instance_create_info = VkInstanceCreateInfo
@@ -199,6 +262,11 @@ namespace Mythos::vulkan
 			.sType = VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR,
 		};
 
+		headless_surface_create_info = VkHeadlessSurfaceCreateInfoEXT
+		{
+			.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT,
+		};
+
 		device_extensions = std::vector<const char*>
 		{
 			VK_KHR_SWAPCHAIN_EXTENSION_NAME
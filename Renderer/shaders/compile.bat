@@ -1,3 +1,8 @@
 C:\VulkanSDK\1.3.239.0\Bin\glslc.exe shader.vert -o vert.spv
-C:\VulkanSDK\1.3.239.0\Bin\glslc.exe shader.frag -o frag.spv
+C:\VulkanSDK\1.3.239.0\Bin\glslc.exe --target-env=vulkan1.2 shader.frag -o frag.spv
+C:\VulkanSDK\1.3.239.0\Bin\glslc.exe -DSINGLE_TEXTURE shader.frag -o frag_single.spv
+C:\VulkanSDK\1.3.239.0\Bin\glslc.exe build_draws.comp -o build_draws.spv
+C:\VulkanSDK\1.3.239.0\Bin\glslc.exe -DOCCLUSION build_draws.comp -o build_draws_occlusion.spv
+C:\VulkanSDK\1.3.239.0\Bin\glslc.exe depth_pyramid.comp -o depth_pyramid.spv
+C:\VulkanSDK\1.3.239.0\Bin\glslc.exe -DMULTISAMPLED depth_pyramid.comp -o depth_pyramid_ms.spv
 pause
\ No newline at end of file
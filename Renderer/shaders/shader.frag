@@ -1,13 +1,28 @@
 #version 450
 
-layout(location = 0) in vec3 fragColor;
+// without descriptor indexing the renderer binds the model's texture alone, see create_descriptor_set_layout
+#ifndef SINGLE_TEXTURE
+#extension GL_EXT_nonuniform_qualifier : require
+#endif
+
+layout(location = 0) in vec3 fragNormal;
 layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) flat in uint fragTexture;
 
 layout(location = 0) out vec4 outColor;
 
-layout(binding = 1) uniform sampler2D texSampler;
+#ifdef SINGLE_TEXTURE
+layout(set = 1, binding = 0) uniform sampler2D texSampler;
+#else
+// the descriptor table, see Vulkan/descriptor_table.hpp
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+#endif
 
 void main() 
 {
+#ifdef SINGLE_TEXTURE
     outColor = texture(texSampler, fragTexCoord);
+#else
+    outColor = texture(textures[nonuniformEXT(fragTexture)], fragTexCoord);
+#endif
 }
\ No newline at end of file
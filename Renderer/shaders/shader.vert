@@ -1,23 +1,61 @@
 #version 450
 
-layout(binding = 0) uniform UniformBufferObject 
+layout(set = 0, binding = 0) uniform UniformBufferObject 
 {
-    mat4 model;
     mat4 view;
     mat4 proj;
+    mat4 view_proj;
 } ubo;
 
+// the top three rows of the world matrix, see Shader/instance_data.hpp
+struct Instance
+{
+    mat3x4 model;
+    uint batch;
+    uint texture;
+    uint padding0;
+    uint padding1;
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer Instances
+{
+    Instance instances[];
+};
+
+// instance indices grouped by batch, gl_InstanceIndex starts at the batch's first instance
+layout(std430, set = 0, binding = 2) readonly buffer VisibleInstances
+{
+    uint visible[];
+};
+
+// set from the vertex layout when the pipeline is created, see Shader/vertex_layout.hpp
+layout(constant_id = 0) const bool OCTAHEDRAL_NORMALS = false;
+
+// quantized formats arrive here already normalized, positions are scaled back by the instance's model matrix
 layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inColor;
+layout(location = 1) in vec3 inNormal;
 layout(location = 2) in vec2 inTexCoord;
 
-layout(location = 0) out vec3 fragColor;
+layout(location = 0) out vec3 fragNormal;
 layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) flat out uint fragTexture;
 
+vec3 decode_octahedral(vec2 folded)
+{
+    vec3 normal = vec3(folded, 1.0 - abs(folded.x) - abs(folded.y));
+    float fold = max(-normal.z, 0.0);
+    normal.xy += vec2(normal.x >= 0.0 ? -fold : fold, normal.y >= 0.0 ? -fold : fold);
+    return normalize(normal);
+}
 
 void main() 
 {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
-    fragColor = inColor;
+    // two matrix vector products per vertex, the matrix products are all taken on the cpu
+    Instance instance = instances[visible[gl_InstanceIndex]];
+    vec3 world = vec4(inPosition, 1.0) * instance.model;
+
+    gl_Position = ubo.view_proj * vec4(world, 1.0);
+    fragNormal = OCTAHEDRAL_NORMALS ? decode_octahedral(inNormal.xy) : inNormal;
     fragTexCoord = inTexCoord;
+    fragTexture = instance.texture;
 }
\ No newline at end of file
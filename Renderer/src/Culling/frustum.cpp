@@ -0,0 +1,107 @@
+#include "Culling/frustum.hpp"
+
+// STL
+#include <bit>
+
+// GLM
+#include <glm/geometric.hpp>
+
+// SIMD
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MYTHOS_CULL_SSE
+#endif
+
+// --
+namespace Mythos
+{
+	// --
+
+	auto extract_frustum(const glm::mat4& view_proj) -> frustum
+	{
+		// rows of the matrix, glm stores columns
+		const auto row = [&view_proj](int i)
+		{
+			return glm::vec4(view_proj[0][i], view_proj[1][i], view_proj[2][i], view_proj[3][i]);
+		};
+
+		const auto x = row(0);
+		const auto y = row(1);
+		const auto z = row(2);
+		const auto w = row(3);
+
+		auto result = frustum{ { w + x, w - x, w + y, w - y, z, w - z } };
+
+		for (auto& plane : result.planes)
+		{
+			plane /= glm::length(glm::vec3(plane));
+		}
+
+		return result;
+	}
+
+	static auto sphere_visible(const frustum& view, float x, float y, float z, float radius) -> bool
+	{
+		for (const auto& plane : view.planes)
+		{
+			// summed in the order the simd version does, so both agree on spheres that only just touch a plane
+			if (plane.x * x + plane.w + plane.y * y + plane.z * z < -radius) return false;
+		}
+
+		return true;
+	}
+
+	auto cull_spheres_scalar(const frustum& view, const sphere_array& spheres, uint32_t begin, uint32_t end, uint8_t* visible) -> uint32_t
+	{
+		auto count = 0u;
+
+		for (auto i = begin; i < end; i++)
+		{
+			visible[i] = sphere_visible(view, spheres.x[i], spheres.y[i], spheres.z[i], spheres.radius[i]) ? 1 : 0;
+			count += visible[i];
+		}
+
+		return count;
+	}
+
+	auto cull_spheres(const frustum& view, const sphere_array& spheres, uint32_t begin, uint32_t end, uint8_t* visible) -> uint32_t
+	{
+#ifdef MYTHOS_CULL_SSE
+		auto count = 0u;
+		auto i = begin;
+
+		for (; i + 4 <= end; i += 4)
+		{
+			const auto x = _mm_loadu_ps(spheres.x.data() + i);
+			const auto y = _mm_loadu_ps(spheres.y.data() + i);
+			const auto z = _mm_loadu_ps(spheres.z.data() + i);
+			const auto negative_radius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(spheres.radius.data() + i));
+
+			auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+			for (const auto& plane : view.planes)
+			{
+				auto distance = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.x)), _mm_set1_ps(plane.w));
+				distance = _mm_add_ps(distance, _mm_mul_ps(y, _mm_set1_ps(plane.y)));
+				distance = _mm_add_ps(distance, _mm_mul_ps(z, _mm_set1_ps(plane.z)));
+
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negative_radius));
+			}
+
+			const auto mask = static_cast<uint32_t>(_mm_movemask_ps(inside));
+
+			visible[i + 0] = (mask >> 0) & 1;
+			visible[i + 1] = (mask >> 1) & 1;
+			visible[i + 2] = (mask >> 2) & 1;
+			visible[i + 3] = (mask >> 3) & 1;
+
+			count += static_cast<uint32_t>(std::popcount(mask));
+		}
+
+		// the last few spheres that do not fill a register
+		return count + cull_spheres_scalar(view, spheres, i, end, visible);
+#else
+		return cull_spheres_scalar(view, spheres, begin, end, visible);
+#endif
+	}
+}
@@ -0,0 +1,283 @@
+#include "Mesh/mesh_import.hpp"
+
+// STL
+#include <algorithm>
+#include <bit>
+
+// GLM
+#include "glm/geometric.hpp"
+
+// Tiny obj
+#define TINYOBJLOADER_IMPLEMENTATION
+#include <tiny_obj_loader.h>
+
+// Mythos
+#include "Debug.hpp"
+
+// --
+namespace Mythos
+{
+	// --
+
+	// corners welded per job, a multiple of three so no triangle straddles two chunks
+	static constexpr uint32_t WELD_CHUNK_SIZE = 3 * 32 * 1024;
+
+	// open addressing with linear probing, sized once for the worst case so it never grows
+	class vertex_welder
+	{
+	public:
+		// capacity is the most vertices that will ever be inserted, the corner count of the input
+		explicit vertex_welder(size_t capacity)
+		{
+			const auto slot_count = std::bit_ceil(std::max<size_t>(capacity * 2, 16));
+
+			slots_.assign(slot_count, { 0, EMPTY });
+			mask_ = slot_count - 1;
+		}
+
+		// index of the vertex in vertices, appending it the first time it is seen
+		auto insert(const vertex& value, std::vector<vertex>& vertices) -> uint32_t
+		{
+			const auto hash = hash_vertex(value);
+			const auto tag = static_cast<uint32_t>(hash >> 32);
+
+			for (auto slot = static_cast<size_t>(hash) & mask_;; slot = (slot + 1) & mask_)
+			{
+				auto& entry = slots_[slot];
+
+				if (entry.index == EMPTY)
+				{
+					entry = { tag, static_cast<uint32_t>(vertices.size()) };
+					vertices.push_back(value);
+					return entry.index;
+				}
+
+				// the upper hash bits reject almost every collision without touching the vertex
+				if (entry.tag == tag && vertices[entry.index] == value)
+				{
+					return entry.index;
+				}
+			}
+		}
+
+	private:
+		static constexpr uint32_t EMPTY = UINT32_MAX;
+
+		struct slot
+		{
+			uint32_t tag;
+			uint32_t index;
+		};
+
+		std::vector<slot> slots_;
+		size_t mask_ = 0;
+	};
+
+	auto import_obj(const std::string& path, std::vector<vertex>& corners, job_system* jobs) -> bool
+	{
+		tinyobj::attrib_t attrib;
+		std::vector<tinyobj::shape_t> shapes;
+		std::vector<tinyobj::material_t> materials;
+		std::string warn, err;
+
+		// runs on the job system and in the cooker, nothing to catch a throw in either
+		if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str()))
+		{
+			Debug::error("Failed to load model " + path + " : " + warn + err);
+			return false;
+		}
+
+		// every shape writes its own range of corners
+		auto offsets = std::vector<size_t>(shapes.size() + 1, 0);
+		for (size_t i = 0; i < shapes.size(); i++)
+		{
+			offsets[i + 1] = offsets[i] + shapes[i].mesh.indices.size();
+		}
+
+		corners.resize(offsets.back());
+
+		// faces without normals share an area weighted average over every face using the position,
+		// which keeps smooth surfaces welded where per face normals would split every vertex
+		auto smooth_normals = std::vector<glm::vec3>();
+
+		for (const auto& shape : shapes)
+		{
+			const auto& indices = shape.mesh.indices;
+
+			for (size_t c = 0; c + 2 < indices.size(); c += 3)
+			{
+				if (indices[c].normal_index >= 0 && indices[c + 1].normal_index >= 0 && indices[c + 2].normal_index >= 0) continue;
+
+				if (smooth_normals.empty())
+				{
+					smooth_normals.assign(attrib.vertices.size() / 3, glm::vec3(0.0f));
+				}
+
+				const auto position = [&](size_t corner)
+				{
+					const auto* value = &attrib.vertices[3 * indices[corner].vertex_index];
+					return glm::vec3(value[0], value[1], value[2]);
+				};
+
+				const auto face = glm::cross(position(c + 1) - position(c), position(c + 2) - position(c));
+
+				for (auto k = 0; k < 3; k++)
+				{
+					smooth_normals[indices[c + k].vertex_index] += face;
+				}
+			}
+		}
+
+		for (auto& normal : smooth_normals)
+		{
+			const auto length = glm::length(normal);
+			normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+		}
+
+		const auto build_shapes = [&](uint32_t begin, uint32_t end)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				auto* corner = corners.data() + offsets[i];
+
+				for (const auto& index : shapes[i].mesh.indices)
+				{
+					corner->pos =
+					{
+						attrib.vertices[3 * index.vertex_index + 0],
+						attrib.vertices[3 * index.vertex_index + 1],
+						attrib.vertices[3 * index.vertex_index + 2]
+					};
+
+					corner->normal = index.normal_index < 0 ? smooth_normals[index.vertex_index] : glm::vec3
+					{
+						attrib.normals[3 * index.normal_index + 0],
+						attrib.normals[3 * index.normal_index + 1],
+						attrib.normals[3 * index.normal_index + 2]
+					};
+
+					// faces without texture coordinates get the origin rather than reading before the array
+					corner->tex_coord = index.texcoord_index < 0 ? glm::vec2(0.0f) : glm::vec2
+					{
+						attrib.texcoords[2 * index.texcoord_index + 0],
+						1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
+					};
+
+					corner++;
+				}
+			}
+		};
+
+		const auto shape_count = static_cast<uint32_t>(shapes.size());
+
+		if (jobs != nullptr)
+		{
+			jobs->parallel_for(shape_count, 1, build_shapes);
+		}
+		else
+		{
+			build_shapes(0, shape_count);
+		}
+
+		return true;
+	}
+
+	auto weld_vertices(const std::vector<vertex>& corners, std::vector<vertex>& vertices, std::vector<uint32_t>& indices,
+	                   job_system* jobs) -> void
+	{
+		vertices.clear();
+		indices.resize(corners.size());
+
+		const auto corner_count = static_cast<uint32_t>(corners.size());
+		const auto chunk_count = (corner_count + WELD_CHUNK_SIZE - 1) / WELD_CHUNK_SIZE;
+
+		if (jobs == nullptr || chunk_count <= 1)
+		{
+			auto welder = vertex_welder(corners.size());
+
+			for (uint32_t i = 0; i < corner_count; i++)
+			{
+				indices[i] = welder.insert(corners[i], vertices);
+			}
+
+			return;
+		}
+
+		// each chunk welds on its own, then the chunks' vertices are merged in order
+		// a vertex new to the merge first appears in the earliest chunk that uses it, at its first use there,
+		// so the result matches welding every corner on one thread
+		struct chunk
+		{
+			std::vector<vertex> vertices;
+			std::vector<uint32_t> remap;
+		};
+
+		auto chunks = std::vector<chunk>(chunk_count);
+
+		jobs->parallel_for(chunk_count, 1, [&](uint32_t begin, uint32_t end)
+		{
+			for (auto c = begin; c < end; c++)
+			{
+				const auto first = c * WELD_CHUNK_SIZE;
+				const auto last = std::min(corner_count, first + WELD_CHUNK_SIZE);
+
+				auto welder = vertex_welder(last - first);
+
+				for (auto i = first; i < last; i++)
+				{
+					indices[i] = welder.insert(corners[i], chunks[c].vertices);
+				}
+			}
+		});
+
+		auto local_total = size_t();
+		for (const auto& item : chunks)
+		{
+			local_total += item.vertices.size();
+		}
+
+		auto welder = vertex_welder(local_total);
+		vertices.reserve(local_total);
+
+		for (auto& item : chunks)
+		{
+			item.remap.resize(item.vertices.size());
+
+			for (size_t i = 0; i < item.vertices.size(); i++)
+			{
+				item.remap[i] = welder.insert(item.vertices[i], vertices);
+			}
+
+			item.vertices = {};
+		}
+
+		// chunk local indices to merged ones
+		jobs->parallel_for(chunk_count, 1, [&](uint32_t begin, uint32_t end)
+		{
+			for (auto c = begin; c < end; c++)
+			{
+				const auto first = c * WELD_CHUNK_SIZE;
+				const auto last = std::min(corner_count, first + WELD_CHUNK_SIZE);
+
+				for (auto i = first; i < last; i++)
+				{
+					indices[i] = chunks[c].remap[indices[i]];
+				}
+			}
+		});
+	}
+
+	auto load_model(const std::string& path, std::vector<vertex>& vertices, std::vector<uint32_t>& indices,
+	                job_system* jobs) -> bool
+	{
+		auto corners = std::vector<vertex>();
+
+		if (!import_obj(path, corners, jobs))
+		{
+			return false;
+		}
+
+		weld_vertices(corners, vertices, indices, jobs);
+		return true;
+	}
+}
@@ -0,0 +1,375 @@
+#include "Mesh/mesh_optimizer.hpp"
+
+// STL
+#include <algorithm>
+#include <numeric>
+
+// GLM
+#include "glm/geometric.hpp"
+
+// --
+namespace Mythos
+{
+	// --
+
+	// a fifo keyed by insertion time, a vertex is still cached while fewer than cache_size misses came after it
+	// bumping the clock by cache_size + 1 empties the cache without touching the stamps
+	class fifo_cache
+	{
+	public:
+		fifo_cache(size_t vertex_count, uint32_t cache_size)
+			: stamps_(vertex_count, 0), size_(cache_size), time_(cache_size + 1) {}
+
+		// true on a miss, which also inserts the vertex
+		bool access(uint32_t index)
+		{
+			if (time_ - stamps_[index] <= size_) return false;
+
+			stamps_[index] = time_++;
+			return true;
+		}
+
+		// tipsify wants to know how long ago a vertex went in, not just whether it is still there
+		uint32_t age(uint32_t index) const
+		{
+			return time_ - stamps_[index];
+		}
+
+		void flush()
+		{
+			time_ += size_ + 1;
+		}
+
+	private:
+		std::vector<uint32_t> stamps_;
+		uint32_t size_ = 0;
+		uint32_t time_ = 0;
+	};
+
+	auto analyze_vertex_cache(const std::vector<uint32_t>& indices, uint32_t vertex_count, uint32_t vertex_stride,
+	                          uint32_t cache_size) -> vertex_cache_stats
+	{
+		if (indices.empty() || vertex_count == 0) return {};
+
+		// 16KB of direct mapped 64 byte lines in front of the vertex buffer
+		constexpr uint64_t LINE_SIZE = 64;
+		constexpr uint64_t LINE_COUNT = 256;
+
+		auto cache = fifo_cache(vertex_count, cache_size);
+		auto lines = std::vector<uint64_t>(LINE_COUNT, UINT64_MAX);
+		auto used = std::vector<bool>(vertex_count, false);
+
+		auto misses = uint64_t();
+		auto fetched = uint64_t();
+		auto used_count = uint64_t();
+
+		for (const auto index : indices)
+		{
+			if (!used[index])
+			{
+				used[index] = true;
+				used_count++;
+			}
+
+			if (!cache.access(index)) continue;
+			misses++;
+
+			const auto first = index * static_cast<uint64_t>(vertex_stride) / LINE_SIZE;
+			const auto last = ((index + 1ull) * vertex_stride - 1) / LINE_SIZE;
+
+			for (auto line = first; line <= last; line++)
+			{
+				if (lines[line % LINE_COUNT] == line) continue;
+
+				lines[line % LINE_COUNT] = line;
+				fetched += LINE_SIZE;
+			}
+		}
+
+		return
+		{
+			.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3),
+			.atvr = static_cast<float>(misses) / static_cast<float>(used_count),
+			.overfetch = static_cast<float>(fetched) / static_cast<float>(uint64_t(vertex_count) * vertex_stride),
+		};
+	}
+
+	auto optimize_vertex_cache(std::vector<uint32_t>& indices, uint32_t vertex_count, std::vector<uint32_t>& clusters,
+	                           uint32_t cache_size) -> void
+	{
+		clusters.clear();
+
+		const auto triangle_count = static_cast<uint32_t>(indices.size() / 3);
+		if (triangle_count == 0) return;
+
+		// triangles around each vertex, and how many of them are still to be emitted
+		auto live = std::vector<uint32_t>(vertex_count, 0);
+		for (const auto index : indices)
+		{
+			live[index]++;
+		}
+
+		auto offsets = std::vector<uint32_t>(vertex_count + 1, 0);
+		std::inclusive_scan(live.begin(), live.end(), offsets.begin() + 1);
+
+		auto adjacency = std::vector<uint32_t>(indices.size());
+		auto fill = std::vector<uint32_t>(offsets.begin(), offsets.end() - 1);
+
+		for (uint32_t i = 0; i < indices.size(); i++)
+		{
+			adjacency[fill[indices[i]]++] = i / 3;
+		}
+
+		auto cache = fifo_cache(vertex_count, cache_size);
+		auto emitted = std::vector<bool>(triangle_count, false);
+
+		auto result = std::vector<uint32_t>();
+		result.reserve(indices.size());
+
+		// every vertex of every emitted triangle, the most recent first, to restart from after a dead end
+		auto dead_ends = std::vector<uint32_t>();
+		dead_ends.reserve(indices.size());
+
+		auto candidates = std::vector<uint32_t>();
+		auto cursor = 0u;
+		auto current = indices[0];
+		auto new_cluster = true;
+
+		while (current != UINT32_MAX)
+		{
+			candidates.clear();
+
+			for (auto i = offsets[current]; i < offsets[current + 1]; i++)
+			{
+				const auto triangle = adjacency[i];
+				if (emitted[triangle]) continue;
+
+				if (new_cluster)
+				{
+					clusters.push_back(static_cast<uint32_t>(result.size() / 3));
+					new_cluster = false;
+				}
+
+				for (auto corner = 0; corner < 3; corner++)
+				{
+					const auto index = indices[triangle * 3 + corner];
+
+					result.push_back(index);
+					dead_ends.push_back(index);
+					candidates.push_back(index);
+
+					live[index]--;
+					cache.access(index);
+				}
+
+				emitted[triangle] = true;
+			}
+
+			// the vertex that has been in the cache longest and can still have all of its triangles emitted
+			// before it falls out, falling back to any vertex with triangles left
+			current = UINT32_MAX;
+			auto best_priority = -1ll;
+
+			for (const auto index : candidates)
+			{
+				if (live[index] == 0) continue;
+
+				auto priority = 0ll;
+				if (cache.age(index) + 2ull * live[index] <= cache_size)
+				{
+					priority = cache.age(index);
+				}
+
+				if (priority > best_priority)
+				{
+					best_priority = priority;
+					current = index;
+				}
+			}
+
+			if (current != UINT32_MAX) continue;
+
+			// dead end, back up through recently used vertices before scanning for untouched ones
+			new_cluster = true;
+
+			while (!dead_ends.empty() && current == UINT32_MAX)
+			{
+				const auto index = dead_ends.back();
+				dead_ends.pop_back();
+
+				if (live[index] > 0) current = index;
+			}
+
+			while (cursor < vertex_count && current == UINT32_MAX)
+			{
+				if (live[cursor] > 0) current = cursor;
+				cursor++;
+			}
+		}
+
+		indices = std::move(result);
+	}
+
+	auto optimize_overdraw(std::vector<uint32_t>& indices, const std::vector<vertex>& vertices,
+	                       std::vector<uint32_t>& clusters, float threshold, uint32_t cache_size) -> void
+	{
+		const auto triangle_count = static_cast<uint32_t>(indices.size() / 3);
+		if (triangle_count == 0 || clusters.empty()) return;
+
+		auto cache = fifo_cache(vertices.size(), cache_size);
+
+		const auto misses = [&](uint32_t triangle)
+		{
+			return uint32_t(cache.access(indices[triangle * 3 + 0])) + uint32_t(cache.access(indices[triangle * 3 + 1])) +
+				uint32_t(cache.access(indices[triangle * 3 + 2]));
+		};
+
+		// a run is cut as soon as it is almost as cache efficient as the whole hard cluster it came from
+		// smaller clusters sort better, the threshold bounds what the extra cold starts cost
+		auto soft = std::vector<uint32_t>();
+
+		for (size_t c = 0; c < clusters.size(); c++)
+		{
+			const auto start = clusters[c];
+			const auto end = c + 1 < clusters.size() ? clusters[c + 1] : triangle_count;
+
+			cache.flush();
+
+			auto cluster_misses = 0u;
+			for (auto triangle = start; triangle < end; triangle++)
+			{
+				cluster_misses += misses(triangle);
+			}
+
+			const auto target = threshold * static_cast<float>(cluster_misses) / static_cast<float>(end - start);
+
+			soft.push_back(start);
+			cache.flush();
+
+			auto running_misses = 0u;
+			auto running_triangles = 0u;
+
+			for (auto triangle = start; triangle + 1 < end; triangle++)
+			{
+				running_misses += misses(triangle);
+				running_triangles++;
+
+				if (static_cast<float>(running_misses) / static_cast<float>(running_triangles) <= target)
+				{
+					soft.push_back(triangle + 1);
+					cache.flush();
+
+					running_misses = 0;
+					running_triangles = 0;
+				}
+			}
+		}
+
+		auto mesh_centre = glm::vec3(0.0f);
+		for (const auto& item : vertices)
+		{
+			mesh_centre += item.pos;
+		}
+		mesh_centre /= static_cast<float>(vertices.size());
+
+		// clusters facing out from the centre are the likeliest to cover the others
+		auto sort_keys = std::vector<float>(soft.size(), 0.0f);
+
+		for (size_t c = 0; c < soft.size(); c++)
+		{
+			const auto end = c + 1 < soft.size() ? soft[c + 1] : triangle_count;
+
+			auto centroid = glm::vec3(0.0f);
+			auto normal = glm::vec3(0.0f);
+			auto area = 0.0f;
+
+			for (auto triangle = soft[c]; triangle < end; triangle++)
+			{
+				const auto& p0 = vertices[indices[triangle * 3 + 0]].pos;
+				const auto& p1 = vertices[indices[triangle * 3 + 1]].pos;
+				const auto& p2 = vertices[indices[triangle * 3 + 2]].pos;
+
+				const auto cross = glm::cross(p1 - p0, p2 - p0);
+				const auto weight = glm::length(cross);
+
+				centroid += (p0 + p1 + p2) * (weight / 3.0f);
+				normal += cross;
+				area += weight;
+			}
+
+			const auto normal_length = glm::length(normal);
+			if (area <= 0.0f || normal_length <= 0.0f) continue;
+
+			sort_keys[c] = glm::dot(centroid / area - mesh_centre, normal / normal_length);
+		}
+
+		auto order = std::vector<uint32_t>(soft.size());
+		std::iota(order.begin(), order.end(), 0u);
+		std::ranges::stable_sort(order, [&](uint32_t lhs, uint32_t rhs) { return sort_keys[lhs] > sort_keys[rhs]; });
+
+		auto result = std::vector<uint32_t>();
+		result.reserve(indices.size());
+		clusters.clear();
+
+		for (const auto c : order)
+		{
+			const auto start = soft[c];
+			const auto end = c + 1 < soft.size() ? soft[c + 1] : triangle_count;
+
+			clusters.push_back(static_cast<uint32_t>(result.size() / 3));
+			result.insert(result.end(), indices.begin() + start * 3ull, indices.begin() + end * 3ull);
+		}
+
+		indices = std::move(result);
+	}
+
+	// consecutive triangles then fetch neighbouring vertices, which is what the pre transform cache wants
+	auto optimize_vertex_fetch(std::vector<vertex>& vertices, std::vector<uint32_t>& indices) -> void
+	{
+		constexpr auto unused = UINT32_MAX;
+
+		auto remap = std::vector<uint32_t>(vertices.size(), unused);
+		auto compacted = std::vector<vertex>();
+		compacted.reserve(vertices.size());
+
+		for (auto& index : indices)
+		{
+			if (remap[index] == unused)
+			{
+				remap[index] = static_cast<uint32_t>(compacted.size());
+				compacted.push_back(vertices[index]);
+			}
+
+			index = remap[index];
+		}
+
+		vertices = std::move(compacted);
+	}
+
+	auto optimize_mesh(std::vector<vertex>& vertices, std::vector<uint32_t>& indices, mesh_optimize_stats* stats,
+	                   uint32_t vertex_stride) -> void
+	{
+		const auto analyze = [&](vertex_cache_stats mesh_optimize_stats::* pass)
+		{
+			if (stats == nullptr) return;
+			stats->*pass = analyze_vertex_cache(indices, static_cast<uint32_t>(vertices.size()), vertex_stride);
+		};
+
+		analyze(&mesh_optimize_stats::source);
+
+		auto clusters = std::vector<uint32_t>();
+		optimize_vertex_cache(indices, static_cast<uint32_t>(vertices.size()), clusters);
+		analyze(&mesh_optimize_stats::vertex_cache);
+
+		optimize_overdraw(indices, vertices, clusters);
+		analyze(&mesh_optimize_stats::overdraw);
+
+		optimize_vertex_fetch(vertices, indices);
+		analyze(&mesh_optimize_stats::vertex_fetch);
+
+		if (stats != nullptr)
+		{
+			stats->cluster_count = static_cast<uint32_t>(clusters.size());
+		}
+	}
+}
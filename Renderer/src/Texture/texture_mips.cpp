@@ -0,0 +1,243 @@
+#include "Texture/texture_mips.hpp"
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+
+// --
+namespace Mythos
+{
+	// --
+
+	// taps for one output texel along one axis
+	struct filter_taps
+	{
+		int32_t first = 0;
+		uint32_t count = 0;
+		uint32_t weights = 0; // offset into the weight table
+	};
+
+	static auto srgb_to_linear(float value) -> float
+	{
+		return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	static auto linear_to_srgb(float value) -> float
+	{
+		return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+	}
+
+	static auto lanczos2(float x) -> float
+	{
+		x = std::abs(x);
+		if (x < 1e-5f) return 1.0f;
+		if (x >= 2.0f) return 0.0f;
+
+		const auto pi_x = std::numbers::pi_v<float> * x;
+		return 2.0f * std::sin(pi_x) * std::sin(pi_x * 0.5f) / (pi_x * pi_x);
+	}
+
+	// the kernel is stretched by the scale so it stays a low pass filter for the smaller image
+	static auto build_taps(uint32_t source_size, uint32_t target_size, std::vector<filter_taps>& taps,
+	                       std::vector<float>& weights) -> void
+	{
+		const auto scale = static_cast<float>(source_size) / static_cast<float>(target_size);
+		const auto support = 2.0f * scale;
+
+		taps.resize(target_size);
+		weights.clear();
+
+		for (uint32_t i = 0; i < target_size; i++)
+		{
+			const auto centre = (static_cast<float>(i) + 0.5f) * scale;
+			const auto first = static_cast<int32_t>(std::floor(centre - support));
+			const auto last = static_cast<int32_t>(std::ceil(centre + support));
+
+			auto& tap = taps[i];
+			tap.first = first;
+			tap.count = static_cast<uint32_t>(last - first + 1);
+			tap.weights = static_cast<uint32_t>(weights.size());
+
+			auto total = 0.0f;
+			for (auto s = first; s <= last; s++)
+			{
+				const auto weight = lanczos2((static_cast<float>(s) + 0.5f - centre) / scale);
+				weights.push_back(weight);
+				total += weight;
+			}
+
+			for (uint32_t k = 0; k < tap.count; k++)
+			{
+				weights[tap.weights + k] /= total;
+			}
+		}
+	}
+
+	static auto for_rows(uint32_t count, job_system* jobs, const auto& function) -> void
+	{
+		if (jobs != nullptr)
+		{
+			jobs->parallel_for(count, 16, function);
+		}
+		else
+		{
+			function(0u, count);
+		}
+	}
+
+	auto to_float_image(const uint8_t* rgba, uint32_t width, uint32_t height, bool srgb) -> float_image
+	{
+		auto table = std::array<float, 256>();
+		for (auto i = 0; i < 256; i++)
+		{
+			table[i] = srgb ? srgb_to_linear(i / 255.0f) : i / 255.0f;
+		}
+
+		auto image = float_image{ width, height, std::vector<float>(static_cast<size_t>(width) * height * 4) };
+
+		for (size_t i = 0; i < static_cast<size_t>(width) * height; i++)
+		{
+			const auto alpha = rgba[i * 4 + 3] / 255.0f;
+
+			image.texels[i * 4 + 0] = table[rgba[i * 4 + 0]] * alpha;
+			image.texels[i * 4 + 1] = table[rgba[i * 4 + 1]] * alpha;
+			image.texels[i * 4 + 2] = table[rgba[i * 4 + 2]] * alpha;
+			image.texels[i * 4 + 3] = alpha;
+		}
+
+		return image;
+	}
+
+	auto to_rgba8(const float_image& image, bool srgb, uint8_t* rgba) -> void
+	{
+		const auto quantize = [](float value) { return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f)); };
+
+		for (size_t i = 0; i < static_cast<size_t>(image.width) * image.height; i++)
+		{
+			const auto alpha = std::clamp(image.texels[i * 4 + 3], 0.0f, 1.0f);
+
+			for (auto c = 0; c < 3; c++)
+			{
+				// fully transparent texels have lost their colour to the premultiply, black is as good as any
+				auto value = alpha > 0.0f ? std::clamp(image.texels[i * 4 + c] / alpha, 0.0f, 1.0f) : 0.0f;
+				rgba[i * 4 + c] = quantize(srgb ? linear_to_srgb(value) : value);
+			}
+
+			rgba[i * 4 + 3] = quantize(alpha);
+		}
+	}
+
+	auto downsample(const float_image& source, job_system* jobs) -> float_image
+	{
+		const auto width = std::max(1u, source.width / 2);
+		const auto height = std::max(1u, source.height / 2);
+
+		auto column_taps = std::vector<filter_taps>();
+		auto column_weights = std::vector<float>();
+		auto row_taps = std::vector<filter_taps>();
+		auto row_weights = std::vector<float>();
+
+		build_taps(source.width, width, column_taps, column_weights);
+		build_taps(source.height, height, row_taps, row_weights);
+
+		const auto clamp_index = [](int32_t value, uint32_t size) { return static_cast<uint32_t>(std::clamp(value, 0, static_cast<int32_t>(size) - 1)); };
+
+		// horizontal pass into a target width by source height image
+		auto horizontal = std::vector<float>(static_cast<size_t>(width) * source.height * 4);
+
+		for_rows(source.height, jobs, [&](uint32_t begin, uint32_t end)
+		{
+			for (auto y = begin; y < end; y++)
+			{
+				const auto* row = source.texels.data() + static_cast<size_t>(y) * source.width * 4;
+				auto* out = horizontal.data() + static_cast<size_t>(y) * width * 4;
+
+				for (uint32_t x = 0; x < width; x++)
+				{
+					const auto& tap = column_taps[x];
+					auto sum = std::array<float, 4>();
+
+					for (uint32_t k = 0; k < tap.count; k++)
+					{
+						const auto* texel = row + clamp_index(tap.first + static_cast<int32_t>(k), source.width) * 4;
+						const auto weight = column_weights[tap.weights + k];
+
+						for (auto c = 0; c < 4; c++) sum[c] += texel[c] * weight;
+					}
+
+					std::copy(sum.begin(), sum.end(), out + x * 4);
+				}
+			}
+		});
+
+		auto result = float_image{ width, height, std::vector<float>(static_cast<size_t>(width) * height * 4) };
+
+		for_rows(height, jobs, [&](uint32_t begin, uint32_t end)
+		{
+			for (auto y = begin; y < end; y++)
+			{
+				const auto& tap = row_taps[y];
+				auto* out = result.texels.data() + static_cast<size_t>(y) * width * 4;
+
+				for (uint32_t k = 0; k < tap.count; k++)
+				{
+					const auto* row = horizontal.data() + static_cast<size_t>(clamp_index(tap.first + static_cast<int32_t>(k), source.height)) * width * 4;
+					const auto weight = row_weights[tap.weights + k];
+
+					for (uint32_t i = 0; i < width * 4; i++) out[i] += row[i] * weight;
+				}
+			}
+		});
+
+		return result;
+	}
+
+	auto generate_mips(const uint8_t* rgba, uint32_t width, uint32_t height, bool srgb, job_system* jobs) -> std::vector<float_image>
+	{
+		const auto count = std::min(TEXTURE_MAX_LEVELS, texture_level_count(width, height));
+
+		auto levels = std::vector<float_image>();
+		levels.reserve(count);
+		levels.push_back(to_float_image(rgba, width, height, srgb));
+
+		while (levels.size() < count)
+		{
+			levels.push_back(downsample(levels.back(), jobs));
+		}
+
+		return levels;
+	}
+
+	auto generate_rgba8_mips(const uint8_t* rgba, uint32_t width, uint32_t height, bool srgb, job_system* jobs) -> rgba8_mip_chain
+	{
+		const auto levels = generate_mips(rgba, width, height, srgb, jobs);
+
+		auto chain = rgba8_mip_chain();
+		chain.width = width;
+		chain.height = height;
+
+		// every rgba8 level is a multiple of 4 bytes, aligning to 16 keeps the copies on the staging alignment
+		auto size = uint64_t();
+		for (const auto& level : levels)
+		{
+			const auto bytes = texture_level_bytes(texture_format::rgba8_srgb, level.width, level.height);
+
+			chain.levels.push_back({ size, bytes });
+			size = align_texture_offset(size + bytes);
+		}
+
+		chain.pixels.resize(size);
+
+		// the top level is the source itself, going through float would only lose the colour of transparent texels
+		std::copy_n(rgba, chain.levels[0].size, chain.pixels.data());
+
+		for (size_t i = 1; i < levels.size(); i++)
+		{
+			to_rgba8(levels[i], srgb, chain.pixels.data() + chain.levels[i].offset);
+		}
+
+		return chain;
+	}
+}
@@ -0,0 +1,244 @@
+#include "Vulkan/asset_manager.hpp"
+
+// STL
+#include <filesystem>
+#include <system_error>
+#include <utility>
+
+// STB
+#include <stb_image.h>
+
+// Mythos
+#include "Debug.hpp"
+#include "Mesh/mesh_import.hpp"
+#include "Mesh/mesh_optimizer.hpp"
+#include "Profile/profiler.hpp"
+#include "Texture/texture_mips.hpp"
+#include "Vulkan/mythos_vulkan.hpp"
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	// the cooked twin of a source asset, if there is one at least as new as the source
+	static auto find_cooked_file(const std::string& path, const char* extension, std::string& cooked_path) -> bool
+	{
+		namespace fs = std::filesystem;
+
+		auto cooked = fs::path(path);
+		const auto is_cooked = cooked.extension() == extension;
+		cooked.replace_extension(extension);
+
+		auto error = std::error_code();
+		if (!fs::exists(cooked, error)) return false;
+
+		// an edited source wins over a stale cooked file until the Cooker is run again
+		if (!is_cooked && fs::exists(path, error) && fs::last_write_time(path, error) > fs::last_write_time(cooked, error))
+		{
+			Debug::warn("Asset manager : " + cooked.string() + " is older than its source, loading " + path);
+			return false;
+		}
+
+		cooked_path = cooked.string();
+		return true;
+	}
+
+	// maps the cooked twin of a source mesh, false sends the caller back to parsing the source
+	static auto load_cooked_mesh(const std::string& path, decoded_mesh& result) -> bool
+	{
+		auto cooked = std::string();
+		if (!find_cooked_file(path, MESH_FILE_EXTENSION, cooked)) return false;
+
+		if (!result.file.open(cooked) ||
+			!read_mesh_file(result.file.data(), result.file.size(), mesh_vertex_layout::id, mesh_vertex_layout::stride, result.view))
+		{
+			Debug::warn("Asset manager : " + cooked + " is not a valid version " +
+				std::to_string(MESH_FILE_VERSION) + " mesh file");
+			result.file.close();
+			return false;
+		}
+
+		const auto* header = result.view.header;
+		result.vertex_count = header->vertex_count;
+		result.bounds = { glm::vec3(header->bounds_min[0], header->bounds_min[1], header->bounds_min[2]),
+		                  glm::vec3(header->bounds_max[0], header->bounds_max[1], header->bounds_max[2]) };
+
+		// take the page faults here on the worker rather than in the render thread's copy
+		result.file.prefetch();
+		return true;
+	}
+
+	// maps the cooked twin of a source texture, its mips were filtered and compressed offline
+	static auto load_cooked_texture(const std::string& path, bool block_compression, decoded_texture& result) -> bool
+	{
+		auto cooked = std::string();
+		if (!find_cooked_file(path, TEXTURE_FILE_EXTENSION, cooked)) return false;
+
+		if (!result.file.open(cooked) || !read_texture_file(result.file.data(), result.file.size(), result.view))
+		{
+			Debug::warn("Asset manager : " + cooked + " is not a valid version " +
+				std::to_string(TEXTURE_FILE_VERSION) + " texture file");
+			result.file.close();
+			return false;
+		}
+
+		const auto* header = result.view.header;
+
+		if (is_block_compressed(header->format) && !block_compression)
+		{
+			Debug::warn("Asset manager : the device can not sample block compressed " + cooked + ", loading its source");
+			result.file.close();
+			return false;
+		}
+
+		result.format = header->format;
+		result.width = header->width;
+		result.height = header->height;
+
+		// take the page faults here on the worker rather than in the render thread's copy
+		result.file.prefetch();
+		return true;
+	}
+
+	asset_manager::~asset_manager()
+	{
+		wait_idle();
+	}
+
+	void asset_manager::set_job_system(job_system* jobs)
+	{
+		jobs_ = jobs;
+	}
+
+	void asset_manager::set_block_compression(bool supported)
+	{
+		block_compression_ = supported;
+	}
+
+	mesh_handle asset_manager::load_mesh(const std::string& path)
+	{
+		const auto index = static_cast<uint32_t>(meshes_.size());
+		meshes_.push_back({ .path = path });
+
+		run([this, index, path]()
+		{
+			PROFILE_ZONE("load mesh");
+
+			auto result = decoded_mesh{ .index = index };
+			result.success = load_cooked_mesh(path, result);
+
+			// cooked meshes were optimized and encoded offline, a source obj pays for it here instead
+			auto vertices = std::vector<vertex>();
+			if (!result.success && load_model(path, vertices, result.indices, jobs_))
+			{
+				optimize_mesh(vertices, result.indices);
+
+				result.vertex_count = static_cast<uint32_t>(vertices.size());
+				result.bounds = compute_bounds(vertices);
+				result.vertex_data = mesh_vertex_layout::encode(vertices, result.bounds);
+				result.success = true;
+			}
+
+			std::lock_guard lock(mutex_);
+			decoded_meshes_.push_back(std::move(result));
+		});
+
+		return { index };
+	}
+
+	texture_handle asset_manager::load_texture(const std::string& path)
+	{
+		const auto index = static_cast<uint32_t>(textures_.size());
+		textures_.push_back({ .path = path });
+
+		run([this, index, path]()
+		{
+			PROFILE_ZONE("load texture");
+
+			auto result = decoded_texture{ .index = index };
+			result.success = load_cooked_texture(path, block_compression_, result);
+
+			auto width = 0;
+			auto height = 0;
+			auto channels = 0;
+			auto* pixels = result.success ? nullptr : stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+
+			// a source image is mipped here instead, uncompressed but filtered the same way as the Cooker does
+			if (pixels != nullptr)
+			{
+				auto chain = generate_rgba8_mips(pixels, width, height, true, jobs_);
+				stbi_image_free(pixels);
+
+				result.format = texture_format::rgba8_srgb;
+				result.width = chain.width;
+				result.height = chain.height;
+				result.levels = std::move(chain.levels);
+				result.pixels = std::move(chain.pixels);
+				result.success = true;
+			}
+			else if (!result.success)
+			{
+				Debug::error("Asset manager failed to load texture : " + path);
+			}
+
+			std::lock_guard lock(mutex_);
+			decoded_textures_.push_back(std::move(result));
+		});
+
+		return { index };
+	}
+
+	std::vector<decoded_mesh> asset_manager::take_decoded_meshes()
+	{
+		std::lock_guard lock(mutex_);
+		return std::exchange(decoded_meshes_, {});
+	}
+
+	std::vector<decoded_texture> asset_manager::take_decoded_textures()
+	{
+		std::lock_guard lock(mutex_);
+		return std::exchange(decoded_textures_, {});
+	}
+
+	mesh_resource* asset_manager::mesh(mesh_handle handle)
+	{
+		return handle.index < meshes_.size() ? &meshes_[handle.index] : nullptr;
+	}
+
+	texture_resource* asset_manager::texture(texture_handle handle)
+	{
+		return handle.index < textures_.size() ? &textures_[handle.index] : nullptr;
+	}
+
+	std::vector<mesh_resource>& asset_manager::meshes()
+	{
+		return meshes_;
+	}
+
+	std::vector<texture_resource>& asset_manager::textures()
+	{
+		return textures_;
+	}
+
+	void asset_manager::wait_idle()
+	{
+		// the job module may already be gone at shutdown, its pool runs every queued job before it stops
+		// so a finished counter never touches the job system
+		if (jobs_ != nullptr && !counter_.is_done())
+		{
+			jobs_->wait(counter_);
+		}
+	}
+
+	void asset_manager::run(std::function<void()> function)
+	{
+		if (jobs_ == nullptr)
+		{
+			function();
+			return;
+		}
+
+		jobs_->run(std::move(function), &counter_);
+	}
+}
@@ -0,0 +1,175 @@
+#include "Vulkan/command_recorder.hpp"
+
+// STL
+#include <algorithm>
+#include <string>
+
+// Mythos
+#include "Debug.hpp"
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	auto partition_draws(uint32_t count, uint32_t max_ranges, uint32_t min_draws) -> std::vector<draw_range>
+	{
+		auto ranges = std::vector<draw_range>();
+		if (count == 0) return ranges;
+
+		const auto range_count = std::clamp(count / std::max(min_draws, 1u), 1u, std::max(max_ranges, 1u));
+
+		// the first count % range_count runs take one extra draw
+		const auto base = count / range_count;
+		const auto extra = count % range_count;
+
+		ranges.reserve(range_count);
+
+		auto begin = 0u;
+		for (auto i = 0u; i < range_count; i++)
+		{
+			const auto end = begin + base + (i < extra ? 1 : 0);
+			ranges.push_back({ begin, end });
+			begin = end;
+		}
+
+		return ranges;
+	}
+
+	bool command_recorder::create(VkDevice device, uint32_t queue_family, uint32_t frame_count, uint32_t slot_count)
+	{
+		device_ = device;
+		slot_count_ = std::clamp(slot_count, 1u, MAX_SLOTS);
+		frames_.resize(frame_count);
+
+		// buffers are never reset one at a time, the whole pool is reset with its frame
+		const auto pool_info = VkCommandPoolCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+			.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+			.queueFamilyIndex = queue_family,
+		};
+
+		for (auto& frame : frames_)
+		{
+			frame.slots.resize(slot_count_);
+
+			auto success = vkCreateCommandPool(device_, &pool_info, nullptr, &frame.primary_pool) == VK_SUCCESS;
+			for (auto& slot : frame.slots)
+			{
+				success = success && vkCreateCommandPool(device_, &pool_info, nullptr, &slot.pool) == VK_SUCCESS;
+			}
+
+			if (!success)
+			{
+				Debug::error("Vulkan command recorder failed to create its command pools");
+				return false;
+			}
+
+			const auto allocate_info = VkCommandBufferAllocateInfo
+			{
+				.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+				.commandPool = frame.primary_pool,
+				.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+				.commandBufferCount = 1,
+			};
+
+			if (vkAllocateCommandBuffers(device_, &allocate_info, &frame.primary) != VK_SUCCESS)
+			{
+				Debug::error("Vulkan command recorder failed to allocate a primary command buffer");
+				return false;
+			}
+		}
+
+		Debug::log("Vulkan command recorder created : " + std::to_string(frame_count) + " frames, " +
+			std::to_string(slot_count_) + " recording slots");
+		return true;
+	}
+
+	void command_recorder::destroy()
+	{
+		if (device_ == VK_NULL_HANDLE) return;
+
+		// frees the command buffers with them
+		for (auto& frame : frames_)
+		{
+			vkDestroyCommandPool(device_, frame.primary_pool, nullptr);
+
+			for (auto& slot : frame.slots)
+			{
+				vkDestroyCommandPool(device_, slot.pool, nullptr);
+			}
+		}
+
+		frames_.clear();
+		device_ = VK_NULL_HANDLE;
+	}
+
+	void command_recorder::begin_frame(uint32_t frame)
+	{
+		vkResetCommandPool(device_, frames_[frame].primary_pool, 0);
+
+		for (auto& slot : frames_[frame].slots)
+		{
+			vkResetCommandPool(device_, slot.pool, 0);
+			slot.used = 0;
+		}
+	}
+
+	VkCommandBuffer command_recorder::primary(uint32_t frame) const
+	{
+		return frames_[frame].primary;
+	}
+
+	VkCommandBuffer command_recorder::begin_secondary(uint32_t frame, uint32_t slot, const VkCommandBufferInheritanceInfo& inheritance)
+	{
+		auto& pool = frames_[frame].slots[slot];
+
+		if (pool.used == pool.secondaries.size())
+		{
+			const auto allocate_info = VkCommandBufferAllocateInfo
+			{
+				.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+				.commandPool = pool.pool,
+				.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+				.commandBufferCount = 1,
+			};
+
+			auto commands = VkCommandBuffer();
+			if (vkAllocateCommandBuffers(device_, &allocate_info, &commands) != VK_SUCCESS)
+			{
+				Debug::error("Vulkan command recorder failed to allocate a secondary command buffer");
+				return VK_NULL_HANDLE;
+			}
+
+			pool.secondaries.push_back(commands);
+		}
+
+		auto commands = pool.secondaries[pool.used++];
+
+		const auto begin_info = VkCommandBufferBeginInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+			.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+			.pInheritanceInfo = &inheritance,
+		};
+
+		if (vkBeginCommandBuffer(commands, &begin_info) != VK_SUCCESS)
+		{
+			Debug::error("Vulkan command recorder failed to begin a secondary command buffer");
+			return VK_NULL_HANDLE;
+		}
+
+		return commands;
+	}
+
+	uint32_t command_recorder::slot_count() const
+	{
+		return slot_count_;
+	}
+
+	recorder_stats& command_recorder::stats()
+	{
+		return stats_;
+	}
+}
@@ -0,0 +1,421 @@
+#include "Vulkan/depth_pyramid.hpp"
+
+// STL
+#include <algorithm>
+#include <bit>
+#include <string>
+
+// Mythos
+#include "Debug.hpp"
+#include "Shader/shader.hpp"
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	// matches the push constants of depth_pyramid.comp
+	struct pyramid_constants
+	{
+		int32_t source_width;
+		int32_t source_height;
+		int32_t width;
+		int32_t height;
+		int32_t source_level;
+		int32_t samples;
+	};
+
+	bool depth_pyramid::create(VkDevice device, memory_allocator& allocator)
+	{
+		device_ = device;
+		allocator_ = &allocator;
+
+		// the source, the depth buffer or the level above, and the level written
+		const auto bindings = std::array<VkDescriptorSetLayoutBinding, 2>
+		{
+			VkDescriptorSetLayoutBinding
+			{
+				.binding = 0,
+				.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+				.descriptorCount = 1,
+				.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+			},
+			VkDescriptorSetLayoutBinding
+			{
+				.binding = 1,
+				.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+				.descriptorCount = 1,
+				.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+			},
+		};
+
+		const auto set_layout_info = VkDescriptorSetLayoutCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+			.bindingCount = static_cast<uint32_t>(bindings.size()),
+			.pBindings = bindings.data(),
+		};
+
+		const auto push_constant = VkPushConstantRange
+		{
+			.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+			.offset = 0,
+			.size = sizeof(pyramid_constants),
+		};
+
+		const auto layout_info = VkPipelineLayoutCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+			.setLayoutCount = 1,
+			.pSetLayouts = &set_layout_,
+			.pushConstantRangeCount = 1,
+			.pPushConstantRanges = &push_constant,
+		};
+
+		const auto pool_sizes = std::array<VkDescriptorPoolSize, 2>
+		{
+			VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_LEVELS },
+			VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, MAX_LEVELS },
+		};
+
+		const auto pool_info = VkDescriptorPoolCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+			.maxSets = MAX_LEVELS,
+			.poolSizeCount = static_cast<uint32_t>(pool_sizes.size()),
+			.pPoolSizes = pool_sizes.data(),
+		};
+
+		// texelFetch ignores filtering, the sampler only completes the combined descriptors
+		const auto sampler_info = VkSamplerCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+			.magFilter = VK_FILTER_NEAREST,
+			.minFilter = VK_FILTER_NEAREST,
+			.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+			.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+			.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+			.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+			.maxLod = VK_LOD_CLAMP_NONE,
+		};
+
+		if (vkCreateDescriptorSetLayout(device_, &set_layout_info, nullptr, &set_layout_) != VK_SUCCESS ||
+			vkCreatePipelineLayout(device_, &layout_info, nullptr, &pipeline_layout_) != VK_SUCCESS ||
+			vkCreateDescriptorPool(device_, &pool_info, nullptr, &descriptor_pool_) != VK_SUCCESS ||
+			vkCreateSampler(device_, &sampler_info, nullptr, &sampler_) != VK_SUCCESS)
+		{
+			Debug::error("Vulkan depth pyramid failed to create its layouts");
+			return false;
+		}
+
+		if (!create_pipeline("../Renderer/shaders/depth_pyramid.spv", reduce_pipeline_) ||
+			!create_pipeline("../Renderer/shaders/depth_pyramid_ms.spv", multisampled_pipeline_))
+		{
+			Debug::error("Vulkan depth pyramid failed to create its pipelines");
+			return false;
+		}
+
+		Debug::log("Vulkan depth pyramid created");
+		return true;
+	}
+
+	void depth_pyramid::destroy()
+	{
+		if (device_ == VK_NULL_HANDLE) return;
+
+		release();
+
+		vkDestroySampler(device_, sampler_, nullptr);
+		vkDestroyPipeline(device_, reduce_pipeline_, nullptr);
+		vkDestroyPipeline(device_, multisampled_pipeline_, nullptr);
+		vkDestroyPipelineLayout(device_, pipeline_layout_, nullptr);
+		vkDestroyDescriptorPool(device_, descriptor_pool_, nullptr);
+		vkDestroyDescriptorSetLayout(device_, set_layout_, nullptr);
+
+		device_ = VK_NULL_HANDLE;
+	}
+
+	bool depth_pyramid::resize(VkImageView depth_view, uint32_t width, uint32_t height, VkSampleCountFlagBits samples)
+	{
+		if (device_ == VK_NULL_HANDLE) return false;
+
+		release();
+
+		depth_extent_ = { width, height };
+		depth_samples_ = samples;
+
+		// the first level halves the depth buffer, rounding up so the odd last row and column are covered
+		extent_ = { std::max(1u, (width + 1) / 2), std::max(1u, (height + 1) / 2) };
+		level_count_ = std::min(static_cast<uint32_t>(std::bit_width(std::max(extent_.width, extent_.height))), MAX_LEVELS);
+
+		const auto image_info = VkImageCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+			.imageType = VK_IMAGE_TYPE_2D,
+			.format = VK_FORMAT_R32_SFLOAT,
+			.extent = { extent_.width, extent_.height, 1 },
+			.mipLevels = level_count_,
+			.arrayLayers = 1,
+			.samples = VK_SAMPLE_COUNT_1_BIT,
+			.tiling = VK_IMAGE_TILING_OPTIMAL,
+			.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+			.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+			.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+		};
+
+		if (vkCreateImage(device_, &image_info, nullptr, &image_) != VK_SUCCESS)
+		{
+			Debug::error("Vulkan depth pyramid failed to create its image");
+			return false;
+		}
+
+		auto requirements = VkMemoryRequirements();
+		vkGetImageMemoryRequirements(device_, image_, &requirements);
+
+		if (!allocator_->allocate(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, resource_kind::optimal, allocation_))
+		{
+			Debug::error("Vulkan depth pyramid failed to allocate its image");
+			vkDestroyImage(device_, image_, nullptr);
+			image_ = VK_NULL_HANDLE;
+			return false;
+		}
+
+		vkBindImageMemory(device_, image_, allocation_.memory, allocation_.offset);
+
+		const auto create_view = [this](uint32_t base_level, uint32_t level_count, VkImageView& view)
+		{
+			const auto view_info = VkImageViewCreateInfo
+			{
+				.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+				.image = image_,
+				.viewType = VK_IMAGE_VIEW_TYPE_2D,
+				.format = VK_FORMAT_R32_SFLOAT,
+				.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, base_level, level_count, 0, 1 },
+			};
+
+			return vkCreateImageView(device_, &view_info, nullptr, &view) == VK_SUCCESS;
+		};
+
+		if (!create_view(0, level_count_, view_))
+		{
+			Debug::error("Vulkan depth pyramid failed to create its view");
+			release();
+			return false;
+		}
+
+		vkResetDescriptorPool(device_, descriptor_pool_, 0);
+
+		for (uint32_t level = 0; level < level_count_; level++)
+		{
+			const auto allocate_info = VkDescriptorSetAllocateInfo
+			{
+				.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+				.descriptorPool = descriptor_pool_,
+				.descriptorSetCount = 1,
+				.pSetLayouts = &set_layout_,
+			};
+
+			if (!create_view(level, 1, level_views_[level]) ||
+				vkAllocateDescriptorSets(device_, &allocate_info, &level_sets_[level]) != VK_SUCCESS)
+			{
+				Debug::error("Vulkan depth pyramid failed to create level " + std::to_string(level));
+				release();
+				return false;
+			}
+
+			// the first level reads the depth buffer, every other one the whole pyramid at the level above
+			const auto source = VkDescriptorImageInfo
+			{
+				.sampler = sampler_,
+				.imageView = level == 0 ? depth_view : view_,
+				.imageLayout = level == 0 ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL,
+			};
+
+			const auto destination = VkDescriptorImageInfo
+			{
+				.imageView = level_views_[level],
+				.imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+			};
+
+			const auto writes = std::array<VkWriteDescriptorSet, 2>
+			{
+				VkWriteDescriptorSet
+				{
+					.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+					.dstSet = level_sets_[level],
+					.dstBinding = 0,
+					.descriptorCount = 1,
+					.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+					.pImageInfo = &source,
+				},
+				VkWriteDescriptorSet
+				{
+					.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+					.dstSet = level_sets_[level],
+					.dstBinding = 1,
+					.descriptorCount = 1,
+					.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+					.pImageInfo = &destination,
+				},
+			};
+
+			vkUpdateDescriptorSets(device_, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+		}
+
+		Debug::log("Vulkan depth pyramid : " + std::to_string(extent_.width) + "x" + std::to_string(extent_.height) +
+			", " + std::to_string(level_count_) + " levels");
+		return true;
+	}
+
+	void depth_pyramid::record(VkCommandBuffer commands, const glm::mat4& view_proj)
+	{
+		if (image_ == VK_NULL_HANDLE) return;
+
+		// each level only depends on the one above it
+		const auto level_barrier = VkMemoryBarrier
+		{
+			.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+			.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+			.dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+		};
+
+		auto source = depth_extent_;
+		auto destination = extent_;
+
+		for (uint32_t level = 0; level < level_count_; level++)
+		{
+			const auto multisampled = level == 0 && depth_samples_ != VK_SAMPLE_COUNT_1_BIT;
+
+			const auto constants = pyramid_constants
+			{
+				.source_width = static_cast<int32_t>(source.width),
+				.source_height = static_cast<int32_t>(source.height),
+				.width = static_cast<int32_t>(destination.width),
+				.height = static_cast<int32_t>(destination.height),
+				.source_level = level == 0 ? 0 : static_cast<int32_t>(level - 1),
+				.samples = static_cast<int32_t>(depth_samples_),
+			};
+
+			vkCmdBindPipeline(commands, VK_PIPELINE_BIND_POINT_COMPUTE, multisampled ? multisampled_pipeline_ : reduce_pipeline_);
+			vkCmdBindDescriptorSets(commands, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_layout_, 0, 1, &level_sets_[level], 0, nullptr);
+			vkCmdPushConstants(commands, pipeline_layout_, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+			vkCmdDispatch(commands, (destination.width + GROUP_SIZE - 1) / GROUP_SIZE, (destination.height + GROUP_SIZE - 1) / GROUP_SIZE, 1);
+
+			// the render graph makes the last level visible to the next frame's culling
+			if (level + 1 < level_count_)
+			{
+				vkCmdPipelineBarrier(commands, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+					0, 1, &level_barrier, 0, nullptr, 0, nullptr);
+			}
+
+			source = destination;
+			destination = { std::max(1u, (destination.width + 1) / 2), std::max(1u, (destination.height + 1) / 2) };
+		}
+
+		view_proj_ = view_proj;
+		valid_ = true;
+	}
+
+	bool depth_pyramid::valid() const
+	{
+		return valid_;
+	}
+
+	VkImage depth_pyramid::image() const
+	{
+		return image_;
+	}
+
+	VkImageView depth_pyramid::view() const
+	{
+		return view_;
+	}
+
+	VkSampler depth_pyramid::sampler() const
+	{
+		return sampler_;
+	}
+
+	VkExtent2D depth_pyramid::extent() const
+	{
+		return extent_;
+	}
+
+	uint32_t depth_pyramid::level_count() const
+	{
+		return level_count_;
+	}
+
+	const glm::mat4& depth_pyramid::view_proj() const
+	{
+		return view_proj_;
+	}
+
+	bool depth_pyramid::create_pipeline(const char* path, VkPipeline& pipeline)
+	{
+		const auto code = shader::read_file(path);
+		if (code.empty()) return false;
+
+		const auto module_info = VkShaderModuleCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+			.codeSize = code.size(),
+			.pCode = reinterpret_cast<const uint32_t*>(code.data()),
+		};
+
+		auto module = VkShaderModule();
+		if (vkCreateShaderModule(device_, &module_info, nullptr, &module) != VK_SUCCESS)
+		{
+			Debug::error(std::string("Vulkan depth pyramid failed to create the shader module of ") + path);
+			return false;
+		}
+
+		const auto pipeline_info = VkComputePipelineCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+			.stage = VkPipelineShaderStageCreateInfo
+			{
+				.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+				.stage = VK_SHADER_STAGE_COMPUTE_BIT,
+				.module = module,
+				.pName = "main",
+			},
+			.layout = pipeline_layout_,
+		};
+
+		const auto success = vkCreateComputePipelines(device_, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &pipeline) == VK_SUCCESS;
+		vkDestroyShaderModule(device_, module, nullptr);
+
+		if (!success)
+		{
+			Debug::error(std::string("Vulkan depth pyramid failed to create the pipeline of ") + path);
+		}
+
+		return success;
+	}
+
+	void depth_pyramid::release()
+	{
+		for (auto& view : level_views_)
+		{
+			vkDestroyImageView(device_, view, nullptr);
+			view = VK_NULL_HANDLE;
+		}
+
+		// the sets go back to the pool when it is reset
+		level_sets_ = {};
+
+		vkDestroyImageView(device_, view_, nullptr);
+		view_ = VK_NULL_HANDLE;
+
+		if (image_ != VK_NULL_HANDLE)
+		{
+			vkDestroyImage(device_, image_, nullptr);
+			allocator_->free(allocation_);
+			image_ = VK_NULL_HANDLE;
+		}
+
+		level_count_ = 0;
+		valid_ = false;
+	}
+}
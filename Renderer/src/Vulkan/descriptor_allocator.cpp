@@ -0,0 +1,150 @@
+#include "Vulkan/descriptor_allocator.hpp"
+
+// STL
+#include <array>
+#include <string>
+
+// Mythos
+#include "Debug.hpp"
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	bool descriptor_allocator::create(VkDevice device, uint32_t frame_count)
+	{
+		device_ = device;
+		frames_.resize(frame_count);
+
+		// one pool each to start with, a frame's sets fit in it until scenes grow
+		for (auto& frame : frames_)
+		{
+			const auto pool = create_pool();
+			if (pool == VK_NULL_HANDLE) return false;
+
+			frame.pools.push_back(pool);
+		}
+
+		Debug::log("Vulkan descriptor allocator created : " + std::to_string(frame_count) + " frames");
+		return true;
+	}
+
+	void descriptor_allocator::destroy()
+	{
+		if (device_ == VK_NULL_HANDLE) return;
+
+		for (auto& frame : frames_)
+		{
+			for (auto pool : frame.pools)
+			{
+				vkDestroyDescriptorPool(device_, pool, nullptr);
+			}
+		}
+		frames_.clear();
+
+		device_ = VK_NULL_HANDLE;
+	}
+
+	void descriptor_allocator::begin_frame(uint32_t frame)
+	{
+		frame_ = frame;
+
+		auto& target = frames_[frame];
+		for (auto pool : target.pools)
+		{
+			vkResetDescriptorPool(device_, pool, 0);
+		}
+
+		target.current = 0;
+	}
+
+	VkDescriptorSet descriptor_allocator::allocate(VkDescriptorSetLayout layout)
+	{
+		auto& target = frames_[frame_];
+
+		auto allocate_info = VkDescriptorSetAllocateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+			.descriptorSetCount = 1,
+			.pSetLayouts = &layout,
+		};
+
+		// a full pool moves the frame on to its next one, making it when the frame never needed that many before
+		while (true)
+		{
+			auto fresh = false;
+
+			if (target.current == target.pools.size())
+			{
+				const auto pool = create_pool();
+				if (pool == VK_NULL_HANDLE) return VK_NULL_HANDLE;
+
+				target.pools.push_back(pool);
+				fresh = true;
+				Debug::log("Vulkan descriptor allocator : frame " + std::to_string(frame_) + " grew to " + std::to_string(target.pools.size()) + " pools");
+			}
+
+			allocate_info.descriptorPool = target.pools[target.current];
+
+			auto set = VkDescriptorSet();
+			const auto result = vkAllocateDescriptorSets(device_, &allocate_info, &set);
+
+			if (result == VK_SUCCESS) return set;
+
+			if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+			{
+				Debug::error("Vulkan descriptor allocator failed to allocate a set");
+				return VK_NULL_HANDLE;
+			}
+
+			// a new pool that cannot hold one set never will
+			if (fresh)
+			{
+				Debug::error("Vulkan descriptor allocator : a set does not fit an empty pool");
+				return VK_NULL_HANDLE;
+			}
+
+			target.current++;
+		}
+	}
+
+	uint32_t descriptor_allocator::pool_count() const
+	{
+		auto count = 0u;
+		for (const auto& frame : frames_)
+		{
+			count += static_cast<uint32_t>(frame.pools.size());
+		}
+
+		return count;
+	}
+
+	VkDescriptorPool descriptor_allocator::create_pool()
+	{
+		// sized for the renderer's frame sets, uniforms and storage buffers with the odd texture of the fallback path
+		const auto pool_sizes = std::array<VkDescriptorPoolSize, 3>
+		{
+			VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, SETS_PER_POOL },
+			VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 * SETS_PER_POOL },
+			VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, SETS_PER_POOL },
+		};
+
+		const auto pool_info = VkDescriptorPoolCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+			.maxSets = SETS_PER_POOL,
+			.poolSizeCount = static_cast<uint32_t>(pool_sizes.size()),
+			.pPoolSizes = pool_sizes.data(),
+		};
+
+		auto pool = VkDescriptorPool();
+		if (vkCreateDescriptorPool(device_, &pool_info, nullptr, &pool) != VK_SUCCESS)
+		{
+			Debug::error("Vulkan descriptor allocator failed to create a pool");
+			return VK_NULL_HANDLE;
+		}
+
+		return pool;
+	}
+}
@@ -0,0 +1,302 @@
+#include "Vulkan/descriptor_table.hpp"
+
+// STL
+#include <algorithm>
+#include <array>
+#include <string>
+
+// Mythos
+#include "Debug.hpp"
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	void slot_list::reset(uint32_t capacity)
+	{
+		capacity_ = capacity;
+		next_ = 0;
+		free_.clear();
+		retired_.clear();
+	}
+
+	uint32_t slot_list::allocate()
+	{
+		if (!free_.empty())
+		{
+			const auto slot = free_.back();
+			free_.pop_back();
+			return slot;
+		}
+
+		return next_ < capacity_ ? next_++ : UINT32_MAX;
+	}
+
+	void slot_list::release(uint32_t slot, uint64_t frame)
+	{
+		retired_.push_back({ slot, frame });
+	}
+
+	void slot_list::recycle(uint64_t frame, uint32_t frame_count)
+	{
+		const auto ready = std::find_if(retired_.begin(), retired_.end(), [&](const retired_slot& retired)
+		{
+			return retired.frame + frame_count > frame;
+		});
+
+		for (auto it = retired_.begin(); it != ready; ++it)
+		{
+			free_.push_back(it->slot);
+		}
+
+		retired_.erase(retired_.begin(), ready);
+	}
+
+	uint32_t slot_list::used() const
+	{
+		return next_ - static_cast<uint32_t>(free_.size()) - static_cast<uint32_t>(retired_.size());
+	}
+
+	// --
+
+	bool descriptor_table::supported(VkPhysicalDevice physical_device, VkPhysicalDeviceVulkan12Features& enable)
+	{
+		// the 1.2 feature struct is only understood by a 1.2 device
+		auto properties = VkPhysicalDeviceProperties();
+		vkGetPhysicalDeviceProperties(physical_device, &properties);
+
+		if (properties.apiVersion < VK_API_VERSION_1_2) return false;
+
+		auto available = VkPhysicalDeviceVulkan12Features{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES };
+		auto features = VkPhysicalDeviceFeatures2{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, .pNext = &available };
+		vkGetPhysicalDeviceFeatures2(physical_device, &features);
+
+		const auto indexing =
+			available.runtimeDescriptorArray && available.shaderSampledImageArrayNonUniformIndexing &&
+			available.descriptorBindingPartiallyBound && available.descriptorBindingUpdateUnusedWhilePending &&
+			available.descriptorBindingSampledImageUpdateAfterBind && available.descriptorBindingStorageBufferUpdateAfterBind;
+
+		if (!indexing) return false;
+
+		enable = VkPhysicalDeviceVulkan12Features
+		{
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+			.descriptorIndexing = available.descriptorIndexing,
+			.shaderSampledImageArrayNonUniformIndexing = VK_TRUE,
+			.shaderStorageBufferArrayNonUniformIndexing = available.shaderStorageBufferArrayNonUniformIndexing,
+			.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE,
+			.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE,
+			.descriptorBindingUpdateUnusedWhilePending = VK_TRUE,
+			.descriptorBindingPartiallyBound = VK_TRUE,
+			.runtimeDescriptorArray = VK_TRUE,
+		};
+
+		return true;
+	}
+
+	bool descriptor_table::create(VkDevice device, VkPhysicalDevice physical_device, uint32_t frame_count)
+	{
+		device_ = device;
+		frame_count_ = frame_count;
+
+		// the arrays are capped by what the device can update after binding
+		auto limits = VkPhysicalDeviceVulkan12Properties{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES };
+		auto properties = VkPhysicalDeviceProperties2{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, .pNext = &limits };
+		vkGetPhysicalDeviceProperties2(physical_device, &properties);
+
+		const auto texture_capacity = std::min({ MAX_TEXTURES, limits.maxDescriptorSetUpdateAfterBindSampledImages,
+		                                         limits.maxPerStageDescriptorUpdateAfterBindSampledImages });
+		const auto buffer_capacity = std::min({ MAX_BUFFERS, limits.maxDescriptorSetUpdateAfterBindStorageBuffers,
+		                                        limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers });
+
+		const auto bindings = std::array<VkDescriptorSetLayoutBinding, 2>
+		{
+			VkDescriptorSetLayoutBinding
+			{
+				.binding = TEXTURE_BINDING,
+				.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+				.descriptorCount = texture_capacity,
+				.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+			},
+			VkDescriptorSetLayoutBinding
+			{
+				.binding = BUFFER_BINDING,
+				.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				.descriptorCount = buffer_capacity,
+				.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT,
+			},
+		};
+
+		// slots nobody reads may be empty or rewritten while frames using the set are in flight
+		constexpr VkDescriptorBindingFlags binding_flags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+			VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+
+		const auto flags = std::array<VkDescriptorBindingFlags, 2>{ binding_flags, binding_flags };
+
+		const auto flags_info = VkDescriptorSetLayoutBindingFlagsCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+			.bindingCount = static_cast<uint32_t>(flags.size()),
+			.pBindingFlags = flags.data(),
+		};
+
+		const auto layout_info = VkDescriptorSetLayoutCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+			.pNext = &flags_info,
+			.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+			.bindingCount = static_cast<uint32_t>(bindings.size()),
+			.pBindings = bindings.data(),
+		};
+
+		const auto pool_sizes = std::array<VkDescriptorPoolSize, 2>
+		{
+			VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, texture_capacity },
+			VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, buffer_capacity },
+		};
+
+		const auto pool_info = VkDescriptorPoolCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+			.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+			.maxSets = 1,
+			.poolSizeCount = static_cast<uint32_t>(pool_sizes.size()),
+			.pPoolSizes = pool_sizes.data(),
+		};
+
+		if (vkCreateDescriptorSetLayout(device_, &layout_info, nullptr, &layout_) != VK_SUCCESS ||
+			vkCreateDescriptorPool(device_, &pool_info, nullptr, &pool_) != VK_SUCCESS)
+		{
+			Debug::error("Vulkan descriptor table failed to create its layout");
+			return false;
+		}
+
+		const auto allocate_info = VkDescriptorSetAllocateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+			.descriptorPool = pool_,
+			.descriptorSetCount = 1,
+			.pSetLayouts = &layout_,
+		};
+
+		if (vkAllocateDescriptorSets(device_, &allocate_info, &set_) != VK_SUCCESS)
+		{
+			Debug::error("Vulkan descriptor table failed to allocate its set");
+			return false;
+		}
+
+		textures_.reset(texture_capacity);
+		buffers_.reset(buffer_capacity);
+
+		Debug::log("Vulkan descriptor table created : " + std::to_string(texture_capacity) + " textures, " +
+			std::to_string(buffer_capacity) + " buffers");
+		return true;
+	}
+
+	void descriptor_table::destroy()
+	{
+		if (device_ == VK_NULL_HANDLE) return;
+
+		// frees the set with it
+		vkDestroyDescriptorPool(device_, pool_, nullptr);
+		vkDestroyDescriptorSetLayout(device_, layout_, nullptr);
+
+		device_ = VK_NULL_HANDLE;
+	}
+
+	void descriptor_table::begin_frame()
+	{
+		frame_++;
+
+		textures_.recycle(frame_, frame_count_);
+		buffers_.recycle(frame_, frame_count_);
+	}
+
+	uint32_t descriptor_table::add_texture(VkImageView view, VkSampler sampler)
+	{
+		const auto slot = textures_.allocate();
+		if (slot == UINT32_MAX)
+		{
+			Debug::error("Vulkan descriptor table is out of texture slots");
+			return INVALID_SLOT;
+		}
+
+		const auto image_info = VkDescriptorImageInfo
+		{
+			.sampler = sampler,
+			.imageView = view,
+			.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+		};
+
+		const auto write = VkWriteDescriptorSet
+		{
+			.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+			.dstSet = set_,
+			.dstBinding = TEXTURE_BINDING,
+			.dstArrayElement = slot,
+			.descriptorCount = 1,
+			.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+			.pImageInfo = &image_info,
+		};
+
+		vkUpdateDescriptorSets(device_, 1, &write, 0, nullptr);
+		return slot;
+	}
+
+	uint32_t descriptor_table::add_buffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+	{
+		const auto slot = buffers_.allocate();
+		if (slot == UINT32_MAX)
+		{
+			Debug::error("Vulkan descriptor table is out of buffer slots");
+			return INVALID_SLOT;
+		}
+
+		const auto buffer_info = VkDescriptorBufferInfo{ buffer, offset, range };
+
+		const auto write = VkWriteDescriptorSet
+		{
+			.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+			.dstSet = set_,
+			.dstBinding = BUFFER_BINDING,
+			.dstArrayElement = slot,
+			.descriptorCount = 1,
+			.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+			.pBufferInfo = &buffer_info,
+		};
+
+		vkUpdateDescriptorSets(device_, 1, &write, 0, nullptr);
+		return slot;
+	}
+
+	void descriptor_table::remove_texture(uint32_t slot)
+	{
+		if (slot != INVALID_SLOT) textures_.release(slot, frame_);
+	}
+
+	void descriptor_table::remove_buffer(uint32_t slot)
+	{
+		if (slot != INVALID_SLOT) buffers_.release(slot, frame_);
+	}
+
+	VkDescriptorSetLayout descriptor_table::layout() const
+	{
+		return layout_;
+	}
+
+	VkDescriptorSet descriptor_table::set() const
+	{
+		return set_;
+	}
+
+	uint32_t descriptor_table::texture_count() const
+	{
+		return textures_.used();
+	}
+
+	uint32_t descriptor_table::buffer_count() const
+	{
+		return buffers_.used();
+	}
+}
@@ -0,0 +1,394 @@
+#include "Vulkan/gpu_profiler.hpp"
+
+// Microsoft
+#ifdef _WIN64
+#define WIN64_LEAN_AND_MEAN
+#include <Windows.h>
+#endif
+
+// STL
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+
+// Mythos
+#include "Debug.hpp"
+#include "Profile/profiler.hpp"
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	// the clock steady_clock reads, the performance counter on windows and the monotonic clock elsewhere
+#ifdef _WIN64
+	constexpr VkTimeDomainEXT HOST_TIME_DOMAIN = VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_EXT;
+#else
+	constexpr VkTimeDomainEXT HOST_TIME_DOMAIN = VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+#endif
+
+	static auto steady_ns() -> int64_t
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// a host domain value as steady_clock nanoseconds
+	static auto host_domain_ns(uint64_t value) -> int64_t
+	{
+#ifdef _WIN64
+		// split as steady_clock does so large counts do not overflow
+		auto frequency = LARGE_INTEGER();
+		QueryPerformanceFrequency(&frequency);
+
+		const auto ticks_per_second = static_cast<uint64_t>(frequency.QuadPart);
+		const auto whole = value / ticks_per_second * 1'000'000'000;
+		const auto part = value % ticks_per_second * 1'000'000'000 / ticks_per_second;
+		return static_cast<int64_t>(whole + part);
+#else
+		return static_cast<int64_t>(value);
+#endif
+	}
+
+	bool gpu_profiler::calibration_supported(VkInstance instance, VkPhysicalDevice physical_device)
+	{
+		auto extension_count = uint32_t();
+		vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, nullptr);
+		auto extensions = std::vector<VkExtensionProperties>(extension_count);
+		vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, extensions.data());
+
+		const auto found = std::ranges::any_of(extensions, [](const VkExtensionProperties& extension)
+		{
+			return std::strcmp(extension.extensionName, VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME) == 0;
+		});
+
+		if (!found) return false;
+
+		// an extension command, the loader does not export it
+		const auto get_domains = reinterpret_cast<PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT>(
+			vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceCalibrateableTimeDomainsEXT"));
+
+		if (get_domains == nullptr) return false;
+
+		auto domain_count = uint32_t();
+		get_domains(physical_device, &domain_count, nullptr);
+		auto domains = std::vector<VkTimeDomainEXT>(domain_count);
+		get_domains(physical_device, &domain_count, domains.data());
+
+		const auto has = [&domains](VkTimeDomainEXT domain) { return std::ranges::find(domains, domain) != domains.end(); };
+		return has(VK_TIME_DOMAIN_DEVICE_EXT) && has(HOST_TIME_DOMAIN);
+	}
+
+	bool gpu_profiler::create(VkPhysicalDevice physical_device, VkDevice device, VkQueue queue, uint32_t queue_family,
+	                          uint32_t frame_count, bool calibrated)
+	{
+		device_ = device;
+
+		auto family_count = uint32_t();
+		vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_count, nullptr);
+		auto families = std::vector<VkQueueFamilyProperties>(family_count);
+		vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_count, families.data());
+
+		const auto valid_bits = queue_family < family_count ? families[queue_family].timestampValidBits : 0u;
+		if (valid_bits == 0)
+		{
+			Debug::warn("Vulkan : the graphics queue has no timestamps, gpu profiling is off");
+			return true;
+		}
+
+		auto properties = VkPhysicalDeviceProperties();
+		vkGetPhysicalDeviceProperties(physical_device, &properties);
+
+		period_ = static_cast<double>(properties.limits.timestampPeriod);
+		mask_ = valid_bits >= 64 ? UINT64_MAX : (uint64_t(1) << valid_bits) - 1;
+
+		const auto pool_info = VkQueryPoolCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+			.queryType = VK_QUERY_TYPE_TIMESTAMP,
+			.queryCount = MAX_REGIONS * 2,
+		};
+
+		frames_.resize(frame_count);
+
+		for (auto& frame : frames_)
+		{
+			if (vkCreateQueryPool(device_, &pool_info, nullptr, &frame.pool) != VK_SUCCESS)
+			{
+				Debug::error("Vulkan gpu profiler failed to create its query pools");
+				return false;
+			}
+
+			frame.regions.reserve(MAX_REGIONS);
+		}
+
+		if (calibrated)
+		{
+			get_calibrated_timestamps_ = reinterpret_cast<PFN_vkGetCalibratedTimestampsEXT>(
+				vkGetDeviceProcAddr(device_, "vkGetCalibratedTimestampsEXT"));
+		}
+
+		if (get_calibrated_timestamps_ == nullptr || !calibrate())
+		{
+			get_calibrated_timestamps_ = nullptr;
+
+			if (!calibrate_by_submit(queue, queue_family))
+			{
+				Debug::error("Vulkan gpu profiler failed to calibrate its clock");
+				return false;
+			}
+		}
+
+		Debug::log("Vulkan gpu profiler created : {} frames, {}ns per tick, {} valid bits, {} within {}ns", frame_count, period_,
+			valid_bits, get_calibrated_timestamps_ != nullptr ? "calibrated timestamps" : "clock offset measured once",
+			calibration_deviation_);
+		return true;
+	}
+
+	void gpu_profiler::destroy()
+	{
+		if (device_ == VK_NULL_HANDLE) return;
+
+		for (auto& frame : frames_)
+		{
+			vkDestroyQueryPool(device_, frame.pool, nullptr);
+		}
+
+		frames_.clear();
+		recording_ = nullptr;
+		device_ = VK_NULL_HANDLE;
+	}
+
+	void gpu_profiler::begin_frame(VkCommandBuffer commands, uint32_t frame)
+	{
+		recording_ = nullptr;
+		if (frames_.empty()) return;
+
+		auto& queries = frames_[frame];
+		if (queries.pending) read_back(queries);
+
+		// cheap enough to repeat, the two clocks need not tick at exactly the same rate
+		if (get_calibrated_timestamps_ != nullptr && ++frames_since_calibration_ >= RECALIBRATE_FRAMES)
+		{
+			calibrate();
+			frames_since_calibration_ = 0;
+		}
+
+		vkCmdResetQueryPool(commands, queries.pool, 0, MAX_REGIONS * 2);
+
+		queries.regions.clear();
+		queries.pending = true;
+		recording_ = &queries;
+	}
+
+	uint32_t gpu_profiler::begin(VkCommandBuffer commands, const char* name)
+	{
+		if (recording_ == nullptr) return NO_REGION;
+
+		auto& regions = recording_->regions;
+		if (regions.size() == MAX_REGIONS)
+		{
+			stats_.dropped++;
+			return NO_REGION;
+		}
+
+		const auto index = static_cast<uint32_t>(regions.size());
+		regions.push_back({ name, index * 2 });
+
+		vkCmdWriteTimestamp(commands, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, recording_->pool, index * 2);
+		return index;
+	}
+
+	void gpu_profiler::end(VkCommandBuffer commands, uint32_t region)
+	{
+		if (recording_ == nullptr || region >= recording_->regions.size()) return;
+
+		// once every command before it has finished
+		auto& ended = recording_->regions[region];
+		vkCmdWriteTimestamp(commands, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, recording_->pool, ended.query + 1);
+		ended.ended = true;
+	}
+
+	bool gpu_profiler::enabled() const
+	{
+		return !frames_.empty();
+	}
+
+	const gpu_profiler_stats& gpu_profiler::stats() const
+	{
+		return stats_;
+	}
+
+	bool gpu_profiler::calibrate()
+	{
+		const VkCalibratedTimestampInfoEXT infos[] =
+		{
+			{ .sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT, .timeDomain = VK_TIME_DOMAIN_DEVICE_EXT },
+			{ .sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT, .timeDomain = HOST_TIME_DOMAIN },
+		};
+
+		// the deviation says how far apart the two reads may have been, a preempted call gives a wide one
+		auto best_deviation = UINT64_MAX;
+
+		for (auto i = 0u; i < CALIBRATION_TRIES; i++)
+		{
+			uint64_t timestamps[2] = {};
+			auto deviation = uint64_t();
+
+			if (get_calibrated_timestamps_(device_, 2, infos, timestamps, &deviation) != VK_SUCCESS) continue;
+			if (deviation >= best_deviation) continue;
+
+			best_deviation = deviation;
+			calibration_ticks_ = timestamps[0] & mask_;
+			calibration_host_ = host_domain_ns(timestamps[1]);
+		}
+
+		if (best_deviation == UINT64_MAX) return false;
+
+		calibration_deviation_ = best_deviation;
+		return true;
+	}
+
+	bool gpu_profiler::calibrate_by_submit(VkQueue queue, uint32_t queue_family)
+	{
+		const auto pool_info = VkCommandPoolCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+			.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+			.queueFamilyIndex = queue_family,
+		};
+
+		auto pool = VkCommandPool();
+		if (vkCreateCommandPool(device_, &pool_info, nullptr, &pool) != VK_SUCCESS) return false;
+
+		const auto allocate_info = VkCommandBufferAllocateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+			.commandPool = pool,
+			.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+			.commandBufferCount = 1,
+		};
+
+		const auto begin_info = VkCommandBufferBeginInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+			.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+		};
+
+		const auto fence_info = VkFenceCreateInfo{ .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+
+		auto commands = VkCommandBuffer();
+		auto fence = VkFence();
+		auto ticks = uint64_t();
+
+		// the first frame's pool is reset again before the frame uses it
+		const auto query_pool = frames_.front().pool;
+
+		auto success = vkAllocateCommandBuffers(device_, &allocate_info, &commands) == VK_SUCCESS &&
+			vkCreateFence(device_, &fence_info, nullptr, &fence) == VK_SUCCESS &&
+			vkBeginCommandBuffer(commands, &begin_info) == VK_SUCCESS;
+
+		if (success)
+		{
+			vkCmdResetQueryPool(commands, query_pool, 0, 1);
+			vkCmdWriteTimestamp(commands, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, query_pool, 0);
+			success = vkEndCommandBuffer(commands) == VK_SUCCESS;
+		}
+
+		const auto submit_info = VkSubmitInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+			.commandBufferCount = 1,
+			.pCommandBuffers = &commands,
+		};
+
+		// the timestamp was written somewhere between the submit and the fence, the midpoint is off by at most half of it
+		const auto before = steady_ns();
+		success = success && vkQueueSubmit(queue, 1, &submit_info, fence) == VK_SUCCESS &&
+			vkWaitForFences(device_, 1, &fence, VK_TRUE, UINT64_MAX) == VK_SUCCESS;
+		const auto after = steady_ns();
+
+		success = success && vkGetQueryPoolResults(device_, query_pool, 0, 1, sizeof(ticks), &ticks, sizeof(ticks),
+			VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT) == VK_SUCCESS;
+
+		if (fence != VK_NULL_HANDLE) vkDestroyFence(device_, fence, nullptr);
+		vkDestroyCommandPool(device_, pool, nullptr);
+
+		if (!success) return false;
+
+		calibration_ticks_ = ticks & mask_;
+		calibration_host_ = before + (after - before) / 2;
+		calibration_deviation_ = static_cast<uint64_t>(after - before) / 2;
+		return true;
+	}
+
+	void gpu_profiler::read_back(frame_queries& frame)
+	{
+		frame.pending = false;
+		if (frame.regions.empty()) return;
+
+		// each query's value followed by whether it was written, never waits so a result missing is left out
+		const auto query_count = static_cast<uint32_t>(frame.regions.size()) * 2;
+		results_.resize(query_count * 2);
+
+		const auto result = vkGetQueryPoolResults(device_, frame.pool, 0, query_count, results_.size() * sizeof(uint64_t),
+			results_.data(), 2 * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+		if (result != VK_SUCCESS && result != VK_NOT_READY)
+		{
+			stats_.dropped += static_cast<uint32_t>(frame.regions.size());
+			return;
+		}
+
+#if MYTHOS_PROFILE
+		auto* profiler = profiler::active();
+		auto events = std::vector<profile_event>();
+#endif
+
+		auto first = INT64_MAX;
+		auto last = INT64_MIN;
+		auto resolved = 0u;
+
+		for (const auto& region : frame.regions)
+		{
+			const auto* begin = &results_[region.query * 2];
+			const auto* end = &results_[(region.query + 1) * 2];
+
+			if (!region.ended || begin[1] == 0 || end[1] == 0)
+			{
+				stats_.dropped++;
+				continue;
+			}
+
+			const auto begin_time = host_time(begin[0]);
+			const auto end_time = begin_time + static_cast<int64_t>(static_cast<double>((end[0] - begin[0]) & mask_) * period_);
+
+			first = std::min(first, begin_time);
+			last = std::max(last, end_time);
+			resolved++;
+
+#if MYTHOS_PROFILE
+			if (profiler != nullptr) events.push_back({ region.name, begin_time, end_time });
+#endif
+		}
+
+		stats_.regions = resolved;
+		stats_.frame_ms = resolved > 0 ? static_cast<double>(last - first) / 1'000'000.0 : 0.0;
+
+#if MYTHOS_PROFILE
+		if (profiler != nullptr) profiler->add_track_events("gpu", events);
+#endif
+	}
+
+	int64_t gpu_profiler::host_time(uint64_t ticks) const
+	{
+		const auto to_ns = [this](uint64_t delta) { return static_cast<int64_t>(static_cast<double>(delta) * period_); };
+
+		// the counter may wrap past its valid bits, a timestamp within half its range of the calibration is placed
+		// on the right side of it
+		const auto ahead = (ticks - calibration_ticks_) & mask_;
+		if (ahead <= mask_ / 2) return calibration_host_ + to_ns(ahead);
+
+		return calibration_host_ - to_ns((calibration_ticks_ - ticks) & mask_);
+	}
+}
@@ -0,0 +1,712 @@
+#include "Vulkan/instance_batcher.hpp"
+
+// STL
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <string>
+
+// GLM
+#include <glm/gtc/quaternion.hpp>
+
+// Mythos
+#include "Debug.hpp"
+#include "Shader/shader.hpp"
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	bool instance_batcher::create(VkDevice device, memory_allocator& allocator, uint32_t frame_count, bool indirect)
+	{
+		device_ = device;
+		allocator_ = &allocator;
+		indirect_ = indirect;
+
+		if (indirect_ && !(create_pipelines() && create_descriptor_pool(frame_count)))
+		{
+			// the shaders are built with the renderer, a missing one is a broken build rather than a device limit
+			Debug::error("Vulkan instance batcher : no compute pass, batches are drawn directly and culled on the cpu");
+			indirect_ = false;
+		}
+
+		cull_mode_ = indirect_ ? cull_mode::gpu : cull_mode::cpu;
+
+		frames_.resize(frame_count);
+
+		for (auto& frame : frames_)
+		{
+			if (indirect_ && !create_buffer(sizeof(cull_uniforms), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+			                                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			                                frame.cull, frame.cull_allocation))
+			{
+				Debug::error("Vulkan instance batcher failed to create its cull uniforms");
+				return false;
+			}
+
+			// every frame starts with buffers, so the descriptor sets pointing at them are valid from the first frame
+			auto grown = false;
+			if (!reserve(frame, MIN_INSTANCES, MIN_COMMANDS, grown)) return false;
+		}
+
+		Debug::log(std::string("Vulkan instance batcher created : ") + (indirect_ ? "indirect draws" : "direct draws"));
+		return true;
+	}
+
+	void instance_batcher::destroy()
+	{
+		if (device_ == VK_NULL_HANDLE) return;
+
+		for (auto& frame : frames_)
+		{
+			release(frame);
+
+			if (frame.cull != VK_NULL_HANDLE)
+			{
+				vkDestroyBuffer(device_, frame.cull, nullptr);
+				allocator_->free(frame.cull_allocation);
+			}
+		}
+		frames_.clear();
+
+		// frees the descriptor sets with it
+		vkDestroyDescriptorPool(device_, descriptor_pool_, nullptr);
+		vkDestroyPipeline(device_, pipeline_, nullptr);
+		vkDestroyPipeline(device_, occlusion_pipeline_, nullptr);
+		vkDestroyPipelineLayout(device_, pipeline_layout_, nullptr);
+		vkDestroyDescriptorSetLayout(device_, set_layout_, nullptr);
+
+		device_ = VK_NULL_HANDLE;
+		pyramid_ = nullptr;
+	}
+
+	void instance_batcher::bind_depth_pyramid(const depth_pyramid* pyramid)
+	{
+		pyramid_ = pyramid;
+
+		for (auto& frame : frames_)
+		{
+			write_descriptor_set(frame);
+		}
+	}
+
+	void instance_batcher::set_cull_mode(cull_mode mode)
+	{
+		cull_mode_ = indirect_ ? mode : cull_mode::cpu;
+	}
+
+	cull_mode instance_batcher::culling() const
+	{
+		return cull_mode_;
+	}
+
+	// the top three rows of position * rotation * scale * translate(local_offset) * scale(local_scale),
+	// local is the dequantization of the instance's mesh
+	static auto compose_rows(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale,
+	                         const glm::vec3& local_offset, const glm::vec3& local_scale) -> glm::mat3x4
+	{
+		const auto rotation_matrix = glm::mat3_cast(rotation);
+
+		const auto x = rotation_matrix[0] * scale.x;
+		const auto y = rotation_matrix[1] * scale.y;
+		const auto z = rotation_matrix[2] * scale.z;
+
+		const auto translation = position + x * local_offset.x + y * local_offset.y + z * local_offset.z;
+
+		const auto lx = x * local_scale.x;
+		const auto ly = y * local_scale.y;
+		const auto lz = z * local_scale.z;
+
+		return glm::mat3x4(
+			lx.x, ly.x, lz.x, translation.x,
+			lx.y, ly.y, lz.y, translation.y,
+			lx.z, ly.z, lz.z, translation.z);
+	}
+
+	bool instance_batcher::build(uint32_t frame, const glm::mat4& view_proj, const instance_list& instances,
+	                             asset_manager& assets, job_system* jobs, std::vector<draw_item>& draws)
+	{
+		auto& target = frames_[frame];
+		const auto& meshes = assets.meshes();
+		const auto count = static_cast<uint32_t>(instances.size());
+		const auto view = extract_frustum(view_proj);
+		const auto cpu_culling = cull_mode_ == cull_mode::cpu;
+
+		// the frame's fence has signalled, its commands still hold what the compute pass counted
+		if (!cpu_culling)
+		{
+			count_visible(target);
+		}
+		else
+		{
+			cull_instances(view, instances, meshes, jobs);
+		}
+
+		draws.clear();
+		batch_of_mesh_.assign(meshes.size(), UINT32_MAX);
+		slots_.assign(count, UINT32_MAX);
+
+		// every mesh that is ready to draw becomes a batch, in the order the instances first use it
+		auto instance_count = 0u;
+		auto ready_count = 0u;
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const auto mesh = instances.meshes[i];
+			if (mesh.index >= meshes.size() || meshes[mesh.index].state != asset_state::ready) continue;
+
+			ready_count++;
+			if (cpu_culling && visible_[i] == 0) continue;
+
+			auto& batch = batch_of_mesh_[mesh.index];
+			if (batch == UINT32_MAX)
+			{
+				batch = static_cast<uint32_t>(draws.size());
+				draws.push_back({ .mesh = mesh, .batch = batch });
+			}
+
+			draws[batch].instance_count++;
+			instance_count++;
+		}
+
+		const auto batch_count = static_cast<uint32_t>(draws.size());
+
+		auto grown = false;
+		if (!reserve(target, instance_count, batch_count, grown))
+		{
+			draws.clear();
+			target.instance_count = 0;
+			target.batch_count = 0;
+			return grown;
+		}
+
+		// each batch owns a run of the visible list, the compute pass counts its instances from zero
+		auto* commands = static_cast<VkDrawIndexedIndirectCommand*>(target.command_allocation.mapped);
+		cursors_.resize(batch_count);
+
+		auto first_instance = 0u;
+
+		for (uint32_t batch = 0; batch < batch_count; batch++)
+		{
+			auto& draw = draws[batch];
+			draw.first_instance = first_instance;
+			cursors_[batch] = first_instance;
+
+			commands[batch] = VkDrawIndexedIndirectCommand
+			{
+				.indexCount = meshes[draw.mesh.index].index_count,
+				.instanceCount = indirect_ ? 0u : draw.instance_count,
+				.firstIndex = 0,
+				.vertexOffset = 0,
+				.firstInstance = first_instance,
+			};
+
+			first_instance += draw.instance_count;
+		}
+
+		if (indirect_)
+		{
+			write_cull_data(target, view, draws, meshes);
+		}
+
+		// instances land grouped by batch so the visible list of a direct draw is the identity
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const auto mesh = instances.meshes[i].index;
+			if (mesh >= batch_of_mesh_.size() || batch_of_mesh_[mesh] == UINT32_MAX) continue;
+			if (cpu_culling && visible_[i] == 0) continue;
+
+			slots_[i] = cursors_[batch_of_mesh_[mesh]]++;
+		}
+
+		// one sweep over the transform arrays, each instance written whole into the mapped buffer
+		auto* written = static_cast<gpu_instance*>(target.instance_allocation.mapped);
+		const auto& transforms = instances.transforms;
+
+		const auto write = [&](uint32_t begin, uint32_t end)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				if (slots_[i] == UINT32_MAX) continue;
+
+				const auto mesh = instances.meshes[i].index;
+				const auto& resource = meshes[mesh];
+
+				written[slots_[i]] = gpu_instance
+				{
+					.model = compose_rows(transforms.positions[i], transforms.rotations[i], transforms.scales[i],
+					                      resource.position_offset, resource.position_scale),
+					.batch = batch_of_mesh_[mesh],
+					.texture = instances.textures[i],
+					.padding = {},
+				};
+			}
+		};
+
+		if (jobs != nullptr && count > INSTANCES_PER_JOB)
+		{
+			jobs->parallel_for(count, INSTANCES_PER_JOB, write);
+		}
+		else
+		{
+			write(0, count);
+		}
+
+		target.instance_count = instance_count;
+		target.batch_count = batch_count;
+
+		stats_.instances = instance_count;
+		stats_.batches = batch_count;
+
+		if (cpu_culling)
+		{
+			stats_.visible = instance_count;
+			stats_.culled = ready_count - instance_count;
+		}
+
+		return grown;
+	}
+
+	void instance_batcher::cull_instances(const frustum& view, const instance_list& instances,
+	                                      const std::vector<mesh_resource>& meshes, job_system* jobs)
+	{
+		const auto count = static_cast<uint32_t>(instances.size());
+		const auto& transforms = instances.transforms;
+
+		spheres_.resize(count);
+		visible_.resize(count);
+
+		// each job places its spheres in world space and tests them while they are still in cache
+		const auto cull = [&](uint32_t begin, uint32_t end)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				const auto mesh = instances.meshes[i].index;
+				const auto& scale = transforms.scales[i];
+
+				// meshes still loading are skipped by the batching whatever their sphere
+				const auto centre = mesh < meshes.size() ? meshes[mesh].bounds_centre : glm::vec3(0.0f);
+				const auto radius = mesh < meshes.size() ? meshes[mesh].bounds_radius : 0.0f;
+
+				const auto world = transforms.positions[i] + transforms.rotations[i] * (scale * centre);
+
+				spheres_.x[i] = world.x;
+				spheres_.y[i] = world.y;
+				spheres_.z[i] = world.z;
+				spheres_.radius[i] = radius * std::max({ std::abs(scale.x), std::abs(scale.y), std::abs(scale.z) });
+			}
+
+			cull_spheres(view, spheres_, begin, end, visible_.data());
+		};
+
+		if (jobs != nullptr && count > INSTANCES_PER_JOB)
+		{
+			jobs->parallel_for(count, INSTANCES_PER_JOB, cull);
+		}
+		else
+		{
+			cull(0, count);
+		}
+	}
+
+	void instance_batcher::count_visible(const frame_buffers& frame)
+	{
+		if (frame.commands == VK_NULL_HANDLE) return;
+
+		// the pass made its writes available to the host before the fence, they still have to reach a non coherent mapping
+		allocator_->invalidate(frame.command_allocation);
+
+		const auto* commands = static_cast<const VkDrawIndexedIndirectCommand*>(frame.command_allocation.mapped);
+
+		auto visible = 0u;
+		for (uint32_t batch = 0; batch < frame.batch_count; batch++)
+		{
+			visible += commands[batch].instanceCount;
+		}
+
+		stats_.visible = visible;
+		stats_.culled = frame.instance_count - visible;
+	}
+
+	void instance_batcher::write_cull_data(frame_buffers& frame, const frustum& view, const std::vector<draw_item>& draws,
+	                                       const std::vector<mesh_resource>& meshes)
+	{
+		// the sphere is moved into the quantized space the rows take positions in, its radius stays in mesh units
+		auto* batches = static_cast<gpu_batch*>(frame.batch_allocation.mapped);
+
+		for (const auto& draw : draws)
+		{
+			const auto& resource = meshes[draw.mesh.index];
+
+			batches[draw.batch] = gpu_batch
+			{
+				.sphere = glm::vec4((resource.bounds_centre - resource.position_offset) / resource.position_scale, resource.bounds_radius),
+				.inverse_scale = glm::vec4(1.0f / resource.position_scale, 0.0f),
+			};
+		}
+
+		const auto gpu_culling = cull_mode_ == cull_mode::gpu;
+
+		// the first frame after the pyramid is resized has no depth to test against
+		frame.occlusion = gpu_culling && occlusion_pipeline_ != VK_NULL_HANDLE && pyramid_ != nullptr && pyramid_->valid();
+
+		auto& uniforms = *static_cast<cull_uniforms*>(frame.cull_allocation.mapped);
+
+		for (size_t i = 0; i < view.planes.size(); i++)
+		{
+			uniforms.planes[i] = view.planes[i];
+		}
+
+		uniforms.previous_view_proj = frame.occlusion ? pyramid_->view_proj() : glm::mat4(1.0f);
+		uniforms.pyramid_size = frame.occlusion ? glm::vec2(pyramid_->extent().width, pyramid_->extent().height) : glm::vec2(0.0f);
+		uniforms.pyramid_levels = frame.occlusion ? pyramid_->level_count() : 0;
+
+		// culled on the cpu already, the pass only counts
+		uniforms.flags = (gpu_culling ? CULL_FRUSTUM : 0) | (frame.occlusion ? CULL_OCCLUSION : 0);
+	}
+
+	void instance_batcher::record(VkCommandBuffer commands, uint32_t frame)
+	{
+		const auto& target = frames_[frame];
+		if (!indirect_ || target.instance_count == 0) return;
+
+		// only the occlusion variant reads the pyramid, the other never needs its descriptor
+		vkCmdBindPipeline(commands, VK_PIPELINE_BIND_POINT_COMPUTE, target.occlusion ? occlusion_pipeline_ : pipeline_);
+		vkCmdBindDescriptorSets(commands, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_layout_, 0, 1, &target.set, 0, nullptr);
+		vkCmdPushConstants(commands, pipeline_layout_, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uint32_t), &target.instance_count);
+		vkCmdDispatch(commands, (target.instance_count + GROUP_SIZE - 1) / GROUP_SIZE, 1, 1);
+
+		// the counted commands are read by the draws, the visible list by the vertex shader, and the counts by the cpu
+		// once the frame's fence has signalled, the fence alone does not make the writes visible to the host
+		const auto barrier = VkMemoryBarrier
+		{
+			.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+			.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+			.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_HOST_READ_BIT,
+		};
+
+		vkCmdPipelineBarrier(commands, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+			0, 1, &barrier, 0, nullptr, 0, nullptr);
+	}
+
+	bool instance_batcher::indirect() const
+	{
+		return indirect_;
+	}
+
+	VkBuffer instance_batcher::instance_buffer(uint32_t frame) const
+	{
+		return frames_[frame].instances;
+	}
+
+	VkBuffer instance_batcher::visible_buffer(uint32_t frame) const
+	{
+		return frames_[frame].visible;
+	}
+
+	VkBuffer instance_batcher::command_buffer(uint32_t frame) const
+	{
+		return frames_[frame].commands;
+	}
+
+	const batcher_stats& instance_batcher::stats() const
+	{
+		return stats_;
+	}
+
+	bool instance_batcher::create_pipelines()
+	{
+		// instances, commands, the visible list, the batch bounds, the cull uniforms and the depth pyramid
+		const auto bindings = std::array<VkDescriptorSetLayoutBinding, 6>
+		{
+			VkDescriptorSetLayoutBinding{ 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT },
+			VkDescriptorSetLayoutBinding{ 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT },
+			VkDescriptorSetLayoutBinding{ 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT },
+			VkDescriptorSetLayoutBinding{ 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT },
+			VkDescriptorSetLayoutBinding{ 4, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT },
+			VkDescriptorSetLayoutBinding{ 5, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT },
+		};
+
+		const auto set_layout_info = VkDescriptorSetLayoutCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+			.bindingCount = static_cast<uint32_t>(bindings.size()),
+			.pBindings = bindings.data(),
+		};
+
+		const auto push_constant = VkPushConstantRange
+		{
+			.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+			.offset = 0,
+			.size = sizeof(uint32_t),
+		};
+
+		const auto layout_info = VkPipelineLayoutCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+			.setLayoutCount = 1,
+			.pSetLayouts = &set_layout_,
+			.pushConstantRangeCount = 1,
+			.pPushConstantRanges = &push_constant,
+		};
+
+		if (vkCreateDescriptorSetLayout(device_, &set_layout_info, nullptr, &set_layout_) != VK_SUCCESS ||
+			vkCreatePipelineLayout(device_, &layout_info, nullptr, &pipeline_layout_) != VK_SUCCESS)
+		{
+			Debug::error("Vulkan instance batcher failed to create its pipeline layout");
+			return false;
+		}
+
+		if (!create_pipeline("../Renderer/shaders/build_draws.spv", pipeline_)) return false;
+
+		// without it instances are only culled against the frustum
+		if (!create_pipeline("../Renderer/shaders/build_draws_occlusion.spv", occlusion_pipeline_))
+		{
+			Debug::error("Vulkan instance batcher : no occlusion culling pipeline");
+		}
+
+		return true;
+	}
+
+	bool instance_batcher::create_pipeline(const char* path, VkPipeline& pipeline)
+	{
+		const auto code = shader::read_file(path);
+		if (code.empty()) return false;
+
+		const auto module_info = VkShaderModuleCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+			.codeSize = code.size(),
+			.pCode = reinterpret_cast<const uint32_t*>(code.data()),
+		};
+
+		auto module = VkShaderModule();
+		if (vkCreateShaderModule(device_, &module_info, nullptr, &module) != VK_SUCCESS)
+		{
+			Debug::error(std::string("Vulkan instance batcher failed to create the shader module of ") + path);
+			return false;
+		}
+
+		const auto pipeline_info = VkComputePipelineCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+			.stage = VkPipelineShaderStageCreateInfo
+			{
+				.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+				.stage = VK_SHADER_STAGE_COMPUTE_BIT,
+				.module = module,
+				.pName = "main",
+			},
+			.layout = pipeline_layout_,
+		};
+
+		const auto success = vkCreateComputePipelines(device_, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &pipeline) == VK_SUCCESS;
+		vkDestroyShaderModule(device_, module, nullptr);
+
+		if (!success)
+		{
+			Debug::error(std::string("Vulkan instance batcher failed to create the pipeline of ") + path);
+		}
+
+		return success;
+	}
+
+	bool instance_batcher::create_descriptor_pool(uint32_t frame_count)
+	{
+		const auto pool_sizes = std::array<VkDescriptorPoolSize, 3>
+		{
+			VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 * frame_count },
+			VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, frame_count },
+			VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, frame_count },
+		};
+
+		const auto pool_info = VkDescriptorPoolCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+			.maxSets = frame_count,
+			.poolSizeCount = static_cast<uint32_t>(pool_sizes.size()),
+			.pPoolSizes = pool_sizes.data(),
+		};
+
+		if (vkCreateDescriptorPool(device_, &pool_info, nullptr, &descriptor_pool_) != VK_SUCCESS)
+		{
+			Debug::error("Vulkan instance batcher failed to create its descriptor pool");
+			return false;
+		}
+
+		return true;
+	}
+
+	bool instance_batcher::reserve(frame_buffers& frame, uint32_t instance_count, uint32_t command_count, bool& grown)
+	{
+		if (instance_count <= frame.instance_capacity && command_count <= frame.command_capacity) return true;
+
+		// the frame's fence has signalled, nothing reads the old buffers any more
+		release(frame);
+
+		const auto instance_capacity = std::bit_ceil(std::max(instance_count, MIN_INSTANCES));
+		const auto command_capacity = std::bit_ceil(std::max(command_count, MIN_COMMANDS));
+
+		constexpr auto host = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+		// the visible list is only ever written by the compute pass, without it the cpu writes the identity once
+		const auto visible_properties = indirect_ ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT : host;
+
+		const auto success =
+			create_buffer(instance_capacity * sizeof(gpu_instance), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, host,
+			              frame.instances, frame.instance_allocation) &&
+			create_buffer(instance_capacity * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, visible_properties,
+			              frame.visible, frame.visible_allocation) &&
+			create_buffer(command_capacity * sizeof(VkDrawIndexedIndirectCommand),
+			              VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, host,
+			              frame.commands, frame.command_allocation) &&
+			(!indirect_ || create_buffer(command_capacity * sizeof(gpu_batch), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, host,
+			                             frame.batches, frame.batch_allocation));
+
+		if (!success)
+		{
+			Debug::error("Vulkan instance batcher failed to create buffers for " + std::to_string(instance_count) + " instances");
+			release(frame);
+			return false;
+		}
+
+		frame.instance_capacity = instance_capacity;
+		frame.command_capacity = command_capacity;
+
+		if (!indirect_)
+		{
+			auto* visible = static_cast<uint32_t*>(frame.visible_allocation.mapped);
+			for (uint32_t i = 0; i < instance_capacity; i++)
+			{
+				visible[i] = i;
+			}
+		}
+
+		write_descriptor_set(frame);
+
+		grown = true;
+		return true;
+	}
+
+	void instance_batcher::release(frame_buffers& frame)
+	{
+		const auto destroy = [this](VkBuffer& buffer, gpu_allocation& allocation)
+		{
+			if (buffer == VK_NULL_HANDLE) return;
+
+			vkDestroyBuffer(device_, buffer, nullptr);
+			allocator_->free(allocation);
+			buffer = VK_NULL_HANDLE;
+		};
+
+		destroy(frame.instances, frame.instance_allocation);
+		destroy(frame.visible, frame.visible_allocation);
+		destroy(frame.commands, frame.command_allocation);
+		destroy(frame.batches, frame.batch_allocation);
+
+		frame.instance_capacity = 0;
+		frame.command_capacity = 0;
+		frame.instance_count = 0;
+		frame.batch_count = 0;
+	}
+
+	void instance_batcher::write_descriptor_set(frame_buffers& frame)
+	{
+		if (!indirect_) return;
+
+		if (frame.set == VK_NULL_HANDLE)
+		{
+			const auto allocate_info = VkDescriptorSetAllocateInfo
+			{
+				.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+				.descriptorPool = descriptor_pool_,
+				.descriptorSetCount = 1,
+				.pSetLayouts = &set_layout_,
+			};
+
+			if (vkAllocateDescriptorSets(device_, &allocate_info, &frame.set) != VK_SUCCESS)
+			{
+				Debug::error("Vulkan instance batcher failed to allocate a descriptor set");
+				return;
+			}
+		}
+
+		const auto buffers = std::array<VkDescriptorBufferInfo, 5>
+		{
+			VkDescriptorBufferInfo{ frame.instances, 0, VK_WHOLE_SIZE },
+			VkDescriptorBufferInfo{ frame.commands, 0, VK_WHOLE_SIZE },
+			VkDescriptorBufferInfo{ frame.visible, 0, VK_WHOLE_SIZE },
+			VkDescriptorBufferInfo{ frame.batches, 0, VK_WHOLE_SIZE },
+			VkDescriptorBufferInfo{ frame.cull, 0, VK_WHOLE_SIZE },
+		};
+
+		auto writes = std::array<VkWriteDescriptorSet, 6>();
+		for (uint32_t i = 0; i < buffers.size(); i++)
+		{
+			writes[i] = VkWriteDescriptorSet
+			{
+				.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+				.dstSet = frame.set,
+				.dstBinding = i,
+				.descriptorCount = 1,
+				.descriptorType = i == 4 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				.pBufferInfo = &buffers[i],
+			};
+		}
+
+		// left unwritten without a pyramid, only the occlusion pipeline reads it
+		const auto pyramid = VkDescriptorImageInfo
+		{
+			.sampler = pyramid_ != nullptr ? pyramid_->sampler() : VK_NULL_HANDLE,
+			.imageView = pyramid_ != nullptr ? pyramid_->view() : VK_NULL_HANDLE,
+			.imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+		};
+
+		writes[5] = VkWriteDescriptorSet
+		{
+			.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+			.dstSet = frame.set,
+			.dstBinding = 5,
+			.descriptorCount = 1,
+			.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+			.pImageInfo = &pyramid,
+		};
+
+		const auto write_count = pyramid.imageView != VK_NULL_HANDLE ? writes.size() : buffers.size();
+		vkUpdateDescriptorSets(device_, static_cast<uint32_t>(write_count), writes.data(), 0, nullptr);
+	}
+
+	bool instance_batcher::create_buffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+	                                     VkBuffer& buffer, gpu_allocation& allocation)
+	{
+		const auto buffer_info = VkBufferCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+			.size = size,
+			.usage = usage,
+			.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+		};
+
+		if (vkCreateBuffer(device_, &buffer_info, nullptr, &buffer) != VK_SUCCESS)
+		{
+			buffer = VK_NULL_HANDLE;
+			return false;
+		}
+
+		auto requirements = VkMemoryRequirements();
+		vkGetBufferMemoryRequirements(device_, buffer, &requirements);
+
+		if (!allocator_->allocate(requirements, properties, resource_kind::linear, allocation))
+		{
+			vkDestroyBuffer(device_, buffer, nullptr);
+			buffer = VK_NULL_HANDLE;
+			return false;
+		}
+
+		vkBindBufferMemory(device_, buffer, allocation.memory, allocation.offset);
+		return true;
+	}
+}
@@ -0,0 +1,430 @@
+#include "Vulkan/memory_allocator.hpp"
+
+// STL
+#include <algorithm>
+#include <bit>
+#include <string>
+
+// Mythos
+#include "Debug.hpp"
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	static auto level_count(VkDeviceSize size, VkDeviceSize min_size) -> uint32_t
+	{
+		return static_cast<uint32_t>(std::countr_zero(size) - std::countr_zero(min_size)) + 1;
+	}
+
+	static auto to_mb(VkDeviceSize bytes) -> std::string
+	{
+		return std::to_string(static_cast<double>(bytes) / (1024.0 * 1024.0)) + "MB";
+	}
+
+	buddy_allocator::buddy_allocator(VkDeviceSize size, VkDeviceSize min_size)
+	{
+		size_ = std::bit_floor(size);
+		min_size = std::min(std::bit_ceil(min_size), size_);
+
+		free_.resize(level_count(size_, min_size));
+		free_[0].insert(0);
+		free_bytes_ = size_;
+	}
+
+	bool buddy_allocator::allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset)
+	{
+		const auto min_size = size_ >> (free_.size() - 1);
+		const auto needed = std::bit_ceil(std::max({ size, alignment, min_size }));
+		if (needed > size_) return false;
+
+		const auto target = static_cast<uint32_t>(std::countr_zero(size_) - std::countr_zero(needed));
+
+		// smallest free block that still fits, walking towards the larger levels
+		auto level = static_cast<int>(target);
+		while (level >= 0 && free_[level].empty())
+		{
+			level--;
+		}
+
+		if (level < 0) return false;
+
+		offset = *free_[level].begin();
+		free_[level].erase(free_[level].begin());
+
+		// split down to the requested size, the upper halves go back on the free lists
+		while (static_cast<uint32_t>(level) < target)
+		{
+			level++;
+			free_[level].insert(offset + (size_ >> level));
+		}
+
+		allocated_[offset] = target;
+		free_bytes_ -= needed;
+		return true;
+	}
+
+	VkDeviceSize buddy_allocator::free(VkDeviceSize offset)
+	{
+		const auto found = allocated_.find(offset);
+		if (found == allocated_.end())
+		{
+			Debug::error("Vulkan allocator : freeing an offset that was never allocated");
+			return 0;
+		}
+
+		auto level = found->second;
+		allocated_.erase(found);
+
+		const auto released = size_ >> level;
+		free_bytes_ += released;
+
+		// merge with the buddy for as long as it is free as well
+		while (level > 0)
+		{
+			const auto buddy = offset ^ (size_ >> level);
+			if (free_[level].erase(buddy) == 0) break;
+
+			offset = std::min(offset, buddy);
+			level--;
+		}
+
+		free_[level].insert(offset);
+		return released;
+	}
+
+	VkDeviceSize buddy_allocator::size() const
+	{
+		return size_;
+	}
+
+	VkDeviceSize buddy_allocator::free_bytes() const
+	{
+		return free_bytes_;
+	}
+
+	bool buddy_allocator::empty() const
+	{
+		return allocated_.empty();
+	}
+
+	// --
+
+	memory_allocator::~memory_allocator()
+	{
+		destroy();
+	}
+
+	bool memory_allocator::create(VkPhysicalDevice physical_device, VkDevice device, VkDeviceSize block_size)
+	{
+		device_ = device;
+		block_size_ = std::bit_floor(std::max(block_size, MIN_ALLOCATION_SIZE));
+
+		vkGetPhysicalDeviceMemoryProperties(physical_device, &memory_properties_);
+
+		auto properties = VkPhysicalDeviceProperties();
+		vkGetPhysicalDeviceProperties(physical_device, &properties);
+		max_allocations_ = properties.limits.maxMemoryAllocationCount;
+		non_coherent_atom_size_ = std::max<VkDeviceSize>(properties.limits.nonCoherentAtomSize, 1);
+
+		Debug::log("Vulkan memory allocator created : " + to_mb(block_size_) + " blocks, " +
+			std::to_string(memory_properties_.memoryTypeCount) + " memory types, limit of " +
+			std::to_string(max_allocations_) + " device allocations");
+		return true;
+	}
+
+	void memory_allocator::destroy()
+	{
+		if (device_ == VK_NULL_HANDLE) return;
+
+		std::lock_guard lock(mutex_);
+
+		if (stats_.sub_allocation_count > 0 || stats_.dedicated_count > 0)
+		{
+			Debug::warn("Vulkan allocator : destroyed with " + std::to_string(stats_.sub_allocation_count) +
+				" sub allocations and " + std::to_string(stats_.dedicated_count) + " dedicated allocations still live");
+		}
+
+		for (auto& pool : pools_)
+		{
+			for (auto& blocks : pool)
+			{
+				for (auto& block : blocks)
+				{
+					destroy_block(*block);
+				}
+				blocks.clear();
+			}
+		}
+
+		device_ = VK_NULL_HANDLE;
+	}
+
+	bool memory_allocator::allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+	                                resource_kind kind, gpu_allocation& allocation)
+	{
+		std::lock_guard lock(mutex_);
+
+		// every compatible memory type is a candidate, the next one is tried when a heap runs out
+		for (uint32_t type = 0; type < memory_properties_.memoryTypeCount; type++)
+		{
+			if ((requirements.memoryTypeBits & (1u << type)) == 0) continue;
+			if ((memory_properties_.memoryTypes[type].propertyFlags & properties) != properties) continue;
+
+			if (allocate_from_type(type, requirements, kind, allocation))
+			{
+				return true;
+			}
+		}
+
+		Debug::error("Vulkan allocator : failed to allocate " + std::to_string(requirements.size) + " bytes");
+		return false;
+	}
+
+	void memory_allocator::free(gpu_allocation& allocation)
+	{
+		if (allocation.memory == VK_NULL_HANDLE) return;
+
+		std::lock_guard lock(mutex_);
+
+		if (allocation.block == nullptr)
+		{
+			vkFreeMemory(device_, allocation.memory, nullptr);
+
+			stats_.dedicated_count--;
+			stats_.device_allocations--;
+			stats_.reserved_bytes -= allocation.size;
+			stats_.used_bytes -= allocation.size;
+
+			allocation = gpu_allocation();
+			return;
+		}
+
+		auto& block = *allocation.block;
+		const auto released = block.buddy.free(allocation.offset);
+
+		stats_.sub_allocation_count--;
+		stats_.used_bytes -= allocation.size;
+		stats_.padding_bytes -= released - allocation.size;
+
+		// keep one empty block per pool around so a load / unload cycle does not hit the driver every time
+		if (block.buddy.empty())
+		{
+			auto& blocks = pools_[block.memory_type][static_cast<uint32_t>(block.kind)];
+			const auto empty_blocks = std::ranges::count_if(blocks, [](const auto& item) { return item->buddy.empty(); });
+
+			if (empty_blocks > 1)
+			{
+				destroy_block(block);
+				std::erase_if(blocks, [&block](const auto& item) { return item.get() == &block; });
+			}
+		}
+
+		allocation = gpu_allocation();
+	}
+
+	void memory_allocator::invalidate(const gpu_allocation& allocation) const
+	{
+		if (allocation.mapped == nullptr) return;
+		if (memory_properties_.memoryTypes[allocation.memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) return;
+
+		// the range is widened to whole atoms, a sub allocation's buddy block is at least as aligned as an atom
+		// and a dedicated allocation starts at zero and owns the rest of its memory
+		const auto atom = non_coherent_atom_size_;
+		const auto offset = allocation.offset / atom * atom;
+		const auto size = allocation.block != nullptr ? (allocation.offset + allocation.size - offset + atom - 1) / atom * atom : VK_WHOLE_SIZE;
+
+		const auto range = VkMappedMemoryRange
+		{
+			.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+			.memory = allocation.memory,
+			.offset = offset,
+			.size = size,
+		};
+
+		vkInvalidateMappedMemoryRanges(device_, 1, &range);
+	}
+
+	allocator_stats memory_allocator::stats() const
+	{
+		std::lock_guard lock(mutex_);
+		return stats_;
+	}
+
+	void memory_allocator::log_stats() const
+	{
+		const auto current = stats();
+
+		Debug::log("Vulkan allocator : " + std::to_string(current.device_allocations) + " device allocations (peak " +
+			std::to_string(current.peak_device_allocations) + "), " +
+			std::to_string(current.block_count) + " blocks, " +
+			std::to_string(current.dedicated_count) + " dedicated, " +
+			std::to_string(current.sub_allocation_count) + " sub allocations, " +
+			to_mb(current.used_bytes) + " used of " + to_mb(current.reserved_bytes) + " reserved, " +
+			to_mb(current.padding_bytes) + " padding");
+	}
+
+	bool memory_allocator::allocate_from_type(uint32_t type, const VkMemoryRequirements& requirements,
+	                                          resource_kind kind, gpu_allocation& allocation)
+	{
+		const auto block_size = block_size_for(type);
+
+		// large images would waste most of a block to rounding, give them their own memory
+		if (requirements.size > block_size / 2)
+		{
+			return allocate_dedicated(type, requirements, allocation);
+		}
+
+		auto& blocks = pools_[type][static_cast<uint32_t>(kind)];
+
+		auto offset = VkDeviceSize();
+		memory_block* target = nullptr;
+
+		for (const auto& block : blocks)
+		{
+			if (block->buddy.free_bytes() < requirements.size) continue;
+			if (!block->buddy.allocate(requirements.size, requirements.alignment, offset)) continue;
+
+			target = block.get();
+			break;
+		}
+
+		if (target == nullptr)
+		{
+			target = create_block(type, kind);
+
+			// the heap may not have room for a whole block but still fit this one resource
+			if (target == nullptr)
+			{
+				return allocate_dedicated(type, requirements, allocation);
+			}
+
+			// alignment padding can still overflow an empty block, the offset is garbage then and must not be used
+			if (!target->buddy.allocate(requirements.size, requirements.alignment, offset))
+			{
+				destroy_block(*target);
+				std::erase_if(blocks, [target](const auto& item) { return item.get() == target; });
+				return allocate_dedicated(type, requirements, allocation);
+			}
+		}
+
+		allocation.memory = target->memory;
+		allocation.offset = offset;
+		allocation.size = requirements.size;
+		allocation.mapped = target->mapped != nullptr ? static_cast<char*>(target->mapped) + offset : nullptr;
+		allocation.memory_type = type;
+		allocation.block = target;
+
+		const auto rounded = std::bit_ceil(std::max({ requirements.size, requirements.alignment, MIN_ALLOCATION_SIZE }));
+
+		stats_.sub_allocation_count++;
+		stats_.used_bytes += requirements.size;
+		stats_.padding_bytes += rounded - requirements.size;
+		return true;
+	}
+
+	bool memory_allocator::allocate_dedicated(uint32_t type, const VkMemoryRequirements& requirements,
+	                                          gpu_allocation& allocation)
+	{
+		auto memory = VkDeviceMemory();
+		auto* mapped = static_cast<void*>(nullptr);
+
+		if (!allocate_device_memory(type, requirements.size, memory, mapped))
+		{
+			return false;
+		}
+
+		allocation.memory = memory;
+		allocation.offset = 0;
+		allocation.size = requirements.size;
+		allocation.mapped = mapped;
+		allocation.memory_type = type;
+		allocation.block = nullptr;
+
+		stats_.dedicated_count++;
+		stats_.reserved_bytes += requirements.size;
+		stats_.used_bytes += requirements.size;
+		return true;
+	}
+
+	memory_block* memory_allocator::create_block(uint32_t type, resource_kind kind)
+	{
+		const auto size = block_size_for(type);
+
+		auto block = std::make_unique<memory_block>(size, MIN_ALLOCATION_SIZE);
+		block->memory_type = type;
+		block->kind = kind;
+
+		if (!allocate_device_memory(type, size, block->memory, block->mapped))
+		{
+			return nullptr;
+		}
+
+		stats_.block_count++;
+		stats_.reserved_bytes += size;
+
+		auto& blocks = pools_[type][static_cast<uint32_t>(kind)];
+		blocks.push_back(std::move(block));
+		return blocks.back().get();
+	}
+
+	void memory_allocator::destroy_block(memory_block& block)
+	{
+		if (block.mapped != nullptr)
+		{
+			vkUnmapMemory(device_, block.memory);
+		}
+
+		vkFreeMemory(device_, block.memory, nullptr);
+
+		stats_.block_count--;
+		stats_.device_allocations--;
+		stats_.reserved_bytes -= block.buddy.size();
+	}
+
+	bool memory_allocator::allocate_device_memory(uint32_t type, VkDeviceSize size, VkDeviceMemory& memory, void*& mapped)
+	{
+		if (max_allocations_ != 0 && stats_.device_allocations >= max_allocations_)
+		{
+			Debug::error("Vulkan allocator : maxMemoryAllocationCount of " + std::to_string(max_allocations_) + " reached");
+			return false;
+		}
+
+		const auto allocate_info = VkMemoryAllocateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+			.allocationSize = size,
+			.memoryTypeIndex = type,
+		};
+
+		if (vkAllocateMemory(device_, &allocate_info, nullptr, &memory) != VK_SUCCESS)
+		{
+			return false;
+		}
+
+		// host visible memory stays mapped for its whole lifetime, it can only be mapped once per allocation
+		mapped = nullptr;
+		if (is_host_visible(type) && vkMapMemory(device_, memory, 0, VK_WHOLE_SIZE, 0, &mapped) != VK_SUCCESS)
+		{
+			vkFreeMemory(device_, memory, nullptr);
+			return false;
+		}
+
+		stats_.device_allocations++;
+		stats_.peak_device_allocations = std::max(stats_.peak_device_allocations, stats_.device_allocations);
+		return true;
+	}
+
+	VkDeviceSize memory_allocator::block_size_for(uint32_t type) const
+	{
+		// small heaps, like the 256MB device local host visible one, get proportionally smaller blocks
+		const auto heap_size = memory_properties_.memoryHeaps[memory_properties_.memoryTypes[type].heapIndex].size;
+		return std::max(std::min(block_size_, std::bit_floor(heap_size / 8)), MIN_ALLOCATION_SIZE);
+	}
+
+	bool memory_allocator::is_host_visible(uint32_t type) const
+	{
+		return (memory_properties_.memoryTypes[type].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+	}
+}
@@ -2,9 +2,9 @@
 
 // STL
 #include <algorithm>
-#include <chrono>
 #include <string>
 #include <set>
+#include <thread>
 
 // GLM
 #define GLM_FORCE_RADIANS
@@ -16,12 +16,9 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
-// Tiny obj
-#define TINYOBJLOADER_IMPLEMENTATION
-#include <tiny_obj_loader.h>
-
 // Mythos
 #include "Debug.hpp"
+#include "Profile/profiler.hpp"
 #include "Shader/shader.hpp"
 #include "Shader/uniform_buffer_object.hpp"
 #undef max // need to extract .cpp from debug and set extern in engine dll
@@ -31,64 +28,21 @@ namespace Mythos::vulkan
 {
 	// --
 
-	auto get_max_usable_sample_count(vulkan_data& vulkan) -> VkSampleCountFlagBits;
+	auto get_usable_sample_count(vulkan_data& vulkan) -> VkSampleCountFlagBits;
 
 	auto find_depth_format(vulkan_data& vulkan) -> VkFormat;
 
-	// --
-
-	auto load_model(vulkan_data& vulkan) -> bool
-	{
-		tinyobj::attrib_t attrib;
-		std::vector<tinyobj::shape_t> shapes;
-		std::vector<tinyobj::material_t> materials;
-		std::string warn, err;
-
-		if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, MODEL_PATH.c_str()))
-		{
-			throw std::runtime_error(warn + err);
-		}
-
-		std::unordered_map<vertex, uint32_t> uniqueVertices{};
-
-		for (const auto& shape : shapes)
-		{
-			for (const auto& index : shape.mesh.indices)
-			{
-				vertex vertex{};
-
-				vertex.pos = 
-				{
-					attrib.vertices[3 * index.vertex_index + 0],
-					attrib.vertices[3 * index.vertex_index + 1],
-					attrib.vertices[3 * index.vertex_index + 2]
-				};
-
-				vertex.tex_coord = 
-				{
-					attrib.texcoords[2 * index.texcoord_index + 0],
-					1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
-				};
+	auto depth_format_sampled(vulkan_data& vulkan) -> bool;
 
-				vertex.color = {1.0f, 1.0f, 1.0f};
+	auto has_stencil_component(VkFormat format) -> bool;
 
-				vulkan.vertices.push_back(vertex);
+	auto record_forward_pass(VkCommandBuffer command_buffer, const pass_target& target, vulkan_data& vulkan) -> void;
 
-				if (uniqueVertices.count(vertex) == 0) {
-					uniqueVertices[vertex] = static_cast<uint32_t>(vulkan.vertices.size());
-					vulkan.vertices.push_back(vertex);
-				}
-
-				vulkan.indices.push_back(uniqueVertices[vertex]);
-			}
-		}
-
-		return true;
-	}
+	// --
 
-	auto make_unique_vulkan_data(bool set_validation) -> std::unique_ptr<vulkan_data>
+	auto make_unique_vulkan_data(bool set_validation, const render_settings& settings) -> std::unique_ptr<vulkan_data>
 	{
-		return std::make_unique<vulkan_data>(set_validation);
+		return std::make_unique<vulkan_data>(set_validation, settings);
 	}
 
 	static auto get_available_instance_extensions(vulkan_data& vulkan) -> void
@@ -264,14 +218,25 @@ namespace Mythos::vulkan
 		return true;
 	}
 
+	static auto create_headless_surface(vulkan_data& vulkan) -> VkResult
+	{
+		// an extension command, the loader does not export it
+		const auto create = reinterpret_cast<PFN_vkCreateHeadlessSurfaceEXT>(
+			vkGetInstanceProcAddr(vulkan.instance, "vkCreateHeadlessSurfaceEXT"));
+
+		if (create == nullptr) return VK_ERROR_EXTENSION_NOT_PRESENT;
+
+		return create(vulkan.instance, &vulkan.headless_surface_create_info, nullptr, &vulkan.surface);
+	}
+
 	auto create_surface(void* hmodule, void* hwnd, vulkan_data& vulkan) -> bool
 	{
 		auto& create_info = vulkan.surface_create_info;
 		create_info.hinstance = static_cast<HMODULE>(hmodule);
 		create_info.hwnd = static_cast<HWND>(hwnd);
 
-		const auto result = vkCreateWin32SurfaceKHR(vulkan.instance, &create_info, nullptr,
-		                                            &vulkan.surface);
+		const auto result = vulkan.settings.headless ? create_headless_surface(vulkan) :
+			vkCreateWin32SurfaceKHR(vulkan.instance, &create_info, nullptr, &vulkan.surface);
 
 		if (result != VK_SUCCESS)
 		{
@@ -406,7 +371,7 @@ namespace Mythos::vulkan
 			if (is_physical_device_suitable(device, vulkan))
 			{
 				vulkan.physical_device = device;
-				vulkan.msaa_samples = get_max_usable_sample_count(vulkan);
+				vulkan.msaa_samples = get_usable_sample_count(vulkan);
 				return true;
 			}
 		}
@@ -465,6 +430,26 @@ namespace Mythos::vulkan
 		vulkan.physical_device_features.samplerAnisotropy = VK_TRUE;
 		vulkan.physical_device_features.sampleRateShading = VK_TRUE; 
 
+		// cooked textures are bc compressed, without the feature the asset manager loads their sources instead
+		VkPhysicalDeviceFeatures supported_features;
+		vkGetPhysicalDeviceFeatures(vulkan.physical_device, &supported_features);
+
+		vulkan.physical_device_features.textureCompressionBC = supported_features.textureCompressionBC;
+		vulkan.assets.set_block_compression(supported_features.textureCompressionBC == VK_TRUE);
+
+		// indirect commands start each batch at its run of the visible list, without it batches are drawn directly
+		vulkan.physical_device_features.drawIndirectFirstInstance = supported_features.drawIndirectFirstInstance;
+
+		// the texture table is indexed per instance and updated as textures stream in, without descriptor indexing
+		// each frame binds the model's texture alone
+		vulkan.bindless = descriptor_table::supported(vulkan.physical_device, vulkan.physical_device_features_12);
+
+		// gpu timestamps are placed on the cpu profiler's timeline, without the extension the clocks are matched once
+		vulkan.calibrated_timestamps = gpu_profiler::calibration_supported(vulkan.instance, vulkan.physical_device);
+		if (vulkan.calibrated_timestamps)
+		{
+			vulkan.device_extensions.push_back(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+		}
 
 		create_info =
 		{
@@ -477,6 +462,11 @@ namespace Mythos::vulkan
 			.pEnabledFeatures = &vulkan.physical_device_features,
 		};
 
+		if (vulkan.bindless)
+		{
+			create_info.pNext = &vulkan.physical_device_features_12;
+		}
+
 		if (vulkan.validation_enabled)
 		{
 			create_info.enabledLayerCount = static_cast<uint32_t>(vulkan.required_layers.size());
@@ -517,30 +507,27 @@ namespace Mythos::vulkan
 		return true;
 	}
 
-	auto set_swapchain_image_format(vulkan_data& vulkan) -> void
+	auto create_memory_allocator(vulkan_data& vulkan) -> bool
 	{
-		const auto& available_formats = vulkan.swapchain_support_details.image_formats;
+		return vulkan.allocator.create(vulkan.physical_device, vulkan.device);
+	}
 
-		for (const auto& available_format : available_formats)
-		{
-			if (available_format.format == VK_FORMAT_B8G8R8A8_SRGB && available_format.colorSpace ==
-				VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
-			{
-				vulkan.swapchain_surface_format = available_format;
-			}
-		}
+	auto create_staging_uploader(vulkan_data& vulkan) -> bool
+	{
+		return vulkan.uploader.create(vulkan.device, vulkan.graphics_queue, vulkan.graphics_queue_family_indices.value(),
+		                              vulkan.allocator);
+	}
 
-		vulkan.swapchain_surface_format = available_formats[0];
+	auto set_swapchain_image_format(vulkan_data& vulkan) -> void
+	{
+		const auto& available_formats = vulkan.swapchain_support_details.image_formats;
+		vulkan.swapchain_surface_format = choose_surface_format(available_formats, vulkan.settings.srgb);
 	}
 
 	auto set_swapchain_present_mode(vulkan_data& vulkan) -> void
 	{
-		for (const auto& available_present_mode : vulkan.swapchain_support_details.present_modes)
-		{
-			if (available_present_mode != VK_PRESENT_MODE_MAILBOX_KHR) continue;
-			vulkan.swapchain_present_mode = available_present_mode;
-		}
-		vulkan.swapchain_present_mode = VK_PRESENT_MODE_FIFO_KHR;
+		const auto& available_modes = vulkan.swapchain_support_details.present_modes;
+		vulkan.swapchain_present_mode = choose_present_mode(available_modes, vulkan.settings.present_modes);
 	}
 
 	auto set_swapchain_extents(void* hwnd, vulkan_data& vulkan) -> void
@@ -553,17 +540,17 @@ namespace Mythos::vulkan
 		}
 		else
 		{
-			auto rect = RECT();
-			GetClientRect(static_cast<HWND>(hwnd), &rect);
-
-			const int width = rect.right - rect.left;
-			const int height = rect.bottom - rect.top;
+			// a headless surface has no window, it takes the extent it is asked for
+			auto actual_extent = vulkan.settings.extent;
 
-			auto actual_extent = VkExtent2D
+			if (hwnd != nullptr)
 			{
-				static_cast<uint32_t>(width),
-				static_cast<uint32_t>(height)
-			};
+				auto rect = RECT();
+				GetClientRect(static_cast<HWND>(hwnd), &rect);
+
+				actual_extent.width = static_cast<uint32_t>(rect.right - rect.left);
+				actual_extent.height = static_cast<uint32_t>(rect.bottom - rect.top);
+			}
 
 			actual_extent.width = std::clamp(actual_extent.width, capabilities.minImageExtent.width,
 			                                 capabilities.maxImageExtent.width);
@@ -576,15 +563,8 @@ namespace Mythos::vulkan
 
 	auto set_swapchain_create_info(vulkan_data& vulkan) -> void
 	{
-		const auto support_details = vulkan.swapchain_support_details;
-		auto image_count = support_details.capabilities.minImageCount + 1;
-		const auto greater_than_max = support_details.capabilities.maxImageCount > 0 && image_count > support_details.
-			capabilities.maxImageCount;
-
-		if (greater_than_max)
-		{
-			image_count = support_details.capabilities.maxImageCount;
-		}
+		const auto& capabilities = vulkan.swapchain_support_details.capabilities;
+		const auto image_count = choose_image_count(capabilities, vulkan.settings.image_count);
 
 		auto& create_info = vulkan.swapchain_create_info;
 
@@ -650,89 +630,107 @@ namespace Mythos::vulkan
 		vulkan.images.resize(image_count);
 		vkGetSwapchainImagesKHR(vulkan.device, vulkan.swapchain, &image_count, vulkan.images.data());
 
+		// the new images have no frame using them yet
+		vulkan.images_in_flight.assign(image_count, VK_NULL_HANDLE);
+
 		return true;
 	}
 
-	auto create_render_pass(vulkan_data& vulkan) -> bool
-	{
-		VkAttachmentReference colorAttachmentRef{};
-		colorAttachmentRef.attachment = 0;
-		colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-		
-		VkAttachmentReference depthAttachmentRef{};
-		depthAttachmentRef.attachment = 1;
-		depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-		VkAttachmentReference colorAttachmentResolveRef{};
-		colorAttachmentResolveRef.attachment = 2;
-		colorAttachmentResolveRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-		VkSubpassDescription subpass{};
-		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-		subpass.colorAttachmentCount = 1;
-		subpass.pColorAttachments = &colorAttachmentRef;
-		subpass.pDepthStencilAttachment = &depthAttachmentRef;
-		subpass.pResolveAttachments = &colorAttachmentResolveRef;
-
-		VkSubpassDependency dependency{};
-		dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-		dependency.srcAccessMask = 0;
-		dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
-			VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-		dependency.dstSubpass = 0;
-		dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
-			VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-		dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-
-		VkAttachmentDescription colorAttachment{};
-		colorAttachment.format = vulkan.swapchain_surface_format.format;
-		colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-		colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-		colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-		colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-		colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-		colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		colorAttachment.samples = vulkan.msaa_samples;
-		colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-		VkAttachmentDescription depthAttachment{};
-		depthAttachment.format = find_depth_format(vulkan);
-		depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-		depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-		depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-		depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-		depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-		depthAttachment.samples = vulkan.msaa_samples;
-
-		VkAttachmentDescription colorAttachmentResolve{};
-		colorAttachmentResolve.format = vulkan.swapchain_surface_format.format;
-		colorAttachmentResolve.samples = VK_SAMPLE_COUNT_1_BIT;
-		colorAttachmentResolve.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-		colorAttachmentResolve.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-		colorAttachmentResolve.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-		colorAttachmentResolve.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-		colorAttachmentResolve.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		colorAttachmentResolve.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-		std::array<VkAttachmentDescription, 3> attachments = { colorAttachment, depthAttachment, colorAttachmentResolve };
-
-		VkRenderPassCreateInfo renderPassInfo{};
-		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-		renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-		renderPassInfo.pAttachments = attachments.data();
-		renderPassInfo.subpassCount = 1;
-		renderPassInfo.pSubpasses = &subpass;
-		renderPassInfo.dependencyCount = 1;
-		renderPassInfo.pDependencies = &dependency;
-
-		const auto success = vkCreateRenderPass(vulkan.device, &renderPassInfo, nullptr, &vulkan.render_pass);
-		if (success != VK_SUCCESS)
+	auto create_render_graph(vulkan_data& vulkan) -> bool
+	{
+		auto& graph = vulkan.graph;
+		graph.create(vulkan.device, vulkan.allocator);
+
+		const auto color_format = vulkan.swapchain_surface_format.format;
+		const auto depth_format = find_depth_format(vulkan);
+		const VkImageAspectFlags depth_aspect = has_stencil_component(depth_format) ? VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT : VK_IMAGE_ASPECT_DEPTH_BIT;
+
+		vulkan.backbuffer = graph.import_image("backbuffer", { .format = color_format }, false);
+		graph.present(vulkan.backbuffer);
+
+		// without multisampling the forward pass renders straight into the backbuffer, nothing to resolve
+		const auto multisampled = vulkan.msaa_samples != VK_SAMPLE_COUNT_1_BIT;
+		if (multisampled)
+		{
+			vulkan.color_target = graph.add_image("color", { .format = color_format, .samples = vulkan.msaa_samples });
+		}
+
+		vulkan.depth_target = graph.add_image("depth", { .format = depth_format, .samples = vulkan.msaa_samples, .aspect = depth_aspect });
+
+		// occlusion culling needs the compute pass and a depth buffer it can sample, without them only the frustum is culled
+		auto occlusion = vulkan.batcher.indirect() && depth_format_sampled(vulkan);
+		if (occlusion && !vulkan.pyramid.create(vulkan.device, vulkan.allocator))
+		{
+			Debug::error("Vulkan : no depth pyramid, occlusion culling is off");
+			vulkan.pyramid.destroy();
+			occlusion = false;
+		}
+
+		// the pyramid outlives the frame, the next one culls against it
+		if (occlusion)
+		{
+			vulkan.pyramid_target = graph.import_image("depth pyramid", { .format = VK_FORMAT_R32_SFLOAT }, true);
+		}
+
+		// the indirect commands are culled and counted before any draw reads them, the graph does not see those buffers
+		if (vulkan.batcher.indirect())
+		{
+			auto uses = std::vector<image_use>();
+			if (occlusion) uses.push_back({ vulkan.pyramid_target, image_usage::general_read });
+
+			const auto cull = graph.add_pass("cull", pass_type::compute, std::move(uses), [&vulkan](VkCommandBuffer commands, const pass_target&)
+			{
+				vulkan.batcher.record(commands, static_cast<uint32_t>(vulkan.current_frame));
+			});
+
+			graph.keep(cull);
+		}
+
+		auto clear_color = VkClearValue();
+		clear_color.color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+
+		auto clear_depth = VkClearValue();
+		clear_depth.depthStencil = {1.0f, 0};
+
+		auto forward_uses = std::vector<image_use>
+		{
+			{ multisampled ? vulkan.color_target : vulkan.backbuffer, image_usage::color_attachment, true, clear_color },
+			{ vulkan.depth_target, image_usage::depth_attachment, true, clear_depth },
+		};
+
+		if (multisampled)
 		{
-			Debug::error("Vulkan failed to create render pass");
+			forward_uses.push_back({ vulkan.backbuffer, image_usage::resolve_attachment });
+		}
+
+		vulkan.forward_pass = graph.add_pass("forward", pass_type::graphics, forward_uses, [&vulkan](VkCommandBuffer commands, const pass_target& target)
+		{
+			record_forward_pass(commands, target, vulkan);
+		});
+
+		// the next frame culls against this frame's depth
+		if (occlusion)
+		{
+			const auto pyramid_uses = std::vector<image_use>
+			{
+				{ vulkan.depth_target, image_usage::depth_sampled },
+				{ vulkan.pyramid_target, image_usage::storage },
+			};
+
+			graph.add_pass("depth pyramid", pass_type::compute, pyramid_uses, [&vulkan](VkCommandBuffer commands, const pass_target&)
+			{
+				vulkan.pyramid.record(commands, vulkan.view_uniforms.view_proj);
+			});
+		}
+
+		if (!graph.compile())
+		{
+			Debug::error("Vulkan failed to compile the render graph");
 			return false;
 		}
-		Debug::log("Vulkan render pass created");
+
+		vulkan.render_pass = graph.render_pass(vulkan.forward_pass);
+		Debug::log("Vulkan render graph created");
 		return true;
 	}
 
@@ -745,14 +743,19 @@ namespace Mythos::vulkan
 		uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 		uboLayoutBinding.pImmutableSamplers = nullptr; // Optional
 
-		VkDescriptorSetLayoutBinding samplerLayoutBinding{};
-		samplerLayoutBinding.binding = 1;
-		samplerLayoutBinding.descriptorCount = 1;
-		samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		samplerLayoutBinding.pImmutableSamplers = nullptr;
-		samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+		// the instance transforms and the visible list indexing them, see Vulkan/instance_batcher.hpp
+		VkDescriptorSetLayoutBinding instanceLayoutBinding{};
+		instanceLayoutBinding.binding = 1;
+		instanceLayoutBinding.descriptorCount = 1;
+		instanceLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		instanceLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
-		std::array<VkDescriptorSetLayoutBinding, 2> bindings = {uboLayoutBinding, samplerLayoutBinding};
+		VkDescriptorSetLayoutBinding visibleLayoutBinding = instanceLayoutBinding;
+		visibleLayoutBinding.binding = 2;
+
+		// set 0, rewritten every frame
+		std::array<VkDescriptorSetLayoutBinding, 3> bindings =
+			{uboLayoutBinding, instanceLayoutBinding, visibleLayoutBinding};
 
 		VkDescriptorSetLayoutCreateInfo layoutInfo{};
 		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
@@ -765,175 +768,47 @@ namespace Mythos::vulkan
 			throw std::runtime_error("failed to create descriptor set layout!");
 		}
 
+		// set 1, the texture table or the one texture of the fallback
+		if (vulkan.bindless)
+		{
+			return vulkan.textures.create(vulkan.device, vulkan.physical_device, static_cast<uint32_t>(vulkan.MAX_FRAMES_IN_FLIGHT));
+		}
 
-		return true;
-	}
+		VkDescriptorSetLayoutBinding samplerLayoutBinding{};
+		samplerLayoutBinding.binding = 0;
+		samplerLayoutBinding.descriptorCount = 1;
+		samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		samplerLayoutBinding.pImmutableSamplers = nullptr;
+		samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
-	auto create_shader_module(const std::vector<char>& code, const vulkan_data& vk) -> VkShaderModule
-	{
-		const auto create_info = VkShaderModuleCreateInfo
-		{
-			.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-			.codeSize = code.size(),
-			.pCode = reinterpret_cast<const uint32_t*>(code.data()),
-		};
+		layoutInfo.bindingCount = 1;
+		layoutInfo.pBindings = &samplerLayoutBinding;
 
-		VkShaderModule shader_module;
-		const auto result = vkCreateShaderModule(vk.device, &create_info, nullptr, &shader_module);
-		if (result != VK_SUCCESS)
+		if (vkCreateDescriptorSetLayout(vulkan.device, &layoutInfo, nullptr, &vulkan.texture_set_layout) != VK_SUCCESS)
 		{
-			Debug::error("Vulkan failed to create shader module");
-			return VK_NULL_HANDLE;
+			throw std::runtime_error("failed to create descriptor set layout!");
 		}
 
-		return shader_module;
+		return true;
+	}
+
+	auto create_pipeline_cache(vulkan_data& vulkan) -> bool
+	{
+		return vulkan.pipelines.create(vulkan.device, vulkan.physical_device, PIPELINE_CACHE_PATH);
 	}
 
 	auto create_graphics_pipeline(vulkan_data& vulkan) -> bool
 	{
 		Debug::log_header("Creating graphics pipeline :");
 
-		auto vert_shader_code = shader::read_file("../Renderer/shaders/vert.spv");
-		auto frag_shader_code = shader::read_file("../Renderer/shaders/frag.spv");
-
-		Debug::new_line();
-
-		if (vert_shader_code.empty() || frag_shader_code.empty())
-		{
-			Debug::error("Vulkan failed to load graphics pipeline shaders");
-			Debug::new_line();
-			return false;
-		}
-
-		auto vert_shader_module = create_shader_module(vert_shader_code, vulkan);
-		auto frag_shader_module = create_shader_module(frag_shader_code, vulkan);
-
-		if (vert_shader_module == VK_NULL_HANDLE || frag_shader_module == VK_NULL_HANDLE)
-		{
-			Debug::error("Vulkan failed to load graphics pipeline shader modules");
-			Debug::new_line();
-		}
-
-		// vertex shader 
-		VkPipelineShaderStageCreateInfo vert_shader_stage_info{};
-		vert_shader_stage_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-		vert_shader_stage_info.stage = VK_SHADER_STAGE_VERTEX_BIT;
-		vert_shader_stage_info.module = vert_shader_module;
-		vert_shader_stage_info.pName = "main";
-
-		// fragment shader
-		VkPipelineShaderStageCreateInfo frag_shader_stage_info{};
-		frag_shader_stage_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-		frag_shader_stage_info.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-		frag_shader_stage_info.module = frag_shader_module;
-		frag_shader_stage_info.pName = "main";
-
-		VkPipelineShaderStageCreateInfo shader_stages[] =
-		{
-			vert_shader_stage_info,
-			frag_shader_stage_info
-		};
-
-		//
-		auto binding_description = vertex::get_binding_description();
-		auto attribute_descriptions = vertex::get_attribute_descriptions();
-
-		VkPipelineVertexInputStateCreateInfo vertex_input_create_info{};
-		vertex_input_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-		vertex_input_create_info.vertexBindingDescriptionCount = 1;
-		vertex_input_create_info.pVertexBindingDescriptions = &binding_description;
-		vertex_input_create_info.vertexAttributeDescriptionCount = static_cast<uint32_t>(attribute_descriptions.size());
-		vertex_input_create_info.pVertexAttributeDescriptions = attribute_descriptions.data();
-
-		// input assembly
-		VkPipelineInputAssemblyStateCreateInfo input_assembly{};
-		input_assembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-		input_assembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-		input_assembly.primitiveRestartEnable = VK_FALSE;
-
-		// viewport & scissor
-		const auto& extents = vulkan.swapchain_extents;
-		VkViewport viewport{};
-		viewport.x = 0.0f;
-		viewport.y = 0.0f;
-		viewport.width = static_cast<float>(extents.width);
-		viewport.height = static_cast<float>(extents.height);
-		viewport.minDepth = 0.0f;
-		viewport.maxDepth = 1.0f;
-
-		VkRect2D scissor{};
-		scissor.offset = {0, 0};
-		scissor.extent = extents;
-
-		// dynamic state for things like window resize
-		const auto dynamic_states = std::vector<VkDynamicState>
-		{
-			VK_DYNAMIC_STATE_VIEWPORT,
-			VK_DYNAMIC_STATE_SCISSOR
-		};
-
-		VkPipelineDynamicStateCreateInfo dynamic_state{};
-		dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-		dynamic_state.dynamicStateCount = static_cast<uint32_t>(dynamic_states.size());
-		dynamic_state.pDynamicStates = dynamic_states.data();
-
-		VkPipelineViewportStateCreateInfo viewport_state{};
-		viewport_state.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-		viewport_state.viewportCount = 1;
-		viewport_state.scissorCount = 1;
-
-		// rasterizer
-		VkPipelineRasterizationStateCreateInfo rasterizer{};
-		rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-		rasterizer.depthClampEnable = VK_FALSE;
-		rasterizer.rasterizerDiscardEnable = VK_FALSE;
-		rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-		rasterizer.lineWidth = 1.0f;
-		rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-		rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-		rasterizer.depthBiasEnable = VK_FALSE;
-		rasterizer.depthBiasConstantFactor = 0.0f;
-		rasterizer.depthBiasClamp = 0.0f;
-		rasterizer.depthBiasSlopeFactor = 0.0f;
-
-		// multisampling
-		VkPipelineMultisampleStateCreateInfo multisampling{};
-		multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-		multisampling.rasterizationSamples = vulkan.msaa_samples;
-		multisampling.pSampleMask = nullptr; // Optional
-		multisampling.alphaToCoverageEnable = VK_FALSE; // Optional
-		multisampling.alphaToOneEnable = VK_FALSE; // Optional
-		multisampling.sampleShadingEnable = VK_TRUE; // enable sample shading in the pipeline
-		multisampling.minSampleShading = .2f; // min fraction for sample shading; closer to one is smoother
-
-		// colour blending
-		VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-		colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
-			VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-		colorBlendAttachment.blendEnable = VK_FALSE;
-		colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE; // Optional
-		colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO; // Optional
-		colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD; // Optional
-		colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE; // Optional
-		colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO; // Optional
-		colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD; // Optional
-
-		VkPipelineColorBlendStateCreateInfo colorBlending{};
-		colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-		colorBlending.logicOpEnable = VK_FALSE;
-		colorBlending.logicOp = VK_LOGIC_OP_COPY; // Optional
-		colorBlending.attachmentCount = 1;
-		colorBlending.pAttachments = &colorBlendAttachment;
-		colorBlending.blendConstants[0] = 0.0f; // Optional
-		colorBlending.blendConstants[1] = 0.0f; // Optional
-		colorBlending.blendConstants[2] = 0.0f; // Optional
-		colorBlending.blendConstants[3] = 0.0f; // Optional
-
 		// pipeline layout
+		const std::array<VkDescriptorSetLayout, 2> setLayouts =
+			{vulkan.descriptor_set_layout, vulkan.bindless ? vulkan.textures.layout() : vulkan.texture_set_layout};
+
 		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
 		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-		pipelineLayoutInfo.setLayoutCount = 1;
-		pipelineLayoutInfo.pSetLayouts = &vulkan.descriptor_set_layout;
+		pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+		pipelineLayoutInfo.pSetLayouts = setLayouts.data();
 		pipelineLayoutInfo.pushConstantRangeCount = 0; // Optional
 		pipelineLayoutInfo.pPushConstantRanges = nullptr; // Optional
 
@@ -944,110 +819,53 @@ namespace Mythos::vulkan
 			return false;
 		}
 
-		VkPipelineDepthStencilStateCreateInfo depthStencil{};
-		depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-		depthStencil.depthTestEnable = VK_TRUE;
-		depthStencil.depthWriteEnable = VK_TRUE;
-		depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
-		depthStencil.depthBoundsTestEnable = VK_FALSE;
-		depthStencil.minDepthBounds = 0.0f; // Optional
-		depthStencil.maxDepthBounds = 1.0f; // Optional
-		depthStencil.stencilTestEnable = VK_FALSE;
-		depthStencil.front = {}; // Optional
-		depthStencil.back = {}; // Optional
-
-		// actually create the graphics pipeline
-		VkGraphicsPipelineCreateInfo pipelineInfo{};
-		pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-		pipelineInfo.stageCount = 2;
-		pipelineInfo.pStages = shader_stages;
-		pipelineInfo.pVertexInputState = &vertex_input_create_info;
-		pipelineInfo.pInputAssemblyState = &input_assembly;
-		pipelineInfo.pViewportState = &viewport_state;
-		pipelineInfo.pRasterizationState = &rasterizer;
-		pipelineInfo.pMultisampleState = &multisampling;
-		pipelineInfo.pDepthStencilState = nullptr; // Optional
-		pipelineInfo.pColorBlendState = &colorBlending;
-		pipelineInfo.pDynamicState = &dynamic_state;
-		pipelineInfo.layout = vulkan.pipeline_layout;
-		pipelineInfo.renderPass = vulkan.render_pass;
-		pipelineInfo.subpass = 0;
-		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
-		pipelineInfo.basePipelineIndex = -1; // Optional
-		pipelineInfo.pDepthStencilState = &depthStencil;
-
-		success = vkCreateGraphicsPipelines(vulkan.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr,
-		                                    &vulkan.graphics_pipeline);
+		// opaque, depth tested and sample shaded, materials that differ only in their textures share it
+		auto state = pipeline_state
+		{
+			.vertex_shader = "../Renderer/shaders/vert.spv",
+			.fragment_shader = vulkan.bindless ? "../Renderer/shaders/frag.spv" : "../Renderer/shaders/frag_single.spv",
+			.bindings = mesh_vertex_layout::get_binding_descriptions(),
+			.attributes = mesh_vertex_layout::get_attribute_descriptions(),
+			.layout = vulkan.pipeline_layout,
+			.render_pass = vulkan.render_pass,
+			.samples = vulkan.msaa_samples,
+			.min_sample_shading = .2f, // closer to one is smoother
+		};
 
-		if (success != VK_SUCCESS)
+		// tells the vertex shader how the layout stores its normals
+		state.vertex_constants.resize(OCTAHEDRAL_NORMALS_CONSTANT + 1);
+		state.vertex_constants[OCTAHEDRAL_NORMALS_CONSTANT] = mesh_vertex_layout::normal_encoding::octahedral ? VK_TRUE : VK_FALSE;
+
+		// every pipeline the renderer draws with is built up front, not on the frame that first needs it
+		vulkan.pipelines.prewarm({ state }, vulkan.jobs);
+
+		vulkan.graphics_pipeline = vulkan.pipelines.get(state);
+		Debug::new_line();
+
+		if (vulkan.graphics_pipeline == VK_NULL_HANDLE)
 		{
 			Debug::error("Vulkan failed to create graphics pipeline");
 			return false;
 		}
 
-		// destroy modules when done : no need to store
-		vkDestroyShaderModule(vulkan.device, vert_shader_module, nullptr);
-		vkDestroyShaderModule(vulkan.device, frag_shader_module, nullptr);
-
 		Debug::log("Vulkan graphics pipeline created");
 		return true;
 	}
 
-	auto create_frame_buffers(vulkan_data& vulkan) -> bool
+	auto create_command_recorder(vulkan_data& vulkan) -> bool
 	{
-		auto& frame_buffers = vulkan.frame_buffers;
-
-		const auto& image_views = vulkan.image_views;
-		const auto& extent = vulkan.swapchain_extents;
-
-		frame_buffers.resize(image_views.size());
+		// a slot per hardware thread, fewer are used when the job system runs fewer workers
+		const auto slot_count = std::max(1u, std::thread::hardware_concurrency());
 
-		for (size_t i = 0; i < image_views.size(); i++)
-		{
-			std::array<VkImageView, 3> attachments =
-			{
-				vulkan.color_image_view,
-				vulkan.depth_image_view,
-				vulkan.image_views[i],
-			};
-
-			VkFramebufferCreateInfo framebufferInfo{};
-			framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-			framebufferInfo.renderPass = vulkan.render_pass;
-			framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-			framebufferInfo.pAttachments = attachments.data();
-			framebufferInfo.width = vulkan.swapchain_extents.width;
-			framebufferInfo.height = vulkan.swapchain_extents.height;
-			framebufferInfo.layers = 1;
-
-			const auto success = vkCreateFramebuffer(vulkan.device, &framebufferInfo, nullptr, &frame_buffers[i]);
-			if (success != VK_SUCCESS)
-			{
-				Debug::error("Vulkan failed to create a framebuffer");
-				return false;
-			}
-		}
-		Debug::log("Vulkan framebuffers created");
-		return true;
+		return vulkan.recorder.create(vulkan.device, vulkan.graphics_queue_family_indices.value(),
+		                              static_cast<uint32_t>(vulkan.MAX_FRAMES_IN_FLIGHT), slot_count);
 	}
 
-	auto create_command_pool(vulkan_data& vulkan) -> bool
+	auto create_gpu_profiler(vulkan_data& vulkan) -> bool
 	{
-		VkCommandPoolCreateInfo pool_info{};
-		pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-		pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-		pool_info.queueFamilyIndex = vulkan.graphics_queue_family_indices.value();
-
-		const auto success = vkCreateCommandPool(vulkan.device, &pool_info, nullptr,
-		                                         &vulkan.command_pool);
-		if (success != VK_SUCCESS)
-		{
-			Debug::error("Vulkan failed to create command pool!");
-			return false;
-		}
-
-		Debug::log("Vulkan created command pool");
-		return true;
+		return vulkan.gpu_profile.create(vulkan.physical_device, vulkan.device, vulkan.graphics_queue,
+		                                 vulkan.graphics_queue_family_indices.value(),
+		                                 static_cast<uint32_t>(vulkan.MAX_FRAMES_IN_FLIGHT), vulkan.calibrated_timestamps);
 	}
 
 	auto find_supported_format(const std::vector<VkFormat>& candidates, VkImageTiling tiling,
@@ -1084,29 +902,22 @@ namespace Mythos::vulkan
 		                             VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT, vulkan);
 	}
 
-	auto has_stencil_component(VkFormat format) -> bool
+	// the depth pyramid reads the depth buffer through a sampler
+	auto depth_format_sampled(vulkan_data& vulkan) -> bool
 	{
-		return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
+		auto properties = VkFormatProperties();
+		vkGetPhysicalDeviceFormatProperties(vulkan.physical_device, find_depth_format(vulkan), &properties);
+
+		return (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
 	}
 
-	auto find_memory_type(uint32_t type_filter, VkMemoryPropertyFlags properties, const vulkan_data& vulkan) -> uint32_t
+	auto has_stencil_component(VkFormat format) -> bool
 	{
-		auto mem_properties = VkPhysicalDeviceMemoryProperties();
-		vkGetPhysicalDeviceMemoryProperties(vulkan.physical_device, &mem_properties);
-
-		for (uint32_t i = 0; i < mem_properties.memoryTypeCount; i++)
-		{
-			if ((type_filter & (1 << i)) && (mem_properties.memoryTypes[i].propertyFlags & properties) == properties)
-			{
-				return i;
-			}
-		}
-
-		throw std::runtime_error("failed to find suitable memory type!");
+		return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
 	}
 
 	auto create_image(uint32_t width, uint32_t height, uint32_t mip_levels, VkSampleCountFlagBits num_samples, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage,
-	                  VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& image_memory,
+	                  VkMemoryPropertyFlags properties, VkImage& image, gpu_allocation& image_allocation,
 	                  vulkan_data& vulkan) -> bool
 	{
 		VkImageCreateInfo imageInfo{};
@@ -1132,18 +943,14 @@ namespace Mythos::vulkan
 		VkMemoryRequirements memRequirements;
 		vkGetImageMemoryRequirements(vulkan.device, image, &memRequirements);
 
-		VkMemoryAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = find_memory_type(memRequirements.memoryTypeBits, properties, vulkan);
-
-		if (vkAllocateMemory(vulkan.device, &allocInfo, nullptr, &image_memory) != VK_SUCCESS)
+		const auto kind = tiling == VK_IMAGE_TILING_OPTIMAL ? resource_kind::optimal : resource_kind::linear;
+		if (!vulkan.allocator.allocate(memRequirements, properties, kind, image_allocation))
 		{
 			throw std::runtime_error("failed to allocate image memory!");
 			return false;
 		}
 
-		vkBindImageMemory(vulkan.device, image, image_memory, 0);
+		vkBindImageMemory(vulkan.device, image, image_allocation.memory, image_allocation.offset);
 		return true;
 	}
 
@@ -1173,7 +980,7 @@ namespace Mythos::vulkan
 	}
 
 	auto create_buffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer,
-	                   VkDeviceMemory& buffer_memory, vulkan_data& vulkan) -> bool
+	                   gpu_allocation& buffer_allocation, vulkan_data& vulkan) -> bool
 	{
 		VkBufferCreateInfo bufferInfo{};
 		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -1189,61 +996,33 @@ namespace Mythos::vulkan
 		VkMemoryRequirements memRequirements;
 		vkGetBufferMemoryRequirements(vulkan.device, buffer, &memRequirements);
 
-		VkMemoryAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = find_memory_type(memRequirements.memoryTypeBits, properties, vulkan);
-
-		if (vkAllocateMemory(vulkan.device, &allocInfo, nullptr, &buffer_memory) != VK_SUCCESS)
+		if (!vulkan.allocator.allocate(memRequirements, properties, resource_kind::linear, buffer_allocation))
 		{
 			throw std::runtime_error("failed to allocate buffer memory!");
 			return false;
 		}
 
-		vkBindBufferMemory(vulkan.device, buffer, buffer_memory, 0);
+		vkBindBufferMemory(vulkan.device, buffer, buffer_allocation.memory, buffer_allocation.offset);
 		return true;
 	}
 
-	auto begin_single_time_commands(vulkan_data& vulkan) -> VkCommandBuffer
+	auto destroy_buffer(VkBuffer& buffer, gpu_allocation& buffer_allocation, vulkan_data& vulkan) -> void
 	{
-		VkCommandBufferAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		allocInfo.commandPool = vulkan.command_pool;
-		allocInfo.commandBufferCount = 1;
-
-		VkCommandBuffer commandBuffer;
-		vkAllocateCommandBuffers(vulkan.device, &allocInfo, &commandBuffer);
-
-		VkCommandBufferBeginInfo beginInfo{};
-		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-		vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-		return commandBuffer;
+		vkDestroyBuffer(vulkan.device, buffer, nullptr);
+		vulkan.allocator.free(buffer_allocation);
+		buffer = VK_NULL_HANDLE;
 	}
 
-	void end_single_time_commands(VkCommandBuffer command_buffer, vulkan_data& vulkan)
+	auto destroy_image(VkImage& image, gpu_allocation& image_allocation, vulkan_data& vulkan) -> void
 	{
-		vkEndCommandBuffer(command_buffer);
-
-		VkSubmitInfo submitInfo{};
-		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &command_buffer;
-
-		vkQueueSubmit(vulkan.graphics_queue, 1, &submitInfo, VK_NULL_HANDLE);
-		vkQueueWaitIdle(vulkan.graphics_queue);
-
-		vkFreeCommandBuffers(vulkan.device, vulkan.command_pool, 1, &command_buffer);
+		vkDestroyImage(vulkan.device, image, nullptr);
+		vulkan.allocator.free(image_allocation);
+		image = VK_NULL_HANDLE;
 	}
 
-	auto transition_image_layout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mip_levels,
-	                             vulkan_data& vulkan) -> void
+	auto transition_image_layout(VkCommandBuffer commandBuffer, VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout,
+	                             uint32_t mip_levels) -> void
 	{
-		VkCommandBuffer commandBuffer = begin_single_time_commands(vulkan);
-
 		VkImageMemoryBarrier barrier{};
 		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
 		barrier.oldLayout = oldLayout;
@@ -1257,10 +1036,7 @@ namespace Mythos::vulkan
 		barrier.subresourceRange.baseArrayLayer = 0;
 		barrier.subresourceRange.layerCount = 1;
 
-		VkPipelineStageFlags sourceStage;
-		VkPipelineStageFlags destinationStage;
-
-		if (newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
+		if (newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL || newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL)
 		{
 			barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
 
@@ -1274,196 +1050,251 @@ namespace Mythos::vulkan
 			barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 		}
 
-		if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
-		{
-			barrier.srcAccessMask = 0;
-			barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-			sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-			destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-		}
-		else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout ==
-			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-		{
-			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		// the stages and accesses follow from the layouts, see Vulkan/render_graph.hpp
+		const auto source = layout_state(oldLayout);
+		const auto destination = layout_state(newLayout);
 
-			sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-			destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-		}
-		else if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout ==
-			VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
-		{
-			barrier.srcAccessMask = 0;
-			barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
-				VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		barrier.srcAccessMask = source.access & (VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+			VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT);
+		barrier.dstAccessMask = destination.access;
 
-			sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-			destinationStage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-		}
-		else
-		{
-			throw std::invalid_argument("unsupported layout transition!");
-		}
+		const auto sourceStage = source.stages;
+		const auto destinationStage = destination.stages;
 
 		vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-		end_single_time_commands(commandBuffer, vulkan);
 	}
 
-	void copy_buffer_to_image(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, vulkan_data& vulkan)
+	// every level of a mip chain in one command, level offsets are relative to level_base and land at offset in the buffer
+	void copy_buffer_to_image(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkImage image, uint32_t width, uint32_t height,
+	                          const texture_level* levels, uint32_t level_count, uint64_t level_base)
 	{
-		VkCommandBuffer commandBuffer = begin_single_time_commands(vulkan);
+		auto regions = std::vector<VkBufferImageCopy>(level_count);
 
-		VkBufferImageCopy region{};
-		region.bufferOffset = 0;
-		region.bufferRowLength = 0;
-		region.bufferImageHeight = 0;
-		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		region.imageSubresource.mipLevel = 0;
-		region.imageSubresource.baseArrayLayer = 0;
-		region.imageSubresource.layerCount = 1;
-		region.imageOffset = {0, 0, 0};
-		region.imageExtent = {
-			width,
-			height,
-			1
-		};
+		for (uint32_t i = 0; i < level_count; i++)
+		{
+			auto& region = regions[i];
+			region.bufferOffset = offset + (levels[i].offset - level_base);
+			region.bufferRowLength = 0;
+			region.bufferImageHeight = 0;
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel = i;
+			region.imageSubresource.baseArrayLayer = 0;
+			region.imageSubresource.layerCount = 1;
+			region.imageOffset = {0, 0, 0};
+			region.imageExtent = {
+				texture_level_extent(width, i),
+				texture_level_extent(height, i),
+				1
+			};
+		}
 
 		vkCmdCopyBufferToImage(
 			commandBuffer,
 			buffer,
 			image,
 			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-			1,
-			&region
+			level_count,
+			regions.data()
 		);
+	}
 
-		end_single_time_commands(commandBuffer, vulkan);
+	auto upload_buffer(VkBuffer dst_buffer, const void* data, VkDeviceSize size, vulkan_data& vulkan) -> bool
+	{
+		auto region = staging_region();
+		if (!vulkan.uploader.stage(data, size, 16, region)) return false;
+
+		VkBufferCopy copyRegion{};
+		copyRegion.srcOffset = region.offset;
+		copyRegion.size = size;
+		vkCmdCopyBuffer(region.commands, region.buffer, dst_buffer, 1, &copyRegion);
+
+		return true;
 	}
 
-	void generate_mipmaps(VkImage image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels, vulkan_data& vulkan)
+	// the whole chain is staged as one block, levels were filtered offline or on a loading job so nothing is blitted here
+	auto upload_image(VkImage image, VkFormat format, uint32_t width, uint32_t height, const texture_level* levels, uint32_t level_count,
+	                  uint64_t level_base, const void* data, VkDeviceSize size, vulkan_data& vulkan) -> bool
 	{
-		// Check if image format supports linear blitting
-		VkFormatProperties formatProperties;
-		vkGetPhysicalDeviceFormatProperties(vulkan.physical_device, imageFormat, &formatProperties);
+		// levels sit at 16 byte multiples from the start of data, which covers every block size
+		auto region = staging_region();
+		if (!vulkan.uploader.stage(data, size, TEXTURE_FILE_ALIGNMENT, region)) return false;
+
+		transition_image_layout(region.commands, image, format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, level_count);
+		copy_buffer_to_image(region.commands, region.buffer, region.offset, image, width, height, levels, level_count, level_base);
+		transition_image_layout(region.commands, image, format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, level_count);
 
-		if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
-			throw std::runtime_error("texture image format does not support linear blitting!");
+		return true;
+	}
+
+	auto to_vk_format(texture_format format) -> VkFormat
+	{
+		switch (format)
+		{
+		case texture_format::rgba8_unorm: return VK_FORMAT_R8G8B8A8_UNORM;
+		case texture_format::rgba8_srgb: return VK_FORMAT_R8G8B8A8_SRGB;
+		case texture_format::bc1_unorm: return VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+		case texture_format::bc1_srgb: return VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+		case texture_format::bc3_unorm: return VK_FORMAT_BC3_UNORM_BLOCK;
+		case texture_format::bc3_srgb: return VK_FORMAT_BC3_SRGB_BLOCK;
+		case texture_format::bc5_unorm: return VK_FORMAT_BC5_UNORM_BLOCK;
+		case texture_format::bc7_unorm: return VK_FORMAT_BC7_UNORM_BLOCK;
+		case texture_format::bc7_srgb: return VK_FORMAT_BC7_SRGB_BLOCK;
 		}
 
-		VkCommandBuffer commandBuffer = begin_single_time_commands(vulkan);
+		return VK_FORMAT_UNDEFINED;
+	}
 
-		VkImageMemoryBarrier barrier{};
-		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-		barrier.image = image;
-		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		barrier.subresourceRange.baseArrayLayer = 0;
-		barrier.subresourceRange.layerCount = 1;
-		barrier.subresourceRange.levelCount = 1;
+	auto create_placeholder_texture(vulkan_data& vulkan) -> bool
+	{
+		// bound in place of textures that are still streaming in
+		constexpr uint8_t pixel[] = {255, 255, 255, 255};
+		constexpr auto level = texture_level{0, sizeof(pixel)};
+		auto& texture = vulkan.placeholder_texture;
 
-		int32_t mipWidth = texWidth;
-		int32_t mipHeight = texHeight;
+		if (!create_image(1, 1, 1, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, texture.image, texture.allocation, vulkan) ||
+			!upload_image(texture.image, VK_FORMAT_R8G8B8A8_SRGB, 1, 1, &level, 1, 0, pixel, sizeof(pixel), vulkan))
+		{
+			return false;
+		}
 
-		for (uint32_t i = 1; i < mipLevels; i++) {
-			barrier.subresourceRange.baseMipLevel = i - 1;
-			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-			barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		texture.view = create_image_view(texture.image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT, 1, vulkan);
+		texture.state = asset_state::ready;
 
-			vkCmdPipelineBarrier(commandBuffer,
-				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
-				0, nullptr,
-				0, nullptr,
-				1, &barrier);
+		return texture.view != VK_NULL_HANDLE;
+	}
 
-			VkImageBlit blit{};
-			blit.srcOffsets[0] = { 0, 0, 0 };
-			blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
-			blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			blit.srcSubresource.mipLevel = i - 1;
-			blit.srcSubresource.baseArrayLayer = 0;
-			blit.srcSubresource.layerCount = 1;
-			blit.dstOffsets[0] = { 0, 0, 0 };
-			blit.dstOffsets[1] = { mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1 };
-			blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			blit.dstSubresource.mipLevel = i;
-			blit.dstSubresource.baseArrayLayer = 0;
-			blit.dstSubresource.layerCount = 1;
+	auto create_mesh_resource(decoded_mesh& decoded, mesh_resource& mesh, vulkan_data& vulkan) -> bool
+	{
+		const void* vertex_data = decoded.vertex_data.data();
+		const void* index_data = decoded.indices.data();
+		auto vertex_size = VkDeviceSize{decoded.vertex_data.size()};
+		auto index_size = VkDeviceSize{sizeof(uint32_t) * decoded.indices.size()};
 
-			vkCmdBlitImage(commandBuffer,
-				image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-				image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-				1, &blit,
-				VK_FILTER_LINEAR);
+		mesh.index_type = VK_INDEX_TYPE_UINT32;
+		mesh.index_count = static_cast<uint32_t>(decoded.indices.size());
 
-			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-			barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		// a cooked file is copied out of its mapping as is, there is nothing left to parse
+		if (decoded.file.is_open())
+		{
+			const auto& view = decoded.view;
 
-			vkCmdPipelineBarrier(commandBuffer,
-				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-				0, nullptr,
-				0, nullptr,
-				1, &barrier);
+			vertex_data = view.vertices;
+			index_data = view.indices;
+			vertex_size = view.vertex_bytes;
+			index_size = view.index_bytes;
 
-			if (mipWidth > 1) mipWidth /= 2;
-			if (mipHeight > 1) mipHeight /= 2;
+			mesh.index_type = view.header->index_type == mesh_index_type::uint16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+			mesh.index_count = view.header->index_count;
 		}
 
-		barrier.subresourceRange.baseMipLevel = mipLevels - 1;
-		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		if (vertex_size == 0 || index_size == 0) return false;
+
+		mesh.stream_offsets = mesh_vertex_layout::stream_offsets(decoded.vertex_count);
+		mesh.position_offset = mesh_vertex_layout::position_offset(decoded.bounds);
+		mesh.position_scale = mesh_vertex_layout::position_scale(decoded.bounds);
+		mesh.bounds_centre = decoded.bounds.centre();
+		mesh.bounds_radius = glm::length(decoded.bounds.max - decoded.bounds.min) * 0.5f;
 
-		vkCmdPipelineBarrier(commandBuffer,
-			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-			0, nullptr,
-			0, nullptr,
-			1, &barrier);
+		constexpr auto vertex_usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+		constexpr auto index_usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
 
-		end_single_time_commands(commandBuffer, vulkan);
+		if (!create_buffer(vertex_size, vertex_usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, mesh.vertex_buffer,
+		                   mesh.vertex_allocation, vulkan))
+		{
+			return false;
+		}
+
+		if (!create_buffer(index_size, index_usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, mesh.index_buffer,
+		                   mesh.index_allocation, vulkan))
+		{
+			return false;
+		}
+
+		// the copies go out with the next staging batch, ahead of the frame that first draws the mesh
+		return upload_buffer(mesh.vertex_buffer, vertex_data, vertex_size, vulkan) &&
+			upload_buffer(mesh.index_buffer, index_data, index_size, vulkan);
 	}
 
-	auto create_texture_image(vulkan_data& vulkan) -> bool
+	auto create_texture_resource(decoded_texture& decoded, texture_resource& texture, vulkan_data& vulkan) -> bool
 	{
-		int texWidth, texHeight, texChannels;
-		stbi_uc* pixels = stbi_load(TEXTURE_PATH.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-		VkDeviceSize imageSize = texWidth * texHeight * 4;
-		vulkan.mip_levels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
+		const auto format = to_vk_format(decoded.format);
 
-		if (!pixels) {
-			throw std::runtime_error("failed to load texture image!");
+		const texture_level* levels = decoded.levels.data();
+		const void* data = decoded.pixels.data();
+		auto level_count = static_cast<uint32_t>(decoded.levels.size());
+		auto level_base = uint64_t();
+		auto size = VkDeviceSize{decoded.pixels.size()};
+
+		// a cooked file is copied out of its mapping as is, every level already compressed
+		if (decoded.file.is_open())
+		{
+			const auto& view = decoded.view;
+
+			levels = view.levels;
+			data = view.data;
+			level_count = view.header->level_count;
+			level_base = view.data_offset;
+			size = view.data_bytes;
 		}
 
-		VkBuffer stagingBuffer;
-		VkDeviceMemory stagingBufferMemory;
-		create_buffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory, vulkan);
+		if (level_count == 0 || size == 0) return false;
 
-		void* data;
-		vkMapMemory(vulkan.device, stagingBufferMemory, 0, imageSize, 0, &data);
-		memcpy(data, pixels, static_cast<size_t>(imageSize));
-		vkUnmapMemory(vulkan.device, stagingBufferMemory);
+		texture.mip_levels = level_count;
 
-		stbi_image_free(pixels);
+		if (!create_image(decoded.width, decoded.height, texture.mip_levels, VK_SAMPLE_COUNT_1_BIT, format, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, texture.image, texture.allocation, vulkan))
+		{
+			return false;
+		}
 
-		create_image(texWidth, texHeight, vulkan.mip_levels, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vulkan.texture_image, vulkan.texture_image_memory, vulkan);
+		if (!upload_image(texture.image, format, decoded.width, decoded.height, levels, level_count, level_base, data, size, vulkan))
+		{
+			return false;
+		}
 
-		transition_image_layout(vulkan.texture_image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, vulkan.mip_levels, vulkan);
-		copy_buffer_to_image(stagingBuffer, vulkan.texture_image, static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight), vulkan);
-		//transitioned to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL while generating mipmaps
+		texture.view = create_image_view(texture.image, format, VK_IMAGE_ASPECT_COLOR_BIT, texture.mip_levels, vulkan);
 
-		vkDestroyBuffer(vulkan.device, stagingBuffer, nullptr);
-		vkFreeMemory(vulkan.device, stagingBufferMemory, nullptr);
+		return texture.view != VK_NULL_HANDLE;
+	}
 
-		generate_mipmaps(vulkan.texture_image, VK_FORMAT_R8G8B8A8_SRGB, texWidth, texHeight, vulkan.mip_levels, vulkan);
+	auto process_asset_uploads(vulkan_data& vulkan) -> void
+	{
+		PROFILE_FUNCTION();
 
-		return true;
+		auto& assets = vulkan.assets;
+
+		for (auto& decoded : assets.take_decoded_meshes())
+		{
+			auto* mesh = assets.mesh({ decoded.index });
+			if (mesh == nullptr) continue;
+
+			mesh->state = decoded.success && create_mesh_resource(decoded, *mesh, vulkan) ? asset_state::ready : asset_state::failed;
+
+			if (mesh->state == asset_state::failed)
+			{
+				Debug::error("Vulkan failed to create mesh : " + mesh->path);
+			}
+		}
+
+		for (auto& decoded : assets.take_decoded_textures())
+		{
+			auto* texture = assets.texture({ decoded.index });
+			if (texture == nullptr) continue;
+
+			texture->state = decoded.success && create_texture_resource(decoded, *texture, vulkan) ? asset_state::ready : asset_state::failed;
+
+			if (texture->state == asset_state::failed)
+			{
+				Debug::error("Vulkan failed to create texture : " + texture->path);
+				continue;
+			}
+
+			// instances pick the slot up from the next frame on, the fallback binds the texture when it writes the frame's set
+			if (vulkan.bindless)
+			{
+				const auto slot = vulkan.textures.add_texture(texture->view, vulkan.texture_sampler);
+				texture->descriptor = slot != descriptor_table::INVALID_SLOT ? slot : vulkan.placeholder_texture.descriptor;
+			}
+		}
 	}
 
 	auto create_image_views(vulkan_data& vulkan) -> bool
@@ -1478,13 +1309,6 @@ namespace Mythos::vulkan
 		return true;
 	}
 
-	auto create_texture_image_view(vulkan_data& vulkan) -> bool
-	{
-		vulkan.texture_image_view = create_image_view(vulkan.texture_image, VK_FORMAT_R8G8B8A8_SRGB,
-		                                              VK_IMAGE_ASPECT_COLOR_BIT, vulkan.mip_levels, vulkan);
-		return vulkan.texture_image_view != VK_NULL_HANDLE;
-	}
-
 	auto create_texture_sampler(vulkan_data& vulkan) -> bool
 	{
 		VkPhysicalDeviceProperties properties{};
@@ -1505,7 +1329,7 @@ namespace Mythos::vulkan
 		samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
 		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
 		samplerInfo.minLod = 0.0f;
-		samplerInfo.maxLod = static_cast<float>(vulkan.mip_levels);
+		samplerInfo.maxLod = VK_LOD_CLAMP_NONE; // shared by every texture, the view limits the mips
 		samplerInfo.mipLodBias = 0.0f;
 
 		if (vkCreateSampler(vulkan.device, &samplerInfo, nullptr, &vulkan.texture_sampler) != VK_SUCCESS) 
@@ -1516,31 +1340,12 @@ namespace Mythos::vulkan
 		return true;
 	}
 
-	auto create_command_buffers(vulkan_data& vulkan) -> bool
-	{
-		vulkan.command_buffers.resize(vulkan.MAX_FRAMES_IN_FLIGHT);
-
-		VkCommandBufferAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-		allocInfo.commandPool = vulkan.command_pool;
-		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		allocInfo.commandBufferCount = static_cast<uint32_t>(vulkan.command_buffers.size());
-
-		const auto success = vkAllocateCommandBuffers(vulkan.device, &allocInfo, vulkan.command_buffers.data());
-		if (success != VK_SUCCESS)
-		{
-			Debug::error("Vulkan failed to allocate command buffers");
-		}
-
-		Debug::log("Vulkan allocated command buffers");
-		return true;
-	}
-
 	auto create_sync_objects(vulkan_data& vulkan) -> bool
 	{
 		vulkan.image_available_semaphores.resize(vulkan.MAX_FRAMES_IN_FLIGHT);
 		vulkan.render_finished_semaphores.resize(vulkan.MAX_FRAMES_IN_FLIGHT);
 		vulkan.in_flight_fences.resize(vulkan.MAX_FRAMES_IN_FLIGHT);
+		vulkan.slot_frame_begins.resize(vulkan.MAX_FRAMES_IN_FLIGHT);
 
 		auto result = false;
 		auto result_2 = false;
@@ -1572,46 +1377,34 @@ namespace Mythos::vulkan
 		return true;
 	}
 
-	auto record_command_buffer(vulkan_data& vulkan, uint32_t image_index) -> void
+	// the instances of this frame, a spinning grid of the model
+	auto gather_instances(vulkan_data& vulkan) -> void
 	{
-		const auto& command_buffer = vulkan.command_buffers[vulkan.current_frame];
-		const auto& render_pass = vulkan.render_pass;
-		const auto& frame_buffers = vulkan.frame_buffers;
-		const auto& swapchain_extent = vulkan.swapchain_extents;
+		const auto spin = glm::angleAxis(vulkan.animation_time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+		const auto half = static_cast<float>(MODEL_GRID - 1) * MODEL_SPACING * 0.5f;
 
+		// the placeholder's slot until the model texture has streamed in
+		const auto* texture = vulkan.assets.texture(vulkan.model_texture);
+		const auto ready = texture != nullptr && texture->state == asset_state::ready;
+		const auto texture_slot = ready ? texture->descriptor : vulkan.placeholder_texture.descriptor;
 
-		VkCommandBufferBeginInfo beginInfo{};
-		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-		beginInfo.flags = 0;
-		beginInfo.pInheritanceInfo = nullptr;
+		vulkan.instances.clear();
+		vulkan.instances.reserve(MODEL_GRID * MODEL_GRID);
 
-		auto success = vkBeginCommandBuffer(command_buffer, &beginInfo);
-		if (success != VK_SUCCESS)
+		for (uint32_t y = 0; y < MODEL_GRID; y++)
 		{
-			Debug::error("Vulkan failed to begin recording command buffer");
+			for (uint32_t x = 0; x < MODEL_GRID; x++)
+			{
+				const auto position = glm::vec3(static_cast<float>(x) * MODEL_SPACING - half, static_cast<float>(y) * MODEL_SPACING - half, 0.0f);
+				vulkan.instances.push(vulkan.model, texture_slot, position, spin);
+			}
 		}
+	}
 
-		VkRenderPassBeginInfo renderPassInfo{};
-		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-		renderPassInfo.renderPass = render_pass;
-		renderPassInfo.framebuffer = frame_buffers[image_index];
-
-		renderPassInfo.renderArea.offset = {0, 0};
-		renderPassInfo.renderArea.extent = swapchain_extent;
-
-		VkClearValue clear_color = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
-		renderPassInfo.clearValueCount = 1;
-		renderPassInfo.pClearValues = &clear_color;
-
-		std::array<VkClearValue, 2> clearValues{};
-		clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
-		clearValues[1].depthStencil = {1.0f, 0};
-
-		renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-		renderPassInfo.pClearValues = clearValues.data();
-
-		// begin render pass
-		vkCmdBeginRenderPass(command_buffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+	// records a run of the draw list, secondaries inherit none of the primary's state so every run sets its own
+	auto record_draws(VkCommandBuffer command_buffer, vulkan_data& vulkan, draw_range range) -> void
+	{
+		const auto& swapchain_extent = vulkan.swapchain_extents;
 
 		// bind the graphics pipeline
 		vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan.graphics_pipeline);
@@ -1631,104 +1424,140 @@ namespace Mythos::vulkan
 		scissor.extent = swapchain_extent;
 		vkCmdSetScissor(command_buffer, 0, 1, &scissor);
 
-		auto& buffer = vulkan.vertex_buffer;
-
-		VkBuffer vertexBuffers[] = {vulkan.vertex_buffer};
-		VkDeviceSize offsets[] = {0};
+		const auto& sets = vulkan.frame_descriptor_sets[vulkan.current_frame];
+		vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan.pipeline_layout, 0,
+		                        static_cast<uint32_t>(sets.size()), sets.data(), 0, nullptr);
 
-		vkCmdBindVertexBuffers(command_buffer, 0, 1, vertexBuffers, offsets);
-		vkCmdBindIndexBuffer(command_buffer, vulkan.index_buffer, 0, VK_INDEX_TYPE_UINT32);
+		const auto& batcher = vulkan.batcher;
+		const auto commands = batcher.command_buffer(static_cast<uint32_t>(vulkan.current_frame));
 
-		vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkan.pipeline_layout, 0, 1,
-		                        &vulkan.descriptor_sets[vulkan.current_frame], 0, nullptr);
-
-		// draw command
-		vkCmdDrawIndexed(command_buffer, static_cast<uint32_t>(vulkan.indices.size()), 1, 0, 0, 0);
-
-		// end the render pass
-		vkCmdEndRenderPass(command_buffer);
-
-		success = vkEndCommandBuffer(command_buffer);
-		if (success != VK_SUCCESS)
+		for (auto i = range.begin; i < range.end; i++)
 		{
-			Debug::error("failed to record command buffer!");
-		}
-	}
+			// the batcher only lists meshes whose buffers are uploaded
+			const auto& draw = vulkan.draw_list[i];
+			const auto* mesh = vulkan.assets.mesh(draw.mesh);
 
-	void copy_buffer(VkBuffer src_buffer, VkBuffer dst_buffer, VkDeviceSize size, vulkan_data& vulkan)
-	{
-		VkCommandBuffer commandBuffer = begin_single_time_commands(vulkan);
+			// split layouts bind the same buffer once per stream
+			VkBuffer vertexBuffers[] = {mesh->vertex_buffer, mesh->vertex_buffer};
 
-		VkBufferCopy copyRegion{};
-		copyRegion.size = size;
-		vkCmdCopyBuffer(commandBuffer, src_buffer, dst_buffer, 1, &copyRegion);
+			vkCmdBindVertexBuffers(command_buffer, 0, mesh_vertex_layout::stream_count, vertexBuffers, mesh->stream_offsets.data());
+			vkCmdBindIndexBuffer(command_buffer, mesh->index_buffer, 0, mesh->index_type);
 
-		end_single_time_commands(commandBuffer, vulkan);
+			// every instance of the batch in one draw, counted on the gpu when the compute pass ran
+			if (batcher.indirect())
+			{
+				constexpr auto stride = static_cast<uint32_t>(sizeof(VkDrawIndexedIndirectCommand));
+				vkCmdDrawIndexedIndirect(command_buffer, commands, draw.batch * stride, 1, stride);
+			}
+			else
+			{
+				vkCmdDrawIndexed(command_buffer, mesh->index_count, draw.instance_count, 0, 0, draw.first_instance);
+			}
+		}
 	}
 
-	auto create_vertex_buffer(vulkan_data& vulkan) -> bool
+	auto record_forward_pass(VkCommandBuffer command_buffer, const pass_target& target, vulkan_data& vulkan) -> void
 	{
-		const auto buffer_size = VkDeviceSize{sizeof(vulkan.vertices[0]) * vulkan.vertices.size()};
+		const auto frame = static_cast<uint32_t>(vulkan.current_frame);
+		auto& recorder = vulkan.recorder;
 
-		constexpr auto staging_usage = VkBufferUsageFlags{VK_BUFFER_USAGE_TRANSFER_SRC_BIT};
-		constexpr auto staging_properties = VkMemoryPropertyFlags{
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-		};
+		// spread the draw list over the job system, a short list is cheaper to record inline
+		const auto draw_count = static_cast<uint32_t>(vulkan.draw_list.size());
+		const auto slots = vulkan.jobs != nullptr ? std::min(recorder.slot_count(), vulkan.jobs->worker_count()) : 1u;
+		const auto ranges = partition_draws(draw_count, slots, command_recorder::MIN_DRAWS_PER_SLOT);
+		const auto parallel = ranges.size() > 1;
 
-		VkBuffer staging_buffer;
-		VkDeviceMemory staging_buffer_memory;
+		// begin render pass, the graph ends it
+		target.begin(command_buffer, parallel ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
 
-		auto success = create_buffer(buffer_size, staging_usage, staging_properties, staging_buffer,
-		                             staging_buffer_memory, vulkan);
+		auto secondaries = std::vector<VkCommandBuffer>();
 
-		if (!success) return false;
+		if (!parallel)
+		{
+			record_draws(command_buffer, vulkan, { 0, draw_count });
+		}
+		else
+		{
+			const auto inheritance = VkCommandBufferInheritanceInfo
+			{
+				.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+				.renderPass = target.render_pass,
+				.subpass = 0,
+				.framebuffer = target.framebuffer,
+			};
 
-		void* data;
-		vkMapMemory(vulkan.device, staging_buffer_memory, 0, buffer_size, 0, &data);
-		memcpy(data, vulkan.vertices.data(), static_cast<size_t>(buffer_size));
-		vkUnmapMemory(vulkan.device, staging_buffer_memory);
+			// each range owns a slot, so no two jobs ever share a command pool
+			secondaries.resize(ranges.size());
 
-		constexpr auto vertex_usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-		constexpr auto vertex_properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+			vulkan.jobs->parallel_for(static_cast<uint32_t>(ranges.size()), 1, [&](uint32_t begin, uint32_t end)
+			{
+				for (auto slot = begin; slot < end; slot++)
+				{
+					const auto secondary = recorder.begin_secondary(frame, slot, inheritance);
+					if (secondary == VK_NULL_HANDLE) continue;
 
-		success = create_buffer(buffer_size, vertex_usage, vertex_properties, vulkan.vertex_buffer,
-		                        vulkan.vertex_buffer_memory, vulkan);
+					record_draws(secondary, vulkan, ranges[slot]);
 
-		if (!success) return false;
+					if (vkEndCommandBuffer(secondary) == VK_SUCCESS)
+					{
+						secondaries[slot] = secondary;
+					}
+				}
+			});
 
-		copy_buffer(staging_buffer, vulkan.vertex_buffer, buffer_size, vulkan);
+			// a range that failed to record loses its draws rather than the frame
+			std::erase(secondaries, VK_NULL_HANDLE);
 
-		vkDestroyBuffer(vulkan.device, staging_buffer, nullptr);
-		vkFreeMemory(vulkan.device, staging_buffer_memory, nullptr);
+			if (!secondaries.empty())
+			{
+				vkCmdExecuteCommands(command_buffer, static_cast<uint32_t>(secondaries.size()), secondaries.data());
+			}
+		}
 
-		return true;
+		auto& stats = recorder.stats();
+		stats.draws = draw_count;
+		stats.secondaries = static_cast<uint32_t>(secondaries.size());
 	}
 
-	auto create_index_buffer(vulkan_data& vulkan) -> bool
+	auto record_command_buffer(vulkan_data& vulkan, uint32_t image_index) -> void
 	{
-		VkDeviceSize bufferSize = sizeof(vulkan.indices[0]) * vulkan.indices.size();
+		PROFILE_FUNCTION();
 
-		VkBuffer stagingBuffer;
-		VkDeviceMemory stagingBufferMemory;
+		const auto frame = static_cast<uint32_t>(vulkan.current_frame);
+		const auto record_begin = std::chrono::steady_clock::now();
 
-		create_buffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		              VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer,
-		              stagingBufferMemory, vulkan);
+		auto& recorder = vulkan.recorder;
+		const auto command_buffer = recorder.primary(frame);
 
-		void* data;
-		vkMapMemory(vulkan.device, stagingBufferMemory, 0, bufferSize, 0, &data);
-		memcpy(data, vulkan.indices.data(), (size_t)bufferSize);
-		vkUnmapMemory(vulkan.device, stagingBufferMemory);
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		beginInfo.pInheritanceInfo = nullptr;
 
-		create_buffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-		              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vulkan.index_buffer, vulkan.index_buffer_memory, vulkan);
+		auto success = vkBeginCommandBuffer(command_buffer, &beginInfo);
+		if (success != VK_SUCCESS)
+		{
+			Debug::error("Vulkan failed to begin recording command buffer");
+		}
 
-		copy_buffer(stagingBuffer, vulkan.index_buffer, bufferSize, vulkan);
+		// the slot's timestamps from its last frame are read back before its queries are reset
+		auto& gpu_profile = vulkan.gpu_profile;
+		gpu_profile.begin_frame(command_buffer, frame);
+		const auto gpu_frame = gpu_profile.begin(command_buffer, "gpu frame");
 
-		vkDestroyBuffer(vulkan.device, stagingBuffer, nullptr);
-		vkFreeMemory(vulkan.device, stagingBufferMemory, nullptr);
+		// every pass with the barriers between them, see create_render_graph
+		vulkan.graph.bind(vulkan.backbuffer, vulkan.images[image_index], vulkan.image_views[image_index]);
+		vulkan.graph.execute(command_buffer, &gpu_profile);
 
-		return true;
+		gpu_profile.end(command_buffer, gpu_frame);
+
+		success = vkEndCommandBuffer(command_buffer);
+		if (success != VK_SUCCESS)
+		{
+			Debug::error("failed to record command buffer!");
+		}
+
+		recorder.stats().record_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - record_begin).count();
 	}
 
 	auto create_uniform_buffers(vulkan_data& vulkan) -> bool
@@ -1736,7 +1565,7 @@ namespace Mythos::vulkan
 		VkDeviceSize bufferSize = sizeof(uniform_buffer_object);
 
 		vulkan.uniform_buffers.resize(vulkan.MAX_FRAMES_IN_FLIGHT);
-		vulkan.uniform_buffers_memory.resize(vulkan.MAX_FRAMES_IN_FLIGHT);
+		vulkan.uniform_buffers_allocation.resize(vulkan.MAX_FRAMES_IN_FLIGHT);
 		vulkan.uniform_buffers_mapped.resize(vulkan.MAX_FRAMES_IN_FLIGHT);
 
 		constexpr auto usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
@@ -1746,118 +1575,243 @@ namespace Mythos::vulkan
 		for (size_t i = 0; i < vulkan.MAX_FRAMES_IN_FLIGHT; i++)
 		{
 			success = create_buffer(bufferSize, usage, properties, vulkan.uniform_buffers[i],
-			                        vulkan.uniform_buffers_memory[i], vulkan);
+			                        vulkan.uniform_buffers_allocation[i], vulkan);
 			if (!success) return false;
-			vkMapMemory(vulkan.device, vulkan.uniform_buffers_memory[i], 0, bufferSize, 0,
-			            &vulkan.uniform_buffers_mapped[i]);
+
+			// host visible memory is mapped once by the allocator for its whole lifetime
+			vulkan.uniform_buffers_mapped[i] = vulkan.uniform_buffers_allocation[i].mapped;
 		}
 
 		return true;
 	}
 
-	auto create_descriptor_pool(vulkan_data& vulkan) -> bool
+	auto create_instance_batcher(vulkan_data& vulkan) -> bool
 	{
-		std::array<VkDescriptorPoolSize, 2> poolSizes{};
-		poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		poolSizes[0].descriptorCount = static_cast<uint32_t>(vulkan.MAX_FRAMES_IN_FLIGHT);
-		poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		poolSizes[1].descriptorCount = static_cast<uint32_t>(vulkan.MAX_FRAMES_IN_FLIGHT);
+		const auto indirect = vulkan.physical_device_features.drawIndirectFirstInstance == VK_TRUE;
 
-		VkDescriptorPoolCreateInfo poolInfo{};
-		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-		poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-		poolInfo.pPoolSizes = poolSizes.data();
-		poolInfo.maxSets = static_cast<uint32_t>(vulkan.MAX_FRAMES_IN_FLIGHT);
+		// the depth pyramid is created with the render graph, which only declares its pass when the batcher culls on the gpu
+		return vulkan.batcher.create(vulkan.device, vulkan.allocator, static_cast<uint32_t>(vulkan.MAX_FRAMES_IN_FLIGHT), indirect);
+	}
+
+	static auto resize_depth_pyramid(vulkan_data& vulkan) -> void
+	{
+		if (vulkan.pyramid_target.index == UINT32_MAX) return;
+
+		const auto& extent = vulkan.swapchain_extents;
+		const auto resized = vulkan.pyramid.resize(vulkan.graph.view(vulkan.depth_target), extent.width, extent.height,
+		                                           vulkan.msaa_samples);
+
+		vulkan.graph.bind(vulkan.pyramid_target, resized ? vulkan.pyramid.image() : VK_NULL_HANDLE,
+		                  resized ? vulkan.pyramid.view() : VK_NULL_HANDLE);
+		vulkan.batcher.bind_depth_pyramid(resized ? &vulkan.pyramid : nullptr);
+	}
 
-		if (vkCreateDescriptorPool(vulkan.device, &poolInfo, nullptr, &vulkan.descriptor_pool) != VK_SUCCESS)
+	auto create_frame_resources(vulkan_data& vulkan) -> bool
+	{
+		if (!vulkan.graph.realize(vulkan.swapchain_extents))
 		{
-			throw std::runtime_error("failed to create descriptor pool!");
+			Debug::error("Vulkan failed to create the render graph's images");
 			return false;
 		}
 
+		// the pyramid follows the depth buffer's size, the device is idle so the batcher's sets can be rewritten
+		resize_depth_pyramid(vulkan);
 		return true;
 	}
 
-	auto create_descriptor_set(vulkan_data& vulkan) -> bool
+	auto create_descriptor_allocator(vulkan_data& vulkan) -> bool
+	{
+		vulkan.frame_descriptor_sets.resize(vulkan.MAX_FRAMES_IN_FLIGHT);
+
+		return vulkan.descriptors.create(vulkan.device, static_cast<uint32_t>(vulkan.MAX_FRAMES_IN_FLIGHT));
+	}
+
+	auto create_texture_table(vulkan_data& vulkan) -> bool
+	{
+		if (!vulkan.bindless) return true;
+
+		// slot 0, what every instance samples until its own texture is ready
+		auto& placeholder = vulkan.placeholder_texture;
+		placeholder.descriptor = vulkan.textures.add_texture(placeholder.view, vulkan.texture_sampler);
+
+		return placeholder.descriptor != descriptor_table::INVALID_SLOT;
+	}
+
+	auto write_frame_descriptors(vulkan_data& vulkan, size_t i) -> bool
 	{
-		std::vector<VkDescriptorSetLayout> layouts(vulkan.MAX_FRAMES_IN_FLIGHT, vulkan.descriptor_set_layout);
+		const auto frame = static_cast<uint32_t>(i);
+		auto& sets = vulkan.frame_descriptor_sets[i];
 
-		VkDescriptorSetAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-		allocInfo.descriptorPool = vulkan.descriptor_pool;
-		allocInfo.descriptorSetCount = static_cast<uint32_t>(vulkan.MAX_FRAMES_IN_FLIGHT);
-		allocInfo.pSetLayouts = layouts.data();
+		sets[0] = vulkan.descriptors.allocate(vulkan.descriptor_set_layout);
+		sets[1] = vulkan.bindless ? vulkan.textures.set() : vulkan.descriptors.allocate(vulkan.texture_set_layout);
 
-		vulkan.descriptor_sets.resize(vulkan.MAX_FRAMES_IN_FLIGHT);
-		if (vkAllocateDescriptorSets(vulkan.device, &allocInfo, vulkan.descriptor_sets.data()) != VK_SUCCESS)
+		if (sets[0] == VK_NULL_HANDLE || sets[1] == VK_NULL_HANDLE)
 		{
-			throw std::runtime_error("failed to allocate descriptor sets!");
+			Debug::error("Vulkan failed to allocate the frame's descriptor sets");
 			return false;
 		}
 
-		for (size_t i = 0; i < vulkan.MAX_FRAMES_IN_FLIGHT; i++)
-		{
-			VkDescriptorBufferInfo bufferInfo{};
-			bufferInfo.buffer = vulkan.uniform_buffers[i];
-			bufferInfo.offset = 0;
-			bufferInfo.range = sizeof(uniform_buffer_object);
+		VkDescriptorBufferInfo bufferInfo{};
+		bufferInfo.buffer = vulkan.uniform_buffers[i];
+		bufferInfo.offset = 0;
+		bufferInfo.range = sizeof(uniform_buffer_object);
+
+		std::array<VkDescriptorBufferInfo, 2> instanceInfos{};
+		instanceInfos[0] = {vulkan.batcher.instance_buffer(frame), 0, VK_WHOLE_SIZE};
+		instanceInfos[1] = {vulkan.batcher.visible_buffer(frame), 0, VK_WHOLE_SIZE};
 
-			VkDescriptorImageInfo imageInfo{};
-			imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-			imageInfo.imageView = vulkan.texture_image_view;
-			imageInfo.sampler = vulkan.texture_sampler;
+		// the model texture once it has streamed in, the placeholder until then, only written without the table
+		const auto* texture = vulkan.assets.texture(vulkan.model_texture);
+		const auto ready = texture != nullptr && texture->state == asset_state::ready;
 
-			std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
+		VkDescriptorImageInfo imageInfo{};
+		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		imageInfo.imageView = ready ? texture->view : vulkan.placeholder_texture.view;
+		imageInfo.sampler = vulkan.texture_sampler;
 
-			descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrites[0].dstSet = vulkan.descriptor_sets[i];
-			descriptorWrites[0].dstBinding = 0;
-			descriptorWrites[0].dstArrayElement = 0;
-			descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			descriptorWrites[0].descriptorCount = 1;
-			descriptorWrites[0].pBufferInfo = &bufferInfo;
+		std::array<VkWriteDescriptorSet, 4> descriptorWrites{};
 
-			descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrites[1].dstSet = vulkan.descriptor_sets[i];
-			descriptorWrites[1].dstBinding = 1;
-			descriptorWrites[1].dstArrayElement = 0;
-			descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-			descriptorWrites[1].descriptorCount = 1;
-			descriptorWrites[1].pImageInfo = &imageInfo;
+		descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[0].dstSet = sets[0];
+		descriptorWrites[0].dstBinding = 0;
+		descriptorWrites[0].dstArrayElement = 0;
+		descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		descriptorWrites[0].descriptorCount = 1;
+		descriptorWrites[0].pBufferInfo = &bufferInfo;
 
-			vkUpdateDescriptorSets(vulkan.device, static_cast<uint32_t>(descriptorWrites.size()),
-			                       descriptorWrites.data(), 0, nullptr);
+		for (size_t binding = 1; binding < 3; binding++)
+		{
+			descriptorWrites[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrites[binding].dstSet = sets[0];
+			descriptorWrites[binding].dstBinding = static_cast<uint32_t>(binding);
+			descriptorWrites[binding].dstArrayElement = 0;
+			descriptorWrites[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			descriptorWrites[binding].descriptorCount = 1;
+			descriptorWrites[binding].pBufferInfo = &instanceInfos[binding - 1];
 		}
 
+		descriptorWrites[3].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[3].dstSet = sets[1];
+		descriptorWrites[3].dstBinding = 0;
+		descriptorWrites[3].dstArrayElement = 0;
+		descriptorWrites[3].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		descriptorWrites[3].descriptorCount = 1;
+		descriptorWrites[3].pImageInfo = &imageInfo;
+
+		const auto writeCount = vulkan.bindless ? 3u : 4u;
+		vkUpdateDescriptorSets(vulkan.device, writeCount, descriptorWrites.data(), 0, nullptr);
+
 		return true;
 	}
 
 	void update_uniform_buffer(vulkan_data& vulkan)
 	{
-		static auto start_time = std::chrono::high_resolution_clock::now();
+		auto& ubo = vulkan.view_uniforms;
+		const auto& extent = vulkan.swapchain_extents;
 
-		const auto current_time = std::chrono::high_resolution_clock::now();
-		float time = std::chrono::duration<float, std::chrono::seconds::period>(current_time - start_time).count();
+		// the camera is fixed, so the view only changes with the aspect ratio
+		if (extent.width != vulkan.view_extent.width || extent.height != vulkan.view_extent.height)
+		{
+			ubo.view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+			ubo.proj = glm::perspective(glm::radians(45.0f), extent.width / static_cast<float>(extent.height), 0.1f, 10.0f);
+			ubo.proj[1][1] *= -1;
+			ubo.view_proj = ubo.proj * ubo.view;
 
-		uniform_buffer_object ubo{};
-		ubo.model = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-		ubo.view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-		ubo.proj = glm::perspective(glm::radians(45.0f),
-		                            vulkan.swapchain_extents.width / static_cast<float>(vulkan.swapchain_extents.
-			                            height), 0.1f, 10.0f);
-		ubo.proj[1][1] *= -1;
+			vulkan.view_extent = extent;
+		}
 
 		memcpy(vulkan.uniform_buffers_mapped[vulkan.current_frame], &ubo, sizeof(ubo));
 	}
 
+	auto create_renderer(void* hmodule, void* hwnd, vulkan_data& vulkan) -> bool
+	{
+		if (!create_instance(vulkan)) return false;
+		if (!create_surface(hmodule, hwnd, vulkan)) return false;
+		if (!select_physical_device(vulkan)) return false;
+		if (!create_logical_device(vulkan)) return false;
+		if (!create_memory_allocator(vulkan)) return false;
+		if (!create_swapchain(hwnd, vulkan)) return false;
+		if (!create_image_views(vulkan)) return false;
+
+		// the graph only declares the passes the batcher and the depth pyramid can run
+		if (!create_instance_batcher(vulkan)) return false;
+		if (!create_render_graph(vulkan)) return false;
+
+		if (!create_descriptor_set_layout(vulkan)) return false;
+		if (!create_pipeline_cache(vulkan)) return false;
+		if (!create_graphics_pipeline(vulkan)) return false;
+		if (!create_command_recorder(vulkan)) return false;
+		if (!create_gpu_profiler(vulkan)) return false;
+		if (!create_staging_uploader(vulkan)) return false;
+		if (!create_frame_resources(vulkan)) return false;
+		if (!create_placeholder_texture(vulkan)) return false;
+		if (!create_texture_sampler(vulkan)) return false;
+		if (!create_uniform_buffers(vulkan)) return false;
+		if (!create_descriptor_allocator(vulkan)) return false;
+		if (!create_texture_table(vulkan)) return false;
+		if (!create_sync_objects(vulkan)) return false;
+
+		Debug::log("Vulkan renderer created : " + std::to_string(static_cast<uint32_t>(vulkan.msaa_samples)) + "x msaa, " +
+			present_mode_name(vulkan.swapchain_present_mode) + ", " + std::to_string(vulkan.images.size()) + " images, " +
+			std::to_string(vulkan.MAX_FRAMES_IN_FLIGHT) + " frames in flight");
+		return true;
+	}
+
+	static auto elapsed_ms(std::chrono::steady_clock::time_point begin) -> double
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+	}
+
 	auto draw_frame(void* hwnd, vulkan_data& vulkan) -> void
 	{
+		PROFILE_FUNCTION();
+
 		const auto i = vulkan.current_frame;
 		auto image_index = uint32_t();
 
-		vkWaitForFences(vulkan.device, 1, &vulkan.in_flight_fences[i], VK_TRUE, UINT64_MAX);
-		auto result = vkAcquireNextImageKHR(vulkan.device, vulkan.swapchain, UINT64_MAX,
-		                                    vulkan.image_available_semaphores[i], VK_NULL_HANDLE, &image_index);
+		const auto frame_begin = std::chrono::steady_clock::now();
+		auto& timings = vulkan.frame_timings;
+
+		// only wait for the frame that last used this slot, the other frames keep the gpu busy meanwhile
+		auto wait_begin = std::chrono::steady_clock::now();
+		{
+			PROFILE_ZONE("wait for frame slot");
+			vkWaitForFences(vulkan.device, 1, &vulkan.in_flight_fences[i], VK_TRUE, UINT64_MAX);
+		}
+		timings.fence_wait_ms = elapsed_ms(wait_begin);
+
+		// the slot's last frame is done on the gpu, more frames in flight and deeper swapchains make this longer
+		auto& slot_begin = vulkan.slot_frame_begins[i];
+		timings.latency_ms = slot_begin.time_since_epoch().count() == 0 ? 0.0 : elapsed_ms(slot_begin);
+		slot_begin = frame_begin;
+
+		// the view is culled against, so it is updated ahead of the batching
+		update_uniform_buffer(vulkan);
+
+		// the slot's last frame is done with its instance buffers, a batcher that outgrew them replaces them here
+		gather_instances(vulkan);
+		vulkan.batcher.build(static_cast<uint32_t>(i), vulkan.view_uniforms.view_proj, vulkan.instances, vulkan.assets,
+		                     vulkan.jobs, vulkan.draw_list);
+
+		// the slot's last frame is done with its descriptor sets, they are allocated and written anew after the build
+		// so they always point at the buffers it just filled
+		vulkan.descriptors.begin_frame(static_cast<uint32_t>(i));
+		if (vulkan.bindless)
+		{
+			vulkan.textures.begin_frame();
+		}
+
+		if (!write_frame_descriptors(vulkan, i)) return;
+
+		wait_begin = std::chrono::steady_clock::now();
+		auto result = VkResult();
+		{
+			PROFILE_ZONE("acquire image");
+			result = vkAcquireNextImageKHR(vulkan.device, vulkan.swapchain, UINT64_MAX,
+			                               vulkan.image_available_semaphores[i], VK_NULL_HANDLE, &image_index);
+		}
+		timings.acquire_ms = elapsed_ms(wait_begin);
+
 		if (result == VK_ERROR_OUT_OF_DATE_KHR)
 		{
 			recreate_swapchain(hwnd, vulkan);
@@ -1867,12 +1821,24 @@ namespace Mythos::vulkan
 		{
 			throw std::runtime_error("failed to acquire swap chain image!");
 		}
+
+		// the swapchain can hand back images out of order, so an image may still be owned by another frame slot
+		if (vulkan.images_in_flight[image_index] != VK_NULL_HANDLE && vulkan.images_in_flight[image_index] != vulkan.in_flight_fences[i])
+		{
+			wait_begin = std::chrono::steady_clock::now();
+			vkWaitForFences(vulkan.device, 1, &vulkan.images_in_flight[image_index], VK_TRUE, UINT64_MAX);
+			timings.fence_wait_ms += elapsed_ms(wait_begin);
+		}
+		vulkan.images_in_flight[image_index] = vulkan.in_flight_fences[i];
+
 		vkResetFences(vulkan.device, 1, &vulkan.in_flight_fences[i]);
 
-		vkResetCommandBuffer(vulkan.command_buffers[i], 0);
+		// the slot's fence has signalled, nothing recorded from its pools is still executing
+		vulkan.recorder.begin_frame(static_cast<uint32_t>(i));
+
 		record_command_buffer(vulkan, image_index);
 
-		update_uniform_buffer(vulkan);
+		const auto command_buffer = vulkan.recorder.primary(static_cast<uint32_t>(i));
 
 		const VkSemaphore wait_semaphores[] = {vulkan.image_available_semaphores[i]};
 		const VkSemaphore signal_semaphores[] = {vulkan.render_finished_semaphores[i]};
@@ -1886,11 +1852,14 @@ namespace Mythos::vulkan
 			.pWaitSemaphores = wait_semaphores,
 			.pWaitDstStageMask = wait_stages,
 			.commandBufferCount = 1,
-			.pCommandBuffers = &vulkan.command_buffers[i],
+			.pCommandBuffers = &command_buffer,
 			.signalSemaphoreCount = 1,
 			.pSignalSemaphores = signal_semaphores,
 		};
 
+		// anything staged since the last frame goes out first, the queue orders it ahead of the draw
+		vulkan.uploader.submit();
+
 		result = vkQueueSubmit(vulkan.graphics_queue, 1, &submit_info, vulkan.in_flight_fences[i]);
 		if (result != VK_SUCCESS)
 		{
@@ -1910,7 +1879,10 @@ namespace Mythos::vulkan
 			.pResults = nullptr,
 		};
 
-		result = vkQueuePresentKHR(vulkan.present_queue, &present_info);
+		{
+			PROFILE_ZONE("present");
+			result = vkQueuePresentKHR(vulkan.present_queue, &present_info);
+		}
 		if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || vulkan.frame_buffer_resized)
 		{
 			vulkan.frame_buffer_resized = false;
@@ -1922,18 +1894,20 @@ namespace Mythos::vulkan
 		}
 
 		vulkan.current_frame = (i + 1) % vulkan.MAX_FRAMES_IN_FLIGHT;
+
+		// a serialized loop costs cpu + gpu per frame, a pipelined one only the larger of the two
+		const auto frame_ms = vulkan.last_frame_begin.time_since_epoch().count() == 0 ? 0.0 :
+			std::chrono::duration<double, std::milli>(frame_begin - vulkan.last_frame_begin).count();
+		vulkan.last_frame_begin = frame_begin;
+
+		timings.cpu_ms = elapsed_ms(frame_begin) - timings.fence_wait_ms - timings.acquire_ms;
+		timings.frame_ms = frame_ms;
+		timings.overlap = frame_ms > 0.0 ? std::clamp(1.0 - timings.fence_wait_ms / frame_ms, 0.0, 1.0) : 0.0;
 	}
 
 	auto clean_up_swapchain(vulkan_data& vulkan) -> void
 	{
-		vkDestroyImageView(vulkan.device, vulkan.depth_image_view, nullptr);
-		vkDestroyImage(vulkan.device, vulkan.depth_image, nullptr);
-		vkFreeMemory(vulkan.device, vulkan.depth_image_memory, nullptr);
-
-		for (size_t i = 0; i < vulkan.frame_buffers.size(); i++)
-		{
-			vkDestroyFramebuffer(vulkan.device, vulkan.frame_buffers[i], nullptr);
-		}
+		// the graph's transients and framebuffers are replaced when it is realized again
 
 		for (size_t i = 0; i < vulkan.image_views.size(); i++)
 		{
@@ -1951,45 +1925,50 @@ namespace Mythos::vulkan
 
 		create_swapchain(hwnd, vulkan);
 		create_image_views(vulkan);
-		create_color_resources(vulkan);
-		create_depth_resources(vulkan);
-		create_frame_buffers(vulkan);
+		create_frame_resources(vulkan);
 	}
 
 	auto destroy_vulkan_data(vulkan_data& vulkan) -> void
 	{
-		clean_up_swapchain(vulkan);
+		// frames are no longer waited on as they are submitted, let the last ones finish
+		vkDeviceWaitIdle(vulkan.device);
 
-		vkDestroyImageView(vulkan.device, vulkan.color_image_view, nullptr);
-		vkDestroyImage(vulkan.device, vulkan.color_image, nullptr);
-		vkFreeMemory(vulkan.device, vulkan.color_image_memory, nullptr);
+		clean_up_swapchain(vulkan);
+		vulkan.graph.destroy();
 
 		vkDestroySampler(vulkan.device, vulkan.texture_sampler, nullptr);
-		vkDestroyImageView(vulkan.device, vulkan.texture_image_view, nullptr);
 
-		vkDestroyImage(vulkan.device, vulkan.texture_image, nullptr);
-		vkFreeMemory(vulkan.device, vulkan.texture_image_memory, nullptr);
+		// loads still decoding are let finish, their results are never uploaded
+		vulkan.assets.wait_idle();
+
+		for (auto& texture : vulkan.assets.textures())
+		{
+			vkDestroyImageView(vulkan.device, texture.view, nullptr);
+			destroy_image(texture.image, texture.allocation, vulkan);
+		}
+
+		vkDestroyImageView(vulkan.device, vulkan.placeholder_texture.view, nullptr);
+		destroy_image(vulkan.placeholder_texture.image, vulkan.placeholder_texture.allocation, vulkan);
 
 		for (size_t i = 0; i < vulkan.MAX_FRAMES_IN_FLIGHT; i++)
 		{
-			vkDestroyBuffer(vulkan.device, vulkan.uniform_buffers[i], nullptr);
-			vkFreeMemory(vulkan.device, vulkan.uniform_buffers_memory[i], nullptr);
+			destroy_buffer(vulkan.uniform_buffers[i], vulkan.uniform_buffers_allocation[i], vulkan);
 		}
 
-		vkDestroyDescriptorPool(vulkan.device, vulkan.descriptor_pool, nullptr);
+		vulkan.descriptors.destroy();
+		vulkan.textures.destroy();
 		vkDestroyDescriptorSetLayout(vulkan.device, vulkan.descriptor_set_layout, nullptr);
+		vkDestroyDescriptorSetLayout(vulkan.device, vulkan.texture_set_layout, nullptr);
 
-		vkDestroyBuffer(vulkan.device, vulkan.index_buffer, nullptr);
-		vkFreeMemory(vulkan.device, vulkan.index_buffer_memory, nullptr);
-
-		vkDestroyBuffer(vulkan.device, vulkan.vertex_buffer, nullptr);
-		vkFreeMemory(vulkan.device, vulkan.vertex_buffer_memory, nullptr);
+		for (auto& mesh : vulkan.assets.meshes())
+		{
+			destroy_buffer(mesh.index_buffer, mesh.index_allocation, vulkan);
+			destroy_buffer(mesh.vertex_buffer, mesh.vertex_allocation, vulkan);
+		}
 
-		vkDestroyPipeline(vulkan.device, vulkan.graphics_pipeline, nullptr);
+		vulkan.pipelines.destroy();
 		vkDestroyPipelineLayout(vulkan.device, vulkan.pipeline_layout, nullptr);
 
-		vkDestroyRenderPass(vulkan.device, vulkan.render_pass, nullptr);
-
 		for (auto i = 0; i < vulkan.MAX_FRAMES_IN_FLIGHT; i++)
 		{
 			vkDestroySemaphore(vulkan.device, vulkan.image_available_semaphores[i], nullptr);
@@ -1997,7 +1976,15 @@ namespace Mythos::vulkan
 			vkDestroyFence(vulkan.device, vulkan.in_flight_fences[i], nullptr);
 		}
 
-		vkDestroyCommandPool(vulkan.device, vulkan.command_pool, nullptr);
+		vulkan.recorder.destroy();
+		vulkan.gpu_profile.destroy();
+		vulkan.batcher.destroy();
+		vulkan.pyramid.destroy();
+
+		vulkan.uploader.destroy();
+
+		vulkan.allocator.log_stats();
+		vulkan.allocator.destroy();
 
 		vkDestroyDevice(vulkan.device, nullptr);
 
@@ -2007,39 +1994,13 @@ namespace Mythos::vulkan
 		Debug::log_header("Vulkan objects destroyed");
 	}
 
-	auto create_depth_resources(vulkan_data& vulkan) -> bool
-	{
-		VkFormat depthFormat = find_depth_format(vulkan);
-
-		auto& extent = vulkan.swapchain_extents;
-		create_image(extent.width, extent.height, 1, vulkan.msaa_samples, depthFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vulkan.depth_image, vulkan.depth_image_memory, vulkan);
-		vulkan.depth_image_view = create_image_view(vulkan.depth_image, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT, 1, vulkan);
-		return true;
-	}
-
-	auto create_color_resources(vulkan_data& vulkan) -> bool
-	{
-		auto& colorFormat = vulkan.swapchain_surface_format.format;
-		auto& extent = vulkan.swapchain_extents;
-		create_image(extent.width, extent.height, 1, vulkan.msaa_samples, colorFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vulkan.color_image, vulkan.color_image_memory, vulkan);
-		vulkan.color_image_view = create_image_view(vulkan.color_image, colorFormat, VK_IMAGE_ASPECT_COLOR_BIT, 1, vulkan);
-
-		return true;
-	}
-
-	auto get_max_usable_sample_count(vulkan_data& vulkan) -> VkSampleCountFlagBits
+	auto get_usable_sample_count(vulkan_data& vulkan) -> VkSampleCountFlagBits
 	{
 		VkPhysicalDeviceProperties physicalDeviceProperties;
 		vkGetPhysicalDeviceProperties(vulkan.physical_device, &physicalDeviceProperties);
 
+		// the device's highest count used to be taken, a cost every pixel pays for edges few of them have
 		VkSampleCountFlags counts = physicalDeviceProperties.limits.framebufferColorSampleCounts & physicalDeviceProperties.limits.framebufferDepthSampleCounts;
-		if (counts & VK_SAMPLE_COUNT_64_BIT) { return VK_SAMPLE_COUNT_64_BIT; }
-		if (counts & VK_SAMPLE_COUNT_32_BIT) { return VK_SAMPLE_COUNT_32_BIT; }
-		if (counts & VK_SAMPLE_COUNT_16_BIT) { return VK_SAMPLE_COUNT_16_BIT; }
-		if (counts & VK_SAMPLE_COUNT_8_BIT) { return VK_SAMPLE_COUNT_8_BIT; }
-		if (counts & VK_SAMPLE_COUNT_4_BIT) { return VK_SAMPLE_COUNT_4_BIT; }
-		if (counts & VK_SAMPLE_COUNT_2_BIT) { return VK_SAMPLE_COUNT_2_BIT; }
-
-		return VK_SAMPLE_COUNT_1_BIT;
+		return choose_sample_count(counts, vulkan.settings.max_samples);
 	}
 }
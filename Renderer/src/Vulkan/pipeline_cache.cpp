@@ -0,0 +1,458 @@
+#include "Vulkan/pipeline_cache.hpp"
+
+// STL
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+// Mythos
+#include "Debug.hpp"
+#include "Shader/shader.hpp"
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	template<typename T>
+	static auto same_bytes(const std::vector<T>& a, const std::vector<T>& b) -> bool
+	{
+		return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+	}
+
+	bool operator==(const pipeline_state& a, const pipeline_state& b)
+	{
+		return a.vertex_shader == b.vertex_shader && a.fragment_shader == b.fragment_shader &&
+			a.vertex_constants == b.vertex_constants &&
+			same_bytes(a.bindings, b.bindings) && same_bytes(a.attributes, b.attributes) &&
+			a.layout == b.layout && a.render_pass == b.render_pass && a.subpass == b.subpass &&
+			a.samples == b.samples && a.min_sample_shading == b.min_sample_shading && a.cull_mode == b.cull_mode &&
+			a.blend == b.blend && a.depth_test == b.depth_test && a.depth_write == b.depth_write &&
+			a.depth_compare == b.depth_compare;
+	}
+
+	// fnv-1a, the descriptions are plain uint32 fields without padding so their bytes hash as they compare
+	static auto hash_bytes(uint64_t hash, const void* data, size_t size) -> uint64_t
+	{
+		const auto* bytes = static_cast<const uint8_t*>(data);
+
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+		}
+
+		return hash;
+	}
+
+	template<typename T>
+	static auto hash_value(uint64_t hash, const T& value) -> uint64_t
+	{
+		return hash_bytes(hash, &value, sizeof(T));
+	}
+
+	auto hash_pipeline_state(const pipeline_state& state) -> uint64_t
+	{
+		auto hash = 0xCBF29CE484222325ull;
+
+		// sizes go in ahead of the contents so neighbouring fields cannot trade bytes
+		hash = hash_value(hash, state.vertex_shader.size());
+		hash = hash_bytes(hash, state.vertex_shader.data(), state.vertex_shader.size());
+		hash = hash_value(hash, state.fragment_shader.size());
+		hash = hash_bytes(hash, state.fragment_shader.data(), state.fragment_shader.size());
+		hash = hash_value(hash, state.vertex_constants.size());
+		hash = hash_bytes(hash, state.vertex_constants.data(), state.vertex_constants.size() * sizeof(uint32_t));
+		hash = hash_value(hash, state.bindings.size());
+		hash = hash_bytes(hash, state.bindings.data(), state.bindings.size() * sizeof(VkVertexInputBindingDescription));
+		hash = hash_value(hash, state.attributes.size());
+		hash = hash_bytes(hash, state.attributes.data(), state.attributes.size() * sizeof(VkVertexInputAttributeDescription));
+
+		hash = hash_value(hash, state.layout);
+		hash = hash_value(hash, state.render_pass);
+		hash = hash_value(hash, state.subpass);
+		hash = hash_value(hash, state.samples);
+		hash = hash_value(hash, state.min_sample_shading);
+		hash = hash_value(hash, state.cull_mode);
+
+		const auto flags = (state.blend ? 1u : 0u) | (state.depth_test ? 2u : 0u) | (state.depth_write ? 4u : 0u);
+		hash = hash_value(hash, flags);
+		hash = hash_value(hash, state.depth_compare);
+
+		return hash;
+	}
+
+	bool pipeline_cache::create(VkDevice device, VkPhysicalDevice physical_device, const std::string& path)
+	{
+		device_ = device;
+		path_ = path;
+		vkGetPhysicalDeviceProperties(physical_device, &properties_);
+
+		// a missing file is the first run, not an error
+		auto data = std::vector<char>();
+		if (auto file = std::ifstream(path, std::ios::ate | std::ios::binary); file.is_open())
+		{
+			data.resize(static_cast<size_t>(file.tellg()));
+			file.seekg(0);
+			file.read(data.data(), static_cast<std::streamsize>(data.size()));
+		}
+
+		if (!data.empty() && !validate(data))
+		{
+			Debug::warn("Vulkan pipeline cache : " + path + " was written by another device or driver, starting empty");
+			data.clear();
+		}
+
+		const auto cache_info = VkPipelineCacheCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+			.initialDataSize = data.size(),
+			.pInitialData = data.empty() ? nullptr : data.data(),
+		};
+
+		if (vkCreatePipelineCache(device_, &cache_info, nullptr, &cache_) != VK_SUCCESS)
+		{
+			Debug::error("Vulkan failed to create the pipeline cache");
+			return false;
+		}
+
+		Debug::log("Vulkan pipeline cache created : " + (data.empty() ? std::string("empty") : std::to_string(data.size()) + " bytes from " + path));
+		return true;
+	}
+
+	void pipeline_cache::destroy()
+	{
+		if (device_ == VK_NULL_HANDLE) return;
+
+		save();
+
+		for (auto& [state, pipeline] : pipelines_)
+		{
+			vkDestroyPipeline(device_, pipeline, nullptr);
+		}
+		pipelines_.clear();
+
+		for (auto& [path, module] : modules_)
+		{
+			vkDestroyShaderModule(device_, module, nullptr);
+		}
+		modules_.clear();
+
+		vkDestroyPipelineCache(device_, cache_, nullptr);
+		cache_ = VK_NULL_HANDLE;
+
+		device_ = VK_NULL_HANDLE;
+	}
+
+	bool pipeline_cache::save() const
+	{
+		if (cache_ == VK_NULL_HANDLE) return false;
+
+		auto size = size_t();
+		if (vkGetPipelineCacheData(device_, cache_, &size, nullptr) != VK_SUCCESS || size == 0) return false;
+
+		auto data = std::vector<char>(size);
+		if (vkGetPipelineCacheData(device_, cache_, &size, data.data()) != VK_SUCCESS) return false;
+
+		const auto temporary = path_ + ".tmp";
+
+		{
+			auto file = std::ofstream(temporary, std::ios::binary | std::ios::trunc);
+			if (!file.is_open() || !file.write(data.data(), static_cast<std::streamsize>(size)))
+			{
+				Debug::warn("Vulkan pipeline cache : failed to write " + temporary);
+				return false;
+			}
+		}
+
+		auto error = std::error_code();
+		std::filesystem::rename(temporary, path_, error);
+
+		if (error)
+		{
+			Debug::warn("Vulkan pipeline cache : failed to replace " + path_ + ", " + error.message());
+			return false;
+		}
+
+		Debug::log("Vulkan pipeline cache saved : " + std::to_string(size) + " bytes to " + path_);
+		return true;
+	}
+
+	VkPipeline pipeline_cache::get(const pipeline_state& state)
+	{
+		{
+			const auto lock = std::lock_guard(mutex_);
+
+			if (const auto found = pipelines_.find(state); found != pipelines_.end())
+			{
+				stats_.hits++;
+				return found->second;
+			}
+		}
+
+		const auto pipeline = build(state);
+		if (pipeline == VK_NULL_HANDLE) return VK_NULL_HANDLE;
+
+		const auto lock = std::lock_guard(mutex_);
+		const auto [entry, inserted] = pipelines_.try_emplace(state, pipeline);
+
+		if (!inserted)
+		{
+			vkDestroyPipeline(device_, pipeline, nullptr);
+		}
+		else
+		{
+			stats_.pipelines++;
+		}
+
+		return entry->second;
+	}
+
+	void pipeline_cache::prewarm(const std::vector<pipeline_state>& states, job_system* jobs)
+	{
+		const auto count = static_cast<uint32_t>(states.size());
+		const auto begin = std::chrono::steady_clock::now();
+
+		const auto build_range = [&](uint32_t first, uint32_t last)
+		{
+			for (auto i = first; i < last; i++)
+			{
+				get(states[i]);
+			}
+		};
+
+		// one pipeline per job, each one is milliseconds of driver compilation
+		if (jobs != nullptr && count > 1)
+		{
+			jobs->parallel_for(count, 1, build_range);
+		}
+		else
+		{
+			build_range(0, count);
+		}
+
+		const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+		Debug::log("Vulkan pipeline cache : " + std::to_string(count) + " pipelines ready in " + std::to_string(elapsed) + "ms");
+	}
+
+	VkPipelineCache pipeline_cache::handle() const
+	{
+		return cache_;
+	}
+
+	pipeline_cache_stats pipeline_cache::stats() const
+	{
+		const auto lock = std::lock_guard(mutex_);
+		return stats_;
+	}
+
+	bool pipeline_cache::validate(const std::vector<char>& data) const
+	{
+		auto header = VkPipelineCacheHeaderVersionOne();
+		if (data.size() < sizeof(header)) return false;
+
+		std::memcpy(&header, data.data(), sizeof(header));
+
+		return header.headerSize >= sizeof(header) &&
+			header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+			header.vendorID == properties_.vendorID &&
+			header.deviceID == properties_.deviceID &&
+			std::memcmp(header.pipelineCacheUUID, properties_.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+	}
+
+	VkShaderModule pipeline_cache::shader_module(const std::string& path)
+	{
+		const auto lock = std::lock_guard(mutex_);
+
+		if (const auto found = modules_.find(path); found != modules_.end()) return found->second;
+
+		const auto code = shader::read_file(path);
+		if (code.empty()) return VK_NULL_HANDLE;
+
+		const auto module_info = VkShaderModuleCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+			.codeSize = code.size(),
+			.pCode = reinterpret_cast<const uint32_t*>(code.data()),
+		};
+
+		auto module = VkShaderModule();
+		if (vkCreateShaderModule(device_, &module_info, nullptr, &module) != VK_SUCCESS)
+		{
+			Debug::error("Vulkan pipeline cache failed to create the shader module of " + path);
+			return VK_NULL_HANDLE;
+		}
+
+		modules_.emplace(path, module);
+		return module;
+	}
+
+	VkPipeline pipeline_cache::build(const pipeline_state& state)
+	{
+		const auto vertex_module = shader_module(state.vertex_shader);
+		const auto fragment_module = shader_module(state.fragment_shader);
+
+		if (vertex_module == VK_NULL_HANDLE || fragment_module == VK_NULL_HANDLE)
+		{
+			Debug::error("Vulkan pipeline cache failed to load the shaders of " + state.vertex_shader);
+			return VK_NULL_HANDLE;
+		}
+
+		auto constant_entries = std::vector<VkSpecializationMapEntry>(state.vertex_constants.size());
+		for (uint32_t i = 0; i < constant_entries.size(); i++)
+		{
+			constant_entries[i] = { i, i * static_cast<uint32_t>(sizeof(uint32_t)), sizeof(uint32_t) };
+		}
+
+		const auto specialization_info = VkSpecializationInfo
+		{
+			.mapEntryCount = static_cast<uint32_t>(constant_entries.size()),
+			.pMapEntries = constant_entries.data(),
+			.dataSize = state.vertex_constants.size() * sizeof(uint32_t),
+			.pData = state.vertex_constants.data(),
+		};
+
+		const VkPipelineShaderStageCreateInfo stages[] =
+		{
+			{
+				.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+				.stage = VK_SHADER_STAGE_VERTEX_BIT,
+				.module = vertex_module,
+				.pName = "main",
+				.pSpecializationInfo = constant_entries.empty() ? nullptr : &specialization_info,
+			},
+			{
+				.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+				.stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+				.module = fragment_module,
+				.pName = "main",
+			},
+		};
+
+		const auto vertex_input = VkPipelineVertexInputStateCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+			.vertexBindingDescriptionCount = static_cast<uint32_t>(state.bindings.size()),
+			.pVertexBindingDescriptions = state.bindings.data(),
+			.vertexAttributeDescriptionCount = static_cast<uint32_t>(state.attributes.size()),
+			.pVertexAttributeDescriptions = state.attributes.data(),
+		};
+
+		const auto input_assembly = VkPipelineInputAssemblyStateCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+			.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+			.primitiveRestartEnable = VK_FALSE,
+		};
+
+		// viewport and scissor are set when recording, a resize never rebuilds a pipeline
+		const auto viewport_state = VkPipelineViewportStateCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+			.viewportCount = 1,
+			.scissorCount = 1,
+		};
+
+		const VkDynamicState dynamic_states[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+
+		const auto dynamic_state = VkPipelineDynamicStateCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+			.dynamicStateCount = 2,
+			.pDynamicStates = dynamic_states,
+		};
+
+		const auto rasterizer = VkPipelineRasterizationStateCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+			.depthClampEnable = VK_FALSE,
+			.rasterizerDiscardEnable = VK_FALSE,
+			.polygonMode = VK_POLYGON_MODE_FILL,
+			.cullMode = state.cull_mode,
+			.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE,
+			.depthBiasEnable = VK_FALSE,
+			.lineWidth = 1.0f,
+		};
+
+		const auto multisampling = VkPipelineMultisampleStateCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+			.rasterizationSamples = state.samples,
+			.sampleShadingEnable = state.min_sample_shading > 0.0f ? VK_TRUE : VK_FALSE,
+			.minSampleShading = state.min_sample_shading,
+		};
+
+		const auto depth_stencil = VkPipelineDepthStencilStateCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+			.depthTestEnable = state.depth_test ? VK_TRUE : VK_FALSE,
+			.depthWriteEnable = state.depth_write ? VK_TRUE : VK_FALSE,
+			.depthCompareOp = state.depth_compare,
+			.depthBoundsTestEnable = VK_FALSE,
+			.stencilTestEnable = VK_FALSE,
+			.minDepthBounds = 0.0f,
+			.maxDepthBounds = 1.0f,
+		};
+
+		const auto blend_attachment = VkPipelineColorBlendAttachmentState
+		{
+			.blendEnable = state.blend ? VK_TRUE : VK_FALSE,
+			.srcColorBlendFactor = state.blend ? VK_BLEND_FACTOR_SRC_ALPHA : VK_BLEND_FACTOR_ONE,
+			.dstColorBlendFactor = state.blend ? VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA : VK_BLEND_FACTOR_ZERO,
+			.colorBlendOp = VK_BLEND_OP_ADD,
+			.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+			.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+			.alphaBlendOp = VK_BLEND_OP_ADD,
+			.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT,
+		};
+
+		const auto color_blend = VkPipelineColorBlendStateCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+			.logicOpEnable = VK_FALSE,
+			.logicOp = VK_LOGIC_OP_COPY,
+			.attachmentCount = 1,
+			.pAttachments = &blend_attachment,
+		};
+
+		const auto pipeline_info = VkGraphicsPipelineCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+			.stageCount = 2,
+			.pStages = stages,
+			.pVertexInputState = &vertex_input,
+			.pInputAssemblyState = &input_assembly,
+			.pViewportState = &viewport_state,
+			.pRasterizationState = &rasterizer,
+			.pMultisampleState = &multisampling,
+			.pDepthStencilState = &depth_stencil,
+			.pColorBlendState = &color_blend,
+			.pDynamicState = &dynamic_state,
+			.layout = state.layout,
+			.renderPass = state.render_pass,
+			.subpass = state.subpass,
+			.basePipelineHandle = VK_NULL_HANDLE,
+			.basePipelineIndex = -1,
+		};
+
+		// the cache is internally synchronized, threads build through it at once
+		const auto begin = std::chrono::steady_clock::now();
+
+		auto pipeline = VkPipeline();
+		const auto result = vkCreateGraphicsPipelines(device_, cache_, 1, &pipeline_info, nullptr, &pipeline);
+
+		const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+		{
+			const auto lock = std::lock_guard(mutex_);
+			stats_.build_ms += elapsed;
+		}
+
+		if (result != VK_SUCCESS)
+		{
+			Debug::error("Vulkan pipeline cache failed to build the pipeline of " + state.vertex_shader);
+			return VK_NULL_HANDLE;
+		}
+
+		return pipeline;
+	}
+}
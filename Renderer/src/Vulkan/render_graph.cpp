@@ -0,0 +1,737 @@
+#include "Vulkan/render_graph.hpp"
+
+// STL
+#include <algorithm>
+
+// Mythos
+#include "Debug.hpp"
+#include "Vulkan/gpu_profiler.hpp"
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	constexpr VkAccessFlags WRITE_ACCESS = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+		VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT |
+		VK_ACCESS_MEMORY_WRITE_BIT;
+
+	constexpr VkImageUsageFlags ATTACHMENT_USAGE = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+
+	auto layout_state(VkImageLayout layout) -> image_state
+	{
+		constexpr auto shader_stages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		constexpr auto depth_stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+		switch (layout)
+		{
+		case VK_IMAGE_LAYOUT_UNDEFINED:
+			return { layout, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0 };
+		case VK_IMAGE_LAYOUT_GENERAL:
+			return { layout, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT };
+		case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+			return { layout, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+			         VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT };
+		case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+			return { layout, depth_stages, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT };
+		case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+		case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+			return { layout, shader_stages, VK_ACCESS_SHADER_READ_BIT };
+		case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+			return { layout, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT };
+		case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+			return { layout, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT };
+		case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+			return { layout, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0 };
+		default:
+			// a layout the renderer does not use yet, correct but slow until it gets a case of its own
+			return { layout, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT };
+		}
+	}
+
+	static auto writes(image_usage usage) -> bool
+	{
+		return usage == image_usage::color_attachment || usage == image_usage::depth_attachment ||
+			usage == image_usage::resolve_attachment || usage == image_usage::storage;
+	}
+
+	static auto attachment(image_usage usage) -> bool
+	{
+		return usage == image_usage::color_attachment || usage == image_usage::depth_attachment ||
+			usage == image_usage::resolve_attachment;
+	}
+
+	static auto usage_flags(image_usage usage) -> VkImageUsageFlags
+	{
+		switch (usage)
+		{
+		case image_usage::color_attachment:
+		case image_usage::resolve_attachment:
+			return VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+		case image_usage::depth_attachment:
+			return VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		case image_usage::storage:
+			return VK_IMAGE_USAGE_STORAGE_BIT;
+		default:
+			return VK_IMAGE_USAGE_SAMPLED_BIT;
+		}
+	}
+
+	// --
+
+	void pass_target::begin(VkCommandBuffer commands, VkSubpassContents contents) const
+	{
+		const auto begin_info = VkRenderPassBeginInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+			.renderPass = render_pass,
+			.framebuffer = framebuffer,
+			.renderArea = { { 0, 0 }, extent },
+			.clearValueCount = static_cast<uint32_t>(clear_values->size()),
+			.pClearValues = clear_values->data(),
+		};
+
+		vkCmdBeginRenderPass(commands, &begin_info, contents);
+	}
+
+	// --
+
+	void render_graph::create(VkDevice device, memory_allocator& allocator)
+	{
+		device_ = device;
+		allocator_ = &allocator;
+	}
+
+	void render_graph::destroy()
+	{
+		if (device_ == VK_NULL_HANDLE) return;
+
+		release_transients();
+
+		for (auto& pass : passes_)
+		{
+			vkDestroyRenderPass(device_, pass.render_pass, nullptr);
+		}
+
+		images_.clear();
+		passes_.clear();
+		device_ = VK_NULL_HANDLE;
+	}
+
+	graph_image render_graph::add_image(const std::string& name, const image_desc& desc)
+	{
+		images_.push_back({ .name = name, .desc = desc });
+		return { static_cast<uint32_t>(images_.size() - 1) };
+	}
+
+	graph_image render_graph::import_image(const std::string& name, const image_desc& desc, bool persistent)
+	{
+		images_.push_back({ .name = name, .desc = desc, .transient = false, .persistent = persistent });
+		return { static_cast<uint32_t>(images_.size() - 1) };
+	}
+
+	void render_graph::present(graph_image image)
+	{
+		images_[image.index].presented = true;
+	}
+
+	graph_pass render_graph::add_pass(const std::string& name, pass_type type, std::vector<image_use> uses, execute_fn execute)
+	{
+		passes_.push_back({ .name = name, .type = type, .uses = std::move(uses), .execute = std::move(execute) });
+		return { static_cast<uint32_t>(passes_.size() - 1) };
+	}
+
+	void render_graph::keep(graph_pass pass)
+	{
+		passes_[pass.index].keep = true;
+	}
+
+	bool render_graph::compile()
+	{
+		// walking back from the frame's results, a pass lives when something alive reads what it writes
+		auto needed = std::vector<bool>(images_.size());
+		for (size_t i = 0; i < images_.size(); i++)
+		{
+			needed[i] = !images_[i].transient;
+		}
+
+		stats_ = {};
+		stats_.passes = static_cast<uint32_t>(passes_.size());
+
+		for (auto p = passes_.size(); p-- > 0;)
+		{
+			auto& pass = passes_[p];
+
+			pass.alive = pass.keep || std::any_of(pass.uses.begin(), pass.uses.end(), [&](const image_use& use)
+			{
+				return writes(use.usage) && needed[use.image.index];
+			});
+
+			if (!pass.alive)
+			{
+				Debug::log("Render graph : culled pass " + pass.name);
+				stats_.culled++;
+				continue;
+			}
+
+			// an attachment that is not cleared loads what an earlier pass left in it
+			for (const auto& use : pass.uses)
+			{
+				if (!writes(use.usage) || (attachment(use.usage) && !use.clear && use.usage != image_usage::resolve_attachment))
+				{
+					needed[use.image.index] = true;
+				}
+			}
+		}
+
+		// lifetimes and usage of the transients, the ones no live pass touches are never created
+		for (uint32_t p = 0; p < passes_.size(); p++)
+		{
+			if (!passes_[p].alive) continue;
+
+			for (const auto& use : passes_[p].uses)
+			{
+				auto& image = images_[use.image.index];
+				image.usage |= usage_flags(use.usage);
+				image.first_pass = std::min(image.first_pass, p);
+				image.last_pass = std::max(image.last_pass, p);
+			}
+		}
+
+		for (auto& image : images_)
+		{
+			// touched by one pass as an attachment only, the contents never reach memory on tiled gpus
+			if (image.transient && image.first_pass == image.last_pass && (image.usage & ~ATTACHMENT_USAGE) == 0)
+			{
+				image.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+			}
+		}
+
+		for (auto& pass : passes_)
+		{
+			if (pass.alive && pass.type == pass_type::graphics && !create_render_pass(pass)) return false;
+		}
+
+		compiled_ = true;
+		Debug::log("Render graph compiled : " + std::to_string(stats_.passes - stats_.culled) + " of " +
+			std::to_string(stats_.passes) + " passes");
+		return true;
+	}
+
+	bool render_graph::realize(VkExtent2D extent)
+	{
+		if (!compiled_) return false;
+
+		release_transients();
+		persistent_states_.clear();
+		extent_ = extent;
+
+		// transients in the order they are first used, each takes the first slot whose images are done with it
+		auto order = std::vector<uint32_t>();
+		for (uint32_t i = 0; i < images_.size(); i++)
+		{
+			if (images_[i].transient && images_[i].first_pass != UINT32_MAX) order.push_back(i);
+		}
+
+		std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b)
+		{
+			return images_[a].first_pass < images_[b].first_pass;
+		});
+
+		for (const auto index : order)
+		{
+			auto& image = images_[index];
+
+			const auto image_info = VkImageCreateInfo
+			{
+				.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+				.imageType = VK_IMAGE_TYPE_2D,
+				.format = image.desc.format,
+				.extent = { extent.width, extent.height, 1 },
+				.mipLevels = 1,
+				.arrayLayers = 1,
+				.samples = image.desc.samples,
+				.tiling = VK_IMAGE_TILING_OPTIMAL,
+				.usage = image.usage,
+				.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+				.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+			};
+
+			if (vkCreateImage(device_, &image_info, nullptr, &image.image) != VK_SUCCESS)
+			{
+				Debug::error("Render graph failed to create image " + image.name);
+				return false;
+			}
+
+			auto requirements = VkMemoryRequirements();
+			vkGetImageMemoryRequirements(device_, image.image, &requirements);
+
+			const auto slot = std::find_if(slots_.begin(), slots_.end(), [&](const memory_slot& candidate)
+			{
+				return candidate.last_pass < image.first_pass &&
+					(candidate.requirements.memoryTypeBits & requirements.memoryTypeBits) != 0;
+			});
+
+			if (slot == slots_.end())
+			{
+				image.slot = static_cast<uint32_t>(slots_.size());
+				slots_.push_back({ .requirements = requirements });
+			}
+			else
+			{
+				image.slot = static_cast<uint32_t>(slot - slots_.begin());
+
+				auto& merged = slot->requirements;
+				merged.size = std::max(merged.size, requirements.size);
+				merged.alignment = std::max(merged.alignment, requirements.alignment);
+				merged.memoryTypeBits &= requirements.memoryTypeBits;
+
+				Debug::log("Render graph : " + image.name + " aliases the memory of an earlier transient");
+			}
+
+			slots_[image.slot].last_pass = image.last_pass;
+		}
+
+		// the first use of a slot in a frame waits on every use of it, in the previous frame or earlier in this one
+		for (const auto& pass : passes_)
+		{
+			if (!pass.alive) continue;
+
+			for (const auto& use : pass.uses)
+			{
+				const auto& image = images_[use.image.index];
+				if (!image.transient) continue;
+
+				const auto state = use_state(use, pass.type);
+				slots_[image.slot].stages |= state.stages;
+				slots_[image.slot].access |= state.access & WRITE_ACCESS;
+			}
+		}
+
+		for (auto& slot : slots_)
+		{
+			if (!allocator_->allocate(slot.requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, resource_kind::optimal, slot.allocation))
+			{
+				Debug::error("Render graph failed to allocate transient memory");
+				return false;
+			}
+
+			stats_.transient_bytes += slot.requirements.size;
+		}
+
+		for (const auto index : order)
+		{
+			auto& image = images_[index];
+			const auto& allocation = slots_[image.slot].allocation;
+			vkBindImageMemory(device_, image.image, allocation.memory, allocation.offset);
+
+			// a depth stencil view is sampled through its depth alone
+			auto aspect = image.desc.aspect;
+			if (aspect & VK_IMAGE_ASPECT_DEPTH_BIT) aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+
+			const auto view_info = VkImageViewCreateInfo
+			{
+				.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+				.image = image.image,
+				.viewType = VK_IMAGE_VIEW_TYPE_2D,
+				.format = image.desc.format,
+				.subresourceRange = { aspect, 0, 1, 0, 1 },
+			};
+
+			if (vkCreateImageView(device_, &view_info, nullptr, &image.view) != VK_SUCCESS)
+			{
+				Debug::error("Render graph failed to create the view of " + image.name);
+				return false;
+			}
+		}
+
+		stats_.transients = static_cast<uint32_t>(order.size());
+		stats_.memory_slots = static_cast<uint32_t>(slots_.size());
+
+		Debug::log("Render graph : " + std::to_string(stats_.transients) + " transients in " +
+			std::to_string(stats_.memory_slots) + " allocations, " + std::to_string(stats_.transient_bytes / 1024) + " KiB");
+		return true;
+	}
+
+	void render_graph::bind(graph_image image, VkImage handle, VkImageView view)
+	{
+		auto& entry = images_[image.index];
+		entry.image = handle;
+		entry.view = view;
+	}
+
+	void render_graph::execute(VkCommandBuffer commands, gpu_profiler* profiler)
+	{
+		// where each image starts the frame
+		for (auto& image : images_)
+		{
+			if (image.transient)
+			{
+				if (image.slot == UINT32_MAX) continue;
+
+				const auto& slot = slots_[image.slot];
+				image.state = { VK_IMAGE_LAYOUT_UNDEFINED, slot.stages, slot.access };
+			}
+			else if (image.persistent)
+			{
+				const auto found = persistent_states_.find(image.image);
+				image.state = found != persistent_states_.end() ? found->second : image_state{};
+			}
+			else
+			{
+				// the acquired swapchain image, the submit waits for it at the color output stage
+				image.state = { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0 };
+			}
+		}
+
+		auto barriers = std::vector<VkImageMemoryBarrier>();
+		auto barrier_count = 0u;
+
+		const auto transition = [&](image_entry& image, const image_state& next, VkPipelineStageFlags& src, VkPipelineStageFlags& dst)
+		{
+			auto& current = image.state;
+
+			// reads in the layout the image is already in only widen what the next writer waits on
+			if (current.layout == next.layout && (current.access & WRITE_ACCESS) == 0 && (next.access & WRITE_ACCESS) == 0)
+			{
+				current.stages |= next.stages;
+				current.access |= next.access;
+				return;
+			}
+
+			barriers.push_back(VkImageMemoryBarrier
+			{
+				.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+				.srcAccessMask = current.access & WRITE_ACCESS,
+				.dstAccessMask = next.access,
+				.oldLayout = current.layout,
+				.newLayout = next.layout,
+				.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.image = image.image,
+				.subresourceRange = { image.desc.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, 1 },
+			});
+
+			src |= current.stages;
+			dst |= next.stages;
+			current = next;
+		};
+
+		const auto flush = [&](VkPipelineStageFlags src, VkPipelineStageFlags dst)
+		{
+			if (barriers.empty()) return;
+
+			vkCmdPipelineBarrier(commands, src, dst, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+			barrier_count += static_cast<uint32_t>(barriers.size());
+			barriers.clear();
+		};
+
+		for (uint32_t p = 0; p < passes_.size(); p++)
+		{
+			auto& pass = passes_[p];
+			if (!pass.alive) continue;
+
+			auto src = VkPipelineStageFlags(0);
+			auto dst = VkPipelineStageFlags(0);
+
+			for (const auto& use : pass.uses)
+			{
+				auto& image = images_[use.image.index];
+				if (image.image == VK_NULL_HANDLE) continue;
+
+				transition(image, use_state(use, pass.type), src, dst);
+			}
+
+			flush(src, dst);
+
+			auto target = pass_target{ .extent = extent_ };
+
+			if (pass.type == pass_type::graphics)
+			{
+				target.render_pass = pass.render_pass;
+				target.framebuffer = framebuffer(p);
+				target.clear_values = &pass.clear_values;
+
+				if (target.framebuffer == VK_NULL_HANDLE) continue;
+			}
+
+			const auto region = profiler != nullptr ? profiler->begin(commands, pass.name.c_str()) : gpu_profiler::NO_REGION;
+
+			pass.execute(commands, target);
+
+			if (pass.type == pass_type::graphics)
+			{
+				vkCmdEndRenderPass(commands);
+			}
+
+			if (profiler != nullptr) profiler->end(commands, region);
+		}
+
+		// hand the presented images to the presentation engine, remember where the persistent ones were left
+		auto src = VkPipelineStageFlags(0);
+		auto dst = VkPipelineStageFlags(0);
+
+		for (auto& image : images_)
+		{
+			if (image.image == VK_NULL_HANDLE) continue;
+
+			if (image.presented)
+			{
+				transition(image, layout_state(VK_IMAGE_LAYOUT_PRESENT_SRC_KHR), src, dst);
+			}
+			else if (image.persistent)
+			{
+				persistent_states_[image.image] = image.state;
+			}
+		}
+
+		flush(src, dst);
+		stats_.barriers = barrier_count;
+	}
+
+	VkRenderPass render_graph::render_pass(graph_pass pass) const
+	{
+		return passes_[pass.index].render_pass;
+	}
+
+	VkImage render_graph::image(graph_image image) const
+	{
+		return images_[image.index].image;
+	}
+
+	VkImageView render_graph::view(graph_image image) const
+	{
+		return images_[image.index].view;
+	}
+
+	bool render_graph::alive(graph_pass pass) const
+	{
+		return passes_[pass.index].alive;
+	}
+
+	const graph_stats& render_graph::stats() const
+	{
+		return stats_;
+	}
+
+	bool render_graph::create_render_pass(pass_entry& pass)
+	{
+		const auto pass_index = static_cast<uint32_t>(&pass - passes_.data());
+
+		auto attachments = std::vector<VkAttachmentDescription>();
+		auto color_refs = std::vector<VkAttachmentReference>();
+		auto resolve_refs = std::vector<VkAttachmentReference>();
+		auto depth_ref = VkAttachmentReference{ VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_UNDEFINED };
+
+		pass.attachments.clear();
+		pass.clear_values.clear();
+
+		// colors, then depth, then resolves, the order the framebuffer is made in
+		const auto add = [&](const image_use& use)
+		{
+			const auto& image = images_[use.image.index];
+			const auto layout = use_state(use, pass.type).layout;
+
+			auto load = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			if (use.clear) load = VK_ATTACHMENT_LOAD_OP_CLEAR;
+			else if (written_before(use.image.index, pass_index)) load = VK_ATTACHMENT_LOAD_OP_LOAD;
+
+			// nothing after the pass reads it, the tile never has to be written out
+			const auto store = read_later(use.image.index, pass_index) ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+			attachments.push_back(VkAttachmentDescription
+			{
+				.format = image.desc.format,
+				.samples = image.desc.samples,
+				.loadOp = load,
+				.storeOp = store,
+				.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+				.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+				.initialLayout = layout,
+				.finalLayout = layout,
+			});
+
+			pass.attachments.push_back(use.image);
+			pass.clear_values.push_back(use.clear_value);
+
+			return VkAttachmentReference{ static_cast<uint32_t>(attachments.size() - 1), layout };
+		};
+
+		for (const auto& use : pass.uses)
+		{
+			if (use.usage == image_usage::color_attachment) color_refs.push_back(add(use));
+		}
+
+		for (const auto& use : pass.uses)
+		{
+			if (use.usage == image_usage::depth_attachment) depth_ref = add(use);
+		}
+
+		for (const auto& use : pass.uses)
+		{
+			if (use.usage == image_usage::resolve_attachment) resolve_refs.push_back(add(use));
+		}
+
+		if (!resolve_refs.empty() && resolve_refs.size() != color_refs.size())
+		{
+			Debug::error("Render graph : pass " + pass.name + " resolves " + std::to_string(resolve_refs.size()) +
+				" of " + std::to_string(color_refs.size()) + " color attachments");
+			return false;
+		}
+
+		const auto subpass = VkSubpassDescription
+		{
+			.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+			.colorAttachmentCount = static_cast<uint32_t>(color_refs.size()),
+			.pColorAttachments = color_refs.data(),
+			.pResolveAttachments = resolve_refs.empty() ? nullptr : resolve_refs.data(),
+			.pDepthStencilAttachment = depth_ref.attachment != VK_ATTACHMENT_UNUSED ? &depth_ref : nullptr,
+		};
+
+		// no dependencies, the layouts never change inside the pass and the graph's barriers order it with the others
+		const auto render_pass_info = VkRenderPassCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+			.attachmentCount = static_cast<uint32_t>(attachments.size()),
+			.pAttachments = attachments.data(),
+			.subpassCount = 1,
+			.pSubpasses = &subpass,
+		};
+
+		if (vkCreateRenderPass(device_, &render_pass_info, nullptr, &pass.render_pass) != VK_SUCCESS)
+		{
+			Debug::error("Render graph failed to create the render pass of " + pass.name);
+			return false;
+		}
+
+		return true;
+	}
+
+	VkFramebuffer render_graph::framebuffer(uint32_t pass)
+	{
+		const auto& entry = passes_[pass];
+
+		auto views = std::vector<VkImageView>();
+		for (const auto image : entry.attachments)
+		{
+			views.push_back(images_[image.index].view);
+		}
+
+		// imported attachments change from frame to frame, one framebuffer per set of views seen since the last realize
+		const auto found = std::find_if(framebuffers_.begin(), framebuffers_.end(), [&](const framebuffer_entry& cached)
+		{
+			return cached.pass == pass && cached.views == views;
+		});
+
+		if (found != framebuffers_.end()) return found->framebuffer;
+
+		const auto framebuffer_info = VkFramebufferCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+			.renderPass = entry.render_pass,
+			.attachmentCount = static_cast<uint32_t>(views.size()),
+			.pAttachments = views.data(),
+			.width = extent_.width,
+			.height = extent_.height,
+			.layers = 1,
+		};
+
+		auto framebuffer = VkFramebuffer();
+		if (vkCreateFramebuffer(device_, &framebuffer_info, nullptr, &framebuffer) != VK_SUCCESS)
+		{
+			Debug::error("Render graph failed to create a framebuffer for " + entry.name);
+			return VK_NULL_HANDLE;
+		}
+
+		framebuffers_.push_back({ pass, std::move(views), framebuffer });
+		return framebuffer;
+	}
+
+	void render_graph::release_transients()
+	{
+		for (auto& cached : framebuffers_)
+		{
+			vkDestroyFramebuffer(device_, cached.framebuffer, nullptr);
+		}
+		framebuffers_.clear();
+
+		for (auto& image : images_)
+		{
+			if (!image.transient) continue;
+
+			vkDestroyImageView(device_, image.view, nullptr);
+			vkDestroyImage(device_, image.image, nullptr);
+
+			image.view = VK_NULL_HANDLE;
+			image.image = VK_NULL_HANDLE;
+			image.slot = UINT32_MAX;
+		}
+
+		for (auto& slot : slots_)
+		{
+			if (slot.allocation.memory != VK_NULL_HANDLE) allocator_->free(slot.allocation);
+		}
+		slots_.clear();
+
+		stats_.transient_bytes = 0;
+	}
+
+	image_state render_graph::use_state(const image_use& use, pass_type type) const
+	{
+		const auto shader_stage = type == pass_type::graphics ? VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT : VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+		switch (use.usage)
+		{
+		case image_usage::color_attachment:
+		case image_usage::resolve_attachment:
+			return layout_state(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+		case image_usage::depth_attachment:
+			return layout_state(VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+		case image_usage::sampled:
+			return { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, shader_stage, VK_ACCESS_SHADER_READ_BIT };
+		case image_usage::depth_sampled:
+			return { VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, shader_stage, VK_ACCESS_SHADER_READ_BIT };
+		case image_usage::general_read:
+			return { VK_IMAGE_LAYOUT_GENERAL, shader_stage, VK_ACCESS_SHADER_READ_BIT };
+		case image_usage::storage:
+			return { VK_IMAGE_LAYOUT_GENERAL, shader_stage, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT };
+		}
+
+		return {};
+	}
+
+	bool render_graph::read_later(uint32_t image, uint32_t pass) const
+	{
+		const auto& entry = images_[image];
+		if (!entry.transient) return true;
+
+		for (auto p = pass + 1; p < passes_.size(); p++)
+		{
+			if (!passes_[p].alive) continue;
+
+			for (const auto& use : passes_[p].uses)
+			{
+				if (use.image.index == image) return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool render_graph::written_before(uint32_t image, uint32_t pass) const
+	{
+		if (images_[image].persistent) return true;
+
+		for (uint32_t p = 0; p < pass; p++)
+		{
+			if (!passes_[p].alive) continue;
+
+			for (const auto& use : passes_[p].uses)
+			{
+				if (use.image.index == image && writes(use.usage)) return true;
+			}
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,111 @@
+#include "Vulkan/render_settings.hpp"
+
+// STL
+#include <algorithm>
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	render_settings render_settings::from_policy(frame_policy policy)
+	{
+		switch (policy)
+		{
+		case frame_policy::low_latency:
+			// immediate may tear, mailbox never does but holds one more image
+			return render_settings
+			{
+				.max_samples = 1,
+				.present_modes = { VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_FIFO_KHR },
+				.image_count = 2,
+				.frames_in_flight = 1,
+			};
+		case frame_policy::quality:
+			return render_settings
+			{
+				.max_samples = 8,
+				.present_modes = { VK_PRESENT_MODE_FIFO_KHR },
+				.image_count = 3,
+				.frames_in_flight = 2,
+			};
+		case frame_policy::balanced:
+		default:
+			return render_settings{};
+		}
+	}
+
+	auto policy_name(frame_policy policy) -> const char*
+	{
+		switch (policy)
+		{
+		case frame_policy::low_latency: return "low latency";
+		case frame_policy::balanced: return "balanced";
+		case frame_policy::quality: return "quality";
+		}
+
+		return "unknown";
+	}
+
+	auto present_mode_name(VkPresentModeKHR mode) -> const char*
+	{
+		switch (mode)
+		{
+		case VK_PRESENT_MODE_IMMEDIATE_KHR: return "immediate";
+		case VK_PRESENT_MODE_MAILBOX_KHR: return "mailbox";
+		case VK_PRESENT_MODE_FIFO_KHR: return "fifo";
+		case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "fifo relaxed";
+		default: return "other";
+		}
+	}
+
+	auto choose_sample_count(VkSampleCountFlags supported, uint32_t max_samples) -> VkSampleCountFlagBits
+	{
+		// the flag bits are the counts themselves
+		for (auto count = 64u; count > 1; count /= 2)
+		{
+			if (count <= max_samples && (supported & count) != 0)
+			{
+				return static_cast<VkSampleCountFlagBits>(count);
+			}
+		}
+
+		return VK_SAMPLE_COUNT_1_BIT;
+	}
+
+	auto choose_present_mode(const std::vector<VkPresentModeKHR>& available, const std::vector<VkPresentModeKHR>& preferred) -> VkPresentModeKHR
+	{
+		for (const auto mode : preferred)
+		{
+			if (std::find(available.begin(), available.end(), mode) != available.end()) return mode;
+		}
+
+		return VK_PRESENT_MODE_FIFO_KHR;
+	}
+
+	auto choose_image_count(const VkSurfaceCapabilitiesKHR& capabilities, uint32_t requested) -> uint32_t
+	{
+		auto count = std::max(requested, capabilities.minImageCount);
+
+		if (capabilities.maxImageCount > 0)
+		{
+			count = std::min(count, capabilities.maxImageCount);
+		}
+
+		return count;
+	}
+
+	auto choose_surface_format(const std::vector<VkSurfaceFormatKHR>& available, bool srgb) -> VkSurfaceFormatKHR
+	{
+		if (srgb)
+		{
+			for (const auto& format : available)
+			{
+				const auto srgb_format = format.format == VK_FORMAT_B8G8R8A8_SRGB || format.format == VK_FORMAT_R8G8B8A8_SRGB;
+				if (srgb_format && format.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) return format;
+			}
+		}
+
+		return available.front();
+	}
+}
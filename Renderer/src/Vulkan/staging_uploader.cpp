@@ -0,0 +1,448 @@
+#include "Vulkan/staging_uploader.hpp"
+
+// STL
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+// Mythos
+#include "Debug.hpp"
+
+// --
+namespace Mythos::vulkan
+{
+	// --
+
+	static auto align_up(VkDeviceSize value, VkDeviceSize alignment) -> VkDeviceSize
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	bool staging_uploader::create(VkDevice device, VkQueue queue, uint32_t queue_family, memory_allocator& allocator,
+	                              VkDeviceSize ring_size)
+	{
+		device_ = device;
+		queue_ = queue;
+		allocator_ = &allocator;
+		ring_size_ = ring_size;
+
+		const auto pool_info = VkCommandPoolCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+			.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+			.queueFamilyIndex = queue_family,
+		};
+
+		if (vkCreateCommandPool(device_, &pool_info, nullptr, &command_pool_) != VK_SUCCESS)
+		{
+			Debug::error("Vulkan staging uploader failed to create its command pool");
+			return false;
+		}
+
+		const auto fence_info = VkFenceCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+		};
+
+		for (auto& item : batches_)
+		{
+			const auto allocate_info = VkCommandBufferAllocateInfo
+			{
+				.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+				.commandPool = command_pool_,
+				.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+				.commandBufferCount = 1,
+			};
+
+			if (vkAllocateCommandBuffers(device_, &allocate_info, &item.commands) != VK_SUCCESS ||
+				vkCreateFence(device_, &fence_info, nullptr, &item.fence) != VK_SUCCESS)
+			{
+				Debug::error("Vulkan staging uploader failed to create its batches");
+				return false;
+			}
+		}
+
+		if (!create_buffer(ring_size_, ring_, ring_allocation_))
+		{
+			Debug::error("Vulkan staging uploader failed to create the ring buffer");
+			return false;
+		}
+
+		Debug::log("Vulkan staging uploader created : " + std::to_string(ring_size_ / (1024 * 1024)) + "MB ring, " +
+			std::to_string(BATCH_COUNT) + " batches");
+		return true;
+	}
+
+	void staging_uploader::destroy()
+	{
+		if (device_ == VK_NULL_HANDLE) return;
+
+		wait_idle();
+
+		// every batch has retired, a dedicated buffer still held means one was never submitted or released
+		if (!oversized_.empty() || std::ranges::any_of(batches_, [](const batch& item) { return !item.oversized.empty(); }))
+		{
+			Debug::error("Vulkan staging uploader : oversized uploads were never released");
+
+			completed_value_ = UINT64_MAX;
+			release_oversized();
+		}
+
+		Debug::log("Vulkan staging uploader : " + std::to_string(stats_.uploads) + " uploads, " +
+			std::to_string(stats_.bytes_staged) + " bytes in " + std::to_string(stats_.batches_submitted) + " batches, " +
+			std::to_string(stats_.ring_stalls) + " ring stalls, " + std::to_string(stats_.oversized_uploads) + " oversized");
+
+		if (ring_ != VK_NULL_HANDLE)
+		{
+			vkDestroyBuffer(device_, ring_, nullptr);
+			allocator_->free(ring_allocation_);
+		}
+
+		for (auto& item : batches_)
+		{
+			vkDestroyFence(device_, item.fence, nullptr);
+		}
+
+		// frees the command buffers with it
+		vkDestroyCommandPool(device_, command_pool_, nullptr);
+
+		device_ = VK_NULL_HANDLE;
+	}
+
+	bool staging_uploader::stage(const void* data, VkDeviceSize size, VkDeviceSize alignment, staging_region& region)
+	{
+		if (size > ring_size_)
+		{
+			return stage_oversized(data, size, region);
+		}
+
+		auto offset = VkDeviceSize();
+
+		while (true)
+		{
+			if (!begin_batch()) return false;
+			if (reserve(size, alignment, offset)) break;
+
+			// the ring is full, flush what this batch holds and wait for the oldest batch to give its space back
+			stats_.ring_stalls++;
+
+			if (batches_[current_].has_work())
+			{
+				submit();
+			}
+
+			if (pending_.empty())
+			{
+				Debug::error("Vulkan staging uploader could not reserve " + std::to_string(size) + " bytes");
+				return false;
+			}
+
+			retire(true);
+		}
+
+		std::memcpy(static_cast<char*>(ring_allocation_.mapped) + offset, data, static_cast<size_t>(size));
+
+		region.commands = batches_[current_].commands;
+		region.buffer = ring_;
+		region.offset = offset;
+
+		stats_.uploads++;
+		stats_.bytes_staged += size;
+		return true;
+	}
+
+	uint64_t staging_uploader::submit()
+	{
+		// reclaim whatever the gpu already finished, submit is called every frame
+		retire(false);
+
+		auto& item = batches_[current_];
+		if (!item.recording) return 0;
+
+		// one barrier for the whole batch makes every copy visible to whatever reads it next
+		const auto barrier = VkMemoryBarrier
+		{
+			.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+			.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+			.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+				VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
+		};
+
+		vkCmdPipelineBarrier(item.commands, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+		vkEndCommandBuffer(item.commands);
+
+		const auto submit_info = VkSubmitInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+			.commandBufferCount = 1,
+			.pCommandBuffers = &item.commands,
+		};
+
+		item.recording = false;
+
+		// the fence would never signal, nothing waits on the batch and what it held is given back now
+		if (vkQueueSubmit(queue_, 1, &submit_info, item.fence) != VK_SUCCESS)
+		{
+			Debug::error("Vulkan staging uploader failed to submit a batch, its uploads are lost");
+			abandon(item);
+			return 0;
+		}
+
+		item.value = next_value_++;
+
+		// the batch slot is reused long before some of these buffers may go, they follow the value they complete at
+		for (auto& [buffer, allocation] : item.oversized)
+		{
+			oversized_.push_back({ item.value, buffer, allocation });
+		}
+		item.oversized.clear();
+
+		pending_.push_back(current_);
+		stats_.batches_submitted++;
+		return item.value;
+	}
+
+	bool staging_uploader::is_complete(uint64_t value)
+	{
+		retire(false);
+		return completed_value_ >= value;
+	}
+
+	void staging_uploader::wait(uint64_t value)
+	{
+		// the value may belong to the batch still being recorded
+		if (value >= next_value_)
+		{
+			submit();
+		}
+
+		while (completed_value_ < value && !pending_.empty())
+		{
+			retire(true);
+		}
+	}
+
+	void staging_uploader::wait_idle()
+	{
+		submit();
+
+		while (!pending_.empty())
+		{
+			retire(true);
+		}
+	}
+
+	const staging_stats& staging_uploader::stats() const
+	{
+		return stats_;
+	}
+
+	bool staging_uploader::begin_batch()
+	{
+		if (batches_[current_].recording) return true;
+
+		// every slot is in flight, the oldest has to finish before its command buffer can be reused
+		if (pending_.size() == BATCH_COUNT)
+		{
+			retire(true);
+		}
+
+		for (uint32_t i = 0; i < BATCH_COUNT; i++)
+		{
+			if (std::ranges::find(pending_, i) != pending_.end()) continue;
+
+			current_ = i;
+			break;
+		}
+
+		auto& item = batches_[current_];
+
+		const auto begin_info = VkCommandBufferBeginInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+			.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+		};
+
+		if (vkBeginCommandBuffer(item.commands, &begin_info) != VK_SUCCESS)
+		{
+			Debug::error("Vulkan staging uploader failed to begin a batch");
+			return false;
+		}
+
+		item.recording = true;
+		item.ring_bytes = 0;
+		return true;
+	}
+
+	bool staging_uploader::reserve(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset)
+	{
+		if (in_use_ == 0)
+		{
+			head_ = 0;
+			tail_ = 0;
+		}
+		else if (head_ == tail_)
+		{
+			return false;
+		}
+
+		auto aligned = align_up(head_, std::max<VkDeviceSize>(alignment, 1));
+		auto consumed = VkDeviceSize();
+
+		if (head_ >= tail_)
+		{
+			if (aligned + size <= ring_size_)
+			{
+				consumed = aligned + size - head_;
+			}
+			else if (size <= tail_)
+			{
+				// skip the end of the ring, the wasted bytes are returned along with the batch
+				aligned = 0;
+				consumed = ring_size_ - head_ + size;
+			}
+			else return false;
+		}
+		else
+		{
+			if (aligned + size > tail_) return false;
+			consumed = aligned + size - head_;
+		}
+
+		offset = aligned;
+		head_ = aligned + size;
+		in_use_ += consumed;
+
+		auto& item = batches_[current_];
+		item.ring_bytes += consumed;
+		item.ring_end = head_;
+		return true;
+	}
+
+	bool staging_uploader::stage_oversized(const void* data, VkDeviceSize size, staging_region& region)
+	{
+		if (!begin_batch()) return false;
+
+		auto buffer = VkBuffer();
+		auto allocation = gpu_allocation();
+
+		if (!create_buffer(size, buffer, allocation))
+		{
+			Debug::error("Vulkan staging uploader failed to stage " + std::to_string(size) + " bytes");
+			return false;
+		}
+
+		std::memcpy(allocation.mapped, data, static_cast<size_t>(size));
+
+		auto& item = batches_[current_];
+		item.oversized.emplace_back(buffer, allocation);
+
+		region.commands = item.commands;
+		region.buffer = buffer;
+		region.offset = 0;
+
+		stats_.uploads++;
+		stats_.oversized_uploads++;
+		stats_.bytes_staged += size;
+		return true;
+	}
+
+	void staging_uploader::retire(bool wait)
+	{
+		while (!pending_.empty())
+		{
+			auto& item = batches_[pending_.front()];
+
+			// only block on the oldest batch, anything behind it is picked up if it has finished too
+			if (wait)
+			{
+				vkWaitForFences(device_, 1, &item.fence, VK_TRUE, UINT64_MAX);
+				wait = false;
+			}
+			else if (vkGetFenceStatus(device_, item.fence) != VK_SUCCESS)
+			{
+				break;
+			}
+
+			release(item);
+			pending_.pop_front();
+		}
+	}
+
+	void staging_uploader::release(batch& item)
+	{
+		if (item.ring_bytes > 0)
+		{
+			tail_ = item.ring_end;
+			in_use_ -= item.ring_bytes;
+			item.ring_bytes = 0;
+		}
+
+		vkResetFences(device_, 1, &item.fence);
+		completed_value_ = item.value;
+
+		release_oversized();
+	}
+
+	void staging_uploader::abandon(batch& item)
+	{
+		// the batch reserved last, so its ring space ends at the head and handing it back moves the head back over it
+		if (item.ring_bytes > 0)
+		{
+			head_ = head_ >= item.ring_bytes ? head_ - item.ring_bytes : head_ + ring_size_ - item.ring_bytes;
+			in_use_ -= item.ring_bytes;
+			item.ring_bytes = 0;
+		}
+
+		for (auto& [buffer, allocation] : item.oversized)
+		{
+			vkDestroyBuffer(device_, buffer, nullptr);
+			allocator_->free(allocation);
+		}
+		item.oversized.clear();
+	}
+
+	void staging_uploader::release_oversized()
+	{
+		while (!oversized_.empty() && oversized_.front().value <= completed_value_)
+		{
+			auto& upload = oversized_.front();
+			vkDestroyBuffer(device_, upload.buffer, nullptr);
+			allocator_->free(upload.allocation);
+			oversized_.pop_front();
+		}
+	}
+
+	bool staging_uploader::create_buffer(VkDeviceSize size, VkBuffer& buffer, gpu_allocation& allocation)
+	{
+		const auto buffer_info = VkBufferCreateInfo
+		{
+			.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+			.size = size,
+			.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+		};
+
+		if (vkCreateBuffer(device_, &buffer_info, nullptr, &buffer) != VK_SUCCESS)
+		{
+			return false;
+		}
+
+		auto requirements = VkMemoryRequirements();
+		vkGetBufferMemoryRequirements(device_, buffer, &requirements);
+
+		constexpr auto properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+		if (!allocator_->allocate(requirements, properties, resource_kind::linear, allocation))
+		{
+			vkDestroyBuffer(device_, buffer, nullptr);
+			return false;
+		}
+
+		vkBindBufferMemory(device_, buffer, allocation.memory, allocation.offset);
+		return true;
+	}
+}